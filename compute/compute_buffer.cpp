@@ -223,3 +223,42 @@ shared_ptr<compute_buffer> compute_buffer::clone(const compute_queue& cqueue, co
 	
 	return ret;
 }
+
+shared_ptr<compute_buffer> compute_buffer::create_sub_buffer(const compute_queue& cqueue floor_unused,
+															 const size_t& offset floor_unused,
+															 const size_t& sub_size floor_unused) const {
+	// not supported by default
+	return {};
+}
+
+shared_ptr<const compute_buffer> compute_buffer::sub_buffer_check(const size_t& offset, const size_t& sub_size) const {
+	if(parent_buffer) {
+		log_error("can't create a sub-buffer of a sub-buffer");
+		return {};
+	}
+	if(has_flag<COMPUTE_MEMORY_FLAG::OPENGL_SHARING>(flags)) {
+		log_error("can't create a sub-buffer of an OpenGL shared buffer");
+		return {};
+	}
+	if(sub_size == 0 || (sub_size % min_multiple()) != 0) {
+		log_error("sub-buffer size must be a non-zero multiple of %u (got %u)", min_multiple(), sub_size);
+		return {};
+	}
+	const auto alignment = get_sub_buffer_alignment();
+	if((offset % alignment) != 0) {
+		log_error("sub-buffer offset %u must be a multiple of %u", offset, alignment);
+		return {};
+	}
+	if(offset >= size || sub_size > size - offset) {
+		log_error("sub-buffer (offset: %u, size: %u) is out of bounds (buffer size: %u)", offset, sub_size, size);
+		return {};
+	}
+	
+	// the sub-buffer keeps this buffer alive
+	auto parent = weak_from_this().lock();
+	if(!parent) {
+		log_error("sub-buffers can only be created from buffers that are owned by a shared_ptr");
+		return {};
+	}
+	return parent;
+}
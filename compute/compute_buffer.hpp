@@ -24,7 +24,7 @@
 FLOOR_PUSH_WARNINGS()
 FLOOR_IGNORE_WARNING(weak-vtables)
 
-class compute_buffer : public compute_memory {
+class compute_buffer : public compute_memory, public enable_shared_from_this<compute_buffer> {
 public:
 	//! constructs a buffer of the specified size, using the host pointer as specified by the flags
 	compute_buffer(const compute_queue& cqueue,
@@ -147,6 +147,19 @@ public:
 	//! returns the size of this buffer (in bytes)
 	const size_t& get_size() const { return size; }
 	
+	//! creates a sub-buffer that references "size" bytes of this buffer starting at "offset" (no new memory is allocated),
+	//! it can be used like any other buffer, with all of its offsets being relative to "offset" in this buffer
+	//! NOTE: returns nullptr if sub-buffers are not supported by the backend or "offset"/"size" are invalid
+	//! NOTE: this buffer must be owned by a shared_ptr, each sub-buffer holds a reference to it (-> keeps it alive)
+	//! NOTE: sub-buffers can not be resized
+	virtual shared_ptr<compute_buffer> create_sub_buffer(const compute_queue& cqueue, const size_t& offset, const size_t& size) const;
+	
+	//! returns the required alignment of sub-buffer offsets (in bytes)
+	virtual size_t get_sub_buffer_alignment() const { return min_multiple(); }
+	
+	//! returns true if this is a sub-buffer of another buffer
+	bool is_sub_buffer() const { return (parent_buffer != nullptr); }
+	
 	//! return struct of get_opengl_buffer_info
 	struct opengl_buffer_info {
 		uint32_t size { 0u };
@@ -160,6 +173,13 @@ public:
 protected:
 	size_t size { 0u };
 	
+	//! set if this is a sub-buffer: the buffer that owns the referenced memory
+	shared_ptr<const compute_buffer> parent_buffer;
+	
+	//! checks if a sub-buffer of the specified "offset" and "size" can be created from this buffer,
+	//! returns the shared_ptr that owns this buffer on success (must be set as the parent of the sub-buffer), nullptr otherwise
+	shared_ptr<const compute_buffer> sub_buffer_check(const size_t& offset, const size_t& sub_size) const;
+	
 	// internal function to create/delete an opengl buffer if compute/opengl sharing is used
 	bool create_gl_buffer(const bool copy_host_data);
 	void delete_gl_buffer();
@@ -0,0 +1,139 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/compute/compute_buffer_pool.hpp>
+#include <floor/compute/compute_context.hpp>
+#include <floor/compute/compute_queue.hpp>
+#include <floor/core/logger.hpp>
+
+compute_buffer_pool::compute_buffer_pool(const compute_context& ctx_,
+										 const compute_queue& cqueue_,
+										 const size_t& block_size_,
+										 const COMPUTE_MEMORY_FLAG flags_) :
+ctx(ctx_), cqueue(cqueue_), block_size(compute_buffer::align_size(block_size_)), flags(flags_),
+has_sub_buffer_support(ctx.has_sub_buffer_support() && !has_flag<COMPUTE_MEMORY_FLAG::OPENGL_SHARING>(flags_)) {
+	if(has_flag<COMPUTE_MEMORY_FLAG::OPENGL_SHARING>(flags)) {
+		log_warn("buffer pool: OpenGL shared buffers can't be sub-allocated, all allocations will be dedicated buffers");
+	}
+	GUARD(pool_lock);
+	epochs.emplace_back(epoch_blocks { 0u, {} });
+}
+
+bool compute_buffer_pool::acquire_block(block& blk) {
+	if(!free_blocks.empty()) {
+		blk = move(free_blocks.back());
+		free_blocks.pop_back();
+		blk.offset = 0u;
+		return true;
+	}
+	
+	auto buffer = ctx.create_buffer(cqueue, block_size, flags);
+	if(!buffer || buffer->get_size() != block_size) {
+		log_error("buffer pool: failed to create a backing buffer of size %u", block_size);
+		return false;
+	}
+	if(alignment == 0u) {
+		alignment = buffer->get_sub_buffer_alignment();
+	}
+	blk = { move(buffer), 0u };
+	++block_count;
+	return true;
+}
+
+shared_ptr<compute_buffer> compute_buffer_pool::allocate(const size_t& size) {
+	if(size == 0) {
+		log_error("buffer pool: can't allocate a buffer of size 0!");
+		return {};
+	}
+	
+	// dedicated allocation if sub-buffers aren't supported or this doesn't fit into a block
+	const auto alloc_size = compute_buffer::align_size(size);
+	if(!has_sub_buffer_support || alloc_size > block_size) {
+		return ctx.create_buffer(cqueue, alloc_size, flags);
+	}
+	
+	GUARD(pool_lock);
+	auto& blocks = epochs.back().blocks;
+	
+	// try to allocate from the current block first, otherwise start a new block
+	// NOTE: the remainder of the previous block is wasted, but will be reused once the epoch is reclaimed
+	size_t offset = 0u;
+	if(!blocks.empty()) {
+		offset = blocks.back().offset;
+		if((offset % alignment) != 0u) {
+			offset += alignment - (offset % alignment);
+		}
+	}
+	if(blocks.empty() || offset > block_size || alloc_size > block_size - offset) {
+		block blk;
+		if(!acquire_block(blk)) {
+			return {};
+		}
+		blocks.emplace_back(move(blk));
+		offset = 0u;
+	}
+	
+	auto& cur_block = blocks.back();
+	auto ret = cur_block.buffer->create_sub_buffer(cqueue, offset, alloc_size);
+	if(!ret) {
+		log_error("buffer pool: failed to create a sub-buffer (offset: %u, size: %u)", offset, alloc_size);
+		return {};
+	}
+	cur_block.offset = offset + alloc_size;
+	return ret;
+}
+
+uint64_t compute_buffer_pool::next_epoch() {
+	GUARD(pool_lock);
+	const auto ended_epoch = epochs.back().epoch;
+	epochs.emplace_back(epoch_blocks { ended_epoch + 1u, {} });
+	return ended_epoch;
+}
+
+uint64_t compute_buffer_pool::get_epoch() const {
+	GUARD(pool_lock);
+	return epochs.back().epoch;
+}
+
+void compute_buffer_pool::reclaim(const uint64_t& epoch) {
+	GUARD(pool_lock);
+	if(epoch >= epochs.back().epoch) {
+		log_error("buffer pool: can't reclaim the current epoch %u", epochs.back().epoch);
+		// still reclaim all prior epochs
+	}
+	
+	// all epochs except for the current one are eligible
+	while(epochs.size() > 1u && epochs.front().epoch <= epoch) {
+		for(auto& blk : epochs.front().blocks) {
+			blk.offset = 0u;
+			free_blocks.emplace_back(move(blk));
+		}
+		epochs.pop_front();
+	}
+}
+
+void compute_buffer_pool::trim() {
+	GUARD(pool_lock);
+	block_count -= free_blocks.size();
+	free_blocks.clear();
+}
+
+size_t compute_buffer_pool::get_allocated_size() const {
+	GUARD(pool_lock);
+	return block_count * block_size;
+}
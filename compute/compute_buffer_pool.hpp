@@ -0,0 +1,103 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_COMPUTE_BUFFER_POOL_HPP__
+#define __FLOOR_COMPUTE_BUFFER_POOL_HPP__
+
+#include <floor/core/essentials.hpp>
+#include <floor/compute/compute_buffer.hpp>
+#include <floor/threading/thread_safety.hpp>
+
+class compute_context;
+class compute_queue;
+
+//! sub-allocates many small buffers from a few large backing buffers ("blocks"), which avoids a device allocation
+//! (and free) for every short-lived buffer, e.g. per-frame or per-dispatch temporaries
+//! allocations are tracked per epoch: once all work using the allocations of an epoch has completed, the epoch can be
+//! reclaimed as a whole, after which its blocks are reused for allocations of later epochs
+//! NOTE: allocations of a reclaimed epoch must no longer be used (their memory is reused by later allocations)
+//! NOTE: each allocation holds a reference to its backing buffer, i.e. trim() and destroying the pool only release
+//!       the pool's references and backing buffers are freed once their last allocation has been destroyed
+//! NOTE: if the backend doesn't support sub-buffers (Metal, OpenGL shared buffers), each allocation is a dedicated buffer
+//!       (freed once it is released)
+class compute_buffer_pool {
+public:
+	//! creates a pool with backing buffers of "block_size" bytes, all allocations are created with the specified flags
+	compute_buffer_pool(const compute_context& ctx,
+						const compute_queue& cqueue,
+						const size_t& block_size,
+						const COMPUTE_MEMORY_FLAG flags = (COMPUTE_MEMORY_FLAG::READ_WRITE |
+														   COMPUTE_MEMORY_FLAG::HOST_READ_WRITE));
+	
+	//! allocates an uninitialized buffer of "size" bytes in the current epoch, returns nullptr on failure
+	//! NOTE: allocations larger than the block size are always dedicated buffers
+	shared_ptr<compute_buffer> allocate(const size_t& size) REQUIRES(!pool_lock);
+	
+	//! ends the current epoch and starts a new one, returns the id of the ended epoch
+	uint64_t next_epoch() REQUIRES(!pool_lock);
+	
+	//! returns the id of the current epoch
+	uint64_t get_epoch() const REQUIRES(!pool_lock);
+	
+	//! reclaims the memory of all allocations made in "epoch" and all epochs before it
+	//! NOTE: the current epoch can not be reclaimed (call next_epoch() first)
+	void reclaim(const uint64_t& epoch) REQUIRES(!pool_lock);
+	
+	//! releases all blocks that are currently unused (see above)
+	void trim() REQUIRES(!pool_lock);
+	
+	//! returns the size of each backing buffer
+	const size_t& get_block_size() const { return block_size; }
+	
+	//! returns the total amount of memory (in bytes) allocated by all backing buffers
+	size_t get_allocated_size() const REQUIRES(!pool_lock);
+	
+protected:
+	const compute_context& ctx;
+	const compute_queue& cqueue;
+	const size_t block_size;
+	const COMPUTE_MEMORY_FLAG flags;
+	const bool has_sub_buffer_support;
+	
+	struct block {
+		shared_ptr<compute_buffer> buffer;
+		//! offset of the next free byte in this block
+		size_t offset { 0u };
+	};
+	struct epoch_blocks {
+		uint64_t epoch;
+		//! all blocks allocations of this epoch were made from, the last one is the one currently allocated from
+		vector<block> blocks;
+	};
+	
+	mutable safe_mutex pool_lock;
+	//! all epochs that haven't been reclaimed yet, ordered by epoch (the last one is the current epoch)
+	deque<epoch_blocks> epochs GUARDED_BY(pool_lock);
+	//! reclaimed blocks that can be reused
+	vector<block> free_blocks GUARDED_BY(pool_lock);
+	//! number of blocks that exist in total (in use or free)
+	size_t block_count GUARDED_BY(pool_lock) { 0u };
+	//! sub-buffer offset alignment, queried from the first backing buffer
+	size_t alignment GUARDED_BY(pool_lock) { 0u };
+	
+	//! returns a reset block from the free list or creates a new one, returns false on failure
+	bool acquire_block(block& blk) REQUIRES(pool_lock);
+	
+};
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/compute/compute_command_graph.hpp>
+#include <floor/compute/compute_queue.hpp>
+#include <floor/compute/compute_kernel.hpp>
+#include <floor/compute/compute_buffer.hpp>
+#include <floor/core/logger.hpp>
+
+compute_command_graph::compute_command_graph(const compute_queue& cqueue_) : cqueue(cqueue_) {
+}
+
+bool compute_command_graph::check_recording() const {
+	if(finalized) {
+		log_error("can't add any more commands to a command graph that has already been finalized");
+		return false;
+	}
+	return true;
+}
+
+uint32_t compute_command_graph::add_kernel_command(shared_ptr<compute_kernel> kernel,
+												   const uint32_t dim,
+												   const uint3& global_work_size,
+												   const uint3& local_work_size,
+												   vector<compute_kernel_arg>&& args) {
+	if(!check_recording()) return ~0u;
+	if(!kernel) {
+		log_error("invalid kernel");
+		return ~0u;
+	}
+	
+	// validate the local work size once here, rather than on every launch
+	const auto entry = kernel->get_kernel_entry(cqueue.get_device());
+	if(entry == nullptr) {
+		log_error("no kernel for this compute queue/device exists!");
+		return ~0u;
+	}
+	
+	const auto checked_local_work_size = kernel->check_local_work_size(*entry, local_work_size);
+	
+	// bind the args once, so that backends can prepare their argument state on the first replay and reuse it afterwards
+	auto bound_args = kernel->bind_args(move(args));
+	commands.emplace_back(kernel_command {
+		.kernel = move(kernel),
+		.dim = dim,
+		.global_work_size = global_work_size,
+		.local_work_size = checked_local_work_size,
+		.bound_args = move(bound_args),
+	});
+	modified = true;
+	return uint32_t(commands.size() - 1u);
+}
+
+uint32_t compute_command_graph::add_copy(compute_buffer& dst, const compute_buffer& src,
+										 const size_t size, const size_t src_offset, const size_t dst_offset) {
+	if(!check_recording()) return ~0u;
+	commands.emplace_back(copy_command {
+		.dst = &dst,
+		.src = &src,
+		.size = size,
+		.src_offset = src_offset,
+		.dst_offset = dst_offset,
+	});
+	modified = true;
+	return uint32_t(commands.size() - 1u);
+}
+
+uint32_t compute_command_graph::add_fill(compute_buffer& buffer, const void* pattern, const size_t& pattern_size,
+										 const size_t size, const size_t offset) {
+	if(!check_recording()) return ~0u;
+	if(pattern == nullptr || pattern_size == 0) {
+		log_error("invalid fill pattern");
+		return ~0u;
+	}
+	commands.emplace_back(fill_command {
+		.buffer = &buffer,
+		.pattern = { (const uint8_t*)pattern, (const uint8_t*)pattern + pattern_size },
+		.size = size,
+		.offset = offset,
+	});
+	modified = true;
+	return uint32_t(commands.size() - 1u);
+}
+
+uint32_t compute_command_graph::add_operation(function<void(const compute_queue&)>&& op) {
+	if(!check_recording()) return ~0u;
+	commands.emplace_back(operation_command { .op = move(op) });
+	modified = true;
+	return uint32_t(commands.size() - 1u);
+}
+
+bool compute_command_graph::set_argument(const uint32_t& cmd_index, const uint32_t& arg_index, const compute_kernel_arg& arg) {
+	if(cmd_index >= commands.size()) {
+		log_error("invalid command index: %u", cmd_index);
+		return false;
+	}
+	auto cmd = get_if<kernel_command>(&commands[cmd_index]);
+	if(cmd == nullptr) {
+		log_error("command #%u is not a kernel launch", cmd_index);
+		return false;
+	}
+	if(arg_index >= cmd->bound_args->get_args().size()) {
+		log_error("invalid argument index %u for command #%u", arg_index, cmd_index);
+		return false;
+	}
+	
+	cmd->bound_args->set_argument(arg_index, arg);
+	modified = true;
+	return true;
+}
+
+void compute_command_graph::rebind(const compute_buffer& old_buffer, compute_buffer& new_buffer) {
+	for(auto& command : commands) {
+		if(auto cmd = get_if<kernel_command>(&command)) {
+			const auto& args = cmd->bound_args->get_args();
+			for(uint32_t i = 0, count = uint32_t(args.size()); i < count; ++i) {
+				if(auto buf_ptr = get_if<const compute_buffer*>(&args[i].var); buf_ptr != nullptr && *buf_ptr == &old_buffer) {
+					auto new_arg = args[i];
+					new_arg.var = (const compute_buffer*)&new_buffer;
+					cmd->bound_args->set_argument(i, new_arg);
+					modified = true;
+				}
+			}
+		} else if(auto copy_cmd = get_if<copy_command>(&command)) {
+			if(copy_cmd->dst == &old_buffer) {
+				copy_cmd->dst = &new_buffer;
+				modified = true;
+			}
+			if(copy_cmd->src == &old_buffer) {
+				copy_cmd->src = &new_buffer;
+				modified = true;
+			}
+		} else if(auto fill_cmd = get_if<fill_command>(&command)) {
+			if(fill_cmd->buffer == &old_buffer) {
+				fill_cmd->buffer = &new_buffer;
+				modified = true;
+			}
+		}
+	}
+}
+
+bool compute_command_graph::finalize() {
+	if(finalized) return true;
+	finalized = true;
+	return true;
+}
+
+bool compute_command_graph::has_operations() const {
+	for(const auto& command : commands) {
+		if(holds_alternative<operation_command>(command)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void compute_command_graph::replay(const compute_queue& exec_queue) const {
+	replay_commands(exec_queue);
+}
+
+void compute_command_graph::replay_commands(const compute_queue& exec_queue) const {
+	for(const auto& command : commands) {
+		if(auto cmd = get_if<kernel_command>(&command)) {
+			cmd->kernel->execute_bound(exec_queue, *cmd->bound_args, cmd->dim, cmd->global_work_size, cmd->local_work_size);
+		} else if(auto copy_cmd = get_if<copy_command>(&command)) {
+			copy_cmd->dst->copy(exec_queue, *copy_cmd->src, copy_cmd->size, copy_cmd->src_offset, copy_cmd->dst_offset);
+		} else if(auto fill_cmd = get_if<fill_command>(&command)) {
+			fill_cmd->buffer->fill(exec_queue, fill_cmd->pattern.data(), fill_cmd->pattern.size(), fill_cmd->size, fill_cmd->offset);
+		} else if(auto op_cmd = get_if<operation_command>(&command)) {
+			op_cmd->op(exec_queue);
+		}
+	}
+}
@@ -0,0 +1,165 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_COMPUTE_COMMAND_GRAPH_HPP__
+#define __FLOOR_COMPUTE_COMMAND_GRAPH_HPP__
+
+#include <functional>
+#include <floor/math/vector_lib.hpp>
+#include <floor/compute/compute_kernel_arg.hpp>
+#include <floor/compute/compute_kernel_bound_args.hpp>
+
+FLOOR_PUSH_WARNINGS()
+FLOOR_IGNORE_WARNING(weak-vtables)
+
+class compute_queue;
+class compute_kernel;
+class compute_buffer;
+
+//! a recorded sequence of kernel launches and buffer operations, which can be replayed many times (with optional
+//! argument/buffer rebinding in between)
+//! NOTE: local work sizes are validated at record time, kernel arguments are bound once (see compute_kernel::bind),
+//!       i.e. on replay, backends only update their argument state for rebound arguments (Host-Compute, OpenCL, CUDA,
+//!       Vulkan), while Metal still encodes all arguments on each launch (see compute_kernel::execute_bound)
+//! NOTE: CUDA (CUDA graph) and Vulkan (secondary command buffer) compile the graph into a native representation that
+//!       is executed as a whole, all other backends replay the commands one by one (on Host-Compute, this already is
+//!       a plain task list of kernel calls with prepared arguments, so there is no separate native form)
+//! NOTE: create this via compute_queue::create_command_graph() and replay it via compute_queue::execute_graph()
+//! NOTE: all memory objects and image arrays referenced by a graph must be kept alive as long as the graph is used
+//! NOTE: this is not thread-safe, recording, rebinding and replaying must not happen concurrently
+class compute_command_graph {
+public:
+	explicit compute_command_graph(const compute_queue& cqueue);
+	virtual ~compute_command_graph() = default;
+	
+	//! records a kernel launch, returns the index of this command
+	//! NOTE: generic (non-memory) arguments are copied
+	template <typename... Args, class work_size_type,
+			  enable_if_t<(is_same<decay_t<work_size_type>, uint1>::value ||
+						   is_same<decay_t<work_size_type>, uint2>::value ||
+						   is_same<decay_t<work_size_type>, uint3>::value), int> = 0>
+	uint32_t add_kernel(shared_ptr<compute_kernel> kernel,
+						const work_size_type& global_work_size,
+						const work_size_type& local_work_size,
+						const Args&... args) {
+		return add_kernel_command(move(kernel), decay_t<work_size_type>::dim(),
+								  uint3 { global_work_size }, uint3 { local_work_size }, { args... });
+	}
+	
+	//! records a buffer copy (see compute_buffer::copy), returns the index of this command
+	uint32_t add_copy(compute_buffer& dst, const compute_buffer& src,
+					  const size_t size = 0, const size_t src_offset = 0, const size_t dst_offset = 0);
+	
+	//! records a buffer fill (see compute_buffer::fill), returns the index of this command
+	//! NOTE: the pattern is copied
+	uint32_t add_fill(compute_buffer& buffer, const void* pattern, const size_t& pattern_size,
+					  const size_t size = 0, const size_t offset = 0);
+	
+	//! records an arbitrary operation on the queue that is executed on every replay, returns the index of this command
+	//! NOTE: this is opaque to the backend, so graphs containing such operations can't be compiled into a native graph
+	uint32_t add_operation(function<void(const compute_queue&)>&& op);
+	
+	//! replaces argument #"arg_index" of the kernel launch command "cmd_index",
+	//! returns false if the command is not a kernel launch or the argument index is out of bounds
+	bool set_argument(const uint32_t& cmd_index, const uint32_t& arg_index, const compute_kernel_arg& arg);
+	
+	//! replaces all uses of "old_buffer" with "new_buffer" in all recorded commands
+	void rebind(const compute_buffer& old_buffer, compute_buffer& new_buffer);
+	
+	//! finishes recording, no more commands can be added after this, but arguments and buffers can still be rebound
+	//! NOTE: backends may compile the graph into their native representation here
+	virtual bool finalize();
+	
+	//! replays all recorded commands on the specified queue (which must belong to the same device as the graph queue)
+	//! NOTE: call compute_queue::execute_graph instead
+	virtual void replay(const compute_queue& cqueue) const;
+	
+	//! returns the queue this graph has been created for
+	const compute_queue& get_queue() const {
+		return cqueue;
+	}
+	
+	//! returns true if this graph has been finalized
+	bool is_finalized() const {
+		return finalized;
+	}
+	
+	//! returns the amount of recorded commands
+	size_t get_command_count() const {
+		return commands.size();
+	}
+	
+protected:
+	//! the queue this graph has been created for
+	const compute_queue& cqueue;
+	
+	bool finalized { false };
+	
+	//! set whenever the recorded commands or arguments have been modified,
+	//! backends with a native graph representation must recompile it if this is set
+	mutable bool modified { true };
+	
+	struct kernel_command {
+		shared_ptr<compute_kernel> kernel;
+		uint32_t dim { 1u };
+		uint3 global_work_size;
+		//! already checked against the limits of the device
+		uint3 local_work_size;
+		//! all arguments, bound to "kernel" (copies all generic arguments)
+		unique_ptr<compute_kernel_bound_args> bound_args;
+	};
+	struct copy_command {
+		compute_buffer* dst;
+		const compute_buffer* src;
+		size_t size;
+		size_t src_offset;
+		size_t dst_offset;
+	};
+	struct fill_command {
+		compute_buffer* buffer;
+		vector<uint8_t> pattern;
+		size_t size;
+		size_t offset;
+	};
+	struct operation_command {
+		function<void(const compute_queue&)> op;
+	};
+	vector<variant<kernel_command, copy_command, fill_command, operation_command>> commands;
+	
+	//! returns true if any recorded command is an opaque operation
+	bool has_operations() const;
+	
+	//! executes all recorded commands one after another on the specified queue,
+	//! this is the default replay implementation (and the fallback for backends with native graphs)
+	void replay_commands(const compute_queue& exec_queue) const;
+	
+	//! adds a kernel command, binding all arguments to the kernel
+	uint32_t add_kernel_command(shared_ptr<compute_kernel> kernel,
+								const uint32_t dim,
+								const uint3& global_work_size,
+								const uint3& local_work_size,
+								vector<compute_kernel_arg>&& args);
+	
+	//! checks if commands can still be added
+	bool check_recording() const;
+	
+};
+
+FLOOR_POP_WARNINGS()
+
+#endif
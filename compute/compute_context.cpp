@@ -17,6 +17,7 @@
  */
 
 #include <floor/compute/compute_context.hpp>
+#include <floor/compute/compute_buffer_pool.hpp>
 
 const compute_device* compute_context::get_device(const compute_device::TYPE type) const {
 	switch(type) {
@@ -74,3 +75,13 @@ vector<const compute_device*> compute_context::get_devices() const {
 	}
 	return ret;
 }
+
+shared_ptr<compute_buffer_pool> compute_context::create_buffer_pool(const compute_queue& cqueue,
+																   const size_t& block_size,
+																   const COMPUTE_MEMORY_FLAG flags) const {
+	if(block_size == 0) {
+		log_error("buffer pool block size must not be 0!");
+		return {};
+	}
+	return make_shared<compute_buffer_pool>(*this, cqueue, block_size, flags);
+}
@@ -34,6 +34,7 @@
 FLOOR_PUSH_WARNINGS()
 FLOOR_IGNORE_WARNING(weak-vtables)
 
+class compute_buffer_pool;
 class cuda_compute;
 class host_compute;
 class metal_compute;
@@ -123,6 +124,16 @@ public:
 												   const COMPUTE_MEMORY_FLAG flags = (COMPUTE_MEMORY_FLAG::READ_WRITE |
 																					  COMPUTE_MEMORY_FLAG::HOST_READ_WRITE)) const = 0;
 	
+	//! returns true if buffers of this context support sub-buffers (see compute_buffer::create_sub_buffer)
+	virtual bool has_sub_buffer_support() const { return false; }
+	
+	//! creates a pool that sub-allocates buffers of the specified flags from "block_size" large backing buffers
+	//! on the device of the specified queue (see compute_buffer_pool)
+	shared_ptr<compute_buffer_pool> create_buffer_pool(const compute_queue& cqueue,
+													   const size_t& block_size = 16u * 1024u * 1024u,
+													   const COMPUTE_MEMORY_FLAG flags = (COMPUTE_MEMORY_FLAG::READ_WRITE |
+																						  COMPUTE_MEMORY_FLAG::HOST_READ_WRITE)) const;
+	
 	//////////////////////////////////////////
 	// image creation
 	
@@ -0,0 +1,53 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_COMPUTE_EVENT_HPP__
+#define __FLOOR_COMPUTE_EVENT_HPP__
+
+#include <floor/core/essentials.hpp>
+
+FLOOR_PUSH_WARNINGS()
+FLOOR_IGNORE_WARNING(weak-vtables)
+
+//! a synchronization point inside a queue, signaled once all work that was enqueued into the queue
+//! before the event was recorded has completed (see compute_queue::record_event)
+//! NOTE: can be waited on from the host (wait()) or from other queues of the same device (compute_queue::wait_for_event)
+class compute_event {
+public:
+	virtual ~compute_event() = default;
+	
+	//! blocks the calling thread until this event has been signaled
+	virtual void wait() const = 0;
+	
+	//! returns true if this event has already been signaled (non-blocking)
+	virtual bool is_complete() const = 0;
+	
+};
+
+//! an event that is already signaled on creation,
+//! used by queues that execute everything synchronously or can't track individual events
+class compute_signaled_event final : public compute_event {
+public:
+	void wait() const override {}
+	bool is_complete() const override { return true; }
+	
+};
+
+FLOOR_POP_WARNINGS()
+
+#endif
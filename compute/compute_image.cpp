@@ -23,6 +23,12 @@
 #include <floor/compute/llvm_toolchain.hpp>
 #include <floor/core/logger.hpp>
 #include <floor/threading/task.hpp>
+#include <thread>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 safe_mutex compute_image::minify_programs_mtx;
 unordered_map<compute_context*, unique_ptr<compute_image::minify_program>> compute_image::minify_programs;
@@ -729,23 +735,243 @@ compute_image::opengl_image_info compute_image::get_opengl_image_info(const uint
 
 #endif
 
+//////////////////////////////////////////
+// RGB <-> RGBA conversion
+
+//! min amount of pixels each thread should convert when splitting a conversion onto multiple threads
+static constexpr size_t rgb_rgba_min_pixels_per_thread { 256u * 1024u };
+
+//! splits the conversion of "pixel_count" pixels into [begin, end) ranges and calls "convert" for each range,
+//! using multiple threads if the image is large enough (the calling thread always converts the first range)
+template <typename F>
+static void rgb_rgba_parallel_convert(const size_t pixel_count, F&& convert) {
+	const auto thread_count = (uint32_t)std::min(size_t(core::get_hw_thread_count()),
+												 std::max(pixel_count / rgb_rgba_min_pixels_per_thread, size_t(1u)));
+	if(thread_count <= 1) {
+		convert(size_t(0), pixel_count);
+		return;
+	}
+	
+	const auto pixels_per_thread = (pixel_count + thread_count - 1u) / thread_count;
+	vector<thread> worker_threads;
+	worker_threads.reserve(thread_count - 1u);
+	for(uint32_t i = 1; i < thread_count; ++i) {
+		const auto begin = std::min(pixels_per_thread * i, pixel_count);
+		const auto end = std::min(begin + pixels_per_thread, pixel_count);
+		worker_threads.emplace_back([&convert, begin, end] { convert(begin, end); });
+	}
+	convert(size_t(0), std::min(pixels_per_thread, pixel_count));
+	for(auto& worker : worker_threads) {
+		worker.join();
+	}
+}
+
+#if defined(__SSSE3__)
+//! creates the byte shuffle mask for 16 bytes of RGBA data (RGB -> RGBA) or 12 bytes of RGB data (RGBA -> RGB),
+//! or, if "alpha_mask" is true, the mask that needs to be or'ed into the RGBA data to make it opaque
+template <uint32_t channel_size, bool to_rgba, bool alpha_mask = false>
+static constexpr array<uint8_t, 16> make_rgb_rgba_shuffle_mask() {
+	constexpr const uint32_t rgb_bpp = channel_size * 3u, rgba_bpp = channel_size * 4u;
+	array<uint8_t, 16> mask {};
+	for(uint32_t i = 0; i < 16u; ++i) {
+		if constexpr(to_rgba) {
+			const auto pixel = i / rgba_bpp, byte = i % rgba_bpp;
+			if constexpr(alpha_mask) {
+				mask[i] = (byte < rgb_bpp ? 0x00u : 0xFFu);
+			}
+			else {
+				mask[i] = (byte < rgb_bpp ? uint8_t(pixel * rgb_bpp + byte) : 0x80u);
+			}
+		}
+		else {
+			const auto pixel = i / rgb_bpp, byte = i % rgb_bpp;
+			mask[i] = (i < 12u ? uint8_t(pixel * rgba_bpp + byte) : 0x80u);
+		}
+	}
+	return mask;
+}
+#endif
+
+//! generic RGB -> RGBA conversion of "pixel_count" pixels, with opaque alpha
+//! NOTE: handles overlapping memory as long as "rgba_data" >= "rgb_data" (pixels are processed in reverse)
+static void rgb_to_rgba_generic(const uint8_t* rgb_data, uint8_t* rgba_data, const size_t pixel_count,
+								const uint32_t rgb_bytes_per_pixel, const uint32_t rgba_bytes_per_pixel) {
+	for(size_t i = pixel_count; i > 0; --i) {
+		uint8_t* rgba_pixel = &rgba_data[(i - 1u) * rgba_bytes_per_pixel];
+		memmove(rgba_pixel, &rgb_data[(i - 1u) * rgb_bytes_per_pixel], rgb_bytes_per_pixel);
+		memset(rgba_pixel + rgb_bytes_per_pixel, 0xFF, rgba_bytes_per_pixel - rgb_bytes_per_pixel); // opaque
+	}
+}
+
+//! generic RGBA -> RGB conversion of "pixel_count" pixels
+static void rgba_to_rgb_generic(const uint8_t* rgba_data, uint8_t* rgb_data, const size_t pixel_count,
+								const uint32_t rgba_bytes_per_pixel, const uint32_t rgb_bytes_per_pixel) {
+	for(size_t i = 0; i < pixel_count; ++i) {
+		memcpy(&rgb_data[i * rgb_bytes_per_pixel], &rgba_data[i * rgba_bytes_per_pixel], rgb_bytes_per_pixel);
+	}
+}
+
+//! SIMD RGB -> RGBA conversion for 8-bit, 16-bit and 32-bit channels
+//! NOTE: with "reverse" set, this converts from the last to the first pixel, which allows in-place conversion
+//!       (RGB and RGBA data starting at the same address), otherwise memory must not overlap
+template <uint32_t channel_size, bool reverse = false>
+static void rgb_to_rgba_simd(const uint8_t* rgb_data, uint8_t* rgba_data, const size_t pixel_count) {
+	static_assert(channel_size == 1u || channel_size == 2u || channel_size == 4u, "invalid channel size");
+	constexpr const uint32_t rgb_bpp = channel_size * 3u, rgba_bpp = channel_size * 4u;
+#if defined(__SSSE3__)
+	// 4/2/1 pixel(s) per 16 byte vector
+	constexpr const size_t vec_pixels = 16u / rgba_bpp;
+	static constexpr const auto shuffle_mask_data = make_rgb_rgba_shuffle_mask<channel_size, true>();
+	static constexpr const auto alpha_mask_data = make_rgb_rgba_shuffle_mask<channel_size, true, true>();
+	const __m128i shuffle_mask = _mm_loadu_si128((const __m128i*)shuffle_mask_data.data());
+	const __m128i alpha_mask = _mm_loadu_si128((const __m128i*)alpha_mask_data.data());
+	// NOTE: each vector load reads 16 bytes, but only consumes 12 bytes -> must not read beyond the end of the RGB data
+	const size_t rgb_size = pixel_count * rgb_bpp;
+	const auto convert_vec = [&](const size_t pixel) {
+		const __m128i rgb = _mm_loadu_si128((const __m128i*)&rgb_data[pixel * rgb_bpp]);
+		_mm_storeu_si128((__m128i*)&rgba_data[pixel * rgba_bpp], _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle_mask), alpha_mask));
+	};
+	const size_t simd_pixels = (rgb_size >= 16u ? ((rgb_size - (16u - 12u)) / 12u) * vec_pixels : 0u);
+	if constexpr(!reverse) {
+		for(size_t i = 0; i < simd_pixels; i += vec_pixels) {
+			convert_vec(i);
+		}
+		rgb_to_rgba_generic(rgb_data + simd_pixels * rgb_bpp, rgba_data + simd_pixels * rgba_bpp,
+							pixel_count - simd_pixels, rgb_bpp, rgba_bpp);
+	}
+	else {
+		// upper remainder must be converted first
+		rgb_to_rgba_generic(rgb_data + simd_pixels * rgb_bpp, rgba_data + simd_pixels * rgba_bpp,
+							pixel_count - simd_pixels, rgb_bpp, rgba_bpp);
+		for(size_t i = simd_pixels; i > 0; i -= vec_pixels) {
+			convert_vec(i - vec_pixels);
+		}
+	}
+#elif defined(__ARM_NEON)
+	// 16/8/4 pixels per de-interleaved vector triple
+	constexpr const size_t vec_pixels = 16u / channel_size;
+	const auto convert_vec = [&](const size_t pixel) {
+		if constexpr(channel_size == 1u) {
+			const uint8x16x3_t rgb = vld3q_u8(&rgb_data[pixel * rgb_bpp]);
+			const uint8x16x4_t rgba { { rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xFFu) } };
+			vst4q_u8(&rgba_data[pixel * rgba_bpp], rgba);
+		}
+		else if constexpr(channel_size == 2u) {
+			const uint16x8x3_t rgb = vld3q_u16((const uint16_t*)&rgb_data[pixel * rgb_bpp]);
+			const uint16x8x4_t rgba { { rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u16(0xFFFFu) } };
+			vst4q_u16((uint16_t*)&rgba_data[pixel * rgba_bpp], rgba);
+		}
+		else {
+			const uint32x4x3_t rgb = vld3q_u32((const uint32_t*)&rgb_data[pixel * rgb_bpp]);
+			const uint32x4x4_t rgba { { rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u32(0xFFFFFFFFu) } };
+			vst4q_u32((uint32_t*)&rgba_data[pixel * rgba_bpp], rgba);
+		}
+	};
+	const size_t simd_pixels = (pixel_count / vec_pixels) * vec_pixels;
+	if constexpr(!reverse) {
+		for(size_t i = 0; i < simd_pixels; i += vec_pixels) {
+			convert_vec(i);
+		}
+		rgb_to_rgba_generic(rgb_data + simd_pixels * rgb_bpp, rgba_data + simd_pixels * rgba_bpp,
+							pixel_count - simd_pixels, rgb_bpp, rgba_bpp);
+	}
+	else {
+		// upper remainder must be converted first
+		rgb_to_rgba_generic(rgb_data + simd_pixels * rgb_bpp, rgba_data + simd_pixels * rgba_bpp,
+							pixel_count - simd_pixels, rgb_bpp, rgba_bpp);
+		for(size_t i = simd_pixels; i > 0; i -= vec_pixels) {
+			convert_vec(i - vec_pixels);
+		}
+	}
+#else
+	rgb_to_rgba_generic(rgb_data, rgba_data, pixel_count, rgb_bpp, rgba_bpp);
+#endif
+}
+
+//! SIMD RGBA -> RGB conversion for 8-bit, 16-bit and 32-bit channels
+template <uint32_t channel_size>
+static void rgba_to_rgb_simd(const uint8_t* rgba_data, uint8_t* rgb_data, const size_t pixel_count) {
+	static_assert(channel_size == 1u || channel_size == 2u || channel_size == 4u, "invalid channel size");
+	constexpr const uint32_t rgb_bpp = channel_size * 3u, rgba_bpp = channel_size * 4u;
+	size_t simd_pixels = 0;
+#if defined(__SSSE3__)
+	constexpr const size_t vec_pixels = 16u / rgba_bpp;
+	static constexpr const auto shuffle_mask_data = make_rgb_rgba_shuffle_mask<channel_size, false>();
+	const __m128i shuffle_mask = _mm_loadu_si128((const __m128i*)shuffle_mask_data.data());
+	// NOTE: each vector store writes 16 bytes, but only 12 bytes are valid (these are overwritten by the next store)
+	//       -> must not write beyond the end of the RGB data
+	const size_t rgb_size = pixel_count * rgb_bpp;
+	for(; (simd_pixels + vec_pixels) * rgb_bpp + (16u - 12u) <= rgb_size; simd_pixels += vec_pixels) {
+		const __m128i rgba = _mm_loadu_si128((const __m128i*)&rgba_data[simd_pixels * rgba_bpp]);
+		_mm_storeu_si128((__m128i*)&rgb_data[simd_pixels * rgb_bpp], _mm_shuffle_epi8(rgba, shuffle_mask));
+	}
+#elif defined(__ARM_NEON)
+	constexpr const size_t vec_pixels = 16u / channel_size;
+	for(; simd_pixels + vec_pixels <= pixel_count; simd_pixels += vec_pixels) {
+		if constexpr(channel_size == 1u) {
+			const uint8x16x4_t rgba = vld4q_u8(&rgba_data[simd_pixels * rgba_bpp]);
+			vst3q_u8(&rgb_data[simd_pixels * rgb_bpp], uint8x16x3_t { { rgba.val[0], rgba.val[1], rgba.val[2] } });
+		}
+		else if constexpr(channel_size == 2u) {
+			const uint16x8x4_t rgba = vld4q_u16((const uint16_t*)&rgba_data[simd_pixels * rgba_bpp]);
+			vst3q_u16((uint16_t*)&rgb_data[simd_pixels * rgb_bpp], uint16x8x3_t { { rgba.val[0], rgba.val[1], rgba.val[2] } });
+		}
+		else {
+			const uint32x4x4_t rgba = vld4q_u32((const uint32_t*)&rgba_data[simd_pixels * rgba_bpp]);
+			vst3q_u32((uint32_t*)&rgb_data[simd_pixels * rgb_bpp], uint32x4x3_t { { rgba.val[0], rgba.val[1], rgba.val[2] } });
+		}
+	}
+#endif
+	rgba_to_rgb_generic(rgba_data + simd_pixels * rgba_bpp, rgb_data + simd_pixels * rgb_bpp,
+						pixel_count - simd_pixels, rgba_bpp, rgb_bpp);
+}
+
+//! dispatches a RGB -> RGBA conversion of "pixel_count" pixels to the SIMD or generic converter
+template <bool reverse = false>
+static void rgb_to_rgba_range(const uint8_t* rgb_data, uint8_t* rgba_data, const size_t pixel_count,
+							  const uint32_t rgb_bytes_per_pixel, const uint32_t rgba_bytes_per_pixel) {
+	// SIMD conversion is only possible if all channels have the same byte size
+	if(rgb_bytes_per_pixel * 4u == rgba_bytes_per_pixel * 3u) {
+		switch(rgb_bytes_per_pixel / 3u) {
+			case 1: rgb_to_rgba_simd<1, reverse>(rgb_data, rgba_data, pixel_count); return;
+			case 2: rgb_to_rgba_simd<2, reverse>(rgb_data, rgba_data, pixel_count); return;
+			case 4: rgb_to_rgba_simd<4, reverse>(rgb_data, rgba_data, pixel_count); return;
+			default: break;
+		}
+	}
+	rgb_to_rgba_generic(rgb_data, rgba_data, pixel_count, rgb_bytes_per_pixel, rgba_bytes_per_pixel);
+}
+
+//! dispatches a RGBA -> RGB conversion of "pixel_count" pixels to the SIMD or generic converter
+static void rgba_to_rgb_range(const uint8_t* rgba_data, uint8_t* rgb_data, const size_t pixel_count,
+							  const uint32_t rgba_bytes_per_pixel, const uint32_t rgb_bytes_per_pixel) {
+	if(rgb_bytes_per_pixel * 4u == rgba_bytes_per_pixel * 3u) {
+		switch(rgb_bytes_per_pixel / 3u) {
+			case 1: rgba_to_rgb_simd<1>(rgba_data, rgb_data, pixel_count); return;
+			case 2: rgba_to_rgb_simd<2>(rgba_data, rgb_data, pixel_count); return;
+			case 4: rgba_to_rgb_simd<4>(rgba_data, rgb_data, pixel_count); return;
+			default: break;
+		}
+	}
+	rgba_to_rgb_generic(rgba_data, rgb_data, pixel_count, rgba_bytes_per_pixel, rgb_bytes_per_pixel);
+}
+
 uint8_t* compute_image::rgb_to_rgba(const COMPUTE_IMAGE_TYPE& rgb_type,
 									const COMPUTE_IMAGE_TYPE& rgba_type,
 									const uint8_t* rgb_data,
+									uint8_t* dst_rgba_data,
 									const bool ignore_mip_levels) {
 	// need to copy/convert the RGB host data to RGBA
 	const auto rgba_size = image_data_size_from_types(image_dim, rgba_type, 1, ignore_mip_levels);
 	const auto rgb_bytes_per_pixel = image_bytes_per_pixel(rgb_type);
 	const auto rgba_bytes_per_pixel = image_bytes_per_pixel(rgba_type);
 	
-	uint8_t* rgba_data_ptr = new uint8_t[rgba_size];
-	memset(rgba_data_ptr, 0xFF, rgba_size); // opaque
-	for(size_t i = 0, count = rgba_size / rgba_bytes_per_pixel; i < count; ++i) {
-		memcpy(&rgba_data_ptr[i * rgba_bytes_per_pixel],
-			   &((const uint8_t*)rgb_data)[i * rgb_bytes_per_pixel],
-			   rgb_bytes_per_pixel);
-	}
-	return rgba_data_ptr;
+	uint8_t* rgba_data_ptr = (dst_rgba_data != nullptr ? dst_rgba_data : new uint8_t[rgba_size]);
+	rgb_rgba_parallel_convert(rgba_size / rgba_bytes_per_pixel, [&](const size_t begin, const size_t end) {
+		rgb_to_rgba_range(&rgb_data[begin * rgb_bytes_per_pixel], &rgba_data_ptr[begin * rgba_bytes_per_pixel],
+						  end - begin, rgb_bytes_per_pixel, rgba_bytes_per_pixel);
+	});
+	return (dst_rgba_data != nullptr ? nullptr : rgba_data_ptr);
 }
 
 void compute_image::rgb_to_rgba_inplace(const COMPUTE_IMAGE_TYPE& rgb_type,
@@ -756,17 +982,24 @@ void compute_image::rgb_to_rgba_inplace(const COMPUTE_IMAGE_TYPE& rgb_type,
 	const auto rgba_size = image_data_size_from_types(image_dim, rgba_type, 1, ignore_mip_levels);
 	const auto rgb_bytes_per_pixel = image_bytes_per_pixel(rgb_type);
 	const auto rgba_bytes_per_pixel = image_bytes_per_pixel(rgba_type);
-	const auto alpha_size = rgba_bytes_per_pixel / 4;
 	
-	// this needs to happen in reverse, otherwise we'd be overwriting the following RGB data
-	for(size_t count = rgba_size / rgba_bytes_per_pixel, i = count - 1; ; --i) {
-		for(size_t j = 0; j < rgb_bytes_per_pixel; ++j) {
-			rgb_to_rgba_data[i * rgba_bytes_per_pixel + j] = rgb_to_rgba_data[i * rgb_bytes_per_pixel + j];
+	// this needs to happen in reverse, otherwise we'd be overwriting the following RGB data:
+	// the RGBA data of all pixels in [lo, hi) with "lo * rgba_bpp >= hi * rgb_bpp" can not overlap any RGB data that
+	// hasn't been converted yet -> convert these in parallel, then continue with [lo', lo) until the rest is small enough
+	size_t hi = rgba_size / rgba_bytes_per_pixel;
+	for(;;) {
+		const size_t lo = (hi * rgb_bytes_per_pixel + rgba_bytes_per_pixel - 1u) / rgba_bytes_per_pixel;
+		if(hi - lo < 2u * rgb_rgba_min_pixels_per_thread) {
+			break;
 		}
-		memset(&rgb_to_rgba_data[(i + 1) * rgba_bytes_per_pixel] - alpha_size, 0xFF, alpha_size); // opaque
-		
-		if(i == 0) break;
+		rgb_rgba_parallel_convert(hi - lo, [&](const size_t begin, const size_t end) {
+			rgb_to_rgba_range(&rgb_to_rgba_data[(lo + begin) * rgb_bytes_per_pixel],
+							  &rgb_to_rgba_data[(lo + begin) * rgba_bytes_per_pixel],
+							  end - begin, rgb_bytes_per_pixel, rgba_bytes_per_pixel);
+		});
+		hi = lo;
 	}
+	rgb_to_rgba_range<true>(rgb_to_rgba_data, rgb_to_rgba_data, hi, rgb_bytes_per_pixel, rgba_bytes_per_pixel);
 }
 
 uint8_t* compute_image::rgba_to_rgb(const COMPUTE_IMAGE_TYPE& rgba_type,
@@ -774,18 +1007,17 @@ uint8_t* compute_image::rgba_to_rgb(const COMPUTE_IMAGE_TYPE& rgba_type,
 									const uint8_t* rgba_data,
 									uint8_t* dst_rgb_data,
 									const bool ignore_mip_levels) {
-	// need to copy/convert the RGB host data to RGBA
+	// need to copy/convert the RGBA data to RGB
 	const auto rgba_size = image_data_size_from_types(image_dim, rgba_type, 1, ignore_mip_levels);
 	const auto rgb_size = image_data_size_from_types(image_dim, rgb_type, 1, ignore_mip_levels);
 	const auto rgb_bytes_per_pixel = image_bytes_per_pixel(rgb_type);
 	const auto rgba_bytes_per_pixel = image_bytes_per_pixel(rgba_type);
 	
 	uint8_t* rgb_data_ptr = (dst_rgb_data != nullptr ? dst_rgb_data : new uint8_t[rgb_size]);
-	for(size_t i = 0, count = rgba_size / rgba_bytes_per_pixel; i < count; ++i) {
-		memcpy(&rgb_data_ptr[i * rgb_bytes_per_pixel],
-			   &((const uint8_t*)rgba_data)[i * rgba_bytes_per_pixel],
-			   rgb_bytes_per_pixel);
-	}
+	rgb_rgba_parallel_convert(rgba_size / rgba_bytes_per_pixel, [&](const size_t begin, const size_t end) {
+		rgba_to_rgb_range(&rgba_data[begin * rgba_bytes_per_pixel], &rgb_data_ptr[begin * rgb_bytes_per_pixel],
+						  end - begin, rgba_bytes_per_pixel, rgb_bytes_per_pixel);
+	});
 	return (dst_rgb_data != nullptr ? nullptr : rgb_data_ptr);
 }
 
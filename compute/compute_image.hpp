@@ -206,14 +206,19 @@ protected:
 	const size_t image_data_size_mip_maps;
 	size_t shim_image_data_size_mip_maps { 0 };
 	
-	//! converts RGB data to RGBA data and returns the owning RGBA image data pointer
+	//! converts RGB data to RGBA data. if "dst_rgba_data" is non-null, the RGBA data is directly written to it (e.g. mapped
+	//! upload/staging memory), no memory is allocated and nullptr is returned. otherwise RGBA image data is allocated and
+	//! an owning pointer to it is returned.
+	//! NOTE: conversion is SIMD accelerated for 8-bit, 16-bit and 32-bit channels and large images are converted using multiple threads
 	uint8_t* rgb_to_rgba(const COMPUTE_IMAGE_TYPE& rgb_type,
 						 const COMPUTE_IMAGE_TYPE& rgba_type,
 						 const uint8_t* rgb_data,
+						 uint8_t* dst_rgba_data = nullptr,
 						 const bool ignore_mip_levels = false);
 	
 	//! in-place converts RGB data to RGBA data
 	//! NOTE: 'rgb_to_rgba_data' must point to sufficient enough memory that can hold the RGBA data
+	//! NOTE: prefer rgb_to_rgba with a destination pointer if the RGB data is still available elsewhere
 	void rgb_to_rgba_inplace(const COMPUTE_IMAGE_TYPE& rgb_type,
 							 const COMPUTE_IMAGE_TYPE& rgba_type,
 							 uint8_t* rgb_to_rgba_data,
@@ -17,6 +17,8 @@
  */
 
 #include <floor/compute/compute_kernel.hpp>
+#include <floor/compute/compute_buffer.hpp>
+#include <floor/compute/compute_queue.hpp>
 #include <floor/core/logger.hpp>
 
 uint3 compute_kernel::check_local_work_size(const compute_kernel::kernel_entry& entry, const uint3& local_work_size) const {
@@ -50,3 +52,65 @@ uint3 compute_kernel::check_local_work_size(const compute_kernel::kernel_entry&
 	}
 	return ret;
 }
+
+void compute_kernel::execute_indirect(const compute_queue& cqueue,
+									  const uint32_t& dim,
+									  const compute_buffer& indirect_buffer,
+									  const size_t& indirect_offset,
+									  const uint3& local_work_size,
+									  const vector<compute_kernel_arg>& args) const {
+	if(indirect_offset + sizeof(uint3) > indirect_buffer.get_size()) {
+		log_error("indirect work-group count offset is out of bounds");
+		return;
+	}
+	
+	// no native support: read back the work-group count (only waits for the read itself, not for the whole queue)
+	uint3 group_count;
+	if(!read_group_count(cqueue, indirect_buffer, indirect_offset, group_count)) {
+		return;
+	}
+	execute_group_count(cqueue, dim, group_count, local_work_size, args);
+}
+
+bool compute_kernel::read_group_count(const compute_queue&, const compute_buffer&, const size_t&, uint3&) const {
+	log_error("indirect kernel execution is not supported by this backend");
+	return false;
+}
+
+unique_ptr<compute_kernel_bound_args> compute_kernel::bind_args(vector<compute_kernel_arg>&& args) const {
+	return make_unique<compute_kernel_bound_args>(*this, move(args));
+}
+
+void compute_kernel::execute_bound(const compute_queue& cqueue,
+								   compute_kernel_bound_args& bound_args,
+								   const uint32_t& dim,
+								   const uint3& global_work_size,
+								   const uint3& local_work_size) const {
+	execute(cqueue, false, dim, global_work_size, local_work_size, bound_args.get_args());
+}
+
+void compute_kernel::execute_group_count(const compute_queue& cqueue,
+										 const uint32_t& dim,
+										 const uint3& group_count,
+										 const uint3& local_work_size,
+										 const vector<compute_kernel_arg>& args) const {
+	const auto entry = get_kernel_entry(cqueue.get_device());
+	if(entry == nullptr) {
+		log_error("no kernel for this compute queue/device exists!");
+		return;
+	}
+	
+	// unused dimensions are always 1
+	uint3 groups { group_count };
+	for(uint32_t i = dim; i < 3; ++i) {
+		groups[i] = 1u;
+	}
+	if(groups.x == 0 || groups.y == 0 || groups.z == 0) {
+		// nothing to do
+		return;
+	}
+	
+	// the local work size must already be the one that is used for execution, so that the work-group count is retained
+	const auto checked_local_work_size = check_local_work_size(*entry, local_work_size);
+	execute(cqueue, false, dim, groups * checked_local_work_size, checked_local_work_size, args);
+}
@@ -24,6 +24,7 @@
 #include <floor/math/vector_lib.hpp>
 #include <floor/compute/compute_common.hpp>
 #include <floor/compute/compute_kernel_arg.hpp>
+#include <floor/compute/compute_kernel_bound_args.hpp>
 #include <floor/compute/llvm_toolchain.hpp>
 #include <floor/core/flat_map.hpp>
 #include <floor/threading/atomic_spin_lock.hpp>
@@ -55,10 +56,42 @@ public:
 						 const uint3& local_work_size,
 						 const vector<compute_kernel_arg>& args) const = 0;
 	
+	//! don't call this directly, call the execute_indirect function in a compute_queue object instead!
+	//! NOTE: the default implementation reads the work-group count back to the host (see read_group_count())
+	//!       and then calls execute()
+	virtual void execute_indirect(const compute_queue& cqueue,
+								  const uint32_t& dim,
+								  const compute_buffer& indirect_buffer,
+								  const size_t& indirect_offset,
+								  const uint3& local_work_size,
+								  const vector<compute_kernel_arg>& args) const;
+	
+	//! binds the specified arguments to this kernel, the returned object can then be launched many times via
+	//! compute_queue::execute_bound, with individual arguments being replaceable in between (see compute_kernel_bound_args)
+	//! NOTE: generic (non-memory) arguments are copied
+	template <typename... Args>
+	unique_ptr<compute_kernel_bound_args> bind(const Args&... args) const {
+		return bind_args({ args... });
+	}
+	
+	//! don't call this directly, call the execute_bound function in a compute_queue object instead!
+	//! NOTE: the default implementation simply calls execute() with the bound arguments
+	virtual void execute_bound(const compute_queue& cqueue,
+							   compute_kernel_bound_args& bound_args,
+							   const uint32_t& dim,
+							   const uint3& global_work_size,
+							   const uint3& local_work_size) const;
+	
 protected:
+	// needs to check local work sizes at record time
+	friend class compute_command_graph;
+	
 	//! same as the one in compute_context, but this way we don't need access to that object
 	virtual COMPUTE_TYPE get_compute_type() const = 0;
 	
+	//! creates the backend-specific bound arguments object, by default this only stores the arguments
+	virtual unique_ptr<compute_kernel_bound_args> bind_args(vector<compute_kernel_arg>&& args) const;
+	
 	mutable atomic_spin_lock warn_map_lock;
 	//! used to prevent console/log spam by remembering if a warning/error has already been printed for a kernel
 	mutable flat_map<const kernel_entry*, bool> warn_map GUARDED_BY(warn_map_lock);
@@ -69,6 +102,23 @@ protected:
 	uint3 check_local_work_size(const kernel_entry& entry,
 								const uint3& local_work_size) const REQUIRES(!warn_map_lock);
 	
+	//! reads the work-group count for an emulated execute_indirect() back to the host, returns false on failure
+	//! NOTE: this blocks until the read has completed, i.e. until all prior work on "cqueue" has completed,
+	//!       but doesn't wait for any work that is enqueued afterwards or on other queues
+	//! NOTE: the default implementation fails (backends without native indirect execution must implement this)
+	virtual bool read_group_count(const compute_queue& cqueue,
+								  const compute_buffer& indirect_buffer,
+								  const size_t& indirect_offset,
+								  uint3& group_count) const;
+	
+	//! executes "group_count" work-groups of the checked local work size, used when emulating indirect execution
+	//! NOTE: nothing is executed if any used dimension of "group_count" is 0 (unused dimensions are ignored)
+	void execute_group_count(const compute_queue& cqueue,
+							 const uint32_t& dim,
+							 const uint3& group_count,
+							 const uint3& local_work_size,
+							 const vector<compute_kernel_arg>& args) const REQUIRES(!warn_map_lock);
+	
 };
 
 FLOOR_POP_WARNINGS()
@@ -22,6 +22,8 @@
 #include <variant>
 #include <memory>
 #include <vector>
+#include <cstdint>
+#include <cstring>
 using namespace std;
 
 class compute_buffer;
@@ -55,6 +57,19 @@ struct compute_kernel_arg {
 			> var;
 	size_t size { 0 };
 	
+	//! if this is a generic argument, copies its data into "data" and makes this argument point to the copy,
+	//! otherwise "data" is reset
+	void store_generic_data(unique_ptr<uint8_t[]>& data) {
+		const auto generic_arg_ptr = get_if<const void*>(&var);
+		if(generic_arg_ptr == nullptr) {
+			data = nullptr;
+			return;
+		}
+		data = make_unique<uint8_t[]>(size);
+		memcpy(data.get(), *generic_arg_ptr, size);
+		var = (const void*)data.get();
+	}
+	
 };
 
 #endif
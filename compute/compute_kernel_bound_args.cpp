@@ -0,0 +1,41 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/compute/compute_kernel_bound_args.hpp>
+#include <floor/core/logger.hpp>
+
+compute_kernel_bound_args::compute_kernel_bound_args(const compute_kernel& kernel_, vector<compute_kernel_arg>&& args_) :
+kernel(kernel_), args(move(args_)), generic_arg_data(args.size()) {
+	for(size_t i = 0, count = args.size(); i < count; ++i) {
+		args[i].store_generic_data(generic_arg_data[i]);
+	}
+}
+
+bool compute_kernel_bound_args::set_argument(const uint32_t& arg_index, const compute_kernel_arg& arg) {
+	if(arg_index >= args.size()) {
+		log_error("invalid argument index: %u", arg_index);
+		return false;
+	}
+	
+	args[arg_index] = arg;
+	args[arg_index].store_generic_data(generic_arg_data[arg_index]);
+	if(find(cbegin(modified_args), cend(modified_args), arg_index) == cend(modified_args)) {
+		modified_args.emplace_back(arg_index);
+	}
+	return true;
+}
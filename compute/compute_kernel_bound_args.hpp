@@ -0,0 +1,70 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_COMPUTE_KERNEL_BOUND_ARGS_HPP__
+#define __FLOOR_COMPUTE_KERNEL_BOUND_ARGS_HPP__
+
+#include <floor/core/essentials.hpp>
+#include <floor/compute/compute_kernel_arg.hpp>
+
+FLOOR_PUSH_WARNINGS()
+FLOOR_IGNORE_WARNING(weak-vtables)
+
+class compute_kernel;
+class compute_device;
+
+//! a set of arguments that has been bound to a kernel once (see compute_kernel::bind), which can then be used for many
+//! kernel launches via compute_queue::execute_bound, with backends only preparing their argument state once
+//! (and only updating it for individually modified arguments afterwards)
+//! NOTE: the kernel and all memory objects and image arrays referenced by the arguments must be kept alive as long as this is used
+//! NOTE: this is not thread-safe, modifying and launching must not happen concurrently
+class compute_kernel_bound_args {
+public:
+	compute_kernel_bound_args(const compute_kernel& kernel, vector<compute_kernel_arg>&& args);
+	virtual ~compute_kernel_bound_args() = default;
+	
+	//! replaces argument #"arg_index", returns false if the argument index is out of bounds
+	//! NOTE: generic (non-memory) arguments are copied
+	bool set_argument(const uint32_t& arg_index, const compute_kernel_arg& arg);
+	
+	//! returns the kernel these arguments have been bound to
+	const compute_kernel& get_kernel() const {
+		return kernel;
+	}
+	
+	//! returns all bound arguments
+	const vector<compute_kernel_arg>& get_args() const {
+		return args;
+	}
+	
+protected:
+	const compute_kernel& kernel;
+	vector<compute_kernel_arg> args;
+	//! copies of all generic arguments (-> generic args point into these)
+	vector<unique_ptr<uint8_t[]>> generic_arg_data;
+	
+	//! device the backend state has been prepared for (nullptr if it hasn't been prepared yet)
+	const compute_device* prepared_device { nullptr };
+	//! indices of all arguments that have been modified since the backend state has been prepared/updated
+	vector<uint32_t> modified_args;
+	
+};
+
+FLOOR_POP_WARNINGS()
+
+#endif
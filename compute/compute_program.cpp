@@ -21,7 +21,7 @@
 compute_program::~compute_program() {}
 
 shared_ptr<compute_kernel> compute_program::get_kernel(const string& func_name) const {
-	const auto iter = find(cbegin(kernel_names), cend(kernel_names), func_name);
-	if(iter == cend(kernel_names)) return {};
-	return kernels[(size_t)distance(cbegin(kernel_names), iter)];
+	const auto iter = kernel_index.find(func_name);
+	if(iter == kernel_index.end() || iter->second >= kernels.size()) return {};
+	return kernels[iter->second];
 }
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <floor/math/vector_lib.hpp>
 #include <floor/compute/llvm_toolchain.hpp>
 #include <floor/compute/universal_binary.hpp>
@@ -56,18 +57,28 @@ public:
 protected:
 	mutable vector<shared_ptr<compute_kernel>> kernels;
 	mutable vector<string> kernel_names;
+	//! kernel name -> index into kernels/kernel_names, built once when the kernels are created
+	mutable unordered_map<string, size_t> kernel_index;
+	
+	//! adds the kernel name to the kernel index, returns false if it already existed
+	bool add_kernel_name(const string& name) const {
+		if(!kernel_index.emplace(name, kernel_names.size()).second) return false;
+		kernel_names.push_back(name);
+		return true;
+	}
 	
 	template <typename device_type, typename program_entry_type>
 	void retrieve_unique_kernel_names(const flat_map<device_type, program_entry_type>& programs) {
 		// go through all kernels in all device programs and create a unique list of all kernel names
+		// NOTE: this keeps the order in which the names were first encountered (kernels are created in this order)
 		kernel_names.clear(); // just in case
+		kernel_index.clear();
 		for(const auto& prog : programs) {
 			if(!prog.second.valid) continue;
 			for(const auto& info : prog.second.functions) {
-				kernel_names.push_back(info.name);
+				add_kernel_name(info.name);
 			}
 		}
-		kernel_names.erase(unique(begin(kernel_names), end(kernel_names)), end(kernel_names));
 	}
 	
 };
@@ -18,7 +18,10 @@
 
 #include <floor/compute/compute_queue.hpp>
 #include <floor/core/core.hpp>
+#include <floor/core/logger.hpp>
 #include <floor/compute/compute_kernel.hpp>
+#include <floor/compute/compute_command_graph.hpp>
+#include <floor/compute/compute_event.hpp>
 
 void compute_queue::start_profiling() {
 	finish();
@@ -50,3 +53,56 @@ void compute_queue::kernel_execute_forwarder(shared_ptr<compute_kernel> kernel,
 											 const vector<compute_kernel_arg>& args) const {
 	kernel->execute(*this, is_cooperative, 3, global_size, local_size, args);
 }
+
+void compute_queue::kernel_execute_indirect_forwarder(shared_ptr<compute_kernel> kernel,
+													  const compute_buffer& indirect_buffer, const size_t indirect_offset,
+													  const uint1& local_size,
+													  const vector<compute_kernel_arg>& args) const {
+	kernel->execute_indirect(*this, 1, indirect_buffer, indirect_offset, uint3 { local_size }, args);
+}
+
+void compute_queue::kernel_execute_indirect_forwarder(shared_ptr<compute_kernel> kernel,
+													  const compute_buffer& indirect_buffer, const size_t indirect_offset,
+													  const uint2& local_size,
+													  const vector<compute_kernel_arg>& args) const {
+	kernel->execute_indirect(*this, 2, indirect_buffer, indirect_offset, uint3 { local_size }, args);
+}
+
+void compute_queue::kernel_execute_indirect_forwarder(shared_ptr<compute_kernel> kernel,
+													  const compute_buffer& indirect_buffer, const size_t indirect_offset,
+													  const uint3& local_size,
+													  const vector<compute_kernel_arg>& args) const {
+	kernel->execute_indirect(*this, 3, indirect_buffer, indirect_offset, local_size, args);
+}
+
+void compute_queue::kernel_execute_bound_forwarder(compute_kernel_bound_args& bound_args,
+												   const uint32_t dim,
+												   const uint3& global_size, const uint3& local_size) const {
+	bound_args.get_kernel().execute_bound(*this, bound_args, dim, global_size, local_size);
+}
+
+shared_ptr<compute_event> compute_queue::record_event() const {
+	finish();
+	return make_shared<compute_signaled_event>();
+}
+
+void compute_queue::wait_for_event(const compute_event& evt) const {
+	evt.wait();
+}
+
+unique_ptr<compute_command_graph> compute_queue::create_command_graph() const {
+	// default: plain command list that is replayed command by command
+	return make_unique<compute_command_graph>(*this);
+}
+
+void compute_queue::execute_graph(const compute_command_graph& graph) const {
+	if(!graph.is_finalized()) {
+		log_error("command graph must be finalized before it can be executed");
+		return;
+	}
+	if(&graph.get_queue().get_device() != &device) {
+		log_error("command graph can only be executed on a queue of the device it has been created for");
+		return;
+	}
+	graph.replay(*this);
+}
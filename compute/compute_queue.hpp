@@ -30,6 +30,9 @@ FLOOR_IGNORE_WARNING(weak-vtables)
 class compute_device;
 class compute_memory;
 class compute_kernel;
+class compute_command_graph;
+class compute_event;
+class compute_kernel_bound_args;
 
 class compute_queue {
 protected:
@@ -85,6 +88,16 @@ public:
 	//! flushes all scheduled work to the associated device
 	virtual void flush() const = 0;
 	
+	//! records an event into this queue, which is signaled once all work that has been enqueued into this queue so far
+	//! (kernel executions, copies, fills, ...) has completed
+	//! NOTE: by default, this will finish() the queue and return an already signaled event
+	virtual shared_ptr<compute_event> record_event() const;
+	
+	//! makes all work that is subsequently enqueued into this queue wait until the specified event has been signaled,
+	//! the event may have been recorded in a different queue of the same device
+	//! NOTE: by default, this will block the calling thread until the event has been signaled
+	virtual void wait_for_event(const compute_event& evt) const;
+	
 	//! implementation specific queue object ptr (cl_command_queue or CUStream, both "struct _ *")
 	virtual const void* get_queue_ptr() const = 0;
 	virtual void* get_queue_ptr() = 0;
@@ -133,6 +146,50 @@ public:
 	__attribute__((enable_if(!check_arg_types<Args...>(), "invalid args"), unavailable("invalid kernel argument(s)!")));
 #endif
 	
+	//! enqueues (and executes) the specified kernel into this queue, with the number of work-groups being read from
+	//! "indirect_buffer" at "indirect_offset" when the kernel is executed
+	//! NOTE: the buffer must contain three uint32_t work-group counts (x, y, z) at this offset (4-byte aligned),
+	//!       unused dimensions must be set to 1, if any work-group count is 0, nothing is executed
+	//! NOTE: backends without native support read the work-group count back to the host first (-> implies a queue finish)
+	template <typename... Args, class work_size_type_local,
+			  enable_if_t<(is_same<decay_t<work_size_type_local>, uint1>::value ||
+						   is_same<decay_t<work_size_type_local>, uint2>::value ||
+						   is_same<decay_t<work_size_type_local>, uint3>::value), int> = 0>
+	void execute_indirect(shared_ptr<compute_kernel> kernel,
+						  const compute_buffer& indirect_buffer,
+						  const size_t indirect_offset,
+						  work_size_type_local&& local_work_size,
+						  const Args&... args) const __attribute__((enable_if(check_arg_types<Args...>(), "valid args"))) {
+		kernel_execute_indirect_forwarder(kernel, indirect_buffer, indirect_offset, local_work_size, { args... });
+	}
+	
+	template <typename... Args, class work_size_type_local,
+			  enable_if_t<(is_same<decay_t<work_size_type_local>, uint1>::value ||
+						   is_same<decay_t<work_size_type_local>, uint2>::value ||
+						   is_same<decay_t<work_size_type_local>, uint3>::value), int> = 0>
+	void execute_indirect(shared_ptr<compute_kernel>, const compute_buffer&, const size_t, work_size_type_local&&, const Args&...) const
+	__attribute__((enable_if(!check_arg_types<Args...>(), "invalid args"), unavailable("invalid kernel argument(s)!")));
+	
+	//! enqueues (and executes) the kernel of the specified bound arguments (see compute_kernel::bind) into this queue
+	template <class work_size_type_global, class work_size_type_local,
+			  enable_if_t<((is_same<decay_t<work_size_type_global>, uint1>::value ||
+							is_same<decay_t<work_size_type_global>, uint2>::value ||
+							is_same<decay_t<work_size_type_global>, uint3>::value) &&
+						   is_same<decay_t<work_size_type_global>, decay_t<work_size_type_local>>::value), int> = 0>
+	void execute_bound(compute_kernel_bound_args& bound_args,
+					   work_size_type_global&& global_work_size,
+					   work_size_type_local&& local_work_size) const {
+		kernel_execute_bound_forwarder(bound_args, decay_t<work_size_type_global>::dim(),
+									   uint3 { global_work_size }, uint3 { local_work_size });
+	}
+	
+	//! creates a new command graph for this queue: kernel launches and buffer operations are recorded into it once,
+	//! after which it can be replayed many times via execute_graph (backends may compile it into a native graph)
+	virtual unique_ptr<compute_command_graph> create_command_graph() const;
+	
+	//! replays the specified (finalized) command graph on this queue
+	void execute_graph(const compute_command_graph& graph) const;
+	
 	//! returns the compute device associated with this queue
 	const compute_device& get_device() const { return device; }
 	
@@ -164,6 +221,21 @@ protected:
 								  const bool is_cooperative,
 								  const uint3& global_size, const uint3& local_size,
 								  const vector<compute_kernel_arg>& args) const;
+	void kernel_execute_indirect_forwarder(shared_ptr<compute_kernel> kernel,
+										   const compute_buffer& indirect_buffer, const size_t indirect_offset,
+										   const uint1& local_size,
+										   const vector<compute_kernel_arg>& args) const;
+	void kernel_execute_indirect_forwarder(shared_ptr<compute_kernel> kernel,
+										   const compute_buffer& indirect_buffer, const size_t indirect_offset,
+										   const uint2& local_size,
+										   const vector<compute_kernel_arg>& args) const;
+	void kernel_execute_indirect_forwarder(shared_ptr<compute_kernel> kernel,
+										   const compute_buffer& indirect_buffer, const size_t indirect_offset,
+										   const uint3& local_size,
+										   const vector<compute_kernel_arg>& args) const;
+	void kernel_execute_bound_forwarder(compute_kernel_bound_args& bound_args,
+										const uint32_t dim,
+										const uint3& global_size, const uint3& local_size) const;
 	
 };
 
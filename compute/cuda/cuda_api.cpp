@@ -122,6 +122,9 @@ bool cuda_api_init(const bool use_internal_api) {
 	(void*&)cuda_api.event_elapsed_time = load_symbol(cuda_lib, "cuEventElapsedTime");
 	if(cuda_api.event_elapsed_time == nullptr) log_error("failed to retrieve function pointer for \"cuEventElapsedTime\"");
 	
+	(void*&)cuda_api.event_query = load_symbol(cuda_lib, "cuEventQuery");
+	if(cuda_api.event_query == nullptr) log_error("failed to retrieve function pointer for \"cuEventQuery\"");
+	
 	(void*&)cuda_api.event_record = load_symbol(cuda_lib, "cuEventRecord");
 	if(cuda_api.event_record == nullptr) log_error("failed to retrieve function pointer for \"cuEventRecord\"");
 	
@@ -137,6 +140,18 @@ bool cuda_api_init(const bool use_internal_api) {
 	(void*&)cuda_api.get_error_string = load_symbol(cuda_lib, "cuGetErrorString");
 	if(cuda_api.get_error_string == nullptr) log_error("failed to retrieve function pointer for \"cuGetErrorString\"");
 	
+	(void*&)cuda_api.graph_destroy = load_symbol(cuda_lib, "cuGraphDestroy");
+	if(cuda_api.graph_destroy == nullptr) log_error("failed to retrieve function pointer for \"cuGraphDestroy\"");
+	
+	(void*&)cuda_api.graph_exec_destroy = load_symbol(cuda_lib, "cuGraphExecDestroy");
+	if(cuda_api.graph_exec_destroy == nullptr) log_error("failed to retrieve function pointer for \"cuGraphExecDestroy\"");
+	
+	(void*&)cuda_api.graph_instantiate = load_symbol(cuda_lib, "cuGraphInstantiate");
+	if(cuda_api.graph_instantiate == nullptr) log_error("failed to retrieve function pointer for \"cuGraphInstantiate\"");
+	
+	(void*&)cuda_api.graph_launch = load_symbol(cuda_lib, "cuGraphLaunch");
+	if(cuda_api.graph_launch == nullptr) log_error("failed to retrieve function pointer for \"cuGraphLaunch\"");
+	
 	(void*&)cuda_api.graphics_gl_register_buffer = load_symbol(cuda_lib, "cuGraphicsGLRegisterBuffer");
 	if(cuda_api.graphics_gl_register_buffer == nullptr) log_error("failed to retrieve function pointer for \"cuGraphicsGLRegisterBuffer\"");
 	
@@ -269,12 +284,21 @@ bool cuda_api_init(const bool use_internal_api) {
 	(void*&)cuda_api.occupancy_max_potential_block_size_with_flags = load_symbol(cuda_lib, "cuOccupancyMaxPotentialBlockSizeWithFlags");
 	if(cuda_api.occupancy_max_potential_block_size_with_flags == nullptr) log_error("failed to retrieve function pointer for \"cuOccupancyMaxPotentialBlockSizeWithFlags\"");
 	
+	(void*&)cuda_api.stream_begin_capture = load_symbol(cuda_lib, "cuStreamBeginCapture_v2");
+	if(cuda_api.stream_begin_capture == nullptr) log_error("failed to retrieve function pointer for \"cuStreamBeginCapture_v2\"");
+	
 	(void*&)cuda_api.stream_create = load_symbol(cuda_lib, "cuStreamCreate");
 	if(cuda_api.stream_create == nullptr) log_error("failed to retrieve function pointer for \"cuStreamCreate\"");
 	
+	(void*&)cuda_api.stream_end_capture = load_symbol(cuda_lib, "cuStreamEndCapture");
+	if(cuda_api.stream_end_capture == nullptr) log_error("failed to retrieve function pointer for \"cuStreamEndCapture\"");
+	
 	(void*&)cuda_api.stream_synchronize = load_symbol(cuda_lib, "cuStreamSynchronize");
 	if(cuda_api.stream_synchronize == nullptr) log_error("failed to retrieve function pointer for \"cuStreamSynchronize\"");
 	
+	(void*&)cuda_api.stream_wait_event = load_symbol(cuda_lib, "cuStreamWaitEvent");
+	if(cuda_api.stream_wait_event == nullptr) log_error("failed to retrieve function pointer for \"cuStreamWaitEvent\"");
+	
 	(void*&)cuda_api.surf_object_create = load_symbol(cuda_lib, "cuSurfObjectCreate");
 	if(cuda_api.surf_object_create == nullptr) log_error("failed to retrieve function pointer for \"cuSurfObjectCreate\"");
 	
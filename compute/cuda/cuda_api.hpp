@@ -385,6 +385,13 @@ enum class CU_STREAM_FLAGS : uint32_t {
 	NON_BLOCKING = 1
 };
 
+// cuda 10.1+
+enum class CU_STREAM_CAPTURE_MODE : uint32_t {
+	GLOBAL = 0,
+	THREAD_LOCAL = 1,
+	RELAXED = 2,
+};
+
 enum class CU_ARRAY_3D_FLAGS : uint32_t {
 	NONE = 0,
 	LAYERED = 1,
@@ -410,6 +417,7 @@ enum class CU_EVENT_FLAGS : uint32_t {
 	DISABLE_TIMING	= (1u << 1u),
 	INTERPROCESS	= (1u << 2u),
 };
+floor_global_enum_no_hash_ext(CU_EVENT_FLAGS)
 
 #define CU_LAUNCH_PARAM_BUFFER_POINTER ((void*)1)
 #define CU_LAUNCH_PARAM_BUFFER_SIZE ((void*)2)
@@ -456,6 +464,18 @@ struct _cu_event;
 using cu_event = _cu_event*;
 using const_cu_event = const _cu_event*;
 
+struct _cu_graph;
+using cu_graph = _cu_graph*;
+using const_cu_graph = const _cu_graph*;
+
+struct _cu_graph_exec;
+using cu_graph_exec = _cu_graph_exec*;
+using const_cu_graph_exec = const _cu_graph_exec*;
+
+struct _cu_graph_node;
+using cu_graph_node = _cu_graph_node*;
+using const_cu_graph_node = const _cu_graph_node*;
+
 using cu_device = int32_t;
 using cu_device_ptr = size_t;
 using cu_surf_object = uint64_t;
@@ -583,11 +603,16 @@ struct cuda_api_ptrs {
 	CU_API CU_RESULT (*event_create)(cu_event* evt, CU_EVENT_FLAGS flags);
 	CU_API CU_RESULT (*event_destroy)(cu_event evt);
 	CU_API CU_RESULT (*event_elapsed_time)(float* milli_seconds, cu_event start_evt, cu_event end_evt);
+	CU_API CU_RESULT (*event_query)(cu_event evt);
 	CU_API CU_RESULT (*event_record)(cu_event evt, const_cu_stream stream);
 	CU_API CU_RESULT (*event_synchronize)(cu_event evt);
 	CU_API CU_RESULT (*function_get_attribute)(int32_t* ret, CU_FUNCTION_ATTRIBUTE attrib, cu_function hfunc);
 	CU_API CU_RESULT (*get_error_name)(CU_RESULT error, const char** p_str);
 	CU_API CU_RESULT (*get_error_string)(CU_RESULT error, const char** p_str);
+	CU_API CU_RESULT (*graph_destroy)(cu_graph h_graph);
+	CU_API CU_RESULT (*graph_exec_destroy)(cu_graph_exec h_graph_exec);
+	CU_API CU_RESULT (*graph_instantiate)(cu_graph_exec* ph_graph_exec, cu_graph h_graph, cu_graph_node* ph_error_node, char* log_buffer, size_t buffer_size);
+	CU_API CU_RESULT (*graph_launch)(cu_graph_exec h_graph_exec, const_cu_stream h_stream);
 	CU_API CU_RESULT (*graphics_gl_register_buffer)(cu_graphics_resource* p_cuda_resource, GLuint buffer, CU_GRAPHICS_REGISTER_FLAGS flags);
 	CU_API CU_RESULT (*graphics_gl_register_image)(cu_graphics_resource* p_cuda_resource, GLuint image, GLenum target, CU_GRAPHICS_REGISTER_FLAGS flags);
 	CU_API CU_RESULT (*graphics_map_resources)(uint32_t count, cu_graphics_resource* resources, const_cu_stream h_stream);
@@ -632,8 +657,11 @@ struct cuda_api_ptrs {
 	CU_API CU_RESULT (*occupancy_max_active_blocks_per_multiprocessor_with_flags)(int32_t* num_blocks, cu_function func, int32_t block_size, size_t dynamic_s_mem_size, uint32_t flags);
 	CU_API CU_RESULT (*occupancy_max_potential_block_size)(int32_t* min_grid_size, int32_t* block_size, cu_function func, cu_occupancy_b2d_size block_size_to_dynamic_s_mem_size, size_t dynamic_s_mem_size, int32_t block_size_limit);
 	CU_API CU_RESULT (*occupancy_max_potential_block_size_with_flags)(int32_t* min_grid_size, int32_t* block_size, cu_function func, cu_occupancy_b2d_size block_size_to_dynamic_s_mem_size, size_t dynamic_s_mem_size, int32_t block_size_limit, uint32_t flags);
+	CU_API CU_RESULT (*stream_begin_capture)(cu_stream h_stream, CU_STREAM_CAPTURE_MODE mode);
 	CU_API CU_RESULT (*stream_create)(cu_stream* ph_stream, CU_STREAM_FLAGS flags);
+	CU_API CU_RESULT (*stream_end_capture)(cu_stream h_stream, cu_graph* ph_graph);
 	CU_API CU_RESULT (*stream_synchronize)(const_cu_stream h_stream);
+	CU_API CU_RESULT (*stream_wait_event)(const_cu_stream h_stream, cu_event h_event, uint32_t flags);
 	CU_API CU_RESULT (*surf_object_create)(cu_surf_object* p_surf_object, const cu_resource_descriptor* p_res_desc);
 	CU_API CU_RESULT (*surf_object_destroy)(cu_surf_object surf_object);
 	CU_API CU_RESULT (*tex_object_create)(cu_tex_object* p_tex_object, const cu_resource_descriptor* p_res_desc, const cu_texture_descriptor* p_tex_desc, const cu_resource_view_descriptor* p_res_view_desc);
@@ -663,11 +691,16 @@ extern bool cuda_can_use_internal_api();
 #define cu_event_create cuda_api.event_create
 #define cu_event_destroy cuda_api.event_destroy
 #define cu_event_elapsed_time cuda_api.event_elapsed_time
+#define cu_event_query cuda_api.event_query
 #define cu_event_record cuda_api.event_record
 #define cu_event_synchronize cuda_api.event_synchronize
 #define cu_function_get_attribute cuda_api.function_get_attribute
 #define cu_get_error_name cuda_api.get_error_name
 #define cu_get_error_string cuda_api.get_error_string
+#define cu_graph_destroy cuda_api.graph_destroy
+#define cu_graph_exec_destroy cuda_api.graph_exec_destroy
+#define cu_graph_instantiate cuda_api.graph_instantiate
+#define cu_graph_launch cuda_api.graph_launch
 #define cu_graphics_gl_register_buffer cuda_api.graphics_gl_register_buffer
 #define cu_graphics_gl_register_image cuda_api.graphics_gl_register_image
 #define cu_graphics_map_resources cuda_api.graphics_map_resources
@@ -712,8 +745,11 @@ extern bool cuda_can_use_internal_api();
 #define cu_occupancy_max_active_blocks_per_multiprocessor_with_flags cuda_api.occupancy_max_active_blocks_per_multiprocessor_with_flags
 #define cu_occupancy_max_potential_block_size cuda_api.occupancy_max_potential_block_size
 #define cu_occupancy_max_potential_block_size_with_flags cuda_api.occupancy_max_potential_block_size_with_flags
+#define cu_stream_begin_capture cuda_api.stream_begin_capture
 #define cu_stream_create cuda_api.stream_create
+#define cu_stream_end_capture cuda_api.stream_end_capture
 #define cu_stream_synchronize cuda_api.stream_synchronize
+#define cu_stream_wait_event cuda_api.stream_wait_event
 #define cu_surf_object_create cuda_api.surf_object_create
 #define cu_surf_object_destroy cuda_api.surf_object_destroy
 #define cu_tex_object_create cuda_api.tex_object_create
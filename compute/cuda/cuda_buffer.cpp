@@ -74,6 +74,17 @@ compute_buffer(cqueue, size_, host_ptr_, flags_, opengl_type_, external_gl_objec
 	}
 }
 
+cuda_buffer::cuda_buffer(const compute_queue& cqueue,
+						 shared_ptr<const cuda_buffer> parent,
+						 const size_t& offset,
+						 const size_t& size_) :
+compute_buffer(cqueue, size_, (parent->host_ptr != nullptr ? (uint8_t*)parent->host_ptr + offset : nullptr),
+			   parent->flags | COMPUTE_MEMORY_FLAG::NO_INITIAL_COPY) {
+	// references the memory of the parent buffer (device memory or mapped host memory), nothing to allocate
+	buffer = parent->buffer + offset;
+	parent_buffer = move(parent);
+}
+
 bool cuda_buffer::create_internal(const bool copy_host_data, const compute_queue& cqueue) {
 	// -> use host memory
 	if(has_flag<COMPUTE_MEMORY_FLAG::USE_HOST_MEMORY>(flags)) {
@@ -129,8 +140,8 @@ bool cuda_buffer::create_internal(const bool copy_host_data, const compute_queue
 }
 
 cuda_buffer::~cuda_buffer() {
-	// kill the buffer
-	if(buffer == 0) return;
+	// kill the buffer (sub-buffers don't own their memory)
+	if(buffer == 0 || parent_buffer) return;
 	
 	// -> host memory
 	if(has_flag<COMPUTE_MEMORY_FLAG::USE_HOST_MEMORY>(flags)) {
@@ -256,6 +267,10 @@ bool cuda_buffer::resize(const compute_queue& cqueue, const size_t& new_size_,
 						 const bool copy_old_data, const bool copy_host_data,
 						 void* new_host_ptr) {
 	if(buffer == 0) return false;
+	if(parent_buffer) {
+		log_error("can't resize a sub-buffer!");
+		return false;
+	}
 	if(new_size_ == 0) {
 		log_error("can't allocate a buffer of size 0!");
 		return false;
@@ -468,4 +483,11 @@ bool cuda_buffer::release_opengl_object(const compute_queue* cqueue) {
 	return true;
 }
 
+shared_ptr<compute_buffer> cuda_buffer::create_sub_buffer(const compute_queue& cqueue, const size_t& offset, const size_t& sub_size) const {
+	if(buffer == 0) return {};
+	auto parent = sub_buffer_check(offset, sub_size);
+	if(!parent) return {};
+	return make_shared<cuda_buffer>(cqueue, static_pointer_cast<const cuda_buffer>(move(parent)), offset, sub_size);
+}
+
 #endif
@@ -59,6 +59,12 @@ public:
 				const uint32_t opengl_type_ = 0) :
 	cuda_buffer(cqueue, sizeof(data_type) * n, (void*)&data[0], flags_, opengl_type_) {}
 	
+	//! constructs a sub-buffer of "parent" (see create_sub_buffer), which holds a reference to "parent"
+	cuda_buffer(const compute_queue& cqueue,
+				shared_ptr<const cuda_buffer> parent,
+				const size_t& offset,
+				const size_t& size_);
+	
 	~cuda_buffer() override;
 	
 	void read(const compute_queue& cqueue, const size_t size = 0, const size_t offset = 0) override;
@@ -91,6 +97,11 @@ public:
 	bool acquire_opengl_object(const compute_queue* cqueue) override;
 	bool release_opengl_object(const compute_queue* cqueue) override;
 	
+	shared_ptr<compute_buffer> create_sub_buffer(const compute_queue& cqueue, const size_t& offset, const size_t& size) const override;
+	
+	//! same as the base alignment of cu_mem_alloc allocations
+	size_t get_sub_buffer_alignment() const override { return 256u; }
+	
 	//! returns the cuda specific buffer pointer (device pointer)
 	const cu_device_ptr& get_cuda_buffer() const {
 		return buffer;
@@ -0,0 +1,107 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/compute/cuda/cuda_command_graph.hpp>
+
+#if !defined(FLOOR_NO_CUDA)
+
+#include <floor/compute/compute_queue.hpp>
+
+cuda_command_graph::cuda_command_graph(const compute_queue& cqueue_) : compute_command_graph(cqueue_) {
+}
+
+cuda_command_graph::~cuda_command_graph() {
+	destroy_graph();
+}
+
+void cuda_command_graph::destroy_graph() const {
+	if(graph_exec != nullptr) {
+		CU_CALL_NO_ACTION(cu_graph_exec_destroy(graph_exec), "failed to destroy graph exec")
+		graph_exec = nullptr;
+	}
+	if(graph != nullptr) {
+		CU_CALL_NO_ACTION(cu_graph_destroy(graph), "failed to destroy graph")
+		graph = nullptr;
+	}
+}
+
+bool cuda_command_graph::finalize() {
+	if(finalized) return true;
+	if(!compute_command_graph::finalize()) return false;
+	
+	if(has_operations()) {
+		// can't capture arbitrary host code
+		no_native_graph = true;
+	}
+	else if(cu_stream_begin_capture == nullptr || cu_stream_end_capture == nullptr ||
+			cu_graph_instantiate == nullptr || cu_graph_launch == nullptr) {
+		log_warn("CUDA graphs are not supported by this driver (requires CUDA 10.1+) - replaying commands one by one");
+		no_native_graph = true;
+	}
+	else {
+		capture();
+	}
+	return true;
+}
+
+bool cuda_command_graph::capture() const {
+	destroy_graph();
+	modified = false;
+	
+	// record everything into a graph instead of executing it
+	// NOTE: thread-local mode, so that other threads can still use potentially unsafe API calls in the meantime
+	auto stream = (cu_stream)const_cast<void*>(cqueue.get_queue_ptr());
+	CU_CALL_ERROR_EXEC(cu_stream_begin_capture(stream, CU_STREAM_CAPTURE_MODE::THREAD_LOCAL),
+					   "failed to begin stream capture", {
+						   no_native_graph = true;
+						   return false;
+					   })
+	replay_commands(cqueue);
+	
+	// NOTE: if any of the commands can't be captured (e.g. synchronous copies), this will fail
+	cu_graph captured_graph { nullptr };
+	CU_CALL_ERROR_EXEC(cu_stream_end_capture(stream, &captured_graph),
+					   "failed to capture commands into a graph - replaying commands one by one", {
+						   no_native_graph = true;
+						   return false;
+					   })
+	graph = captured_graph;
+	
+	CU_CALL_ERROR_EXEC(cu_graph_instantiate(&graph_exec, graph, nullptr, nullptr, 0),
+					   "failed to instantiate graph - replaying commands one by one", {
+						   destroy_graph();
+						   no_native_graph = true;
+						   return false;
+					   })
+	return true;
+}
+
+void cuda_command_graph::replay(const compute_queue& exec_queue) const {
+	if(!no_native_graph && (modified || graph_exec == nullptr)) {
+		capture();
+	}
+	if(no_native_graph) {
+		replay_commands(exec_queue);
+		return;
+	}
+	
+	CU_CALL_RET(cu_graph_launch(graph_exec, (const_cu_stream)exec_queue.get_queue_ptr()),
+				"failed to launch graph")
+}
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_CUDA_COMMAND_GRAPH_HPP__
+#define __FLOOR_CUDA_COMMAND_GRAPH_HPP__
+
+#include <floor/compute/cuda/cuda_common.hpp>
+
+#if !defined(FLOOR_NO_CUDA)
+
+#include <floor/compute/compute_command_graph.hpp>
+
+//! compiles the recorded commands into a native CUDA graph (via stream capture), which is then launched as a whole
+//! NOTE: if the graph contains opaque operations or capturing fails, commands are replayed one by one instead
+class cuda_command_graph final : public compute_command_graph {
+public:
+	explicit cuda_command_graph(const compute_queue& cqueue);
+	~cuda_command_graph() override;
+	
+	//! NOTE: this captures the graph on the queue it has been created for,
+	//!       no other work must be enqueued into that queue while this is happening
+	bool finalize() override;
+	
+	//! NOTE: if arguments or buffers have been rebound, this will recapture the graph first (see finalize)
+	void replay(const compute_queue& exec_queue) const override;
+	
+protected:
+	mutable cu_graph graph { nullptr };
+	mutable cu_graph_exec graph_exec { nullptr };
+	//! set if this graph can't be turned into a native graph (-> always replay commands one by one)
+	mutable bool no_native_graph { false };
+	
+	//! (re-)captures and instantiates the native graph
+	bool capture() const;
+	
+	//! destroys the current native graph (if any)
+	void destroy_graph() const;
+	
+};
+
+#endif
+
+#endif
@@ -72,9 +72,18 @@ void cuda_kernel::execute(const compute_queue& cqueue,
 		return;
 	}
 	
-	// check work size (NOTE: will set elements to at least 1)
-	const uint3 block_dim = check_local_work_size(kernel_iter->second, local_work_size);
-	
+	vector<void*> kernel_params;
+	unique_ptr<uint8_t[]> kernel_params_data;
+	if(!set_kernel_params(kernel_iter->second, args, kernel_params, kernel_params_data)) {
+		return;
+	}
+	launch(cqueue, kernel_iter->second, is_cooperative, global_work_size, local_work_size, kernel_params.data());
+}
+
+bool cuda_kernel::set_kernel_params(const cuda_kernel_entry& entry,
+									const vector<compute_kernel_arg>& args,
+									vector<void*>& kernel_params,
+									unique_ptr<uint8_t[]>& kernel_params_data) const {
 	// set and handle kernel arguments
 	static constexpr const size_t heap_protect {
 #if defined(FLOOR_DEBUG)
@@ -83,13 +92,12 @@ void cuda_kernel::execute(const compute_queue& cqueue,
 		0
 #endif
 	};
-	vector<void*> kernel_params(args.size(), nullptr);
-	auto kernel_params_data = make_unique<uint8_t[]>(kernel_iter->second.kernel_args_size + heap_protect);
+	kernel_params.assign(args.size(), nullptr);
+	kernel_params_data = make_unique<uint8_t[]>(entry.kernel_args_size + heap_protect);
 	uint8_t* data = kernel_params_data.get();
 	
 	{
 #if defined(FLOOR_DEBUG)
-		const auto& entry = kernel_iter->second;
 		uint32_t param_idx = 0;
 #endif
 		auto param_iter = kernel_params.begin();
@@ -110,20 +118,20 @@ void cuda_kernel::execute(const compute_queue& cqueue,
 				// sanity checks
 				if (entry.info->args[idx].image_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::NONE) {
 					log_error("no image access qualifier specified!");
-					return;
+					return false;
 				}
 				if (entry.info->args[idx].image_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ ||
 					entry.info->args[idx].image_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ_WRITE) {
 					if (cu_img->get_cuda_textures()[0] == 0) {
 						log_error("image is set to be readable, but texture objects don't exist!");
-						return;
+						return false;
 					}
 				}
 				if (entry.info->args[idx].image_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::WRITE ||
 					entry.info->args[idx].image_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ_WRITE) {
 					if (cu_img->get_cuda_surfaces()[0] == 0) {
 						log_error("image is set to be writable, but surface object doesn't exist!");
-						return;
+						return false;
 					}
 				}
 #endif
@@ -158,29 +166,76 @@ void cuda_kernel::execute(const compute_queue& cqueue,
 				data += 4 /* padding */;
 			} else if (auto vec_img_ptrs = get_if<const vector<compute_image*>*>(&arg.var)) {
 				log_error("array of images is not supported for CUDA");
-				return;
+				return false;
 			} else if (auto vec_img_sptrs = get_if<const vector<shared_ptr<compute_image>>*>(&arg.var)) {
 				log_error("array of images is not supported for CUDA");
-				return;
+				return false;
 			} else if (auto generic_arg_ptr = get_if<const void*>(&arg.var)) {
 				param = data;
 				memcpy(data, *generic_arg_ptr, arg.size);
 				data += arg.size;
 			} else {
 				log_error("encountered invalid arg");
-				return;
+				return false;
 			}
 		}
 	}
 	
 	const auto written_args_size = distance(&kernel_params_data[0], data);
-	if((size_t)written_args_size != kernel_iter->second.kernel_args_size) {
+	if((size_t)written_args_size != entry.kernel_args_size) {
 		log_error("invalid kernel parameters size (in %s): got %u, expected %u",
-				  kernel_iter->second.info->name,
-				  written_args_size, kernel_iter->second.kernel_args_size);
+				  entry.info->name,
+				  written_args_size, entry.kernel_args_size);
+		return false;
+	}
+	return true;
+}
+
+bool cuda_kernel::cuda_bound_args::update(const cuda_kernel_entry& entry, const compute_device& dev) {
+	// NOTE: parameters are tightly packed and may have a device-specific size -> re-marshal all of them on any modification
+	if(prepared_device != &dev || !modified_args.empty()) {
+		prepared_device = nullptr;
+		modified_args.clear();
+		if(!((const cuda_kernel&)kernel).set_kernel_params(entry, args, kernel_params, kernel_params_data)) {
+			return false;
+		}
+		prepared_device = &dev;
+	}
+	return true;
+}
+
+unique_ptr<compute_kernel_bound_args> cuda_kernel::bind_args(vector<compute_kernel_arg>&& args) const {
+	return make_unique<cuda_bound_args>(*this, move(args));
+}
+
+void cuda_kernel::execute_bound(const compute_queue& cqueue,
+								compute_kernel_bound_args& bound_args,
+								const uint32_t& dim floor_unused,
+								const uint3& global_work_size,
+								const uint3& local_work_size) const {
+	const auto kernel_iter = get_kernel(cqueue);
+	if(kernel_iter == kernels.cend()) {
+		log_error("no kernel for this compute queue/device exists!");
 		return;
 	}
 	
+	// NOTE: bound args are always created by bind_args() above
+	auto& cuda_args = (cuda_bound_args&)bound_args;
+	if(!cuda_args.update(kernel_iter->second, cqueue.get_device())) {
+		return;
+	}
+	launch(cqueue, kernel_iter->second, false, global_work_size, local_work_size, cuda_args.kernel_params.data());
+}
+
+void cuda_kernel::launch(const compute_queue& cqueue,
+						 const cuda_kernel_entry& entry,
+						 const bool is_cooperative,
+						 const uint3& global_work_size,
+						 const uint3& local_work_size,
+						 void** kernel_params) const {
+	// check work size (NOTE: will set elements to at least 1)
+	const uint3 block_dim = check_local_work_size(entry, local_work_size);
+	
 	// run
 	const uint3 grid_dim_overflow {
 		global_work_size.x > 0 ? std::min(uint32_t(global_work_size.x % block_dim.x), 1u) : 0u,
@@ -191,12 +246,24 @@ void cuda_kernel::execute(const compute_queue& cqueue,
 	grid_dim.max(1u);
 	
 	if (!is_cooperative) {
-		execute_internal(cqueue, kernel_iter->second, grid_dim, block_dim, &kernel_params[0]);
+		execute_internal(cqueue, entry, grid_dim, block_dim, kernel_params);
 	} else {
-		execute_cooperative_internal(cqueue, kernel_iter->second, grid_dim, block_dim, &kernel_params[0]);
+		execute_cooperative_internal(cqueue, entry, grid_dim, block_dim, kernel_params);
 	}
 }
 
+bool cuda_kernel::read_group_count(const compute_queue& cqueue,
+								   const compute_buffer& indirect_buffer,
+								   const size_t& indirect_offset,
+								   uint3& group_count) const {
+	// NOTE: device -> pageable host memory copies return once the copy has completed,
+	//       i.e. this only waits for the prior work on this stream
+	CU_CALL_RET(cu_memcpy_dtoh_async(&group_count, ((const cuda_buffer&)indirect_buffer).get_cuda_buffer() + indirect_offset,
+									 sizeof(group_count), (const_cu_stream)cqueue.get_queue_ptr()),
+				"failed to read the indirect work-group count", false)
+	return true;
+}
+
 const compute_kernel::kernel_entry* cuda_kernel::get_kernel_entry(const compute_device& dev) const {
 	const auto ret = kernels.get((const cuda_device&)dev);
 	return !ret.first ? nullptr : &ret.second->second;
@@ -50,6 +50,17 @@ public:
 				 const uint3& local_work_size,
 				 const vector<compute_kernel_arg>& args) const override;
 	
+	void execute_bound(const compute_queue& cqueue,
+					   compute_kernel_bound_args& bound_args,
+					   const uint32_t& dim,
+					   const uint3& global_work_size,
+					   const uint3& local_work_size) const override;
+	
+	bool read_group_count(const compute_queue& cqueue,
+						  const compute_buffer& indirect_buffer,
+						  const size_t& indirect_offset,
+						  uint3& group_count) const override;
+	
 	const kernel_entry* get_kernel_entry(const compute_device& dev) const override;
 	
 protected:
@@ -59,6 +70,32 @@ protected:
 	
 	typename kernel_map_type::const_iterator get_kernel(const compute_queue& cqueue) const;
 	
+	//! bound args with an already marshalled kernel parameter array
+	struct cuda_bound_args final : public compute_kernel_bound_args {
+		using compute_kernel_bound_args::compute_kernel_bound_args;
+		
+		vector<void*> kernel_params;
+		unique_ptr<uint8_t[]> kernel_params_data;
+		
+		//! (re-)marshals all kernel parameters if necessary, returns false on failure
+		bool update(const cuda_kernel_entry& entry, const compute_device& dev);
+	};
+	unique_ptr<compute_kernel_bound_args> bind_args(vector<compute_kernel_arg>&& args) const override;
+	
+	//! marshals all arguments into the kernel parameter array + data, returns false on failure
+	bool set_kernel_params(const cuda_kernel_entry& entry,
+						   const vector<compute_kernel_arg>& args,
+						   vector<void*>& kernel_params,
+						   unique_ptr<uint8_t[]>& kernel_params_data) const;
+	
+	//! checks the work size and launches the kernel with the specified marshalled parameters
+	void launch(const compute_queue& cqueue,
+				const cuda_kernel_entry& entry,
+				const bool is_cooperative,
+				const uint3& global_work_size,
+				const uint3& local_work_size,
+				void** kernel_params) const;
+	
 	void execute_internal(const compute_queue& cqueue,
 						  const cuda_kernel_entry& entry,
 						  const uint3& grid_dim,
@@ -50,57 +50,60 @@ cuda_program::cuda_program(program_map_type&& programs_) : programs(move(program
 	retrieve_unique_kernel_names(programs);
 	
 	// create all kernels of all device programs
-	// note that this essentially reshuffles the program "device -> kernels" data to "kernels -> devices"
-	kernels.reserve(kernel_names.size());
-	for(const auto& kernel_name : kernel_names) {
-		cuda_kernel::kernel_map_type kernel_map;
-		kernel_map.reserve(kernel_names.size());
-		
-		for(const auto& prog : programs) {
-			if(!prog.second.valid) continue;
-			for(const auto& info : prog.second.functions) {
-				if(info.name == kernel_name) {
-					cuda_kernel::cuda_kernel_entry entry;
-					entry.info = &info;
-					entry.kernel_args_size = compute_kernel_args_size(info);
-					entry.max_local_size = prog.first.get().max_local_size;
-					
-					CU_CALL_CONT(cu_module_get_function(&entry.kernel, prog.second.program, kernel_name.c_str()),
-								 "failed to get function \"" + kernel_name + "\"")
-					
-					// retrieve max local work size for this kernel for this device
-					int max_total_local_size = 0;
-					CU_CALL_IGNORE(cu_function_get_attribute(&max_total_local_size,
-															 CU_FUNCTION_ATTRIBUTE::MAX_THREADS_PER_BLOCK, entry.kernel))
-					entry.max_total_local_size = (max_total_local_size < 0 ? 0 : (uint32_t)max_total_local_size);
-					
+	// note that this essentially reshuffles the program "device -> kernels" data to "kernels -> devices",
+	// which only requires a single pass over all device functions (kernels are looked up through the kernel index)
+	vector<cuda_kernel::kernel_map_type> kernel_maps(kernel_names.size());
+	for(const auto& prog : programs) {
+		if(!prog.second.valid) continue;
+		for(const auto& info : prog.second.functions) {
+			// kernel_index contains all function names of all device programs
+			auto& kernel_map = kernel_maps[kernel_index.at(info.name)];
+			if(kernel_map.find(prog.first) != kernel_map.end()) {
+				continue; // only use the first function with this name
+			}
+			const auto& kernel_name = info.name;
+			
+			cuda_kernel::cuda_kernel_entry entry;
+			entry.info = &info;
+			entry.kernel_args_size = compute_kernel_args_size(info);
+			entry.max_local_size = prog.first.get().max_local_size;
+			
+			CU_CALL_CONT(cu_module_get_function(&entry.kernel, prog.second.program, kernel_name.c_str()),
+						 "failed to get function \"" + kernel_name + "\"")
+			
+			// retrieve max local work size for this kernel for this device
+			int max_total_local_size = 0;
+			CU_CALL_IGNORE(cu_function_get_attribute(&max_total_local_size,
+													 CU_FUNCTION_ATTRIBUTE::MAX_THREADS_PER_BLOCK, entry.kernel))
+			entry.max_total_local_size = (max_total_local_size < 0 ? 0 : (uint32_t)max_total_local_size);
+			
 #if 0 // WIP
-					// use this to compute max occupancy
-					int min_grid_size = 0, block_size = 0;
-					CU_CALL_NO_ACTION(cu_occupancy_max_potential_block_size(&min_grid_size, &block_size, entry.kernel, nullptr, 0, 0),
-									  "failed to compute max potential occupancy");
-					log_debug("%s max occupancy: grid size >= %u with block size %u", kernel_name, min_grid_size, block_size);
-					
-					//
-					static const array<uint32_t, 6> check_local_sizes {{
-						32, 64, 128, 256, 512, 1024
-					}};
-					for(const auto& local_size : check_local_sizes) {
-						int block_count = 0;
-						CU_CALL_NO_ACTION(cu_occupancy_max_active_blocks_per_multiprocessor(&block_count, entry.kernel,
-																							int(local_size), 0),
-										  "failed to compute max active blocks per mp");
-						log_debug("%s: #blocks: %u for local-size %u", kernel_name, block_count, local_size);
-					}
-#endif
-					
-					// success, insert into map
-					kernel_map.insert_or_assign(prog.first, entry);
-					break;
-				}
+			// use this to compute max occupancy
+			int min_grid_size = 0, block_size = 0;
+			CU_CALL_NO_ACTION(cu_occupancy_max_potential_block_size(&min_grid_size, &block_size, entry.kernel, nullptr, 0, 0),
+							  "failed to compute max potential occupancy");
+			log_debug("%s max occupancy: grid size >= %u with block size %u", kernel_name, min_grid_size, block_size);
+			
+			//
+			static const array<uint32_t, 6> check_local_sizes {{
+				32, 64, 128, 256, 512, 1024
+			}};
+			for(const auto& local_size : check_local_sizes) {
+				int block_count = 0;
+				CU_CALL_NO_ACTION(cu_occupancy_max_active_blocks_per_multiprocessor(&block_count, entry.kernel,
+																					int(local_size), 0),
+								  "failed to compute max active blocks per mp");
+				log_debug("%s: #blocks: %u for local-size %u", kernel_name, block_count, local_size);
 			}
+#endif
+			
+			// success, insert into map
+			kernel_map.insert_or_assign(prog.first, entry);
 		}
-		
+	}
+	
+	kernels.reserve(kernel_names.size());
+	for(auto& kernel_map : kernel_maps) {
 		kernels.emplace_back(make_shared<cuda_kernel>(move(kernel_map)));
 	}
 }
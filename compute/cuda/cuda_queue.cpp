@@ -20,6 +20,30 @@
 
 #if !defined(FLOOR_NO_CUDA)
 
+#include <floor/compute/cuda/cuda_command_graph.hpp>
+
+cuda_event::cuda_event(cu_event evt_) : evt(evt_) {
+}
+
+cuda_event::~cuda_event() {
+	if(evt != nullptr) {
+		CU_CALL_NO_ACTION(cu_event_destroy(evt), "failed to destroy event")
+	}
+}
+
+void cuda_event::wait() const {
+	CU_CALL_RET(cu_event_synchronize(evt), "failed to wait for event")
+}
+
+bool cuda_event::is_complete() const {
+	const auto query_err = cu_event_query(evt);
+	if(query_err == CU_RESULT::NOT_READY) {
+		return false;
+	}
+	CU_CALL_RET(query_err, "failed to query event status", true)
+	return true;
+}
+
 cuda_queue::cuda_queue(const compute_device& device_, const cu_stream queue_) : compute_queue(device_), queue(queue_) {
 	CU_CALL_NO_ACTION(cu_event_create(&prof_start, CU_EVENT_FLAGS::BLOCKING_SYNC), "failed to create profiling event")
 	CU_CALL_NO_ACTION(cu_event_create(&prof_stop, CU_EVENT_FLAGS::BLOCKING_SYNC), "failed to create profiling event")
@@ -51,6 +75,25 @@ void* cuda_queue::get_queue_ptr() {
 	return queue;
 }
 
+shared_ptr<compute_event> cuda_queue::record_event() const {
+	// no timing needed, but don't want to spin when waiting for it on the host
+	cu_event evt { nullptr };
+	CU_CALL_RET(cu_event_create(&evt, CU_EVENT_FLAGS::BLOCKING_SYNC | CU_EVENT_FLAGS::DISABLE_TIMING),
+				"failed to create event", {})
+	auto ret = make_shared<cuda_event>(evt);
+	CU_CALL_RET(cu_event_record(evt, queue), "failed to record event", {})
+	return ret;
+}
+
+void cuda_queue::wait_for_event(const compute_event& evt) const {
+	// NOTE: events are always recorded in a queue of the same device -> this is always a cuda_event
+	CU_CALL_RET(cu_stream_wait_event(queue, ((const cuda_event&)evt).get_cuda_event(), 0), "failed to wait for event")
+}
+
+unique_ptr<compute_command_graph> cuda_queue::create_command_graph() const {
+	return make_unique<cuda_command_graph>(*this);
+}
+
 void cuda_queue::start_profiling() {
 	CU_CALL_NO_ACTION(cu_event_record(prof_start, queue), "failed to record profiling event")
 }
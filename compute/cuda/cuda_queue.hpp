@@ -24,6 +24,25 @@
 #if !defined(FLOOR_NO_CUDA)
 
 #include <floor/compute/compute_queue.hpp>
+#include <floor/compute/compute_event.hpp>
+
+//! wraps a CUDA event that has been recorded into a stream
+class cuda_event final : public compute_event {
+public:
+	explicit cuda_event(cu_event evt);
+	~cuda_event() override;
+	
+	void wait() const override;
+	bool is_complete() const override;
+	
+	cu_event get_cuda_event() const {
+		return evt;
+	}
+	
+protected:
+	cu_event evt { nullptr };
+	
+};
 
 class cuda_queue final : public compute_queue {
 public:
@@ -33,9 +52,14 @@ public:
 	void finish() const override;
 	void flush() const override;
 	
+	shared_ptr<compute_event> record_event() const override;
+	void wait_for_event(const compute_event& evt) const override;
+	
 	const void* get_queue_ptr() const override;
 	void* get_queue_ptr() override;
 	
+	unique_ptr<compute_command_graph> create_command_graph() const override;
+	
 	bool has_profiling_support() const override {
 		return true;
 	}
@@ -22,6 +22,7 @@
 #if defined(FLOOR_COMPUTE_HOST)
 
 #include <floor/constexpr/soft_f16.hpp>
+#include <floor/compute/device/host_image_compressed.hpp>
 
 // ignore vectorization/optimization/etc. hints and infos
 FLOOR_PUSH_WARNINGS()
@@ -415,23 +416,14 @@ FLOOR_PUSH_WARNINGS()
 FLOOR_IGNORE_WARNING(cast-align) // kill "cast needs 4 byte alignment" warning in here (it is 4 byte aligned)
 
 		// image read functions
-		template <typename coord_type, typename offset_type, COMPUTE_IMAGE_TYPE type = fixed_image_type,
+		template <COMPUTE_IMAGE_TYPE type = fixed_image_type,
 				  enable_if_t<((has_flag<COMPUTE_IMAGE_TYPE::FLAG_NORMALIZED>(type) ||
 								(type & COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK) == COMPUTE_IMAGE_TYPE::FLOAT) &&
 							   !has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type))>* = nullptr>
-		static auto read(const host_device_image<type, is_lod, is_lod_float, is_bias>* img,
-						 const coord_type& coord,
-						 const offset_type& coord_offset,
-						 const uint32_t layer,
-						 const int32_t lod_i,
-						 const float lod_or_bias_f) {
+		static auto read_texel(const host_device_image<type, is_lod, is_lod_float, is_bias>* img,
+							   const size_t offset) {
 			// read/copy raw data
-			constexpr const bool is_array = has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(type);
 			constexpr const size_t bpp = image_bytes_per_pixel(type);
-			const auto lod = select_lod(lod_i, lod_or_bias_f);
-			size_t offset;
-			if constexpr(!is_array) offset = coord_to_offset(img->level_info[lod], process_coord(img->level_info[lod], coord, coord_offset));
-			else offset = coord_to_offset(img->level_info[lod], process_coord(img->level_info[lod], coord, coord_offset), layer);
 			typedef uint8_t raw_data_type[bpp];
 			const raw_data_type& raw_data = *(const raw_data_type*)&img->data[offset];
 			
@@ -496,15 +488,10 @@ FLOOR_IGNORE_WARNING(cast-align) // kill "cast needs 4 byte alignment" warning i
 
 FLOOR_POP_WARNINGS()
 
-		template <typename coord_type, typename offset_type, COMPUTE_IMAGE_TYPE type = fixed_image_type,
+		template <COMPUTE_IMAGE_TYPE type = fixed_image_type,
 				  enable_if_t<has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type)>* = nullptr>
-		static auto read(const host_device_image<type, is_lod, is_lod_float, is_bias>* img,
-						 const coord_type& coord,
-						 const offset_type& coord_offset,
-						 const uint32_t layer,
-						 const int32_t lod_i,
-						 const float lod_or_bias_f) {
-			constexpr const bool is_array = has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(type);
+		static auto read_texel(const host_device_image<type, is_lod, is_lod_float, is_bias>* img,
+							   const size_t offset) {
 			constexpr const auto data_type = (type & COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK);
 			constexpr const auto image_format = (type & COMPUTE_IMAGE_TYPE::__FORMAT_MASK);
 			constexpr const bool has_stencil = has_flag<COMPUTE_IMAGE_TYPE::FLAG_STENCIL>(type);
@@ -516,10 +503,6 @@ FLOOR_POP_WARNINGS()
 			// NOTE: neither opencl, nor cuda support reading depth+stencil images, so a proper return type is unclear right now
 			typedef conditional_t<!has_stencil, float1, pair<float1, uint8_t>> ret_type;
 			ret_type ret;
-			const auto lod = select_lod(lod_i, lod_or_bias_f);
-			size_t offset;
-			if constexpr(!is_array) offset = coord_to_offset(img->level_info[lod], process_coord(img->level_info[lod], coord, coord_offset));
-			else offset = coord_to_offset(img->level_info[lod], process_coord(img->level_info[lod], coord, coord_offset), layer);
 			if constexpr(data_type == COMPUTE_IMAGE_TYPE::FLOAT) {
 				// can just pass-through the float value
 				memcpy(&ret, &img->data[offset], sizeof(float));
@@ -569,24 +552,15 @@ FLOOR_POP_WARNINGS()
 FLOOR_PUSH_WARNINGS()
 FLOOR_IGNORE_WARNING(cast-align) // kill "cast needs 4 byte alignment" warning in here (it is 4 byte aligned)
 
-		template <typename coord_type, typename offset_type, COMPUTE_IMAGE_TYPE type = fixed_image_type,
+		template <COMPUTE_IMAGE_TYPE type = fixed_image_type,
 				  enable_if_t<(!has_flag<COMPUTE_IMAGE_TYPE::FLAG_NORMALIZED>(type) &&
 							   ((type & COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK) == COMPUTE_IMAGE_TYPE::INT ||
 								(type & COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK) == COMPUTE_IMAGE_TYPE::UINT) &&
 							   !has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type))>* = nullptr>
-		static auto read(const host_device_image<type, is_lod, is_lod_float, is_bias>* img,
-						 const coord_type& coord,
-						 const offset_type& coord_offset,
-						 const uint32_t layer,
-						 const int32_t lod_i,
-						 const float lod_or_bias_f) {
+		static auto read_texel(const host_device_image<type, is_lod, is_lod_float, is_bias>* img,
+							   const size_t offset) {
 			// read/copy raw data
-			constexpr const bool is_array = has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(type);
 			constexpr const size_t bpp = image_bytes_per_pixel(type);
-			const auto lod = select_lod(lod_i, lod_or_bias_f);
-			size_t offset;
-			if constexpr(!is_array) offset = coord_to_offset(img->level_info[lod], process_coord(img->level_info[lod], coord, coord_offset));
-			else offset = coord_to_offset(img->level_info[lod], process_coord(img->level_info[lod], coord, coord_offset), layer);
 			typedef uint8_t raw_data_type[bpp];
 			const raw_data_type& raw_data = *(const raw_data_type*)&img->data[offset];
 			
@@ -603,6 +577,96 @@ FLOOR_IGNORE_WARNING(cast-align) // kill "cast needs 4 byte alignment" warning i
 
 FLOOR_POP_WARNINGS()
 
+		//! image read: computes the texel offset, then decodes the texel at that offset
+		template <typename coord_type, typename offset_type>
+		static auto read(const host_device_image<fixed_image_type, is_lod, is_lod_float, is_bias>* img,
+						 const coord_type& coord,
+						 const offset_type& coord_offset,
+						 const uint32_t layer,
+						 const int32_t lod_i,
+						 const float lod_or_bias_f) {
+			constexpr const bool is_array = has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(fixed_image_type);
+			const auto lod = select_lod(lod_i, lod_or_bias_f);
+			size_t offset;
+			if constexpr(!is_array) offset = coord_to_offset(img->level_info[lod], process_coord(img->level_info[lod], coord, coord_offset));
+			else offset = coord_to_offset(img->level_info[lod], process_coord(img->level_info[lod], coord, coord_offset), layer);
+			return read_texel(img, offset);
+		}
+		
+		//! 2x2 texel footprint of a bilinear sample, in the usual gather order: (i0, j1), (i1, j1), (i1, j0), (i0, j0)
+		struct gather_footprint {
+			uint2 texels[4];
+			//! array layer and/or cube face
+			uint32_t slice;
+		};
+		
+		//! computes the gather footprint at 'coord' (2D and cube images, float coordinates only)
+		template <typename coord_type, typename offset_type>
+		floor_inline_always static gather_footprint compute_gather_footprint(const image_level_info& level_info,
+																			 const coord_type& coord,
+																			 const offset_type& coord_offset,
+																			 const uint32_t layer) {
+			constexpr const bool is_array = has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(fixed_image_type);
+			constexpr const bool is_cube = has_flag<COMPUTE_IMAGE_TYPE::FLAG_CUBE>(fixed_image_type);
+			static_assert(image_dim_count(fixed_image_type) == 2, "gather is only supported for 2D and cube images");
+			static_assert(ext::is_floating_point_v<typename coord_type::decayed_scalar_type>,
+						  "gather requires floating point coordinates");
+			
+			// resolve the 2D coordinate and the slice index (array layer and/or cube face)
+			float2 st;
+			uint32_t slice = (is_array ? layer : 0u);
+			if constexpr(is_cube) {
+				const auto coord_layer = compute_cube_coord_and_layer(coord.xyz);
+				st = coord_layer.first;
+				slice = (is_array ? layer * 6u + coord_layer.second : coord_layer.second);
+			}
+			else {
+				st = coord.xy;
+			}
+			
+			// scale to texel space and shift by half a texel, so that floor() yields the top-left texel of the footprint,
+			// then clamp both texel rows/columns to the image (clamp-to-edge)
+			const auto tex_coord = st * level_info.clamp_dim_float.xy + float2(coord_offset) - 0.5f;
+			const int2 i0 = int2(tex_coord.floored());
+			const auto max_coord = level_info.clamp_dim_int.xy;
+			const uint2 c0 { i0.clamped(max_coord) };
+			const uint2 c1 { (i0 + 1).clamped(max_coord) };
+			return {
+				{
+					uint2 { c0.x, c1.y },
+					uint2 { c1.x, c1.y },
+					uint2 { c1.x, c0.y },
+					uint2 { c0.x, c0.y },
+				},
+				slice
+			};
+		}
+		
+		//! image gather: returns the 2x2 texel footprint that a bilinear sample at 'coord' would use
+		//! NOTE: the lod, layer and cube face are only resolved once for all four texels
+		template <typename coord_type, typename offset_type>
+		static auto gather(const host_device_image<fixed_image_type, is_lod, is_lod_float, is_bias>* img,
+						   const coord_type& coord,
+						   const offset_type& coord_offset,
+						   const uint32_t layer,
+						   const int32_t lod_i,
+						   const float lod_or_bias_f) {
+			constexpr const bool has_slice = (has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(fixed_image_type) ||
+											  has_flag<COMPUTE_IMAGE_TYPE::FLAG_CUBE>(fixed_image_type));
+			const auto lod = select_lod(lod_i, lod_or_bias_f);
+			const auto& level_info = img->level_info[lod];
+			const auto footprint = compute_gather_footprint(level_info, coord, coord_offset, layer);
+			
+			typedef decltype(read_texel(img, size_t(0))) color_type;
+			const_array<color_type, 4> ret;
+#pragma unroll
+			for(uint32_t i = 0; i < 4; ++i) {
+				if constexpr(!has_slice) ret[i] = read_texel(img, coord_to_offset(level_info, footprint.texels[i]));
+				else ret[i] = read_texel(img, coord_to_offset(level_info, footprint.texels[i], footprint.slice));
+			}
+			return ret;
+		}
+		
 		// image write functions
 		template <typename coord_type, COMPUTE_IMAGE_TYPE type = fixed_image_type,
 				  enable_if_t<((has_flag<COMPUTE_IMAGE_TYPE::FLAG_NORMALIZED>(type) ||
@@ -754,6 +818,69 @@ FLOOR_POP_WARNINGS()
 			memcpy(&img->data[offset], &raw_data, sizeof(raw_data));
 		}
 	};
+
+	//! block-compressed (BC1 - BC7, ETC1/ETC2/EAC) 2D and cube images: data is stored in its compressed form and decoded on access,
+	//! with recently decoded 4x4 blocks being cached per thread (see decoded_block_cache).
+	//! the compression format is only known at run-time, the dim/array/cube flags are fixed.
+	template <COMPUTE_IMAGE_TYPE fixed_image_type, bool is_lod, bool is_lod_float, bool is_bias>
+	struct compressed_image {
+		typedef fixed_image<fixed_image_type, is_lod, is_lod_float, is_bias> fixed_image_t;
+		static_assert(image_dim_count(fixed_image_type) == 2, "compressed images must be 2D or cube images");
+
+		//! fetches a single (clamped) texel of the specified slice (array layer and/or cube face)
+		floor_inline_always static float4 fetch(const uint8_t* data,
+												const image_level_info& level_info,
+												const COMPUTE_IMAGE_TYPE runtime_image_type,
+												const uint2 texel,
+												const uint32_t slice) {
+			const uint32_t block_size = image_bits_per_pixel(runtime_image_type) * 2u; // 16 texels per block
+			const uint32_t blocks_per_row = (level_info.dim.x + 3u) / 4u;
+			const size_t offset = (level_info.offset +
+								   image_slice_data_size_from_types(level_info.dim, runtime_image_type) * slice +
+								   (size_t(texel.y / 4u) * blocks_per_row + texel.x / 4u) * block_size);
+			return decode_block_cached(&data[offset], runtime_image_type)[(texel.y & 3u) * 4u + (texel.x & 3u)];
+		}
+
+		template <typename coord_type, typename offset_type>
+		static float4 read(const uint8_t* data,
+						   const image_level_info* level_info,
+						   const COMPUTE_IMAGE_TYPE runtime_image_type,
+						   const coord_type& coord,
+						   const offset_type& coord_offset,
+						   const uint32_t layer,
+						   const int32_t lod_i,
+						   const float lod_or_bias_f) {
+			constexpr const bool is_array = has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(fixed_image_type);
+			const auto lod = fixed_image_t::select_lod(lod_i, lod_or_bias_f);
+			const auto texel = fixed_image_t::process_coord(level_info[lod], coord, coord_offset);
+			if constexpr(has_flag<COMPUTE_IMAGE_TYPE::FLAG_CUBE>(fixed_image_type)) {
+				// -> texel.z is the cube face
+				return fetch(data, level_info[lod], runtime_image_type, texel.xy, (is_array ? layer * 6u + texel.z : texel.z));
+			}
+			else {
+				return fetch(data, level_info[lod], runtime_image_type, texel, (is_array ? layer : 0u));
+			}
+		}
+
+		template <typename coord_type, typename offset_type>
+		static const_array<float4, 4> gather(const uint8_t* data,
+											 const image_level_info* level_info,
+											 const COMPUTE_IMAGE_TYPE runtime_image_type,
+											 const coord_type& coord,
+											 const offset_type& coord_offset,
+											 const uint32_t layer,
+											 const int32_t lod_i,
+											 const float lod_or_bias_f) {
+			const auto lod = fixed_image_t::select_lod(lod_i, lod_or_bias_f);
+			const auto footprint = fixed_image_t::compute_gather_footprint(level_info[lod], coord, coord_offset, layer);
+			const_array<float4, 4> ret;
+#pragma unroll
+			for(uint32_t i = 0; i < 4; ++i) {
+				ret[i] = fetch(data, level_info[lod], runtime_image_type, footprint.texels[i], footprint.slice);
+			}
+			return ret;
+		}
+	};
 }
 
 template <COMPUTE_IMAGE_TYPE sample_image_type, bool is_lod = false, bool is_lod_float = false, bool is_bias = false>
@@ -1061,6 +1188,79 @@ FLOOR_POP_WARNINGS()
 		return 0.0f;
 	}
 	
+	// image read (nearest/point sampling), dispatches to the run-time image type
+	template <typename... Args>
+	static auto read(const host_device_image_type* img, Args&&... args) {
+		return read_dispatch<false>(img, std::forward<Args>(args)...);
+	}
+	
+	// image gather: returns the specified channel of the 2x2 bilinear footprint texels (2D/cube images)
+	// NOTE: for depth images, the depth value is always returned (component must be 0)
+	template <uint32_t component, typename coord_type, typename offset_type>
+	static auto gather(const host_device_image_type* img,
+					   const coord_type& coord,
+					   const offset_type& coord_offset,
+					   const uint32_t layer,
+					   const int32_t lod_i,
+					   const float lod_or_bias_f) {
+		const auto texels = read_dispatch<true>(img, coord, coord_offset, layer, lod_i, lod_or_bias_f);
+		if constexpr(has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(sample_image_type)) {
+			static_assert(component == 0, "depth images only have a single component");
+			return float4 {
+				get_depth(texels[0]),
+				get_depth(texels[1]),
+				get_depth(texels[2]),
+				get_depth(texels[3]),
+			};
+		}
+		else {
+			static_assert(component < 4, "invalid component");
+			typedef decay_t<decltype(texels[0].x)> scalar_type;
+			return vector4<scalar_type> {
+				texels[0][component],
+				texels[1][component],
+				texels[2][component],
+				texels[3][component],
+			};
+		}
+	}
+	
+	// depth compare gather (compares each depth value of the 2x2 bilinear footprint with the compare value)
+	template <typename coord_type, typename offset_type, COMPUTE_IMAGE_TYPE type = sample_image_type,
+			  enable_if_t<(has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type))>* = nullptr>
+	static auto gather_compare(const host_device_image_type* img,
+							   const coord_type& coord,
+							   const offset_type& coord_offset,
+							   const uint32_t layer,
+							   const int32_t lod_i,
+							   const float lod_or_bias_f,
+							   const COMPARE_FUNCTION compare_function,
+							   const float compare_value) {
+		const auto texels = read_dispatch<true>(img, coord, coord_offset, layer, lod_i, lod_or_bias_f);
+		return float4 {
+			perform_compare(compare_function, compare_value, texels[0]),
+			perform_compare(compare_function, compare_value, texels[1]),
+			perform_compare(compare_function, compare_value, texels[2]),
+			perform_compare(compare_function, compare_value, texels[3]),
+		};
+	}
+	
+	// depth compare gather is not supported for non-depth images -> compile-time error when used
+	template <typename... Args, COMPUTE_IMAGE_TYPE type = sample_image_type,
+			  enable_if_t<(!has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type))>* = nullptr>
+	static float4 gather_compare(Args&&...) {
+		static_assert(has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type), "gather_compare is only supported for depth images");
+		return {};
+	}
+	
+	// extracts the depth value from a depth or depth+stencil texel
+	floor_inline_always static constexpr float get_depth(const float1& depth_value) {
+		return depth_value.x;
+	}
+	floor_inline_always static constexpr float get_depth(const pair<float1, uint8_t>& depth_stencil_value) {
+		return depth_stencil_value.first.x;
+	}
+	
 	// statically/compile-time known base type that won't change at run-time
 	floor_inline_always static constexpr COMPUTE_IMAGE_TYPE fixed_base_type() {
 		// variable at run-time: channel count, format, data type, normalized flag
@@ -1076,8 +1276,13 @@ FLOOR_POP_WARNINGS()
 	}
 	
 #define FLOOR_RT_READ_IMAGE_CASE(rt_base_type) case (rt_base_type): \
+if constexpr(!is_gather) { \
 return host_image_impl::fixed_image<(rt_base_type | fixed_base_type()), is_lod, is_lod_float, is_bias>::read( \
-(const host_device_image<(rt_base_type | fixed_base_type()), is_lod, is_lod_float, is_bias>*)img, std::forward<Args>(args)...);
+(const host_device_image<(rt_base_type | fixed_base_type()), is_lod, is_lod_float, is_bias>*)img, std::forward<Args>(args)...); \
+} else { \
+return host_image_impl::fixed_image<(rt_base_type | fixed_base_type()), is_lod, is_lod_float, is_bias>::gather( \
+(const host_device_image<(rt_base_type | fixed_base_type()), is_lod, is_lod_float, is_bias>*)img, std::forward<Args>(args)...); \
+}
 
 #define FLOOR_RT_WRITE_IMAGE_CASE(rt_base_type) case (rt_base_type): \
 host_image_impl::fixed_image<(rt_base_type | fixed_base_type()), is_lod, is_lod_float, is_bias>::write( \
@@ -1087,13 +1292,26 @@ FLOOR_PUSH_WARNINGS()
 FLOOR_IGNORE_WARNING(switch) // ignore "case value not in enumerated type 'COMPUTE_IMAGE_TYPE'" warnings, this is expected
 	
 	// normalized or float data (not double)
-	template <COMPUTE_IMAGE_TYPE type = sample_image_type, typename... Args,
+	template <bool is_gather, COMPUTE_IMAGE_TYPE type = sample_image_type, typename... Args,
 			  enable_if_t<(// float or normalized int/uint
 						   (has_flag<COMPUTE_IMAGE_TYPE::FLAG_NORMALIZED>(type) ||
 							(type & COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK) == COMPUTE_IMAGE_TYPE::FLOAT) &&
 						   // !depth
 						   !has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type))>* = nullptr>
-	static auto read(const host_device_image_type* img, Args&&... args) {
+	static auto read_dispatch(const host_device_image_type* img, Args&&... args) {
+		// block-compressed data (2D/cube images only), decoded on access
+		if constexpr(image_dim_count(type) == 2) {
+			if(image_compressed(img->runtime_image_type)) {
+				typedef host_image_impl::compressed_image<fixed_base_type(), is_lod, is_lod_float, is_bias> compressed_image_type;
+				if constexpr(!is_gather) {
+					return compressed_image_type::read(img->data, img->level_info, img->runtime_image_type, std::forward<Args>(args)...);
+				}
+				else {
+					return compressed_image_type::gather(img->data, img->level_info, img->runtime_image_type, std::forward<Args>(args)...);
+				}
+			}
+		}
+
 		const auto runtime_base_type = img->runtime_image_type & (COMPUTE_IMAGE_TYPE::__FORMAT_MASK |
 																  COMPUTE_IMAGE_TYPE::__CHANNELS_MASK |
 																  COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK |
@@ -1177,10 +1395,10 @@ FLOOR_IGNORE_WARNING(switch) // ignore "case value not in enumerated type 'COMPU
 	}
 	
 	// depth float
-	template <COMPUTE_IMAGE_TYPE type = sample_image_type, typename... Args,
+	template <bool is_gather, COMPUTE_IMAGE_TYPE type = sample_image_type, typename... Args,
 			  enable_if_t<(has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type) &&
 						   !has_flag<COMPUTE_IMAGE_TYPE::FLAG_STENCIL>(type))>* = nullptr>
-	static auto read(const host_device_image_type* img, Args&&... args) {
+	static auto read_dispatch(const host_device_image_type* img, Args&&... args) {
 		const auto runtime_base_type = img->runtime_image_type & (COMPUTE_IMAGE_TYPE::__FORMAT_MASK |
 																  COMPUTE_IMAGE_TYPE::__CHANNELS_MASK |
 																  COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK |
@@ -1196,10 +1414,10 @@ FLOOR_IGNORE_WARNING(switch) // ignore "case value not in enumerated type 'COMPU
 	}
 	
 	// depth+stencil float+uint8_t
-	template <COMPUTE_IMAGE_TYPE type = sample_image_type, typename... Args,
+	template <bool is_gather, COMPUTE_IMAGE_TYPE type = sample_image_type, typename... Args,
 			  enable_if_t<(has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(type) &&
 						   has_flag<COMPUTE_IMAGE_TYPE::FLAG_STENCIL>(type))>* = nullptr>
-	static auto read(const host_device_image_type* img, Args&&... args) {
+	static auto read_dispatch(const host_device_image_type* img, Args&&... args) {
 		const auto runtime_base_type = img->runtime_image_type & (COMPUTE_IMAGE_TYPE::__FORMAT_MASK |
 																  COMPUTE_IMAGE_TYPE::__CHANNELS_MASK |
 																  COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK |
@@ -1213,12 +1431,12 @@ FLOOR_IGNORE_WARNING(switch) // ignore "case value not in enumerated type 'COMPU
 	}
 	
 	// non-normalized int/uint data (<= 32-bit)
-	template <COMPUTE_IMAGE_TYPE type = sample_image_type, typename... Args,
+	template <bool is_gather, COMPUTE_IMAGE_TYPE type = sample_image_type, typename... Args,
 			  COMPUTE_IMAGE_TYPE fixed_data_type = (type & COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK),
 			  enable_if_t<(!has_flag<COMPUTE_IMAGE_TYPE::FLAG_NORMALIZED>(type) &&
 						   (fixed_data_type == COMPUTE_IMAGE_TYPE::INT ||
 							fixed_data_type == COMPUTE_IMAGE_TYPE::UINT))>* = nullptr>
-	static auto read(const host_device_image_type* img, Args&&... args) {
+	static auto read_dispatch(const host_device_image_type* img, Args&&... args) {
 		const auto runtime_base_type = img->runtime_image_type & (COMPUTE_IMAGE_TYPE::__FORMAT_MASK |
 																  COMPUTE_IMAGE_TYPE::__CHANNELS_MASK |
 																  COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK);
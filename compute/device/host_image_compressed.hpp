@@ -0,0 +1,899 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_COMPUTE_DEVICE_HOST_IMAGE_COMPRESSED_HPP__
+#define __FLOOR_COMPUTE_DEVICE_HOST_IMAGE_COMPRESSED_HPP__
+
+#if defined(FLOOR_COMPUTE_HOST)
+
+// incremented by the host kernel execution for every kernel launch,
+// decoded blocks that were cached by a prior launch are invalid after this changes
+extern FLOOR_DLL_API uint32_t floor_host_image_epoch;
+
+namespace host_image_impl {
+	//! block decoders for BC1 - BC7 (S3TC/DXT + RGTC + BPTC), decoding one 4x4 block into 16 float4 texels (row-major)
+	namespace bc_decoder {
+		//! decodes a 5:6:5 color to normalized [0, 1] floats
+		floor_inline_always static float3 decode_565(const uint32_t color) {
+			return {
+				float((color >> 11u) & 0x1Fu) * (1.0f / 31.0f),
+				float((color >> 5u) & 0x3Fu) * (1.0f / 63.0f),
+				float(color & 0x1Fu) * (1.0f / 31.0f)
+			};
+		}
+		
+		//! decodes the BC1 color block (also used by BC2/BC3, which always use the 4-color mode)
+		//! NOTE: the 3-color mode (color0 <= color1) is only valid for BC1, its 4th color is black with alpha 0 (RGBA) or 1 (RGB)
+		floor_inline_always static void decode_color_block(const uint8_t* block,
+														   const bool is_bc1,
+														   const bool has_alpha,
+														   float4 (&texels)[16]) {
+			const uint32_t c0 = uint32_t(block[0]) | (uint32_t(block[1]) << 8u);
+			const uint32_t c1 = uint32_t(block[2]) | (uint32_t(block[3]) << 8u);
+			const uint32_t indices = (uint32_t(block[4]) | (uint32_t(block[5]) << 8u) |
+									  (uint32_t(block[6]) << 16u) | (uint32_t(block[7]) << 24u));
+			const auto color0 = decode_565(c0);
+			const auto color1 = decode_565(c1);
+			
+			float4 palette[4];
+			palette[0] = { color0, 1.0f };
+			palette[1] = { color1, 1.0f };
+			if(c0 > c1 || !is_bc1) {
+				palette[2] = { (color0 * 2.0f + color1) * (1.0f / 3.0f), 1.0f };
+				palette[3] = { (color0 + color1 * 2.0f) * (1.0f / 3.0f), 1.0f };
+			}
+			else {
+				palette[2] = { (color0 + color1) * 0.5f, 1.0f };
+				palette[3] = { 0.0f, 0.0f, 0.0f, (has_alpha ? 0.0f : 1.0f) };
+			}
+			
+#pragma unroll
+			for(uint32_t i = 0; i < 16; ++i) {
+				texels[i] = palette[(indices >> (i * 2u)) & 0x3u];
+			}
+		}
+		
+		//! decodes a BC2 explicit 4-bit alpha block into the alpha channel
+		floor_inline_always static void decode_explicit_alpha_block(const uint8_t* block, float4 (&texels)[16]) {
+#pragma unroll
+			for(uint32_t i = 0; i < 16; ++i) {
+				texels[i].w = float((block[i / 2u] >> ((i & 1u) * 4u)) & 0xFu) * (1.0f / 15.0f);
+			}
+		}
+		
+		//! decodes a BC3 alpha / BC4 / BC5 (one channel) interpolated block into the specified channel
+		template <bool is_signed>
+		floor_inline_always static void decode_channel_block(const uint8_t* block, const uint32_t channel, float4 (&texels)[16]) {
+			float palette[8];
+			bool is_6_value_mode;
+			if constexpr(!is_signed) {
+				palette[0] = float(block[0]) * (1.0f / 255.0f);
+				palette[1] = float(block[1]) * (1.0f / 255.0f);
+				is_6_value_mode = (block[0] <= block[1]);
+			}
+			else {
+				// -128 and -127 both map to -1
+				palette[0] = max(float(int8_t(block[0])) * (1.0f / 127.0f), -1.0f);
+				palette[1] = max(float(int8_t(block[1])) * (1.0f / 127.0f), -1.0f);
+				is_6_value_mode = (int8_t(block[0]) <= int8_t(block[1]));
+			}
+			
+			if(!is_6_value_mode) {
+#pragma unroll
+				for(uint32_t i = 1; i < 7; ++i) {
+					palette[i + 1] = (palette[0] * float(7u - i) + palette[1] * float(i)) * (1.0f / 7.0f);
+				}
+			}
+			else {
+#pragma unroll
+				for(uint32_t i = 1; i < 5; ++i) {
+					palette[i + 1] = (palette[0] * float(5u - i) + palette[1] * float(i)) * (1.0f / 5.0f);
+				}
+				palette[6] = (is_signed ? -1.0f : 0.0f);
+				palette[7] = 1.0f;
+			}
+			
+			// 16 * 3-bit indices
+			uint64_t indices = 0;
+#pragma unroll
+			for(uint32_t i = 0; i < 6; ++i) {
+				indices |= uint64_t(block[2u + i]) << (uint64_t(i) * 8ull);
+			}
+#pragma unroll
+			for(uint32_t i = 0; i < 16; ++i) {
+				texels[i][channel] = palette[(indices >> (uint64_t(i) * 3ull)) & 0x7ull];
+			}
+		}
+		
+		//! reads consecutive bit fields (LSB first) from a 128-bit block
+		struct block_bit_reader {
+			uint64_t lo { 0u };
+			uint64_t hi { 0u };
+			uint32_t pos { 0u };
+			
+			explicit block_bit_reader(const uint8_t* block) {
+#pragma unroll
+				for(uint32_t i = 0; i < 8; ++i) {
+					lo |= uint64_t(block[i]) << (uint64_t(i) * 8ull);
+					hi |= uint64_t(block[8u + i]) << (uint64_t(i) * 8ull);
+				}
+			}
+			
+			//! reads the next "count" (<= 32) bits
+			uint32_t read(const uint32_t count) {
+				if(count == 0) return 0;
+				uint64_t bits;
+				if(pos >= 64u) bits = hi >> (pos - 64u);
+				else if(pos + count <= 64u) bits = lo >> pos;
+				else bits = (lo >> pos) | (hi << (64u - pos));
+				pos += count;
+				return uint32_t(bits & ((1ull << uint64_t(count)) - 1ull));
+			}
+			
+			//! reads the next "count" bits in reversed order (the first bit read is the MSB)
+			uint32_t read_reversed(const uint32_t count) {
+				uint32_t ret = 0;
+				for(uint32_t i = 0; i < count; ++i) {
+					ret = (ret << 1u) | read(1);
+				}
+				return ret;
+			}
+		};
+		
+		//! partition/anchor/weight tables shared by BC6H and BC7
+		namespace bptc {
+			//! 2-subset partitions: bit #i is the subset of texel #i
+			static constexpr const uint16_t partitions_2[64] {
+				0xCCCCu, 0x8888u, 0xEEEEu, 0xECC8u, 0xC880u, 0xFEECu, 0xFEC8u, 0xEC80u,
+				0xC800u, 0xFFECu, 0xFE80u, 0xE800u, 0xFFE8u, 0xFF00u, 0xFFF0u, 0xF000u,
+				0xF710u, 0x008Eu, 0x7100u, 0x08CEu, 0x008Cu, 0x7310u, 0x3100u, 0x8CCEu,
+				0x088Cu, 0x3110u, 0x6666u, 0x366Cu, 0x17E8u, 0x0FF0u, 0x718Eu, 0x399Cu,
+				0xAAAAu, 0xF0F0u, 0x5A5Au, 0x33CCu, 0x3C3Cu, 0x55AAu, 0x9696u, 0xA55Au,
+				0x73CEu, 0x13C8u, 0x324Cu, 0x3BDCu, 0x6996u, 0xC33Cu, 0x9966u, 0x0660u,
+				0x0272u, 0x04E4u, 0x4E40u, 0x2720u, 0xC936u, 0x936Cu, 0x39C6u, 0x639Cu,
+				0x9336u, 0x9CC6u, 0x817Eu, 0xE718u, 0xCCF0u, 0x0FCCu, 0x7744u, 0xEE22u,
+			};
+			//! 3-subset partitions: bits #2i and #2i+1 are the subset of texel #i
+			static constexpr const uint32_t partitions_3[64] {
+				0xAA685050u, 0x6A5A5040u, 0x5A5A4200u, 0x5450A0A8u, 0xA5A50000u, 0xA0A05050u, 0x5555A0A0u, 0x5A5A5050u,
+				0xAA550000u, 0xAA555500u, 0xAAAA5500u, 0x90909090u, 0x94949494u, 0xA4A4A4A4u, 0xA9A59450u, 0x2A0A4250u,
+				0xA5945040u, 0x0A425054u, 0xA5A5A500u, 0x55A0A0A0u, 0xA8A85454u, 0x6A6A4040u, 0xA4A45000u, 0x1A1A0500u,
+				0x0050A4A4u, 0xAAA59090u, 0x14696914u, 0x69691400u, 0xA08585A0u, 0xAA821414u, 0x50A4A450u, 0x6A5A0200u,
+				0xA9A58000u, 0x5090A0A8u, 0xA8A09050u, 0x24242424u, 0x00AA5500u, 0x24924924u, 0x24499224u, 0x50A50A50u,
+				0x500AA550u, 0xAAAA4444u, 0x66660000u, 0xA5A0A5A0u, 0x50A050A0u, 0x69286928u, 0x44AAAA44u, 0x66666600u,
+				0xAA444444u, 0x54A854A8u, 0x95809580u, 0x96969600u, 0xA85454A8u, 0x80959580u, 0xAA141414u, 0x96960000u,
+				0xAAAA1414u, 0xA05050A0u, 0xA0A5A5A0u, 0x96000000u, 0x40804080u, 0xA9A8A9A8u, 0xAAAAAA44u, 0x2A4A5254u,
+			};
+			//! anchor texel of the second subset of 2-subset partitions
+			static constexpr const uint8_t anchors_2[64] {
+				15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+				15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+				15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+				6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+			};
+			//! anchor texel of the second subset of 3-subset partitions
+			static constexpr const uint8_t anchors_3_second[64] {
+				3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+				3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+				8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+				3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+			};
+			//! anchor texel of the third subset of 3-subset partitions
+			static constexpr const uint8_t anchors_3_third[64] {
+				15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+				15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+				15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+				15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+			};
+			static constexpr const uint8_t weights_2[4] { 0, 21, 43, 64 };
+			static constexpr const uint8_t weights_3[8] { 0, 9, 18, 27, 37, 46, 55, 64 };
+			static constexpr const uint8_t weights_4[16] { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+			
+			floor_inline_always static int32_t weight(const uint32_t index_bits, const uint32_t index) {
+				switch(index_bits) {
+					case 2: return weights_2[index];
+					case 3: return weights_3[index];
+					default: return weights_4[index];
+				}
+			}
+			
+			floor_inline_always static int32_t interpolate(const int32_t e0, const int32_t e1, const int32_t weight) {
+				return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+			}
+			
+			floor_inline_always static uint32_t subset(const uint32_t subset_count, const uint32_t partition, const uint32_t texel) {
+				switch(subset_count) {
+					case 2: return (partitions_2[partition] >> texel) & 1u;
+					case 3: return (partitions_3[partition] >> (texel * 2u)) & 3u;
+					default: return 0;
+				}
+			}
+			
+			//! anchor texels store their index with one bit less (the MSB is implicitly 0)
+			floor_inline_always static bool is_anchor(const uint32_t subset_count, const uint32_t partition, const uint32_t texel) {
+				if(texel == 0) return true;
+				switch(subset_count) {
+					case 2: return (texel == anchors_2[partition]);
+					case 3: return (texel == anchors_3_second[partition] || texel == anchors_3_third[partition]);
+					default: return false;
+				}
+			}
+		}
+		
+		//! decodes a BC7 (BPTC unorm) block
+		static void decode_bc7_block(const uint8_t* block, float4 (&texels)[16]) {
+			struct mode_info {
+				uint8_t subset_count;
+				uint8_t partition_bits;
+				uint8_t rotation_bits;
+				uint8_t index_selection_bits;
+				uint8_t color_bits;
+				uint8_t alpha_bits;
+				uint8_t endpoint_p_bits;
+				uint8_t shared_p_bits;
+				uint8_t index_bits;
+				uint8_t index_bits_2;
+			};
+			static constexpr const mode_info modes[8] {
+				{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+				{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+				{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+				{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+				{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+				{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+				{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+				{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+			};
+			
+			// mode is the number of leading 0 bits
+			block_bit_reader bits(block);
+			uint32_t mode = 0;
+			while(mode < 8u && bits.read(1) == 0) {
+				++mode;
+			}
+			if(mode == 8u) {
+				// reserved -> transparent black
+				for(auto& texel : texels) {
+					texel = { 0.0f, 0.0f, 0.0f, 0.0f };
+				}
+				return;
+			}
+			const auto& info = modes[mode];
+			const uint32_t partition = bits.read(info.partition_bits);
+			const uint32_t rotation = bits.read(info.rotation_bits);
+			const uint32_t index_selection = bits.read(info.index_selection_bits);
+			
+			// endpoints are stored channel by channel, each for all subsets and both endpoints (-> [subset * 2 + endpoint])
+			const uint32_t endpoint_count = info.subset_count * 2u;
+			uint32_t endpoints[6][4] {};
+			for(uint32_t ch = 0; ch < 3; ++ch) {
+				for(uint32_t ep = 0; ep < endpoint_count; ++ep) {
+					endpoints[ep][ch] = bits.read(info.color_bits);
+				}
+			}
+			for(uint32_t ep = 0; ep < endpoint_count; ++ep) {
+				endpoints[ep][3] = bits.read(info.alpha_bits);
+			}
+			
+			// p-bits (either one per endpoint or one per subset) are the shared LSB of all channels
+			uint32_t color_bits = info.color_bits;
+			uint32_t alpha_bits = info.alpha_bits;
+			if(info.endpoint_p_bits > 0 || info.shared_p_bits > 0) {
+				uint32_t p_bits[6] {};
+				for(uint32_t ep = 0; ep < endpoint_count; ++ep) {
+					if(info.endpoint_p_bits > 0) p_bits[ep] = bits.read(1);
+					else if((ep & 1u) == 0) p_bits[ep] = p_bits[ep + 1] = bits.read(1);
+				}
+				for(uint32_t ep = 0; ep < endpoint_count; ++ep) {
+					for(uint32_t ch = 0; ch < 4; ++ch) {
+						endpoints[ep][ch] = (endpoints[ep][ch] << 1u) | p_bits[ep];
+					}
+				}
+				++color_bits;
+				if(alpha_bits > 0) ++alpha_bits;
+			}
+			
+			// expand to 8-bit
+			const auto expand = [](const uint32_t value, const uint32_t value_bits) {
+				const uint32_t shifted = value << (8u - value_bits);
+				return shifted | (shifted >> value_bits);
+			};
+			for(uint32_t ep = 0; ep < endpoint_count; ++ep) {
+				for(uint32_t ch = 0; ch < 3; ++ch) {
+					endpoints[ep][ch] = expand(endpoints[ep][ch], color_bits);
+				}
+				endpoints[ep][3] = (alpha_bits > 0 ? expand(endpoints[ep][3], alpha_bits) : 255u);
+			}
+			
+			uint32_t indices[16];
+			uint32_t indices_2[16] {};
+			for(uint32_t i = 0; i < 16; ++i) {
+				indices[i] = bits.read(info.index_bits - (bptc::is_anchor(info.subset_count, partition, i) ? 1u : 0u));
+			}
+			if(info.index_bits_2 > 0) {
+				for(uint32_t i = 0; i < 16; ++i) {
+					indices_2[i] = bits.read(info.index_bits_2 - (i == 0 ? 1u : 0u));
+				}
+			}
+			
+			for(uint32_t i = 0; i < 16; ++i) {
+				const auto subset = bptc::subset(info.subset_count, partition, i);
+				const auto& e0 = endpoints[subset * 2u];
+				const auto& e1 = endpoints[subset * 2u + 1u];
+				
+				// with a second index set, the index selection bit decides which one is used for color and alpha
+				uint32_t color_index = indices[i], color_index_bits = info.index_bits;
+				uint32_t alpha_index = indices[i], alpha_index_bits = info.index_bits;
+				if(info.index_bits_2 > 0) {
+					if(index_selection == 0) {
+						alpha_index = indices_2[i];
+						alpha_index_bits = info.index_bits_2;
+					}
+					else {
+						color_index = indices_2[i];
+						color_index_bits = info.index_bits_2;
+					}
+				}
+				const auto color_weight = bptc::weight(color_index_bits, color_index);
+				const auto alpha_weight = bptc::weight(alpha_index_bits, alpha_index);
+				
+				int32_t rgba[4];
+				for(uint32_t ch = 0; ch < 3; ++ch) {
+					rgba[ch] = bptc::interpolate(int32_t(e0[ch]), int32_t(e1[ch]), color_weight);
+				}
+				rgba[3] = bptc::interpolate(int32_t(e0[3]), int32_t(e1[3]), alpha_weight);
+				
+				// rotation: swap alpha with r/g/b
+				if(rotation > 0) {
+					const auto tmp = rgba[3];
+					rgba[3] = rgba[rotation - 1u];
+					rgba[rotation - 1u] = tmp;
+				}
+				
+				texels[i] = {
+					float(rgba[0]) * (1.0f / 255.0f),
+					float(rgba[1]) * (1.0f / 255.0f),
+					float(rgba[2]) * (1.0f / 255.0f),
+					float(rgba[3]) * (1.0f / 255.0f)
+				};
+			}
+		}
+		
+		//! decodes a BC6H (BPTC float) block, either signed or unsigned
+		static void decode_bc6h_block(const uint8_t* block, const bool is_signed, float4 (&texels)[16]) {
+			//! "count" bits at "shift" of endpoint value "field" (endpoint * 3 + channel),
+			//! "reversed" fields are stored in reversed bit order
+			struct field_bits {
+				uint8_t field;
+				uint8_t shift;
+				uint8_t count;
+				uint8_t reversed;
+			};
+			struct mode_info {
+				uint8_t mode;
+				uint8_t region_count;
+				uint8_t endpoint_bits;
+				uint8_t delta_bits[3];
+				bool transformed;
+				//! bit layout of all endpoints (in stored order), terminated by count == 0
+				field_bits fields[24];
+			};
+			static constexpr const mode_info modes[14] {
+				{ 0x00u, 2, 10, { 5, 5, 5 }, true, {
+					{ 7, 4, 1, 0 }, { 8, 4, 1, 0 }, { 11, 4, 1, 0 }, { 0, 0, 10, 0 }, { 1, 0, 10, 0 }, { 2, 0, 10, 0 }, { 3, 0, 5, 0 }, { 10, 4, 1, 0 },
+					{ 7, 0, 4, 0 }, { 4, 0, 5, 0 }, { 11, 0, 1, 0 }, { 10, 0, 4, 0 }, { 5, 0, 5, 0 }, { 11, 1, 1, 0 }, { 8, 0, 4, 0 }, { 6, 0, 5, 0 },
+					{ 11, 2, 1, 0 }, { 9, 0, 5, 0 }, { 11, 3, 1, 0 },
+				} },
+				{ 0x01u, 2, 7, { 6, 6, 6 }, true, {
+					{ 7, 5, 1, 0 }, { 10, 4, 1, 0 }, { 10, 5, 1, 0 }, { 0, 0, 7, 0 }, { 11, 0, 1, 0 }, { 11, 1, 1, 0 }, { 8, 4, 1, 0 }, { 1, 0, 7, 0 },
+					{ 8, 5, 1, 0 }, { 11, 2, 1, 0 }, { 7, 4, 1, 0 }, { 2, 0, 7, 0 }, { 11, 3, 1, 0 }, { 11, 5, 1, 0 }, { 11, 4, 1, 0 }, { 3, 0, 6, 0 },
+					{ 7, 0, 4, 0 }, { 4, 0, 6, 0 }, { 10, 0, 4, 0 }, { 5, 0, 6, 0 }, { 8, 0, 4, 0 }, { 6, 0, 6, 0 }, { 9, 0, 6, 0 },
+				} },
+				{ 0x02u, 2, 11, { 5, 4, 4 }, true, {
+					{ 0, 0, 10, 0 }, { 1, 0, 10, 0 }, { 2, 0, 10, 0 }, { 3, 0, 5, 0 }, { 0, 10, 1, 0 }, { 7, 0, 4, 0 }, { 4, 0, 4, 0 }, { 1, 10, 1, 0 },
+					{ 11, 0, 1, 0 }, { 10, 0, 4, 0 }, { 5, 0, 4, 0 }, { 2, 10, 1, 0 }, { 11, 1, 1, 0 }, { 8, 0, 4, 0 }, { 6, 0, 5, 0 }, { 11, 2, 1, 0 },
+					{ 9, 0, 5, 0 }, { 11, 3, 1, 0 },
+				} },
+				{ 0x06u, 2, 11, { 4, 5, 4 }, true, {
+					{ 0, 0, 10, 0 }, { 1, 0, 10, 0 }, { 2, 0, 10, 0 }, { 3, 0, 4, 0 }, { 0, 10, 1, 0 }, { 10, 4, 1, 0 }, { 7, 0, 4, 0 }, { 4, 0, 5, 0 },
+					{ 1, 10, 1, 0 }, { 10, 0, 4, 0 }, { 5, 0, 4, 0 }, { 2, 10, 1, 0 }, { 11, 1, 1, 0 }, { 8, 0, 4, 0 }, { 6, 0, 4, 0 }, { 11, 0, 1, 0 },
+					{ 11, 2, 1, 0 }, { 9, 0, 4, 0 }, { 7, 4, 1, 0 }, { 11, 3, 1, 0 },
+				} },
+				{ 0x0Au, 2, 11, { 4, 4, 5 }, true, {
+					{ 0, 0, 10, 0 }, { 1, 0, 10, 0 }, { 2, 0, 10, 0 }, { 3, 0, 4, 0 }, { 0, 10, 1, 0 }, { 8, 4, 1, 0 }, { 7, 0, 4, 0 }, { 4, 0, 4, 0 },
+					{ 1, 10, 1, 0 }, { 11, 0, 1, 0 }, { 10, 0, 4, 0 }, { 5, 0, 5, 0 }, { 2, 10, 1, 0 }, { 8, 0, 4, 0 }, { 6, 0, 4, 0 }, { 11, 1, 1, 0 },
+					{ 11, 2, 1, 0 }, { 9, 0, 4, 0 }, { 11, 4, 1, 0 }, { 11, 3, 1, 0 },
+				} },
+				{ 0x0Eu, 2, 9, { 5, 5, 5 }, true, {
+					{ 0, 0, 9, 0 }, { 8, 4, 1, 0 }, { 1, 0, 9, 0 }, { 7, 4, 1, 0 }, { 2, 0, 9, 0 }, { 11, 4, 1, 0 }, { 3, 0, 5, 0 }, { 10, 4, 1, 0 },
+					{ 7, 0, 4, 0 }, { 4, 0, 5, 0 }, { 11, 0, 1, 0 }, { 10, 0, 4, 0 }, { 5, 0, 5, 0 }, { 11, 1, 1, 0 }, { 8, 0, 4, 0 }, { 6, 0, 5, 0 },
+					{ 11, 2, 1, 0 }, { 9, 0, 5, 0 }, { 11, 3, 1, 0 },
+				} },
+				{ 0x12u, 2, 8, { 6, 5, 5 }, true, {
+					{ 0, 0, 8, 0 }, { 10, 4, 1, 0 }, { 8, 4, 1, 0 }, { 1, 0, 8, 0 }, { 11, 2, 1, 0 }, { 7, 4, 1, 0 }, { 2, 0, 8, 0 }, { 11, 3, 1, 0 },
+					{ 11, 4, 1, 0 }, { 3, 0, 6, 0 }, { 7, 0, 4, 0 }, { 4, 0, 5, 0 }, { 11, 0, 1, 0 }, { 10, 0, 4, 0 }, { 5, 0, 5, 0 }, { 11, 1, 1, 0 },
+					{ 8, 0, 4, 0 }, { 6, 0, 6, 0 }, { 9, 0, 6, 0 },
+				} },
+				{ 0x16u, 2, 8, { 5, 6, 5 }, true, {
+					{ 0, 0, 8, 0 }, { 11, 0, 1, 0 }, { 8, 4, 1, 0 }, { 1, 0, 8, 0 }, { 7, 5, 1, 0 }, { 7, 4, 1, 0 }, { 2, 0, 8, 0 }, { 10, 5, 1, 0 },
+					{ 11, 4, 1, 0 }, { 3, 0, 5, 0 }, { 10, 4, 1, 0 }, { 7, 0, 4, 0 }, { 4, 0, 6, 0 }, { 10, 0, 4, 0 }, { 5, 0, 5, 0 }, { 11, 1, 1, 0 },
+					{ 8, 0, 4, 0 }, { 6, 0, 5, 0 }, { 11, 2, 1, 0 }, { 9, 0, 5, 0 }, { 11, 3, 1, 0 },
+				} },
+				{ 0x1Au, 2, 8, { 5, 5, 6 }, true, {
+					{ 0, 0, 8, 0 }, { 11, 1, 1, 0 }, { 8, 4, 1, 0 }, { 1, 0, 8, 0 }, { 8, 5, 1, 0 }, { 7, 4, 1, 0 }, { 2, 0, 8, 0 }, { 11, 5, 1, 0 },
+					{ 11, 4, 1, 0 }, { 3, 0, 5, 0 }, { 10, 4, 1, 0 }, { 7, 0, 4, 0 }, { 4, 0, 5, 0 }, { 11, 0, 1, 0 }, { 10, 0, 4, 0 }, { 5, 0, 6, 0 },
+					{ 8, 0, 4, 0 }, { 6, 0, 5, 0 }, { 11, 2, 1, 0 }, { 9, 0, 5, 0 }, { 11, 3, 1, 0 },
+				} },
+				{ 0x1Eu, 2, 6, { 6, 6, 6 }, false, {
+					{ 0, 0, 6, 0 }, { 10, 4, 1, 0 }, { 11, 0, 1, 0 }, { 11, 1, 1, 0 }, { 8, 4, 1, 0 }, { 1, 0, 6, 0 }, { 7, 5, 1, 0 }, { 8, 5, 1, 0 },
+					{ 11, 2, 1, 0 }, { 7, 4, 1, 0 }, { 2, 0, 6, 0 }, { 10, 5, 1, 0 }, { 11, 3, 1, 0 }, { 11, 5, 1, 0 }, { 11, 4, 1, 0 }, { 3, 0, 6, 0 },
+					{ 7, 0, 4, 0 }, { 4, 0, 6, 0 }, { 10, 0, 4, 0 }, { 5, 0, 6, 0 }, { 8, 0, 4, 0 }, { 6, 0, 6, 0 }, { 9, 0, 6, 0 },
+				} },
+				{ 0x03u, 1, 10, { 10, 10, 10 }, false, {
+					{ 0, 0, 10, 0 }, { 1, 0, 10, 0 }, { 2, 0, 10, 0 }, { 3, 0, 10, 0 }, { 4, 0, 10, 0 }, { 5, 0, 10, 0 },
+				} },
+				{ 0x07u, 1, 11, { 9, 9, 9 }, true, {
+					{ 0, 0, 10, 0 }, { 1, 0, 10, 0 }, { 2, 0, 10, 0 }, { 3, 0, 9, 0 }, { 0, 10, 1, 0 }, { 4, 0, 9, 0 }, { 1, 10, 1, 0 }, { 5, 0, 9, 0 },
+					{ 2, 10, 1, 0 },
+				} },
+				{ 0x0Bu, 1, 12, { 8, 8, 8 }, true, {
+					{ 0, 0, 10, 0 }, { 1, 0, 10, 0 }, { 2, 0, 10, 0 }, { 3, 0, 8, 0 }, { 0, 10, 2, 1 }, { 4, 0, 8, 0 }, { 1, 10, 2, 1 }, { 5, 0, 8, 0 },
+					{ 2, 10, 2, 1 },
+				} },
+				{ 0x0Fu, 1, 16, { 4, 4, 4 }, true, {
+					{ 0, 0, 10, 0 }, { 1, 0, 10, 0 }, { 2, 0, 10, 0 }, { 3, 0, 4, 0 }, { 0, 10, 6, 1 }, { 4, 0, 4, 0 }, { 1, 10, 6, 1 }, { 5, 0, 4, 0 },
+					{ 2, 10, 6, 1 },
+				} },
+			};
+			
+			// 2-bit or 5-bit mode
+			block_bit_reader bits(block);
+			uint32_t mode_value = bits.read(2);
+			if(mode_value > 1u) {
+				mode_value |= bits.read(3) << 2u;
+			}
+			const mode_info* info = nullptr;
+			for(const auto& mode : modes) {
+				if(mode.mode == mode_value) {
+					info = &mode;
+					break;
+				}
+			}
+			if(info == nullptr) {
+				// reserved -> black
+				for(auto& texel : texels) {
+					texel = { 0.0f, 0.0f, 0.0f, 1.0f };
+				}
+				return;
+			}
+			
+			int32_t endpoints[4][3] {};
+			for(const auto& field : info->fields) {
+				if(field.count == 0) break;
+				const auto value = (field.reversed ? bits.read_reversed(field.count) : bits.read(field.count));
+				endpoints[field.field / 3u][field.field % 3u] |= int32_t(value << field.shift);
+			}
+			const uint32_t partition = (info->region_count == 2 ? bits.read(5) : 0u);
+			
+			const auto sign_extend = [](const int32_t value, const uint32_t value_bits) {
+				const auto shift = 32u - value_bits;
+				return int32_t(uint32_t(value) << shift) >> shift;
+			};
+			const auto unquantize = [is_signed](int32_t value, const uint32_t value_bits) -> int32_t {
+				if(!is_signed) {
+					if(value_bits >= 15u) return value;
+					if(value == 0) return 0;
+					if(value == (1 << value_bits) - 1) return 0xFFFF;
+					return ((value << 16) + 0x8000) >> value_bits;
+				}
+				if(value_bits >= 16u) return value;
+				const bool is_negative = (value < 0);
+				if(is_negative) value = -value;
+				int32_t ret;
+				if(value == 0) ret = 0;
+				else if(value >= (1 << (value_bits - 1u)) - 1) ret = 0x7FFF;
+				else ret = ((value << 15) + 0x4000) >> (value_bits - 1u);
+				return (is_negative ? -ret : ret);
+			};
+			
+			// undo the delta transform (endpoints 1 - 3 are stored as deltas to endpoint 0), then unquantize to 16-bit
+			const uint32_t endpoint_count = info->region_count * 2u;
+			const uint32_t endpoint_bits = info->endpoint_bits;
+			const int32_t endpoint_mask = (1 << endpoint_bits) - 1;
+			for(uint32_t ch = 0; ch < 3; ++ch) {
+				if(is_signed) endpoints[0][ch] = sign_extend(endpoints[0][ch], endpoint_bits);
+				for(uint32_t ep = 1; ep < endpoint_count; ++ep) {
+					if(info->transformed) {
+						endpoints[ep][ch] = sign_extend(endpoints[ep][ch], info->delta_bits[ch]);
+						endpoints[ep][ch] = (endpoints[0][ch] + endpoints[ep][ch]) & endpoint_mask;
+					}
+					if(is_signed) endpoints[ep][ch] = sign_extend(endpoints[ep][ch], endpoint_bits);
+				}
+				for(uint32_t ep = 0; ep < endpoint_count; ++ep) {
+					endpoints[ep][ch] = unquantize(endpoints[ep][ch], endpoint_bits);
+				}
+			}
+			
+			// 3-bit indices with two regions, 4-bit indices with one region
+			const uint32_t index_bits = (info->region_count == 2 ? 3u : 4u);
+			for(uint32_t i = 0; i < 16; ++i) {
+				const auto index = bits.read(index_bits - (bptc::is_anchor(info->region_count, partition, i) ? 1u : 0u));
+				const auto weight = bptc::weight(index_bits, index);
+				const auto region = bptc::subset(info->region_count, partition, i);
+				
+				float rgb[3];
+				for(uint32_t ch = 0; ch < 3; ++ch) {
+					const auto value = bptc::interpolate(endpoints[region * 2u][ch], endpoints[region * 2u + 1u][ch], weight);
+					// scale to the half float range (sign-magnitude for negative values) and convert to float
+					uint16_t half_bits;
+					if(!is_signed) half_bits = uint16_t((value * 31) >> 6);
+					else half_bits = uint16_t(value < 0 ? (((-value * 31) >> 5) | 0x8000) : ((value * 31) >> 5));
+					soft_f16 half_value;
+					memcpy(&half_value, &half_bits, sizeof(half_bits));
+					rgb[ch] = (float)half_value;
+				}
+				texels[i] = { rgb[0], rgb[1], rgb[2], 1.0f };
+			}
+		}
+	}
+	
+	//! block decoders for ETC1, ETC2 (RGB, RGB + 1-bit alpha, RGBA) and EAC (R11/RG11), decoding one 4x4 block
+	//! into 16 float4 texels (row-major)
+	//! NOTE: ETC/EAC blocks are stored big-endian and their texel indices are stored column-major
+	namespace etc_decoder {
+		static constexpr const int32_t modifier_table[8][2] {
+			{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 },
+		};
+		static constexpr const int32_t distance_table[8] { 3, 6, 11, 16, 23, 32, 41, 64 };
+		static constexpr const int32_t eac_modifier_table[16][8] {
+			{ -3, -6, -9, -15, 2, 5, 8, 14 },
+			{ -3, -7, -10, -13, 2, 6, 9, 12 },
+			{ -2, -5, -8, -13, 1, 4, 7, 12 },
+			{ -2, -4, -6, -13, 1, 3, 5, 12 },
+			{ -3, -6, -8, -12, 2, 5, 7, 11 },
+			{ -3, -7, -9, -11, 2, 6, 8, 10 },
+			{ -4, -7, -8, -11, 3, 6, 7, 10 },
+			{ -3, -5, -8, -11, 2, 4, 7, 10 },
+			{ -2, -6, -8, -10, 1, 5, 7, 9 },
+			{ -2, -5, -8, -10, 1, 4, 7, 9 },
+			{ -2, -4, -8, -10, 1, 3, 7, 9 },
+			{ -2, -5, -7, -10, 1, 4, 6, 9 },
+			{ -3, -4, -7, -10, 2, 3, 6, 9 },
+			{ -1, -2, -3, -10, 0, 1, 2, 9 },
+			{ -4, -6, -8, -9, 3, 5, 7, 8 },
+			{ -3, -5, -7, -9, 2, 4, 6, 8 },
+		};
+		
+		floor_inline_always static uint64_t read_block_bits(const uint8_t* block) {
+			uint64_t bits = 0;
+#pragma unroll
+			for(uint32_t i = 0; i < 8; ++i) {
+				bits = (bits << 8ull) | uint64_t(block[i]);
+			}
+			return bits;
+		}
+		
+		//! returns the "count" bits at "shift"
+		floor_inline_always static int32_t get_bits(const uint64_t bits, const uint32_t shift, const uint32_t count) {
+			return int32_t((bits >> uint64_t(shift)) & ((1ull << uint64_t(count)) - 1ull));
+		}
+		
+		//! expands a 4/5/6/7-bit color value to 8 bits
+		floor_inline_always static int32_t expand(const int32_t value, const uint32_t value_bits) {
+			const int32_t shifted = value << (8u - value_bits);
+			return shifted | (shifted >> value_bits);
+		}
+		
+		floor_inline_always static int32_t clamp_255(const int32_t value) {
+			return (value < 0 ? 0 : (value > 255 ? 255 : value));
+		}
+		
+		//! decodes an ETC1/ETC2 RGB color block, with "punch_through" selecting the ETC2 RGB + 1-bit alpha variant
+		static void decode_color_block(const uint8_t* block, const bool punch_through, float4 (&texels)[16]) {
+			const uint64_t bits = read_block_bits(block);
+			const bool diff_bit = (get_bits(bits, 33, 1) != 0);
+			// with punch-through alpha, the diff bit is the "opaque" bit and the differential mode is always used
+			const bool differential = (punch_through || diff_bit);
+			const bool opaque = (!punch_through || diff_bit);
+			
+			enum class ETC_MODE { SUB_BLOCK, T, H, PLANAR };
+			auto mode = ETC_MODE::SUB_BLOCK;
+			// individual/differential: base colors of both sub-blocks, T/H: the 4 paint colors
+			int32_t paint[4][3] {};
+			if(!differential) {
+				for(uint32_t ch = 0; ch < 3; ++ch) {
+					paint[0][ch] = expand(get_bits(bits, 60u - ch * 8u, 4), 4);
+					paint[1][ch] = expand(get_bits(bits, 56u - ch * 8u, 4), 4);
+				}
+			}
+			else {
+				// an overflowing red/green/blue sum selects the ETC2 T/H/planar mode
+				int32_t base[3], sum[3];
+				for(uint32_t ch = 0; ch < 3; ++ch) {
+					base[ch] = get_bits(bits, 59u - ch * 8u, 5);
+					const auto delta = get_bits(bits, 56u - ch * 8u, 3);
+					sum[ch] = base[ch] + (delta >= 4 ? delta - 8 : delta);
+				}
+				if(sum[0] < 0 || sum[0] > 31) mode = ETC_MODE::T;
+				else if(sum[1] < 0 || sum[1] > 31) mode = ETC_MODE::H;
+				else if(sum[2] < 0 || sum[2] > 31) mode = ETC_MODE::PLANAR;
+				else {
+					for(uint32_t ch = 0; ch < 3; ++ch) {
+						paint[0][ch] = expand(base[ch], 5);
+						paint[1][ch] = expand(sum[ch], 5);
+					}
+				}
+			}
+			
+			if(mode == ETC_MODE::PLANAR) {
+				const int32_t origin[3] {
+					expand(get_bits(bits, 57, 6), 6),
+					expand((get_bits(bits, 56, 1) << 6) | get_bits(bits, 49, 6), 7),
+					expand((get_bits(bits, 48, 1) << 5) | (get_bits(bits, 43, 2) << 3) | get_bits(bits, 39, 3), 6),
+				};
+				const int32_t horizontal[3] {
+					expand((get_bits(bits, 34, 5) << 1) | get_bits(bits, 32, 1), 6),
+					expand(get_bits(bits, 25, 7), 7),
+					expand(get_bits(bits, 19, 6), 6),
+				};
+				const int32_t vertical[3] {
+					expand(get_bits(bits, 13, 6), 6),
+					expand(get_bits(bits, 6, 7), 7),
+					expand(get_bits(bits, 0, 6), 6),
+				};
+				for(int32_t y = 0; y < 4; ++y) {
+					for(int32_t x = 0; x < 4; ++x) {
+						float rgb[3];
+						for(uint32_t ch = 0; ch < 3; ++ch) {
+							const auto value = (x * (horizontal[ch] - origin[ch]) + y * (vertical[ch] - origin[ch]) + 4 * origin[ch] + 2) >> 2;
+							rgb[ch] = float(clamp_255(value)) * (1.0f / 255.0f);
+						}
+						texels[y * 4 + x] = { rgb[0], rgb[1], rgb[2], 1.0f };
+					}
+				}
+				return;
+			}
+			
+			if(mode == ETC_MODE::T || mode == ETC_MODE::H) {
+				int32_t color_0[3], color_1[3];
+				int32_t distance;
+				if(mode == ETC_MODE::T) {
+					color_0[0] = (get_bits(bits, 59, 2) << 2) | get_bits(bits, 56, 2);
+					color_0[1] = get_bits(bits, 52, 4);
+					color_0[2] = get_bits(bits, 48, 4);
+					color_1[0] = get_bits(bits, 44, 4);
+					color_1[1] = get_bits(bits, 40, 4);
+					color_1[2] = get_bits(bits, 36, 4);
+					distance = distance_table[(get_bits(bits, 34, 2) << 1) | get_bits(bits, 32, 1)];
+				}
+				else {
+					color_0[0] = get_bits(bits, 59, 4);
+					color_0[1] = (get_bits(bits, 56, 3) << 1) | get_bits(bits, 52, 1);
+					color_0[2] = (get_bits(bits, 51, 1) << 3) | get_bits(bits, 47, 3);
+					color_1[0] = get_bits(bits, 43, 4);
+					color_1[1] = get_bits(bits, 39, 4);
+					color_1[2] = get_bits(bits, 35, 4);
+					// the LSB of the distance index is given by the order of both colors
+					const auto order_0 = (color_0[0] << 8) | (color_0[1] << 4) | color_0[2];
+					const auto order_1 = (color_1[0] << 8) | (color_1[1] << 4) | color_1[2];
+					distance = distance_table[(get_bits(bits, 34, 1) << 2) | (get_bits(bits, 32, 1) << 1) | (order_0 >= order_1 ? 1 : 0)];
+				}
+				for(uint32_t ch = 0; ch < 3; ++ch) {
+					color_0[ch] = expand(color_0[ch], 4);
+					color_1[ch] = expand(color_1[ch], 4);
+					if(mode == ETC_MODE::T) {
+						paint[0][ch] = color_0[ch];
+						paint[1][ch] = clamp_255(color_1[ch] + distance);
+						paint[2][ch] = color_1[ch];
+						paint[3][ch] = clamp_255(color_1[ch] - distance);
+					}
+					else {
+						paint[0][ch] = clamp_255(color_0[ch] + distance);
+						paint[1][ch] = clamp_255(color_0[ch] - distance);
+						paint[2][ch] = clamp_255(color_1[ch] + distance);
+						paint[3][ch] = clamp_255(color_1[ch] - distance);
+					}
+				}
+			}
+			
+			const bool flip = (get_bits(bits, 32, 1) != 0);
+			const int32_t table_index[2] { get_bits(bits, 37, 3), get_bits(bits, 34, 3) };
+			for(uint32_t x = 0; x < 4; ++x) {
+				for(uint32_t y = 0; y < 4; ++y) {
+					const uint32_t i = x * 4u + y;
+					const uint32_t index = (uint32_t(get_bits(bits, 16u + i, 1)) << 1u) | uint32_t(get_bits(bits, i, 1));
+					auto& texel = texels[y * 4u + x];
+					
+					// punch-through alpha: index 2 is transparent black
+					if(!opaque && index == 2u) {
+						texel = { 0.0f, 0.0f, 0.0f, 0.0f };
+						continue;
+					}
+					
+					int32_t rgb[3];
+					if(mode == ETC_MODE::SUB_BLOCK) {
+						const uint32_t sub_block = (flip ? (y >= 2u ? 1u : 0u) : (x >= 2u ? 1u : 0u));
+						const auto& modifiers = modifier_table[table_index[sub_block]];
+						// 0 -> +small, 1 -> +large, 2 -> -small, 3 -> -large (small is 0 in non-opaque punch-through blocks)
+						const int32_t modifier_value = ((index & 1u) != 0 ? modifiers[1] : (opaque ? modifiers[0] : 0));
+						const int32_t modifier = ((index & 2u) != 0 ? -modifier_value : modifier_value);
+						for(uint32_t ch = 0; ch < 3; ++ch) {
+							rgb[ch] = clamp_255(paint[sub_block][ch] + modifier);
+						}
+					}
+					else {
+						for(uint32_t ch = 0; ch < 3; ++ch) {
+							rgb[ch] = paint[index][ch];
+						}
+					}
+					texel = {
+						float(rgb[0]) * (1.0f / 255.0f),
+						float(rgb[1]) * (1.0f / 255.0f),
+						float(rgb[2]) * (1.0f / 255.0f),
+						1.0f
+					};
+				}
+			}
+		}
+		
+		//! decodes an EAC block into the specified channel: either an 8-bit alpha block (ETC2 RGBA) or an 11-bit R/RG block
+		static void decode_eac_block(const uint8_t* block, const uint32_t channel, const bool is_alpha, const bool is_signed,
+									 float4 (&texels)[16]) {
+			const uint64_t bits = read_block_bits(block);
+			// -128 is treated as -127
+			const int32_t base = (is_signed ? max(int32_t(int8_t(block[0])), -127) : int32_t(block[0]));
+			const int32_t multiplier = int32_t(block[1] >> 4u);
+			const auto& modifiers = eac_modifier_table[block[1] & 0xFu];
+			for(uint32_t i = 0; i < 16; ++i) {
+				// 3-bit indices, first texel in the MSBs
+				const auto modifier = modifiers[get_bits(bits, 45u - i * 3u, 3)];
+				float value;
+				if(is_alpha) {
+					value = float(clamp_255(base + modifier * multiplier)) * (1.0f / 255.0f);
+				}
+				else {
+					// 11-bit: a multiplier of 0 is treated as 1/8
+					const int32_t scaled_modifier = modifier * (multiplier == 0 ? 1 : multiplier * 8);
+					if(!is_signed) {
+						const auto value_11 = base * 8 + 4 + scaled_modifier;
+						value = float(value_11 < 0 ? 0 : (value_11 > 2047 ? 2047 : value_11)) * (1.0f / 2047.0f);
+					}
+					else {
+						const auto value_11 = base * 8 + scaled_modifier;
+						value = float(value_11 < -1023 ? -1023 : (value_11 > 1023 ? 1023 : value_11)) * (1.0f / 1023.0f);
+					}
+				}
+				texels[(i & 3u) * 4u + (i / 4u)][channel] = value;
+			}
+		}
+	}
+	
+	//! decodes a single block of the specified run-time image type
+	static void decode_block(const uint8_t* block, const COMPUTE_IMAGE_TYPE image_type, float4 (&texels)[16]) {
+		const auto channel_count = image_channel_count(image_type);
+		const bool is_signed = ((image_type & COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK) == COMPUTE_IMAGE_TYPE::INT);
+		switch(image_type & COMPUTE_IMAGE_TYPE::__COMPRESSION_MASK) {
+			case COMPUTE_IMAGE_TYPE::BC1:
+				bc_decoder::decode_color_block(block, true, (channel_count == 4), texels);
+				break;
+			case COMPUTE_IMAGE_TYPE::BC2:
+				bc_decoder::decode_color_block(block + 8, false, true, texels);
+				bc_decoder::decode_explicit_alpha_block(block, texels);
+				break;
+			case COMPUTE_IMAGE_TYPE::BC3:
+				bc_decoder::decode_color_block(block + 8, false, true, texels);
+				bc_decoder::decode_channel_block<false>(block, 3u, texels);
+				break;
+			case COMPUTE_IMAGE_TYPE::RGTC:
+#pragma unroll
+				for(uint32_t i = 0; i < 16; ++i) {
+					texels[i] = { 0.0f, 0.0f, 0.0f, 1.0f };
+				}
+				for(uint32_t ch = 0; ch < min(channel_count, 2u); ++ch) {
+					if(!is_signed) bc_decoder::decode_channel_block<false>(block + ch * 8u, ch, texels);
+					else bc_decoder::decode_channel_block<true>(block + ch * 8u, ch, texels);
+				}
+				break;
+			case COMPUTE_IMAGE_TYPE::BPTC:
+				// BC6H: float (signed unless normalized), BC7: unorm
+				if((image_type & COMPUTE_IMAGE_TYPE::__DATA_TYPE_MASK) == COMPUTE_IMAGE_TYPE::FLOAT) {
+					bc_decoder::decode_bc6h_block(block, !has_flag<COMPUTE_IMAGE_TYPE::FLAG_NORMALIZED>(image_type), texels);
+				}
+				else {
+					bc_decoder::decode_bc7_block(block, texels);
+				}
+				break;
+			case COMPUTE_IMAGE_TYPE::EAC:
+				// ETC1 RGB (same compression value as EAC)
+				if(channel_count == 3) {
+					etc_decoder::decode_color_block(block, false, texels);
+					break;
+				}
+				// EAC R11/RG11
+#pragma unroll
+				for(uint32_t i = 0; i < 16; ++i) {
+					texels[i] = { 0.0f, 0.0f, 0.0f, 1.0f };
+				}
+				for(uint32_t ch = 0; ch < min(channel_count, 2u); ++ch) {
+					etc_decoder::decode_eac_block(block + ch * 8u, ch, false, is_signed, texels);
+				}
+				break;
+			case COMPUTE_IMAGE_TYPE::ETC2:
+				if(channel_count == 3) {
+					etc_decoder::decode_color_block(block, false, texels);
+				}
+				// RGB + 1-bit alpha
+				else if((image_type & COMPUTE_IMAGE_TYPE::__FORMAT_MASK) == COMPUTE_IMAGE_TYPE::FORMAT_1) {
+					etc_decoder::decode_color_block(block, true, texels);
+				}
+				// EAC alpha block, followed by the RGB block
+				else {
+					etc_decoder::decode_color_block(block + 8, false, texels);
+					etc_decoder::decode_eac_block(block, 3u, true, false, texels);
+				}
+				break;
+			default: floor_unreachable();
+		}
+	}
+	
+	//! per-thread direct-mapped cache of decoded 4x4 blocks, indexed by the block address
+	//! NOTE: compressed images are read-only, so entries only need to be dropped when a new kernel launch starts
+	struct decoded_block_cache {
+		static constexpr const uint32_t entry_count { 64u };
+		
+		struct entry {
+			const uint8_t* block { nullptr };
+			float4 texels[16];
+		};
+		entry entries[entry_count];
+		uint32_t epoch { ~0u };
+		
+		floor_inline_always static uint32_t entry_index(const uint8_t* block) {
+			// blocks are 8 or 16 bytes in size -> ignore the lower bits, fold in some of the row bits
+			const auto addr = size_t(block);
+			return uint32_t((addr >> 3u) ^ (addr >> 11u)) & (entry_count - 1u);
+		}
+		
+		//! returns the decoded texels of the specified block, decoding it if it isn't cached yet
+		const float4* get(const uint8_t* block, const COMPUTE_IMAGE_TYPE image_type) {
+			if(epoch != floor_host_image_epoch) {
+				for(auto& e : entries) {
+					e.block = nullptr;
+				}
+				epoch = floor_host_image_epoch;
+			}
+			
+			auto& e = entries[entry_index(block)];
+			if(e.block != block) {
+				decode_block(block, image_type, e.texels);
+				e.block = block;
+			}
+			return e.texels;
+		}
+	};
+	
+	//! returns the decoded texels of the specified block using the decoded block cache of the current thread
+	floor_inline_always static const float4* decode_block_cached(const uint8_t* block, const COMPUTE_IMAGE_TYPE image_type) {
+		static thread_local decoded_block_cache cache;
+		return cache.get(block, image_type);
+	}
+}
+
+#endif
+
+#endif
@@ -222,8 +222,8 @@ floor_inline_always static std::locale locale_global(const std::locale& loc) {
 #define FLOOR_COMPUTE_INFO_HAS_IMAGE_OFFSET_WRITE_SUPPORT_1
 #define FLOOR_COMPUTE_INFO_HAS_IMAGE_DEPTH_COMPARE_SUPPORT 1
 #define FLOOR_COMPUTE_INFO_HAS_IMAGE_DEPTH_COMPARE_SUPPORT_1
-#define FLOOR_COMPUTE_INFO_HAS_IMAGE_GATHER_SUPPORT 0
-#define FLOOR_COMPUTE_INFO_HAS_IMAGE_GATHER_SUPPORT_0
+#define FLOOR_COMPUTE_INFO_HAS_IMAGE_GATHER_SUPPORT 1
+#define FLOOR_COMPUTE_INFO_HAS_IMAGE_GATHER_SUPPORT_1
 #define FLOOR_COMPUTE_INFO_HAS_IMAGE_READ_WRITE_SUPPORT 1
 #define FLOOR_COMPUTE_INFO_HAS_IMAGE_READ_WRITE_SUPPORT_1
 
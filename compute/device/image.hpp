@@ -860,6 +860,72 @@ namespace floor_image {
 			return read_internal<true, false, true, true, compare_function>(coord, layer, 0, offset, 0.0f, 0, gradient, compare_value);
 		}
 		
+#if defined(FLOOR_COMPUTE_HOST)
+		//////////////////////////////////////////
+		// gather functions (2D/cube images, float coordinates only):
+		// * host-compute: has full support for this (see device_info::has_image_gather_support())
+		// * other backends: not yet exposed
+		// gathered values are returned in the order (i0, j1), (i1, j1), (i1, j0), (i0, j0) of the bilinear footprint
+		
+		//! internal gather function, handling all kinds of gathers
+		template <uint32_t component, bool is_compare = false, COMPARE_FUNCTION compare_function = COMPARE_FUNCTION::NEVER,
+				  typename coord_type, typename offset_vec_type>
+		floor_inline_always auto gather_internal(const coord_type& coord,
+												 const uint32_t layer,
+												 const offset_vec_type offset,
+												 const float compare_value = 0.0f) const {
+			static_assert(image_dim_count(image_type) == 2, "gather is only supported for 2D and cube images");
+			static_assert(!has_flag<COMPUTE_IMAGE_TYPE::FLAG_MSAA>(image_type), "gather is not supported for msaa images");
+			static_assert(!is_int_coord<coord_type>(), "gather requires float coordinates");
+			static_assert((is_compare && has_flag<COMPUTE_IMAGE_TYPE::FLAG_DEPTH>(image_type)) || !is_compare,
+						  "compare is only allowed with depth images");
+			
+			typedef host_device_image<image_type, false, false, true> host_image_type;
+			const auto converted_coord = convert_coord(coord);
+			if constexpr(!is_compare) {
+				return host_image_type::template gather<component>((const host_image_type*)r_img(), converted_coord, offset, layer, 0, 0.0f);
+			}
+			else {
+				return host_image_type::gather_compare((const host_image_type*)r_img(), converted_coord, offset, layer, 0, 0.0f,
+													   compare_function, compare_value);
+			}
+		}
+		
+		//! gathers the specified component of the four texels that would be used for bilinear sampling (non-array)
+		template <uint32_t component = 0, typename coord_type, COMPUTE_IMAGE_TYPE image_type_ = image_type,
+				  typename offset_vec_type = typename offset_vec_type_for_image_type<image_type_>::type,
+				  enable_if_t<!has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(image_type_)>* = nullptr>
+		auto gather(const coord_type& coord, const offset_vec_type offset = {}) const {
+			return gather_internal<component>(coord, 0, offset);
+		}
+		
+		//! gathers the specified component of the four texels that would be used for bilinear sampling (array)
+		template <uint32_t component = 0, typename coord_type, COMPUTE_IMAGE_TYPE image_type_ = image_type,
+				  typename offset_vec_type = typename offset_vec_type_for_image_type<image_type_>::type,
+				  enable_if_t<has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(image_type_)>* = nullptr>
+		auto gather(const coord_type& coord, const uint32_t layer, const offset_vec_type offset = {}) const {
+			return gather_internal<component>(coord, layer, offset);
+		}
+		
+		//! gathers the four depth texels that would be used for bilinear sampling and compares each of them
+		//! with the compare value according to the compare function (non-array)
+		template <COMPARE_FUNCTION compare_function, typename coord_type, COMPUTE_IMAGE_TYPE image_type_ = image_type,
+				  typename offset_vec_type = typename offset_vec_type_for_image_type<image_type_>::type,
+				  enable_if_t<!has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(image_type_)>* = nullptr>
+		auto gather_compare(const coord_type& coord, const float& compare_value, const offset_vec_type offset = {}) const {
+			return gather_internal<0, true, compare_function>(coord, 0, offset, compare_value);
+		}
+		
+		//! gathers the four depth texels that would be used for bilinear sampling and compares each of them
+		//! with the compare value according to the compare function (array)
+		template <COMPARE_FUNCTION compare_function, typename coord_type, COMPUTE_IMAGE_TYPE image_type_ = image_type,
+				  typename offset_vec_type = typename offset_vec_type_for_image_type<image_type_>::type,
+				  enable_if_t<has_flag<COMPUTE_IMAGE_TYPE::FLAG_ARRAY>(image_type_)>* = nullptr>
+		auto gather_compare(const coord_type& coord, const uint32_t layer, const float& compare_value, const offset_vec_type offset = {}) const {
+			return gather_internal<0, true, compare_function>(coord, layer, offset, compare_value);
+		}
+#endif
+		
 	};
 	
 	//! read-write/write-only image container
@@ -340,6 +340,19 @@ enum class COMPUTE_IMAGE_TYPE : uint32_t {
 	BPTC_RGBUHF				= BPTC | CHANNELS_3 | FORMAT_3_3_2 | FLOAT | FLAG_NORMALIZED,
 	BPTC_RGBA				= BPTC | CHANNELS_4 | FORMAT_2 | UINT | FLAG_NORMALIZED,
 	BPTC_RGBA_SRGB			= BPTC | CHANNELS_4 | FORMAT_2 | UINT | FLAG_NORMALIZED | FLAG_SRGB,
+	EAC_RUI					= EAC | CHANNELS_1 | FORMAT_4 | UINT | FLAG_NORMALIZED,
+	EAC_RI					= EAC | CHANNELS_1 | FORMAT_4 | INT | FLAG_NORMALIZED,
+	EAC_RGUI				= EAC | CHANNELS_2 | FORMAT_4 | UINT | FLAG_NORMALIZED,
+	EAC_RGI					= EAC | CHANNELS_2 | FORMAT_4 | INT | FLAG_NORMALIZED,
+	ETC1_RGB				= ETC1 | CHANNELS_3 | FORMAT_1 | UINT | FLAG_NORMALIZED,
+	ETC2_RGB				= ETC2 | CHANNELS_3 | FORMAT_1 | UINT | FLAG_NORMALIZED,
+	ETC2_RGB_SRGB			= ETC2 | CHANNELS_3 | FORMAT_1 | UINT | FLAG_NORMALIZED | FLAG_SRGB,
+	//! ETC2 with 1-bit "punch-through" alpha
+	ETC2_RGB_A1				= ETC2 | CHANNELS_4 | FORMAT_1 | UINT | FLAG_NORMALIZED,
+	ETC2_RGB_A1_SRGB		= ETC2 | CHANNELS_4 | FORMAT_1 | UINT | FLAG_NORMALIZED | FLAG_SRGB,
+	//! ETC2 with EAC alpha
+	ETC2_RGBA				= ETC2 | CHANNELS_4 | FORMAT_2 | UINT | FLAG_NORMALIZED,
+	ETC2_RGBA_SRGB			= ETC2 | CHANNELS_4 | FORMAT_2 | UINT | FLAG_NORMALIZED | FLAG_SRGB,
 	PVRTC_RGB2				= PVRTC | CHANNELS_3 | FORMAT_2 | UINT | FLAG_NORMALIZED,
 	PVRTC_RGB4				= PVRTC | CHANNELS_3 | FORMAT_4 | UINT | FLAG_NORMALIZED,
 	PVRTC_RGBA2				= PVRTC | CHANNELS_4 | FORMAT_2 | UINT | FLAG_NORMALIZED,
@@ -461,8 +474,18 @@ static constexpr uint32_t image_bits_per_pixel(const COMPUTE_IMAGE_TYPE& image_t
 		}
 	}
 	else {
+		const auto channel_count = image_channel_count(image_type);
 		switch(image_type & COMPUTE_IMAGE_TYPE::__COMPRESSION_MASK) {
 			case COMPUTE_IMAGE_TYPE::PVRTC: return (format == COMPUTE_IMAGE_TYPE::FORMAT_2 ? 2 : 4);
+			// 4x4 blocks: 64-bit blocks for BC1, 1-channel RGTC/BC4 and ETC1/ETC2 RGB, 128-bit blocks for everything else
+			case COMPUTE_IMAGE_TYPE::BC1: return 4;
+			case COMPUTE_IMAGE_TYPE::BC2: return 8;
+			case COMPUTE_IMAGE_TYPE::BC3: return 8;
+			case COMPUTE_IMAGE_TYPE::RGTC: return (channel_count == 1 ? 4 : 8);
+			case COMPUTE_IMAGE_TYPE::BPTC: return 8;
+			case COMPUTE_IMAGE_TYPE::EAC: return (channel_count == 2 || channel_count == 4 ? 8 : 4);
+			// NOTE: ETC2 RGB with 1-bit alpha (FORMAT_1) is a 64-bit block
+			case COMPUTE_IMAGE_TYPE::ETC2: return (channel_count == 4 && format != COMPUTE_IMAGE_TYPE::FORMAT_1 ? 8 : 4);
 			// TODO: other compressed formats
 			default: return 1;
 		}
@@ -509,14 +532,33 @@ static constexpr uint32_t image_bytes_per_pixel(const COMPUTE_IMAGE_TYPE& image_
 	return ((bpp + 7u) / 8u);
 }
 
+//! returns the width/height of a compressed block for block-compressed image formats (BCn, ETC, EAC),
+//! or 1 for uncompressed formats and formats that are not stored in fixed-size 4x4 blocks
+static constexpr uint32_t image_compression_block_dim(const COMPUTE_IMAGE_TYPE& image_type) {
+	switch(image_type & COMPUTE_IMAGE_TYPE::__COMPRESSION_MASK) {
+		case COMPUTE_IMAGE_TYPE::BC1:
+		case COMPUTE_IMAGE_TYPE::BC2:
+		case COMPUTE_IMAGE_TYPE::BC3:
+		case COMPUTE_IMAGE_TYPE::RGTC:
+		case COMPUTE_IMAGE_TYPE::BPTC:
+		case COMPUTE_IMAGE_TYPE::EAC:
+		case COMPUTE_IMAGE_TYPE::ETC2:
+			return 4;
+		default: break;
+	}
+	return 1;
+}
+
 //! returns the total amount of bytes needed to store a slice of an image of the specified dimensions and types
 //! (or of the complete image w/o mip levels if it isn't an array or cube image)
 static constexpr size_t image_slice_data_size_from_types(const uint4& image_dim,
 														 const COMPUTE_IMAGE_TYPE& image_type,
 														 const size_t sample_count = 1) {
 	const auto dim_count = image_dim_count(image_type);
-	size_t size = size_t(image_dim.x);
-	if(dim_count >= 2) size *= size_t(image_dim.y);
+	const auto block_dim = image_compression_block_dim(image_type);
+	// NOTE: for block-compressed formats, dims are rounded up to the block size
+	size_t size = size_t(((image_dim.x + block_dim - 1u) / block_dim) * block_dim);
+	if(dim_count >= 2) size *= size_t(((image_dim.y + block_dim - 1u) / block_dim) * block_dim);
 	if(dim_count == 3) size *= size_t(image_dim.z);
 	
 	if(has_flag<COMPUTE_IMAGE_TYPE::FLAG_MSAA>(image_type)) {
@@ -530,6 +572,23 @@ static constexpr size_t image_slice_data_size_from_types(const uint4& image_dim,
 	return size;
 }
 
+// block sizes and slice sizes of block-compressed formats (partial blocks are stored as whole blocks)
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::BC1_RGBA) * 16u == 64u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::BC3_RGBA) * 16u == 128u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::RGTC_RUI) * 16u == 64u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::RGTC_RGUI) * 16u == 128u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::BPTC_RGBHF) * 16u == 128u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::BPTC_RGBA) * 16u == 128u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::EAC_RUI) * 16u == 64u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::EAC_RGI) * 16u == 128u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::ETC1_RGB) * 16u == 64u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::ETC2_RGB) * 16u == 64u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::ETC2_RGB_A1) * 16u == 64u);
+static_assert(image_bits_per_pixel(COMPUTE_IMAGE_TYPE::ETC2_RGBA) * 16u == 128u);
+static_assert(image_slice_data_size_from_types(uint4 { 5u, 5u, 1u, 0u }, COMPUTE_IMAGE_TYPE::IMAGE_2D | COMPUTE_IMAGE_TYPE::BC1_RGB) == 4u * 8u);
+static_assert(image_slice_data_size_from_types(uint4 { 4u, 2u, 1u, 0u }, COMPUTE_IMAGE_TYPE::IMAGE_2D | COMPUTE_IMAGE_TYPE::BPTC_RGBA) == 16u);
+static_assert(image_slice_data_size_from_types(uint4 { 8u, 8u, 1u, 0u }, COMPUTE_IMAGE_TYPE::IMAGE_2D | COMPUTE_IMAGE_TYPE::ETC2_RGBA) == 4u * 16u);
+
 //! returns the amount of mip-map levels required by the specified max image dimension (no flag checking)
 static constexpr uint32_t image_mip_level_count_from_max_dim(const uint32_t& max_dim) {
 	// each mip level is half the size of its upper/parent level, until dim == 1
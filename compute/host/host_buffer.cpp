@@ -40,6 +40,17 @@ compute_buffer(cqueue, size_, host_ptr_, flags_, opengl_type_, external_gl_objec
 	}
 }
 
+host_buffer::host_buffer(const compute_queue& cqueue,
+						 shared_ptr<const host_buffer> parent,
+						 const size_t& offset,
+						 const size_t& size_) :
+compute_buffer(cqueue, size_, (parent->host_ptr != nullptr ? (uint8_t*)parent->host_ptr + offset : nullptr),
+			   parent->flags | COMPUTE_MEMORY_FLAG::NO_INITIAL_COPY) {
+	// references the memory of the parent buffer, nothing to allocate
+	buffer = parent->buffer + offset;
+	parent_buffer = move(parent);
+}
+
 bool host_buffer::create_internal(const bool copy_host_data, const compute_queue& cqueue) {
 	// TODO: handle the remaining flags + host ptr
 	
@@ -75,8 +86,8 @@ host_buffer::~host_buffer() {
 		if(!gl_object_state) release_opengl_object(nullptr); // -> release to opengl
 		delete_gl_buffer();
 	}
-	// then, also kill the host buffer
-	if(buffer != nullptr) {
+	// then, also kill the host buffer (sub-buffers don't own their memory)
+	if(buffer != nullptr && !parent_buffer) {
 		delete [] buffer;
 		buffer = nullptr;
 	}
@@ -178,6 +189,10 @@ bool host_buffer::resize(const compute_queue& cqueue, const size_t& new_size_,
 						 const bool copy_old_data, const bool copy_host_data,
 						 void* new_host_ptr) {
 	if(buffer == nullptr) return false;
+	if(parent_buffer) {
+		log_error("can't resize a sub-buffer!");
+		return false;
+	}
 	if(new_size_ == 0) {
 		log_error("can't allocate a buffer of size 0!");
 		return false;
@@ -313,4 +328,11 @@ bool host_buffer::release_opengl_object(const compute_queue* cqueue floor_unused
 	return true;
 }
 
+shared_ptr<compute_buffer> host_buffer::create_sub_buffer(const compute_queue& cqueue, const size_t& offset, const size_t& sub_size) const {
+	if(buffer == nullptr) return {};
+	auto parent = sub_buffer_check(offset, sub_size);
+	if(!parent) return {};
+	return make_shared<host_buffer>(cqueue, static_pointer_cast<const host_buffer>(move(parent)), offset, sub_size);
+}
+
 #endif
@@ -58,6 +58,12 @@ public:
 													COMPUTE_MEMORY_FLAG::HOST_READ_WRITE),
 				const uint32_t opengl_type_ = 0) :
 	host_buffer(cqueue, sizeof(data_type) * n, (void*)&data[0], flags_, opengl_type_) {}
+	
+	//! constructs a sub-buffer of "parent" (see create_sub_buffer), which holds a reference to "parent"
+	host_buffer(const compute_queue& cqueue,
+				shared_ptr<const host_buffer> parent,
+				const size_t& offset,
+				const size_t& size_);
 
 	~host_buffer() override;
 
@@ -91,6 +97,11 @@ public:
 	bool acquire_opengl_object(const compute_queue* cqueue) override;
 	bool release_opengl_object(const compute_queue* cqueue) override;
 	
+	shared_ptr<compute_buffer> create_sub_buffer(const compute_queue& cqueue, const size_t& offset, const size_t& size) const override;
+	
+	//! keep the alignment of get_host_buffer_ptr()
+	size_t get_sub_buffer_alignment() const override { return 128u; }
+	
 	//! returns a direct pointer to the internal host buffer
 	uint8_t* __attribute__((aligned(128))) get_host_buffer_ptr() const {
 		return buffer;
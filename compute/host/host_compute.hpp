@@ -77,6 +77,8 @@ public:
 										   const COMPUTE_MEMORY_FLAG flags = (COMPUTE_MEMORY_FLAG::READ_WRITE |
 																			  COMPUTE_MEMORY_FLAG::HOST_READ_WRITE)) const override;
 	
+	bool has_sub_buffer_support() const override { return true; }
+	
 	//////////////////////////////////////////
 	// image creation
 	
@@ -64,6 +64,6 @@ host_device::host_device() : compute_device() {
 	image_offset_read_support = true;
 	image_offset_write_support = true;
 	image_depth_compare_support = true;
-	image_gather_support = false; // for now
+	image_gather_support = true;
 	image_read_write_support = true;
 }
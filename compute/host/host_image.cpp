@@ -49,6 +49,32 @@ compute_image(cqueue, image_dim_, image_type_, host_ptr_, flags_,
 }
 
 bool host_image::create_internal(const bool copy_host_data, const compute_queue& cqueue) {
+	// only BC1 - BC7 and ETC1/ETC2/EAC are decoded on the host (no PVRTC/ASTC), and only for 2D/cube images
+	if(image_compressed(image_type)) {
+		const auto compression = (image_type & COMPUTE_IMAGE_TYPE::__COMPRESSION_MASK);
+		if(compression != COMPUTE_IMAGE_TYPE::BC1 &&
+		   compression != COMPUTE_IMAGE_TYPE::BC2 &&
+		   compression != COMPUTE_IMAGE_TYPE::BC3 &&
+		   compression != COMPUTE_IMAGE_TYPE::RGTC &&
+		   compression != COMPUTE_IMAGE_TYPE::BPTC &&
+		   compression != COMPUTE_IMAGE_TYPE::EAC &&
+		   compression != COMPUTE_IMAGE_TYPE::ETC2) {
+			log_error("unsupported compressed image format (only BC1 - BC7 and ETC1/ETC2/EAC are supported): %X", image_type);
+			return false;
+		}
+		// EAC: R11/RG11 or ETC1 RGB, ETC2: RGB or RGBA
+		const auto channel_count = image_channel_count(image_type);
+		if((compression == COMPUTE_IMAGE_TYPE::EAC && channel_count > 3) ||
+		   (compression == COMPUTE_IMAGE_TYPE::ETC2 && channel_count < 3)) {
+			log_error("unsupported ETC/EAC channel count %u: %X", channel_count, image_type);
+			return false;
+		}
+		if(image_dim_count(image_type) != 2) {
+			log_error("compressed images must be 2D or cube images");
+			return false;
+		}
+	}
+	
 	image = new uint8_t[image_data_size_mip_maps + protection_size] alignas(1024);
 	program_info.buffer = image;
 	program_info.runtime_image_type = image_type;
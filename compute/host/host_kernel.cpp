@@ -484,6 +484,8 @@ static void floor_set_thread_affinity(const uint32_t& affinity) {
 
 // id handling vars
 uint32_t floor_work_dim { 1u };
+// decoded compressed image block caches are invalidated whenever this changes
+uint32_t floor_host_image_epoch { 0u };
 uint3 floor_global_work_size;
 static uint32_t floor_linear_global_work_size;
 uint3 floor_local_work_size;
@@ -564,30 +566,79 @@ void host_kernel::execute(const compute_queue& cqueue,
 		return;
 	}
 	
-	// only a single kernel can be active/executed at one time
-	static safe_mutex exec_lock {};
-	GUARD(exec_lock);
-	
-	vector<const void*> vptr_args;
-	vptr_args.reserve(args.size());
-	for (const auto& arg : args) {
-		if (auto buf_ptr = get_if<const compute_buffer*>(&arg.var)) {
-			vptr_args.emplace_back(((const host_buffer*)(*buf_ptr))->get_host_buffer_ptr());
-		} else if (auto img_ptr = get_if<const compute_image*>(&arg.var)) {
-			vptr_args.emplace_back(((const host_image*)(*img_ptr))->get_host_image_program_info());
-		} else if (auto vec_img_ptrs = get_if<const vector<compute_image*>*>(&arg.var)) {
-			log_error("array of images is not supported for Host-Compute");
-			return;
-		} else if (auto vec_img_sptrs = get_if<const vector<shared_ptr<compute_image>>*>(&arg.var)) {
-			log_error("array of images is not supported for Host-Compute");
-			return;
-		} else if (auto generic_arg_ptr = get_if<const void*>(&arg.var)) {
-			vptr_args.emplace_back(*generic_arg_ptr);
-		} else {
-			log_error("encountered invalid arg");
+	vector<const void*> vptr_args(args.size(), nullptr);
+	for (size_t i = 0, count = args.size(); i < count; ++i) {
+		if (!resolve_arg(args[i], vptr_args[i])) {
 			return;
 		}
 	}
+	execute_resolved(cqueue, dim, global_work_size, local_work_size, vptr_args);
+}
+
+bool host_kernel::resolve_arg(const compute_kernel_arg& arg, const void*& vptr_arg) {
+	if (auto buf_ptr = get_if<const compute_buffer*>(&arg.var)) {
+		vptr_arg = ((const host_buffer*)(*buf_ptr))->get_host_buffer_ptr();
+	} else if (auto img_ptr = get_if<const compute_image*>(&arg.var)) {
+		vptr_arg = ((const host_image*)(*img_ptr))->get_host_image_program_info();
+	} else if (auto vec_img_ptrs = get_if<const vector<compute_image*>*>(&arg.var)) {
+		log_error("array of images is not supported for Host-Compute");
+		return false;
+	} else if (auto vec_img_sptrs = get_if<const vector<shared_ptr<compute_image>>*>(&arg.var)) {
+		log_error("array of images is not supported for Host-Compute");
+		return false;
+	} else if (auto generic_arg_ptr = get_if<const void*>(&arg.var)) {
+		vptr_arg = *generic_arg_ptr;
+	} else {
+		log_error("encountered invalid arg");
+		return false;
+	}
+	return true;
+}
+
+bool host_kernel::host_bound_args::update(const compute_device& dev) {
+	if (prepared_device != &dev) {
+		// resolve all
+		vptr_args.assign(args.size(), nullptr);
+		valid.assign(args.size(), false);
+		for (size_t i = 0, count = args.size(); i < count; ++i) {
+			valid[i] = resolve_arg(args[i], vptr_args[i]);
+		}
+		prepared_device = &dev;
+	} else {
+		// only resolve modified args again
+		for (const auto& idx : modified_args) {
+			valid[idx] = resolve_arg(args[idx], vptr_args[idx]);
+		}
+	}
+	modified_args.clear();
+	return all_of(cbegin(valid), cend(valid), [](const bool is_valid) { return is_valid; });
+}
+
+unique_ptr<compute_kernel_bound_args> host_kernel::bind_args(vector<compute_kernel_arg>&& args) const {
+	return make_unique<host_bound_args>(*this, move(args));
+}
+
+void host_kernel::execute_bound(const compute_queue& cqueue,
+								compute_kernel_bound_args& bound_args,
+								const uint32_t& dim,
+								const uint3& global_work_size,
+								const uint3& local_work_size) const {
+	// NOTE: bound args are always created by bind_args() above
+	auto& host_args = (host_bound_args&)bound_args;
+	if (!host_args.update(cqueue.get_device())) {
+		return;
+	}
+	execute_resolved(cqueue, dim, global_work_size, local_work_size, host_args.vptr_args);
+}
+
+void host_kernel::execute_resolved(const compute_queue& cqueue,
+								   const uint32_t& dim,
+								   const uint3& global_work_size,
+								   const uint3& local_work_size,
+								   const vector<const void*>& vptr_args) const {
+	// only a single kernel can be active/executed at one time
+	static safe_mutex exec_lock {};
+	GUARD(exec_lock);
 	
 	static function<void()> kernel_func;
 	switch (vptr_args.size()) {
@@ -657,6 +708,23 @@ void host_kernel::execute(const compute_queue& cqueue,
 	cur_kernel_function = nullptr;
 }
 
+void host_kernel::execute_indirect(const compute_queue& cqueue,
+								   const uint32_t& dim,
+								   const compute_buffer& indirect_buffer,
+								   const size_t& indirect_offset,
+								   const uint3& local_work_size,
+								   const vector<compute_kernel_arg>& args) const {
+	if(indirect_offset + sizeof(uint3) > indirect_buffer.get_size()) {
+		log_error("indirect work-group count offset is out of bounds");
+		return;
+	}
+	
+	// everything is executed synchronously -> can directly read the work-group count
+	uint3 group_count;
+	memcpy(&group_count, ((const host_buffer&)indirect_buffer).get_host_buffer_ptr() + indirect_offset, sizeof(group_count));
+	execute_group_count(cqueue, dim, group_count, local_work_size, args);
+}
+
 void host_kernel::execute_internal(const compute_queue& cqueue,
 								   const uint32_t work_dim,
 								   const uint3 global_work_size,
@@ -684,6 +752,7 @@ void host_kernel::execute_internal(const compute_queue& cqueue,
 	
 	// setup id handling
 	floor_work_dim = work_dim;
+	++floor_host_image_epoch;
 	floor_global_work_size = global_work_size;
 	floor_local_work_size = local_dim;
 	
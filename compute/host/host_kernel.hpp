@@ -57,6 +57,20 @@ public:
 				 const uint3& local_work_size,
 				 const vector<compute_kernel_arg>& args) const override;
 	
+	//! reads the work-group count directly from host memory
+	void execute_indirect(const compute_queue& cqueue,
+						  const uint32_t& dim,
+						  const compute_buffer& indirect_buffer,
+						  const size_t& indirect_offset,
+						  const uint3& local_work_size,
+						  const vector<compute_kernel_arg>& args) const override;
+	
+	void execute_bound(const compute_queue& cqueue,
+					   compute_kernel_bound_args& bound_args,
+					   const uint32_t& dim,
+					   const uint3& global_work_size,
+					   const uint3& local_work_size) const override;
+	
 	const kernel_entry* get_kernel_entry(const compute_device&) const override {
 		return &entry; // can't really check if the device is correct here
 	}
@@ -69,6 +83,28 @@ protected:
 	
 	COMPUTE_TYPE get_compute_type() const override { return COMPUTE_TYPE::HOST; }
 	
+	//! bound args with already resolved host pointers of all arguments
+	struct host_bound_args final : public compute_kernel_bound_args {
+		using compute_kernel_bound_args::compute_kernel_bound_args;
+		
+		vector<const void*> vptr_args;
+		vector<bool> valid;
+		
+		//! (re-)resolves all arguments if necessary, or only the modified ones, returns false if any argument is invalid
+		bool update(const compute_device& dev);
+	};
+	unique_ptr<compute_kernel_bound_args> bind_args(vector<compute_kernel_arg>&& args) const override;
+	
+	//! resolves the host pointer of the specified argument, returns false if the argument is not supported
+	static bool resolve_arg(const compute_kernel_arg& arg, const void*& vptr_arg);
+	
+	//! executes this kernel with the specified resolved arguments
+	void execute_resolved(const compute_queue& cqueue,
+						  const uint32_t& dim,
+						  const uint3& global_work_size,
+						  const uint3& local_work_size,
+						  const vector<const void*>& vptr_args) const;
+	
 	void execute_internal(const compute_queue& cqueue,
 						  const uint32_t work_dim,
 						  const uint3 global_work_size,
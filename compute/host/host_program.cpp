@@ -32,6 +32,11 @@ host_program::host_program(const compute_device& device_) : device(device_) {
 }
 
 shared_ptr<compute_kernel> host_program::get_kernel(const string& func_name) const {
+	// already retrieved?
+	if(auto kernel = compute_program::get_kernel(func_name); kernel) {
+		return kernel;
+	}
+	
 #if !defined(__WINDOWS__)
 FLOOR_PUSH_WARNINGS()
 FLOOR_IGNORE_WARNING(zero-as-null-pointer-constant) // RTLD_DEFAULT is implementation-defined, but cast from int to void*
@@ -65,7 +70,7 @@ FLOOR_POP_WARNINGS()
 	
 	auto kernel = make_shared<host_kernel>((const void*)func_ptr, func_name, move(entry));
 	kernels.emplace_back(kernel);
-	kernel_names.emplace_back(func_name);
+	add_kernel_name(func_name);
 	
 	return kernel;
 }
@@ -19,6 +19,7 @@
 #include <floor/compute/host/host_queue.hpp>
 
 #if !defined(FLOOR_NO_HOST_COMPUTE)
+#include <floor/compute/compute_event.hpp>
 
 host_queue::host_queue(const compute_device& device_) : compute_queue(device_) {
 }
@@ -31,6 +32,14 @@ void host_queue::flush() const {
 	// nop
 }
 
+shared_ptr<compute_event> host_queue::record_event() const {
+	return make_shared<compute_signaled_event>();
+}
+
+void host_queue::wait_for_event(const compute_event& evt floor_unused) const {
+	// nop: all events are already signaled
+}
+
 const void* host_queue::get_queue_ptr() const {
 	return this;
 }
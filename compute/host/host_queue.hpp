@@ -33,6 +33,10 @@ public:
 	void finish() const override;
 	void flush() const override;
 	
+	//! everything is executed synchronously -> events are always signaled right away
+	shared_ptr<compute_event> record_event() const override;
+	void wait_for_event(const compute_event& evt) const override;
+	
 	const void* get_queue_ptr() const override;
 	void* get_queue_ptr() override;
 	
@@ -18,6 +18,7 @@
 
 #include <floor/compute/llvm_toolchain.hpp>
 #include <floor/floor/floor.hpp>
+#include <floor/constexpr/sha_256.hpp>
 #include <regex>
 #include <climits>
 
@@ -30,6 +31,17 @@
 #include <floor/darwin/darwin_helper.hpp>
 #endif
 
+#if defined(__linux__) && !defined(__WINDOWS__)
+#include <sys/mman.h> // memfd_create
+#include <fcntl.h>
+#endif
+
+#include <sys/stat.h>
+#include <errno.h>
+#if !defined(__WINDOWS__)
+#include <unistd.h> // geteuid
+#endif
+
 namespace llvm_toolchain {
 
 bool create_floor_function_info(const string& ffi_file_name,
@@ -118,9 +130,412 @@ bool create_floor_function_info(const string& ffi_file_name,
 	return true;
 }
 
+bool prepare_cache_directory() {
+	static const bool is_usable = []() {
+		auto path = floor::get_toolchain_cache_path();
+		while(path.size() > 1 && (path.back() == '/' || path.back() == '\\')) {
+			path.pop_back();
+		}
+#if !defined(__WINDOWS__)
+		// create all missing directories with 0700 (existing parent directories are left untouched)
+		for(size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+			const auto dir = path.substr(0, pos);
+			if(!file_io::is_directory(dir) && mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+				log_error("failed to create toolchain cache directory %s: %s", dir, strerror(errno));
+				return false;
+			}
+			if(pos == string::npos) break;
+		}
+		
+		// must be a directory (not a symlink to one), owned by us and not writable by anyone else
+		struct stat dir_stat {};
+		if(lstat(path.c_str(), &dir_stat) != 0 || !S_ISDIR(dir_stat.st_mode)) {
+			log_error("toolchain cache path %s is not a directory - disabling the toolchain cache", path);
+			return false;
+		}
+		if(dir_stat.st_uid != geteuid()) {
+			log_error("toolchain cache directory %s is not owned by the current user - disabling the toolchain cache", path);
+			return false;
+		}
+		if((dir_stat.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+			log_error("toolchain cache directory %s is writable by other users - disabling the toolchain cache", path);
+			return false;
+		}
+		return true;
+#else
+		if(!file_io::create_directory(path)) {
+			log_error("failed to create toolchain cache directory: %s", path);
+			return false;
+		}
+		return true;
+#endif
+	}();
+	return is_usable;
+}
+
+//! on-disk compile cache
+//! every entry is identified by the SHA-256 of the complete compiler invocation (this includes the source code
+//! or source file name, all device capability defines and the toolchain version) plus the identity of the used
+//! compiler binaries (path, size and modification time), and consists of:
+//!  * <key>.deps: "<SHA-256> <file name>" of each source file and header the program depends on
+//!  * <key>.ffi: the floor function info of the program
+//!  * <key>.bin: the compiled program binary
+//! an entry is only used if all dependencies still have the same contents
+//! NOTE: the cache directory is created with 0700 and is only used if it is owned by the current user and not
+//!       writable by anyone else (cached binaries are loaded and executed without any further verification)
+namespace compile_cache {
+	//! must be updated if the layout or contents of cache entries change
+	static constexpr const char cache_version[] { "2" };
+	
+	static string hash_to_string(const sha_256::hash_t& hash) {
+		static constexpr const char hex_chars[] { "0123456789ABCDEF" };
+		string ret(sha_256::SHA_256_BLOCK_SIZE * 2u, '0');
+		for(size_t i = 0; i < sha_256::SHA_256_BLOCK_SIZE; ++i) {
+			ret[i * 2u] = hex_chars[hash.hash[i] >> 4u];
+			ret[i * 2u + 1u] = hex_chars[hash.hash[i] & 0xFu];
+		}
+		return ret;
+	}
+	
+	//! hashes the contents of the specified file, returns an empty string on failure
+	static string hash_file(const string& file_name) {
+		if(!file_io::is_file(file_name)) return {};
+		auto file = file_io::map_file(file_name);
+		if(!file) return {};
+		return hash_to_string(sha_256::compute_hash_fast(file->data(), file->size()));
+	}
+	
+	//! returns the cache entry path prefix for the specified key (i.e. without file extension)
+	static string entry_path(const string& key) {
+		return floor::get_toolchain_cache_path() + key;
+	}
+	
+	//! returns the identity of the specified compiler binary (path, size and modification time),
+	//! so that updating/replacing the compiler invalidates all of its cache entries
+	static string compiler_identity(const string& compiler_path) {
+		struct stat compiler_stat {};
+		if(stat(compiler_path.c_str(), &compiler_stat) != 0) {
+			return compiler_path + " <unknown>";
+		}
+		return compiler_path + ' ' + to_string(compiler_stat.st_size) + ' ' + to_string(compiler_stat.st_mtime);
+	}
+	
+	//! returns the identity of all compiler binaries used for the specified target
+	static string toolchain_identity(const TARGET target) {
+		switch(target) {
+			case TARGET::SPIR:
+			case TARGET::SPIRV_OPENCL:
+				return compiler_identity(floor::get_opencl_compiler());
+			case TARGET::PTX:
+				// PTX is additionally compiled by llc
+				return compiler_identity(floor::get_cuda_compiler()) + '\n' + compiler_identity(floor::get_cuda_llc());
+			case TARGET::AIR:
+				return compiler_identity(floor::get_metal_compiler());
+			case TARGET::SPIRV_VULKAN:
+				return compiler_identity(floor::get_vulkan_compiler());
+		}
+		floor_unreachable();
+	}
+	
+	//! computes the cache key for the specified compiler invocation
+	//! NOTE: any temporary file names must have been removed from "cmd" already
+	static string compute_key(const string& cmd, const TARGET target) {
+		const auto key_data = "floor-compile-cache-v"s + cache_version + '\n' + toolchain_identity(target) + '\n' + cmd;
+		return hash_to_string(sha_256::compute_hash_fast((const uint8_t*)key_data.data(), key_data.size()));
+	}
+	
+	//! parses a make-style dependency file (as written by clang -MD) and returns all dependencies
+	static vector<string> parse_dep_file(const string& dep_file_name) {
+		string dep_data;
+		if(!file_io::file_to_string(dep_file_name, dep_data)) {
+			return {};
+		}
+		
+		// skip the target ("<target>: "), note that the target file name may contain ':' (windows)
+		size_t pos = 0;
+		for(const auto len = dep_data.size(); pos + 1 < len; ++pos) {
+			if(dep_data[pos] == ':' && (dep_data[pos + 1] == ' ' || dep_data[pos + 1] == '\n' ||
+										dep_data[pos + 1] == '\r' || dep_data[pos + 1] == '\t')) {
+				break;
+			}
+		}
+		if(pos + 1 >= dep_data.size()) {
+			return {};
+		}
+		++pos;
+		
+		vector<string> deps;
+		string cur_dep;
+		const auto flush_dep = [&deps, &cur_dep]() {
+			if(!cur_dep.empty()) {
+				deps.emplace_back(move(cur_dep));
+				cur_dep.clear();
+			}
+		};
+		for(const auto len = dep_data.size(); pos < len; ++pos) {
+			const auto ch = dep_data[pos];
+			if(ch == '\\' && pos + 1 < len) {
+				const auto next_ch = dep_data[pos + 1];
+				if(next_ch == ' ' || next_ch == '#') {
+					// escaped char
+					cur_dep += next_ch;
+					++pos;
+					continue;
+				}
+				if(next_ch == '\n' || next_ch == '\r') {
+					// line continuation
+					flush_dep();
+					continue;
+				}
+			}
+			else if(ch == '$' && pos + 1 < len && dep_data[pos + 1] == '$') {
+				cur_dep += '$';
+				++pos;
+				continue;
+			}
+			if(ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+				flush_dep();
+				continue;
+			}
+			cur_dep += ch;
+		}
+		flush_dep();
+		return deps;
+	}
+	
+	//! tries to retrieve the program for the specified key from the cache, returns true on success
+	//! NOTE: for SPIR-V and AIR targets, the cached binary is written to a new temporary file (as is done when compiling)
+	static bool lookup(const string& key,
+					   const TARGET target,
+					   const string& output_file_type,
+					   const uint32_t toolchain_version,
+					   program_data& ret) {
+		if(!prepare_cache_directory()) {
+			return false;
+		}
+		
+		const auto path = entry_path(key);
+		string deps_data;
+		if(!file_io::is_file(path + ".deps") ||
+		   !file_io::file_to_string(path + ".deps", deps_data)) {
+			return false;
+		}
+		
+		// verify that no dependency has changed
+		vector<string> dependencies;
+		for(const auto& line : core::tokenize(deps_data, '\n')) {
+			if(line.empty()) continue;
+			const auto space_pos = line.find(' ');
+			if(space_pos == string::npos) return false;
+			dependencies.emplace_back(line.substr(space_pos + 1));
+			if(hash_file(dependencies.back()) != line.substr(0, space_pos)) {
+				return false;
+			}
+		}
+		
+		vector<function_info> functions;
+		if(!create_floor_function_info(path + ".ffi", functions, toolchain_version)) {
+			return false;
+		}
+		
+		string binary;
+		if(!file_io::file_to_string(path + ".bin", binary)) {
+			return false;
+		}
+		if(target == TARGET::SPIRV_VULKAN ||
+		   target == TARGET::SPIRV_OPENCL ||
+		   target == TARGET::AIR) {
+			auto binary_file_name = core::create_tmp_file_name("", '.' + output_file_type);
+			if(!file_io::string_to_file(binary_file_name, binary)) {
+				return false;
+			}
+			binary.swap(binary_file_name);
+		}
+		
+		ret.valid = true;
+		ret.data_or_filename = move(binary);
+		ret.functions = move(functions);
+		ret.dependencies = move(dependencies);
+		return true;
+	}
+	
+	//! writes the compiled program to the cache
+	static void store(const string& key,
+					  const vector<string>& dependencies,
+					  const string& ffi_data,
+					  const TARGET target,
+					  const string& data_or_filename) {
+		if(!prepare_cache_directory()) {
+			return;
+		}
+		
+		// hash all dependencies
+		string deps_data;
+		for(const auto& dep : dependencies) {
+			const auto dep_hash = hash_file(dep);
+			if(dep_hash.empty()) {
+				return; // can't reliably cache this
+			}
+			deps_data += dep_hash + ' ' + dep + '\n';
+		}
+		
+		string binary;
+		if(target == TARGET::SPIRV_VULKAN ||
+		   target == TARGET::SPIRV_OPENCL ||
+		   target == TARGET::AIR) {
+			if(!file_io::file_to_string(data_or_filename, binary)) {
+				return;
+			}
+		}
+		
+		// write the deps file last (after a rename), so that incomplete entries are never used,
+		// even if another process is accessing the cache at the same time
+		const auto path = entry_path(key);
+		remove((path + ".deps").c_str());
+		const auto tmp_deps_file_name = path + ".deps." + to_string(core::rand<uint32_t>());
+		if(!file_io::string_to_file(path + ".ffi", ffi_data) ||
+		   !file_io::buffer_to_file(path + ".bin",
+									binary.empty() ? data_or_filename.data() : binary.data(),
+									binary.empty() ? data_or_filename.size() : binary.size()) ||
+		   !file_io::string_to_file(tmp_deps_file_name, deps_data) ||
+		   rename(tmp_deps_file_name.c_str(), (path + ".deps").c_str()) != 0) {
+			log_error("failed to write compile cache entry %s", path);
+			return;
+		}
+	}
+}
+
+#if !defined(__WINDOWS__) && !defined(FLOOR_IOS)
+//! if true, the compiler and all other tools are directly spawned (no shell) and communicate through pipes
+static constexpr const bool use_spawn_process { true };
+#else
+static constexpr const bool use_spawn_process { false };
+#endif
+
+//! splits a shell-like command line into its arguments (handles single/double quotes and escaped chars)
+static vector<string> split_command_line(const string& cmd) {
+	vector<string> args;
+	string cur_arg;
+	bool has_arg = false;
+	char quote_char = 0;
+	for(size_t i = 0, len = cmd.size(); i < len; ++i) {
+		const auto ch = cmd[i];
+		if(quote_char != 0) {
+			if(ch == quote_char) {
+				quote_char = 0;
+			}
+			else if(ch == '\\' && quote_char == '"' && i + 1 < len && (cmd[i + 1] == '"' || cmd[i + 1] == '\\')) {
+				cur_arg += cmd[++i];
+			}
+			else {
+				cur_arg += ch;
+			}
+			continue;
+		}
+		
+		if(ch == '"' || ch == '\'') {
+			quote_char = ch;
+			has_arg = true;
+		}
+		else if(ch == '\\' && i + 1 < len) {
+			cur_arg += cmd[++i];
+			has_arg = true;
+		}
+		else if(ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+			if(has_arg) {
+				args.emplace_back(move(cur_arg));
+				cur_arg.clear();
+				has_arg = false;
+			}
+		}
+		else {
+			cur_arg += ch;
+			has_arg = true;
+		}
+	}
+	if(has_arg) {
+		args.emplace_back(move(cur_arg));
+	}
+	return args;
+}
+
+//! file that is written by the compiler and read back afterwards (function info, dependencies)
+//! NOTE: when the compiler is spawned directly on Linux, this is an anonymous in-memory file (memfd) that is only passed on
+//!       to the compiler process (at the fixed fd "compiler_fd", accessed via /dev/fd/N), otherwise or with keep_temp set,
+//!       this is a temporary file (removed on destruction unless keep_temp is set)
+struct compiler_output_file {
+	//! fixed fds of the output files in the compiler process
+	static constexpr const int function_info_compiler_fd { 3 };
+	static constexpr const int dependencies_compiler_fd { 4 };
+	
+	//! path of the file in this process
+	string path;
+	//! path of the file in the compiler process
+	string compiler_path;
+	//! memfd in this process
+	int fd { -1 };
+	//! fd of the memfd in the compiler process
+	int compiler_fd { -1 };
+	
+	compiler_output_file(const char* prefix, const char* suffix,
+						 const bool spawn_compiler floor_unused, const int compiler_fd_ floor_unused) {
+#if defined(__linux__) && !defined(__WINDOWS__)
+		if(spawn_compiler && !floor::get_toolchain_keep_temp()) {
+			// MFD_CLOEXEC: must not be inherited by any other process that is spawned at the same time,
+			// the compiler process gets it explicitly via dup2
+			fd = memfd_create(prefix, MFD_CLOEXEC);
+			if(fd >= 0 && fd <= dependencies_compiler_fd) {
+				// dup2 onto the same fd would leave FD_CLOEXEC set -> move it out of the way
+				const auto moved_fd = fcntl(fd, F_DUPFD_CLOEXEC, dependencies_compiler_fd + 1);
+				close(fd);
+				fd = moved_fd;
+			}
+			if(fd >= 0) {
+				path = "/dev/fd/" + to_string(fd);
+				compiler_fd = compiler_fd_;
+				compiler_path = "/dev/fd/" + to_string(compiler_fd);
+				return;
+			}
+		}
+#endif
+		path = core::create_tmp_file_name(prefix, suffix);
+		compiler_path = path;
+	}
+	~compiler_output_file() {
+#if defined(__linux__) && !defined(__WINDOWS__)
+		if(fd >= 0) {
+			close(fd);
+			return;
+		}
+#endif
+		if(!floor::get_toolchain_keep_temp()) {
+			remove(path.c_str());
+		}
+	}
+	compiler_output_file(const compiler_output_file&) = delete;
+	compiler_output_file& operator=(const compiler_output_file&) = delete;
+	
+	//! adds the <fd in this process, fd in the compiler process> mapping of this file (if it is a memfd)
+	void add_fd_mapping(vector<pair<int, int>>& fd_mappings) const {
+		if(fd >= 0) {
+			fd_mappings.emplace_back(fd, compiler_fd);
+		}
+	}
+};
+
+static program_data compile_input_internal(const string& input,
+										   const string& cmd_prefix,
+										   const string* input_data,
+										   const compute_device& device,
+										   const compile_options options);
+
 program_data compile_program(const compute_device& device,
 							 const string& code,
 							 const compile_options options) {
+	if(use_spawn_process) {
+		// directly pipe the code into the compiler
+		return compile_input_internal("-", "", &code, device, options);
+	}
 	const string printable_code { "printf \"" + core::str_hex_escape(code) + "\" | " };
 	return compile_input("-", printable_code, device, options);
 }
@@ -135,6 +550,17 @@ program_data compile_input(const string& input,
 						   const string& cmd_prefix,
 						   const compute_device& device,
 						   const compile_options options) {
+	return compile_input_internal(input, cmd_prefix, nullptr, device, options);
+}
+
+static program_data compile_input_internal(const string& input,
+										   const string& cmd_prefix,
+										   const string* input_data,
+										   const compute_device& device,
+										   const compile_options options) {
+	// a command prefix must always be run through the shell
+	const bool spawn_compiler = (use_spawn_process && cmd_prefix.empty());
+	
 	// create the initial clang compilation command
 	string clang_cmd = cmd_prefix;
 	string libcxx_path = " -isystem \"", clang_path = " -isystem \"", floor_path = " -isystem \"";
@@ -701,8 +1127,8 @@ program_data compile_input(const string& input,
 	}
 	
 	// floor function info
-	const auto function_info_file_name = core::create_tmp_file_name("ffi", ".txt");
-	clang_cmd += " -Xclang -floor-function-info=" + function_info_file_name;
+	const compiler_output_file function_info_file { "ffi", ".txt", spawn_compiler, compiler_output_file::function_info_compiler_fd };
+	clang_cmd += " -Xclang -floor-function-info=" + function_info_file.compiler_path;
 	
 	// target specific compute info
 	switch(options.target) {
@@ -757,7 +1183,10 @@ program_data compile_input(const string& input,
 	};
 	
 	// add generic flags/options that are always used
-	auto compiled_file_or_code = core::create_tmp_file_name("", '.' + output_file_type);
+	// SPIR and PTX binaries are directly written to stdout when the compiler is spawned (no temporary file needed),
+	// SPIR-V and AIR binaries are always written to a file, which is then handed to the backend
+	const bool output_to_pipe = (spawn_compiler && (options.target == TARGET::SPIR || options.target == TARGET::PTX));
+	auto compiled_file_or_code = (output_to_pipe ? "-"s : core::create_tmp_file_name("", '.' + output_file_type));
 	clang_cmd += {
 #if defined(FLOOR_DEBUG)
 		" -DFLOOR_DEBUG"
@@ -774,16 +1203,70 @@ program_data compile_input(const string& input,
 		" -m64 -emit-llvm -c -o " + compiled_file_or_code + " " + input
 	};
 	
-	// on sane systems, redirect errors to stdout so that we can grab them
-#if !defined(_MSC_VER)
-	clang_cmd += " 2>&1";
-#endif
+	// check the compile cache first
+	// NOTE: the compile command already contains all device and toolchain specific information (plus source code or file name)
+	const bool use_compile_cache = floor::get_toolchain_use_cache();
+	string cache_key;
+	unique_ptr<compiler_output_file> dep_file;
+	if(use_compile_cache) {
+		// temporary file names differ for each invocation -> replace them
+		auto key_cmd = clang_cmd;
+		core::find_and_replace(key_cmd, function_info_file.compiler_path, "<ffi>");
+		if(!output_to_pipe) {
+			core::find_and_replace(key_cmd, compiled_file_or_code, "<output>");
+		}
+		if(input_data != nullptr) {
+			// code that is piped into the compiler is not part of the command
+			key_cmd += '\n' + *input_data;
+		}
+		cache_key = compile_cache::compute_key(key_cmd, options.target);
+		
+		program_data cached_program;
+		if(compile_cache::lookup(cache_key, options.target, output_file_type, toolchain_version, cached_program)) {
+			if(floor::get_toolchain_log_commands() &&
+			   !options.silence_debug_output) {
+				log_debug("using cached program %s for cmd: %s", cache_key, clang_cmd);
+			}
+			cached_program.options = options;
+			return cached_program;
+		}
+	}
+	
+	// let clang write out all dependencies, so that the cache entry can later be validated and/or the caller can track them
+	if(use_compile_cache || options.collect_dependencies) {
+		dep_file = make_unique<compiler_output_file>("deps", ".d", spawn_compiler, compiler_output_file::dependencies_compiler_fd);
+		clang_cmd += " -MD -MF " + dep_file->compiler_path;
+	}
 	
 	// compile
 	string compilation_output = "";
-	core::system(clang_cmd, compilation_output);
-	// check if the output contains an error string (yes, a bit ugly, but it works for now - can't actually check the return code)
-	if(compilation_output.find(" error: ") != string::npos ||
+	string compiled_data = ""; // only used with output_to_pipe
+	int compile_exit_code = 0;
+	if(spawn_compiler) {
+		// only the output files are passed on to the compiler
+		vector<pair<int, int>> fd_mappings;
+		function_info_file.add_fd_mapping(fd_mappings);
+		if(dep_file) {
+			dep_file->add_fd_mapping(fd_mappings);
+		}
+		compile_exit_code = core::spawn_process(split_command_line(clang_cmd), compiled_data, compilation_output,
+												input_data != nullptr ? *input_data : "", fd_mappings);
+		if(!output_to_pipe) {
+			// not expected to contain anything, but don't lose it either
+			compilation_output += compiled_data;
+			compiled_data.clear();
+		}
+	}
+	else {
+		// on sane systems, redirect errors to stdout so that we can grab them
+#if !defined(_MSC_VER)
+		clang_cmd += " 2>&1";
+#endif
+		core::system(clang_cmd, compilation_output);
+	}
+	// check if the output contains an error string (when running through the shell, we can't actually check the return code)
+	if(compile_exit_code != 0 ||
+	   compilation_output.find(" error: ") != string::npos ||
 	   compilation_output.find(" errors:") != string::npos) {
 		log_error("compilation failed! failed cmd was:\n%s", clang_cmd);
 		log_error("compilation errors:\n%s", compilation_output);
@@ -801,25 +1284,31 @@ program_data compile_input(const string& input,
 	
 	// grab floor function info and create the internal per-function info
 	vector<function_info> functions;
-	if(!create_floor_function_info(function_info_file_name, functions, toolchain_version)) {
+	if(!create_floor_function_info(function_info_file.path, functions, toolchain_version)) {
 		log_error("failed to create internal floor function info");
 		return {};
 	}
-	if(!floor::get_toolchain_keep_temp()) {
-		core::system("rm " + function_info_file_name);
+	string function_info_data;
+	if(use_compile_cache) {
+		file_io::file_to_string(function_info_file.path, function_info_data);
 	}
 	
 	// final target specific processing/compilation
 	if(options.target == TARGET::SPIR) {
 		string spir_bc_data = "";
-		if(!file_io::file_to_string(compiled_file_or_code, spir_bc_data)) {
-			log_error("failed to read SPIR 1.2 .bc file");
-			return {};
+		if(output_to_pipe) {
+			spir_bc_data.swap(compiled_data);
 		}
-		
-		// cleanup
-		if(!floor::get_toolchain_keep_temp()) {
-			core::system("rm " + compiled_file_or_code);
+		else {
+			if(!file_io::file_to_string(compiled_file_or_code, spir_bc_data)) {
+				log_error("failed to read SPIR 1.2 .bc file");
+				return {};
+			}
+			
+			// cleanup
+			if(!floor::get_toolchain_keep_temp()) {
+				remove(compiled_file_or_code.c_str());
+			}
 		}
 		
 		// move spir data
@@ -830,22 +1319,32 @@ program_data compile_input(const string& input,
 	}
 	else if(options.target == TARGET::PTX) {
 		// compile llvm ir to ptx
-		const string llc_cmd {
+		// NOTE: when piping, the LLVM IR is directly fed into llc via stdin ("-" input)
+		string llc_cmd {
 			"\"" + floor::get_cuda_llc() + "\"" +
 			" -nvptx-fma-level=2 -nvptx-sched4reg -enable-unsafe-fp-math" \
 			" -mcpu=sm_" + sm_version + " -mattr=ptx" + to_string(ptx_version) +
 			(toolchain_version >= 80000 && options.cuda.short_ptr ? " -nvptx-short-ptr" : "") +
 			" -o - " + compiled_file_or_code
-#if !defined(_MSC_VER)
-			+ " 2>&1"
-#endif
 		};
 		if(floor::get_toolchain_log_commands() &&
 		   !options.silence_debug_output) {
 			log_debug("llc cmd: %s", llc_cmd);
 		}
 		string ptx_code = "";
-		core::system(llc_cmd, ptx_code);
+		if(spawn_compiler) {
+			string llc_error_output;
+			if(core::spawn_process(split_command_line(llc_cmd), ptx_code, llc_error_output, compiled_data) != 0) {
+				ptx_code += llc_error_output; // -> fails below
+			}
+			compiled_data.clear();
+		}
+		else {
+#if !defined(_MSC_VER)
+			llc_cmd += " 2>&1";
+#endif
+			core::system(llc_cmd, ptx_code);
+		}
 		ptx_code += '\0'; // make sure there is a \0 terminator
 		
 		// only output the compiled ptx code if this was specified in the config
@@ -861,8 +1360,8 @@ program_data compile_input(const string& input,
 		}
 		
 		// cleanup
-		if(!floor::get_toolchain_keep_temp()) {
-			core::system("rm " + compiled_file_or_code);
+		if(!output_to_pipe && !floor::get_toolchain_keep_temp()) {
+			remove(compiled_file_or_code.c_str());
 		}
 		
 		// move ptx code
@@ -877,14 +1376,21 @@ program_data compile_input(const string& input,
 		
 		// run spirv-val if specified
 		if(validate) {
-			const string spirv_validator_cmd {
-				"\"" + validator + "\" " + compiled_file_or_code
+			string spirv_validator_output = "";
+			if(spawn_compiler) {
+				string spirv_validator_error_output;
+				core::spawn_process({ validator, compiled_file_or_code }, spirv_validator_output, spirv_validator_error_output);
+				spirv_validator_output += spirv_validator_error_output;
+			}
+			else {
+				const string spirv_validator_cmd {
+					"\"" + validator + "\" " + compiled_file_or_code
 #if !defined(_MSC_VER)
-				+ " 2>&1"
+					+ " 2>&1"
 #endif
-			};
-			string spirv_validator_output = "";
-			core::system(spirv_validator_cmd, spirv_validator_output);
+				};
+				core::system(spirv_validator_cmd, spirv_validator_output);
+			}
 			if(!spirv_validator_output.empty() && spirv_validator_output[spirv_validator_output.size() - 1] == '\n') {
 				spirv_validator_output.pop_back(); // trim last newline
 			}
@@ -901,7 +1407,22 @@ program_data compile_input(const string& input,
 		// NOTE: will cleanup the binary in opencl_compute/vulkan_compute
 	}
 	
-	return { true, compiled_file_or_code, functions, options };
+	// NOTE: stdin input has no backing file (code is either part of the cache key or tracked by the caller)
+	vector<string> dependencies;
+	if(dep_file) {
+		dependencies = compile_cache::parse_dep_file(dep_file->path);
+		dependencies.erase(remove_if(dependencies.begin(), dependencies.end(), [](const string& dep) {
+			return (dep == "-" || dep == "<stdin>");
+		}), dependencies.end());
+	}
+	
+	// add to the compile cache
+	if(use_compile_cache) {
+		compile_cache::store(cache_key, dependencies, function_info_data, options.target, compiled_file_or_code);
+	}
+	
+	return { true, compiled_file_or_code, functions, options,
+		(options.collect_dependencies ? move(dependencies) : vector<string> {}) };
 }
 
 } // llvm_toolchain
@@ -198,6 +198,9 @@ namespace llvm_toolchain {
 		//! e.g. OS, CPU features, ...
 		bool ignore_runtime_info { false };
 		
+		//! if true, all files the program depends on (source + headers) are collected in program_data::dependencies
+		bool collect_dependencies { false };
+		
 		//! cuda specific options
 		struct {
 			//! sets the PTX version that should be used (4.3 by default)
@@ -233,6 +236,9 @@ namespace llvm_toolchain {
 		
 		//! the options that were used to compile this program
 		compile_options options;
+		
+		//! all files this program depends on (only set if compile_options::collect_dependencies is set)
+		vector<string> dependencies;
 	};
 	
 	//! compiles a program from a source code string
@@ -255,6 +261,11 @@ namespace llvm_toolchain {
 	bool create_floor_function_info(const string& ffi_file_name,
 									vector<function_info>& functions,
 									const uint32_t toolchain_version);
+	
+	//! creates the toolchain cache directory (floor::get_toolchain_cache_path()) with 0700 if it doesn't exist yet and
+	//! verifies that it is a directory (not a symlink) owned by the current user and not writable by anyone else,
+	//! this is only done once, returns false if the cache directory must not be used
+	bool prepare_cache_directory();
 
 } // llvm_toolchain
 
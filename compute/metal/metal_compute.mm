@@ -643,7 +643,7 @@ static metal_program::metal_program_entry create_metal_program(const metal_devic
 	if(!floor::get_toolchain_keep_temp()) {
 		// cleanup
 		if(!floor::get_toolchain_debug()) {
-			core::system("rm "s + program.data_or_filename);
+			remove(program.data_or_filename.c_str());
 		}
 	}
 	if(!ret.program) {
@@ -497,7 +497,7 @@ bool metal_image::create_internal(const bool copy_host_data, const compute_queue
 			const uint8_t* data_ptr {
 				image_type != shim_image_type ?
 				// need to copy/convert the RGB host data to RGBA
-				rgb_to_rgba(image_type, shim_image_type, cpy_host_ptr, true /* ignore mip levels as we do this manually */) :
+				rgb_to_rgba(image_type, shim_image_type, cpy_host_ptr, nullptr, true /* ignore mip levels as we do this manually */) :
 				// else: can use host ptr directly
 				cpy_host_ptr
 			};
@@ -53,6 +53,14 @@ public:
 				 const uint3& local_work_size,
 				 const vector<compute_kernel_arg>& args) const override;
 	
+	//! natively supported via dispatchThreadgroupsWithIndirectBuffer
+	void execute_indirect(const compute_queue& cqueue,
+						  const uint32_t& dim,
+						  const compute_buffer& indirect_buffer,
+						  const size_t& indirect_offset,
+						  const uint3& local_work_size,
+						  const vector<compute_kernel_arg>& args) const override;
+	
 	const kernel_entry* get_kernel_entry(const compute_device& dev) const override;
 	
 protected:
@@ -62,6 +70,16 @@ protected:
 	
 	typename kernel_map_type::const_iterator get_kernel(const compute_queue& queue) const;
 	
+	//! encodes and commits the dispatch of this kernel with the specified arguments, dispatching either "grid_dim" work-groups,
+	//! or the work-group count that is stored in "indirect_buffer" at "indirect_offset" if "indirect_buffer" is non-nullptr
+	void execute_internal(const compute_queue& cqueue,
+						  typename kernel_map_type::const_iterator kernel_iter,
+						  const uint3& block_dim,
+						  const uint3& grid_dim,
+						  const metal_buffer* indirect_buffer,
+						  const size_t& indirect_offset,
+						  const vector<compute_kernel_arg>& args) const;
+	
 	//! actual kernel argument setters
 	void set_const_argument(metal_encoder& encoder, uint32_t& buffer_idx,
 							const void* ptr, const size_t& size) const;
@@ -269,7 +269,47 @@ void metal_kernel::execute(const compute_queue& cqueue,
 	// check work size (NOTE: will set elements to at least 1)
 	const auto block_dim = check_local_work_size(kernel_iter->second, local_work_size);
 	
-	//
+	const uint3 grid_dim_overflow {
+		dim >= 1 && global_work_size.x > 0 ? std::min(uint32_t(global_work_size.x % block_dim.x), 1u) : 0u,
+		dim >= 2 && global_work_size.y > 0 ? std::min(uint32_t(global_work_size.y % block_dim.y), 1u) : 0u,
+		dim >= 3 && global_work_size.z > 0 ? std::min(uint32_t(global_work_size.z % block_dim.z), 1u) : 0u
+	};
+	uint3 grid_dim { (global_work_size / block_dim) + grid_dim_overflow };
+	grid_dim.max(1u);
+	
+	execute_internal(cqueue, kernel_iter, block_dim, grid_dim, nullptr, 0, args);
+}
+
+void metal_kernel::execute_indirect(const compute_queue& cqueue,
+									const uint32_t& dim floor_unused,
+									const compute_buffer& indirect_buffer,
+									const size_t& indirect_offset,
+									const uint3& local_work_size,
+									const vector<compute_kernel_arg>& args) const {
+	// find entry for queue device
+	const auto kernel_iter = get_kernel(cqueue);
+	if(kernel_iter == kernels.cend()) {
+		log_error("no kernel for this compute queue/device exists!");
+		return;
+	}
+	
+	// NOTE: Metal requires a 4-byte aligned offset
+	if(indirect_offset % 4u != 0u || indirect_offset + sizeof(MTLDispatchThreadgroupsIndirectArguments) > indirect_buffer.get_size()) {
+		log_error("invalid indirect work-group count offset: %u", indirect_offset);
+		return;
+	}
+	
+	execute_internal(cqueue, kernel_iter, check_local_work_size(kernel_iter->second, local_work_size), {},
+					 (const metal_buffer*)&indirect_buffer, indirect_offset, args);
+}
+
+void metal_kernel::execute_internal(const compute_queue& cqueue,
+									typename kernel_map_type::const_iterator kernel_iter,
+									const uint3& block_dim,
+									const uint3& grid_dim,
+									const metal_buffer* indirect_buffer,
+									const size_t& indirect_offset,
+									const vector<compute_kernel_arg>& args) const {
 	auto encoder = create_encoder(cqueue, kernel_iter->second);
 	
 	// set and handle kernel arguments
@@ -302,18 +342,17 @@ void metal_kernel::execute(const compute_queue& cqueue,
 	}
 	
 	// run
-	const uint3 grid_dim_overflow {
-		dim >= 1 && global_work_size.x > 0 ? std::min(uint32_t(global_work_size.x % block_dim.x), 1u) : 0u,
-		dim >= 2 && global_work_size.y > 0 ? std::min(uint32_t(global_work_size.y % block_dim.y), 1u) : 0u,
-		dim >= 3 && global_work_size.z > 0 ? std::min(uint32_t(global_work_size.z % block_dim.z), 1u) : 0u
-	};
-	uint3 grid_dim { (global_work_size / block_dim) + grid_dim_overflow };
-	grid_dim.max(1u);
-	
 	// TODO/NOTE: guarantee that all buffers have finished their prior processing
-	const MTLSize metal_grid_dim { grid_dim.x, grid_dim.y, grid_dim.z };
 	const MTLSize metal_block_dim { block_dim.x, block_dim.y, block_dim.z };
-	[encoder->encoder dispatchThreadgroups:metal_grid_dim threadsPerThreadgroup:metal_block_dim];
+	if(indirect_buffer == nullptr) {
+		const MTLSize metal_grid_dim { grid_dim.x, grid_dim.y, grid_dim.z };
+		[encoder->encoder dispatchThreadgroups:metal_grid_dim threadsPerThreadgroup:metal_block_dim];
+	}
+	else {
+		[encoder->encoder dispatchThreadgroupsWithIndirectBuffer:indirect_buffer->get_metal_buffer()
+											indirectBufferOffset:indirect_offset
+										   threadsPerThreadgroup:metal_block_dim];
+	}
 	[encoder->encoder endEncoding];
 	[encoder->cmd_buffer commit];
 	
@@ -30,57 +30,59 @@ metal_program::metal_program(program_map_type&& programs_) : programs(move(progr
 	retrieve_unique_kernel_names(programs);
 	
 	// create all kernels of all device programs
-	// note that this essentially reshuffles the program "device -> kernels" data to "kernels -> devices"
-	kernels.reserve(kernel_names.size());
-	for(const auto& kernel_name : kernel_names) {
-		metal_kernel::kernel_map_type kernel_map;
-		kernel_map.reserve(kernel_names.size());
-		
-		for(auto& prog : programs) {
-			if(!prog.second.valid) continue;
-			for(const auto& info : prog.second.functions) {
-				if(info.name == kernel_name) {
-					metal_kernel::metal_kernel_entry entry;
-					entry.info = &info;
-					entry.max_local_size = prog.first.get().max_local_size;
-					
-					//
-					const auto func_name = [NSString stringWithUTF8String:info.name.c_str()];
-					id <MTLFunction> func = [prog.second.program newFunctionWithName:func_name];
-					if(!func) {
-						log_error("failed to get function \"%s\" for device \"%s\"", info.name, prog.first.get().name);
-						continue;
-					}
-					
-					NSError* err = nullptr;
-					id <MTLComputePipelineState> kernel_state = nil;
-					if([func functionType] == MTLFunctionTypeKernel) {
-						kernel_state = [[prog.second.program device] newComputePipelineStateWithFunction:func error:&err];
-						if(!kernel_state) {
-							log_error("failed to create kernel state \"%s\" for device \"%s\": %s", info.name, prog.first.get().name,
-									  (err != nullptr ? [[err localizedDescription] UTF8String] : "unknown error"));
-							continue;
-						}
+	// note that this essentially reshuffles the program "device -> kernels" data to "kernels -> devices",
+	// which only requires a single pass over all device functions (kernels are looked up through the kernel index)
+	vector<metal_kernel::kernel_map_type> kernel_maps(kernel_names.size());
+	for(auto& prog : programs) {
+		if(!prog.second.valid) continue;
+		for(const auto& info : prog.second.functions) {
+			// kernel_index contains all function names of all device programs
+			auto& kernel_map = kernel_maps[kernel_index.at(info.name)];
+			if(kernel_map.find(prog.first) != kernel_map.end()) {
+				continue; // only use the first function with this name
+			}
+			
+			metal_kernel::metal_kernel_entry entry;
+			entry.info = &info;
+			entry.max_local_size = prog.first.get().max_local_size;
+			
+			//
+			const auto func_name = [NSString stringWithUTF8String:info.name.c_str()];
+			id <MTLFunction> func = [prog.second.program newFunctionWithName:func_name];
+			if(!func) {
+				log_error("failed to get function \"%s\" for device \"%s\"", info.name, prog.first.get().name);
+				continue;
+			}
+			
+			NSError* err = nullptr;
+			id <MTLComputePipelineState> kernel_state = nil;
+			if([func functionType] == MTLFunctionTypeKernel) {
+				kernel_state = [[prog.second.program device] newComputePipelineStateWithFunction:func error:&err];
+				if(!kernel_state) {
+					log_error("failed to create kernel state \"%s\" for device \"%s\": %s", info.name, prog.first.get().name,
+							  (err != nullptr ? [[err localizedDescription] UTF8String] : "unknown error"));
+					continue;
+				}
 #if defined(FLOOR_DEBUG) || defined(FLOOR_IOS)
-						log_debug("%s (%s): max work-items: %u, simd width: %u, local mem: %u",
-								  info.name, prog.first.get().name,
-								  [kernel_state maxTotalThreadsPerThreadgroup], [kernel_state threadExecutionWidth], [kernel_state staticThreadgroupMemoryLength]);
+				log_debug("%s (%s): max work-items: %u, simd width: %u, local mem: %u",
+						  info.name, prog.first.get().name,
+						  [kernel_state maxTotalThreadsPerThreadgroup], [kernel_state threadExecutionWidth], [kernel_state staticThreadgroupMemoryLength]);
 #endif
-					}
-					
-					// success, insert necessary info/data everywhere
-					prog.second.metal_kernels.emplace_back(metal_program_entry::metal_kernel_data { func, kernel_state });
-					entry.kernel = (__bridge void*)func;
-					entry.kernel_state = (__bridge void*)kernel_state;
-					if(kernel_state != nil) {
-						entry.max_total_local_size = (uint32_t)[kernel_state maxTotalThreadsPerThreadgroup];
-					}
-					kernel_map.insert_or_assign(prog.first.get(), entry);
-					break;
-				}
 			}
+			
+			// success, insert necessary info/data everywhere
+			prog.second.metal_kernels.emplace_back(metal_program_entry::metal_kernel_data { func, kernel_state });
+			entry.kernel = (__bridge void*)func;
+			entry.kernel_state = (__bridge void*)kernel_state;
+			if(kernel_state != nil) {
+				entry.max_total_local_size = (uint32_t)[kernel_state maxTotalThreadsPerThreadgroup];
+			}
+			kernel_map.insert_or_assign(prog.first.get(), entry);
 		}
-		
+	}
+	
+	kernels.reserve(kernel_names.size());
+	for(auto& kernel_map : kernel_maps) {
 		kernels.emplace_back(make_shared<metal_kernel>(move(kernel_map)));
 	}
 }
@@ -78,6 +78,25 @@ compute_buffer(cqueue, size_, host_ptr_, flags_, opengl_type_, external_gl_objec
 	}
 }
 
+opencl_buffer::opencl_buffer(const compute_queue& cqueue,
+							 shared_ptr<const opencl_buffer> parent,
+							 const size_t& offset,
+							 const size_t& size_) :
+compute_buffer(cqueue, size_, (parent->host_ptr != nullptr ? (uint8_t*)parent->host_ptr + offset : nullptr),
+			   parent->flags | COMPUTE_MEMORY_FLAG::NO_INITIAL_COPY) {
+	// access flags are inherited from the parent buffer
+	const cl_buffer_region region { offset, size };
+	cl_int create_err = CL_SUCCESS;
+	buffer = clCreateSubBuffer(parent->buffer, 0, CL_BUFFER_CREATE_TYPE_REGION, &region, &create_err);
+	if(create_err != CL_SUCCESS) {
+		log_error("failed to create sub-buffer: %u: %s", create_err, cl_error_to_string(create_err));
+		buffer = nullptr;
+		return;
+	}
+	cl_flags = (parent->cl_flags & ~cl_mem_flags(CL_MEM_COPY_HOST_PTR));
+	parent_buffer = move(parent);
+}
+
 bool opencl_buffer::create_internal(const bool copy_host_data, const compute_queue& cqueue) {
 	// TODO: handle the remaining flags + host ptr
 	const auto& cl_dev = (const opencl_device&)cqueue.get_device();
@@ -197,6 +216,10 @@ bool opencl_buffer::resize(const compute_queue& cqueue, const size_t& new_size_,
 						   const bool copy_old_data, const bool copy_host_data,
 						   void* new_host_ptr) {
 	if(buffer == nullptr) return false;
+	if(parent_buffer) {
+		log_error("can't resize a sub-buffer!");
+		return false;
+	}
 	if(new_size_ == 0) {
 		log_error("can't allocate a buffer of size 0!");
 		return false;
@@ -352,4 +375,18 @@ cl_command_queue opencl_buffer::queue_or_default_queue(const compute_queue* cque
 	return (cl_command_queue)const_cast<void*>(((const opencl_compute&)*dev.context).get_device_default_queue((const opencl_device&)dev)->get_queue_ptr());
 }
 
+shared_ptr<compute_buffer> opencl_buffer::create_sub_buffer(const compute_queue& cqueue, const size_t& offset, const size_t& sub_size) const {
+	if(buffer == nullptr) return {};
+	auto parent = sub_buffer_check(offset, sub_size);
+	if(!parent) return {};
+	auto ret = make_shared<opencl_buffer>(cqueue, static_pointer_cast<const opencl_buffer>(move(parent)), offset, sub_size);
+	if(ret->get_cl_buffer() == nullptr) return {};
+	return ret;
+}
+
+size_t opencl_buffer::get_sub_buffer_alignment() const {
+	// NOTE: reported in bits
+	return std::max(size_t(cl_get_info<CL_DEVICE_MEM_BASE_ADDR_ALIGN>(((const opencl_device&)dev).device_id)) / 8u, min_multiple());
+}
+
 #endif
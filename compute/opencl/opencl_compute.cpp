@@ -959,18 +959,23 @@ opencl_program::opencl_program_entry opencl_compute::create_opencl_program(const
 	
 	if (target == llvm_toolchain::TARGET::SPIRV_OPENCL) {
 		// SPIR-V binary, loaded from a file
-		size_t spirv_binary_size = 0;
-		auto spirv_binary = spirv_handler::load_binary(program.data_or_filename, spirv_binary_size);
+		opencl_program::opencl_program_entry ret;
+		{
+			const auto spirv_binary = spirv_handler::load_binary(program.data_or_filename);
+			if (spirv_binary.code != nullptr) {
+				ret = create_opencl_program_internal((const opencl_device&)device,
+													 (const void*)spirv_binary.code, spirv_binary.code_size,
+													 program.functions, target,
+													 program.options.silence_debug_output);
+			}
+			// else: already prints an error
+		}
+		// must unmap before removing the file (required on Windows)
 		if (!floor::get_toolchain_keep_temp() && file_io::is_file(program.data_or_filename)) {
 			// cleanup if file exists
-			core::system("rm " + program.data_or_filename);
+			remove(program.data_or_filename.c_str());
 		}
-		if (spirv_binary == nullptr) return {}; // already prints an error
-		
-		return create_opencl_program_internal((const opencl_device&)device,
-											  (const void*)spirv_binary.get(), spirv_binary_size,
-											  program.functions, target,
-											  program.options.silence_debug_output);
+		return ret;
 	} else {
 		// SPIR binary, alreay in memory
 		return create_opencl_program_internal((const opencl_device&)device,
@@ -26,9 +26,45 @@
 #include <floor/compute/opencl/opencl_device.hpp>
 #include <floor/threading/task.hpp>
 
+opencl_kernel::kernel_pool::~kernel_pool() {
+	GUARD(pool_lock);
+	for(auto& created_kernel : created_kernels) {
+		CL_CALL_IGNORE(clReleaseKernel(created_kernel), "failed to release kernel")
+	}
+	created_kernels.clear();
+	free_kernels.clear();
+}
+
 opencl_kernel::opencl_kernel(kernel_map_type&& kernels_) : kernels(move(kernels_)) {
 }
 
+cl_kernel opencl_kernel::acquire_kernel(const opencl_kernel_entry& entry) const {
+	auto& pool = *entry.pool;
+	{
+		GUARD(pool.pool_lock);
+		if(!pool.free_kernels.empty()) {
+			auto kernel = pool.free_kernels.back();
+			pool.free_kernels.pop_back();
+			return kernel;
+		}
+	}
+	
+	// all kernels are in use -> create a new one (outside of the lock, this may take a while)
+	// NOTE: not using clCloneKernel here, since this would require OpenCL 2.1 and we don't need the argument state anyways
+	cl_kernel kernel { nullptr };
+	CL_CALL_ERR_PARAM_RET(kernel = clCreateKernel(pool.program, entry.info->name.c_str(), &kernel_err), kernel_err,
+						  "failed to create an additional kernel object for kernel " + entry.info->name, nullptr)
+	
+	GUARD(pool.pool_lock);
+	pool.created_kernels.emplace_back(kernel);
+	return kernel;
+}
+
+void opencl_kernel::release_kernel(const opencl_kernel_entry& entry, cl_kernel kernel) const {
+	GUARD(entry.pool->pool_lock);
+	entry.pool->free_kernels.emplace_back(kernel);
+}
+
 typename opencl_kernel::kernel_map_type::const_iterator opencl_kernel::get_kernel(const compute_queue& queue) const {
 	return kernels.find((const opencl_device&)queue.get_device());
 }
@@ -38,7 +74,7 @@ void opencl_kernel::execute(const compute_queue& cqueue,
 							const uint32_t& work_dim,
 							const uint3& global_work_size,
 							const uint3& local_work_size_,
-							const vector<compute_kernel_arg>& args) const REQUIRES(!args_lock) {
+							const vector<compute_kernel_arg>& args) const {
 	// no cooperative support yet
 	if (is_cooperative) {
 		log_error("cooperative kernel execution is not supported for OpenCL");
@@ -58,25 +94,18 @@ void opencl_kernel::execute(const compute_queue& cqueue,
 	// create arg handler (needed if param workaround is necessary)
 	auto handler = create_arg_handler(cqueue);
 	
-	// need to make sure that only one thread is setting kernel arguments at a time
-	GUARD(args_lock);
+	// get a kernel object that no other thread is currently setting arguments on
+	const opencl_kernel_entry& entry = kernel_iter->second;
+	const auto kernel = acquire_kernel(entry);
+	if(kernel == nullptr) {
+		return;
+	}
 	
 	// set and handle kernel arguments
 	uint32_t total_idx = 0, arg_idx = 0;
-	const opencl_kernel_entry& entry = kernel_iter->second;
 	for (const auto& arg : args) {
-		if (auto buf_ptr = get_if<const compute_buffer*>(&arg.var)) {
-			set_kernel_argument(total_idx, arg_idx, handler.get(), entry, *buf_ptr);
-		} else if (auto img_ptr = get_if<const compute_image*>(&arg.var)) {
-			set_kernel_argument(total_idx, arg_idx, handler.get(), entry, *img_ptr);
-		} else if (auto vec_img_ptrs = get_if<const vector<compute_image*>*>(&arg.var)) {
-			log_error("array of images is not supported for OpenCL");
-		} else if (auto vec_img_sptrs = get_if<const vector<shared_ptr<compute_image>>*>(&arg.var)) {
-			log_error("array of images is not supported for OpenCL");
-		} else if (auto generic_arg_ptr = get_if<const void*>(&arg.var)) {
-			set_const_kernel_argument(total_idx, arg_idx, handler.get(), entry, const_cast<void*>(*generic_arg_ptr) /* non-const b/c OpenCL */, arg.size);
-		} else {
-			log_error("encountered invalid arg");
+		if (!set_kernel_argument(total_idx, arg_idx, handler.get(), entry, kernel, arg)) {
+			release_kernel(entry, kernel);
 			return;
 		}
 		++total_idx;
@@ -87,14 +116,21 @@ void opencl_kernel::execute(const compute_queue& cqueue,
 	const size3 local_ws { local_work_size };
 	const bool has_tmp_buffers = !handler->args.empty();
 	cl_event wait_evt = nullptr;
-	CL_CALL_RET(clEnqueueNDRangeKernel((cl_command_queue)const_cast<void*>(cqueue.get_queue_ptr()),
-									   entry.kernel, work_dim, nullptr,
-									   global_ws.data(), local_ws.data(),
-									   0, nullptr,
-									   // when using the param workaround, we have created tmp buffers
-									   // that need to be destroyed once the kernel has finished execution
-									   handler->needs_param_workaround && has_tmp_buffers ? &wait_evt : nullptr),
-				"failed to execute kernel " + entry.info->name)
+	const auto enqueue_err = clEnqueueNDRangeKernel((cl_command_queue)const_cast<void*>(cqueue.get_queue_ptr()),
+													kernel, work_dim, nullptr,
+													global_ws.data(), local_ws.data(),
+													0, nullptr,
+													// when using the param workaround, we have created tmp buffers
+													// that need to be destroyed once the kernel has finished execution
+													handler->needs_param_workaround && has_tmp_buffers ? &wait_evt : nullptr);
+	
+	// arguments have been captured by the enqueue -> kernel object can be reused right away
+	release_kernel(entry, kernel);
+	
+	if(enqueue_err != CL_SUCCESS) {
+		log_error("failed to execute kernel %s: %u: %s", entry.info->name, enqueue_err, cl_error_to_string(enqueue_err));
+		return;
+	}
 	
 	if(handler->needs_param_workaround && has_tmp_buffers) {
 		task::spawn([handler, wait_evt]() {
@@ -104,6 +140,107 @@ void opencl_kernel::execute(const compute_queue& cqueue,
 	}
 }
 
+opencl_kernel::opencl_bound_args::~opencl_bound_args() {
+	release();
+}
+
+void opencl_kernel::opencl_bound_args::release() {
+	if(bound_kernel != nullptr) {
+		((const opencl_kernel&)kernel).release_kernel(*entry, bound_kernel);
+		bound_kernel = nullptr;
+	}
+	entry = nullptr;
+	prepared_device = nullptr;
+}
+
+bool opencl_kernel::opencl_bound_args::update(const opencl_kernel_entry& kernel_entry, const compute_queue& cqueue) {
+	const auto& ocl_kernel = (const opencl_kernel&)kernel;
+	auto handler = ocl_kernel.create_arg_handler(cqueue);
+	
+	if(prepared_device != &cqueue.get_device()) {
+		// new device (or first use): acquire a kernel object that is only used by these bound args and set all arguments
+		release();
+		bound_kernel = ocl_kernel.acquire_kernel(kernel_entry);
+		if(bound_kernel == nullptr) {
+			return false;
+		}
+		entry = &kernel_entry;
+		
+		cl_arg_indices.resize(args.size());
+		uint32_t total_idx = 0, arg_idx = 0;
+		for(const auto& arg : args) {
+			cl_arg_indices[total_idx] = arg_idx;
+			if(!ocl_kernel.set_kernel_argument(total_idx, arg_idx, handler.get(), kernel_entry, bound_kernel, arg)) {
+				return false;
+			}
+			++total_idx;
+		}
+		prepared_device = &cqueue.get_device();
+	} else {
+		// only set modified arguments again
+		for(const auto& idx : modified_args) {
+			uint32_t total_idx = idx, arg_idx = cl_arg_indices[idx];
+			if(!ocl_kernel.set_kernel_argument(total_idx, arg_idx, handler.get(), kernel_entry, bound_kernel, args[idx])) {
+				return false;
+			}
+		}
+	}
+	modified_args.clear();
+	return true;
+}
+
+bool opencl_kernel::read_group_count(const compute_queue& cqueue,
+									 const compute_buffer& indirect_buffer,
+									 const size_t& indirect_offset,
+									 uint3& group_count) const {
+	// blocking read of only the work-group count (in-order queue -> all prior writes to it have completed)
+	CL_CALL_RET(clEnqueueReadBuffer((cl_command_queue)const_cast<void*>(cqueue.get_queue_ptr()),
+									((const opencl_buffer&)indirect_buffer).get_cl_buffer(), true,
+									indirect_offset, sizeof(group_count), &group_count,
+									0, nullptr, nullptr),
+				"failed to read the indirect work-group count", false)
+	return true;
+}
+
+unique_ptr<compute_kernel_bound_args> opencl_kernel::bind_args(vector<compute_kernel_arg>&& args) const {
+	return make_unique<opencl_bound_args>(*this, move(args));
+}
+
+void opencl_kernel::execute_bound(const compute_queue& cqueue,
+								  compute_kernel_bound_args& bound_args,
+								  const uint32_t& work_dim,
+								  const uint3& global_work_size,
+								  const uint3& local_work_size_) const {
+	// with the param workaround, generic arguments need new tmp buffers for each launch -> can't prepare anything
+	if(cqueue.get_device().param_workaround) {
+		compute_kernel::execute_bound(cqueue, bound_args, work_dim, global_work_size, local_work_size_);
+		return;
+	}
+	
+	// find entry for queue device
+	const auto kernel_iter = get_kernel(cqueue);
+	if(kernel_iter == kernels.cend()) {
+		log_error("no kernel for this compute queue/device exists!");
+		return;
+	}
+	
+	// NOTE: bound args are always created by bind_args() above
+	auto& cl_args = (opencl_bound_args&)bound_args;
+	if(!cl_args.update(kernel_iter->second, cqueue)) {
+		return;
+	}
+	
+	// run
+	const uint3 local_work_size = check_local_work_size(kernel_iter->second, local_work_size_);
+	const size3 global_ws { global_work_size };
+	const size3 local_ws { local_work_size };
+	CL_CALL_RET(clEnqueueNDRangeKernel((cl_command_queue)const_cast<void*>(cqueue.get_queue_ptr()),
+									   cl_args.bound_kernel, work_dim, nullptr,
+									   global_ws.data(), local_ws.data(),
+									   0, nullptr, nullptr),
+				"failed to execute kernel "s + kernel_iter->second.info->name)
+}
+
 shared_ptr<opencl_kernel::arg_handler> opencl_kernel::create_arg_handler(const compute_queue& cqueue) const {
 	auto handler = make_shared<arg_handler>();
 	handler->cqueue = &cqueue;
@@ -112,11 +249,31 @@ shared_ptr<opencl_kernel::arg_handler> opencl_kernel::create_arg_handler(const c
 	return handler;
 }
 
+bool opencl_kernel::set_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx, arg_handler* handler,
+										const opencl_kernel_entry& entry, cl_kernel kernel,
+										const compute_kernel_arg& arg) const {
+	if (auto buf_ptr = get_if<const compute_buffer*>(&arg.var)) {
+		set_kernel_argument(total_idx, arg_idx, handler, entry, kernel, *buf_ptr);
+	} else if (auto img_ptr = get_if<const compute_image*>(&arg.var)) {
+		set_kernel_argument(total_idx, arg_idx, handler, entry, kernel, *img_ptr);
+	} else if (auto vec_img_ptrs = get_if<const vector<compute_image*>*>(&arg.var)) {
+		log_error("array of images is not supported for OpenCL");
+	} else if (auto vec_img_sptrs = get_if<const vector<shared_ptr<compute_image>>*>(&arg.var)) {
+		log_error("array of images is not supported for OpenCL");
+	} else if (auto generic_arg_ptr = get_if<const void*>(&arg.var)) {
+		set_const_kernel_argument(total_idx, arg_idx, handler, entry, kernel, const_cast<void*>(*generic_arg_ptr) /* non-const b/c OpenCL */, arg.size);
+	} else {
+		log_error("encountered invalid arg");
+		return false;
+	}
+	return true;
+}
+
 void opencl_kernel::set_const_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx, arg_handler* handler, const opencl_kernel_entry& entry,
-											  void* arg, const size_t arg_size) const {
+											  cl_kernel kernel, void* arg, const size_t arg_size) const {
 	// if param workaround isn't needed, just set the arg
 	if(!handler->needs_param_workaround) {
-		CL_CALL_RET(clSetKernelArg(entry.kernel, arg_idx, arg_size, arg),
+		CL_CALL_RET(clSetKernelArg(kernel, arg_idx, arg_size, arg),
 					"failed to set generic kernel argument #" + to_string(total_idx) + " (in kernel " + entry.info->name + ")")
 		++arg_idx;
 		return;
@@ -128,22 +285,22 @@ void opencl_kernel::set_const_kernel_argument(uint32_t& total_idx, uint32_t& arg
 												COMPUTE_MEMORY_FLAG::READ | COMPUTE_MEMORY_FLAG::HOST_WRITE);
 	handler->args.emplace_back(param_buf);
 	
-	set_kernel_argument(total_idx, arg_idx, nullptr, entry, (const compute_buffer*)param_buf.get());
+	set_kernel_argument(total_idx, arg_idx, nullptr, entry, kernel, (const compute_buffer*)param_buf.get());
 }
 
 void opencl_kernel::set_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx, arg_handler*,
-										const opencl_kernel_entry& entry,
+										const opencl_kernel_entry& entry, cl_kernel kernel,
 										const compute_buffer* arg) const {
-	CL_CALL_RET(clSetKernelArg(entry.kernel, arg_idx, sizeof(cl_mem),
+	CL_CALL_RET(clSetKernelArg(kernel, arg_idx, sizeof(cl_mem),
 							   &((const opencl_buffer*)arg)->get_cl_buffer()),
 				"failed to set buffer kernel argument #" + to_string(total_idx) + " (in kernel " + entry.info->name + ")")
 	++arg_idx;
 }
 
 void opencl_kernel::set_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx, arg_handler* handler,
-										const opencl_kernel_entry& entry,
+										const opencl_kernel_entry& entry, cl_kernel kernel,
 										const compute_image* arg) const {
-	CL_CALL_RET(clSetKernelArg(entry.kernel, arg_idx, sizeof(cl_mem),
+	CL_CALL_RET(clSetKernelArg(kernel, arg_idx, sizeof(cl_mem),
 							   &((const opencl_image*)arg)->get_cl_image()),
 				"failed to set image kernel argument #" + to_string(total_idx) + " (in kernel " + entry.info->name + ")")
 	++arg_idx;
@@ -151,7 +308,7 @@ void opencl_kernel::set_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx,
 	// legacy s/w read/write image -> set it twice
 	if(entry.info->args[total_idx].image_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ_WRITE &&
 	   !handler->device->image_read_write_support) {
-		CL_CALL_RET(clSetKernelArg(entry.kernel, arg_idx, sizeof(cl_mem),
+		CL_CALL_RET(clSetKernelArg(kernel, arg_idx, sizeof(cl_mem),
 								   &((const opencl_image*)arg)->get_cl_image()),
 					"failed to set image kernel argument #" + to_string(total_idx) + " (in kernel " + entry.info->name + ")")
 		++arg_idx;
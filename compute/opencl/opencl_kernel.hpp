@@ -42,8 +42,26 @@ protected:
 	shared_ptr<arg_handler> create_arg_handler(const compute_queue& cqueue) const;
 	
 public:
+	//! pool of cl_kernel objects of one kernel on one device, so that concurrent launches from different threads/queues
+	//! can each set arguments on their own cl_kernel (the argument state is part of the cl_kernel object)
+	struct kernel_pool {
+		~kernel_pool();
+		
+		//! the original kernel that all other kernels are created like (not owned by the pool)
+		cl_kernel kernel { nullptr };
+		//! the program the kernel has been created from
+		cl_program program { nullptr };
+		
+		atomic_spin_lock pool_lock;
+		//! currently unused kernels
+		vector<cl_kernel> free_kernels GUARDED_BY(pool_lock);
+		//! all kernels that have been created by the pool (will be released on destruction)
+		vector<cl_kernel> created_kernels GUARDED_BY(pool_lock);
+	};
+	
 	struct opencl_kernel_entry : kernel_entry {
 		cl_kernel kernel { nullptr };
+		shared_ptr<kernel_pool> pool;
 	};
 	typedef flat_map<const opencl_device&, opencl_kernel_entry> kernel_map_type;
 	
@@ -57,28 +75,69 @@ public:
 				 const uint3& local_work_size,
 				 const vector<compute_kernel_arg>& args) const override;
 	
+	bool read_group_count(const compute_queue& cqueue,
+						  const compute_buffer& indirect_buffer,
+						  const size_t& indirect_offset,
+						  uint3& group_count) const override;
+	
+	void execute_bound(const compute_queue& cqueue,
+					   compute_kernel_bound_args& bound_args,
+					   const uint32_t& dim,
+					   const uint3& global_work_size,
+					   const uint3& local_work_size) const override;
+	
 	const kernel_entry* get_kernel_entry(const compute_device& dev) const override;
 	
 protected:
 	const kernel_map_type kernels;
 	
-	mutable atomic_spin_lock args_lock;
+	//! bound args with a dedicated kernel object (from the kernel pool) on which all arguments have already been set
+	struct opencl_bound_args final : public compute_kernel_bound_args {
+		using compute_kernel_bound_args::compute_kernel_bound_args;
+		~opencl_bound_args() override;
+		
+		//! entry of the prepared device
+		const opencl_kernel_entry* entry { nullptr };
+		//! kernel object that has been acquired from the pool of "entry"
+		cl_kernel bound_kernel { nullptr };
+		//! OpenCL argument index of each argument (some arguments use more than one)
+		vector<uint32_t> cl_arg_indices;
+		
+		//! sets all arguments on a newly acquired kernel object if the device changed, or only the modified ones,
+		//! returns false on failure
+		bool update(const opencl_kernel_entry& kernel_entry, const compute_queue& cqueue);
+		//! puts the kernel object back into the pool
+		void release();
+	};
+	unique_ptr<compute_kernel_bound_args> bind_args(vector<compute_kernel_arg>&& args) const override;
+	
+	//! returns an unused kernel object of the specified entry, creating a new one if all are in use,
+	//! returns nullptr on failure
+	cl_kernel acquire_kernel(const opencl_kernel_entry& entry) const;
+	//! puts a kernel object that has been acquired via acquire_kernel back into the pool
+	//! NOTE: it is safe to do this right after enqueueing, since arguments are captured at enqueue time
+	void release_kernel(const opencl_kernel_entry& entry, cl_kernel kernel) const;
 	
 	typename kernel_map_type::const_iterator get_kernel(const compute_queue& cqueue) const;
 	
 	COMPUTE_TYPE get_compute_type() const override { return COMPUTE_TYPE::OPENCL; }
 	
+	//! sets the specified argument of any type, returns false if the argument is invalid
+	bool set_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx, arg_handler* handler,
+							 const opencl_kernel_entry& entry, cl_kernel kernel,
+							 const compute_kernel_arg& arg) const;
+	
 	//! actual kernel argument setters
 	void set_const_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx, arg_handler* handler,
-								   const opencl_kernel_entry& entry,
+								   const opencl_kernel_entry& entry, cl_kernel kernel,
 								   void* arg, const size_t arg_size) const;
 	
 	void set_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx, arg_handler*,
-							 const opencl_kernel_entry& entry,
+							 const opencl_kernel_entry& entry, cl_kernel kernel,
 							 const compute_buffer* arg) const;
 	
 	floor_inline_always void set_kernel_argument(uint32_t& total_idx, uint32_t& arg_idx, arg_handler* handler,
-												 const opencl_kernel_entry& entry,
+												 const opencl_kernel_entry& entry, cl_kernel kernel,
 												 const compute_image* arg) const;
 	
 };
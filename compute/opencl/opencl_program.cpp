@@ -29,51 +29,63 @@ opencl_program::opencl_program(program_map_type&& programs_) : programs(move(pro
 	retrieve_unique_kernel_names(programs);
 	
 	// create all kernels of all device programs
-	// note that this essentially reshuffles the program "device -> kernels" data to "kernels -> devices"
-	kernels.reserve(kernel_names.size());
-	for(const auto& kernel_name : kernel_names) {
-		opencl_kernel::kernel_map_type kernel_map;
-		kernel_map.reserve(kernel_names.size());
+	// note that this essentially reshuffles the program "device -> kernels" data to "kernels -> devices",
+	// which only requires a single pass over all device functions (kernels are looked up through the kernel index)
+	vector<opencl_kernel::kernel_map_type> kernel_maps(kernel_names.size());
+	for(const auto& prog : programs) {
+		if(!prog.second.valid) continue;
 		
-		for(const auto& prog : programs) {
-			if(!prog.second.valid) continue;
+		for(const auto& info : prog.second.functions) {
+			// kernel_index contains all function names of all device programs
+			auto& kernel_map = kernel_maps[kernel_index.at(info.name)];
+			if(kernel_map.find(prog.first) != kernel_map.end()) {
+				continue; // only use the first function with this name
+			}
+			const auto& kernel_name = info.name;
+			
+			opencl_kernel::opencl_kernel_entry entry;
+			entry.info = &info;
+			entry.max_local_size = prog.first.get().max_local_size;
+			
+			CL_CALL_ERR_PARAM_CONT(entry.kernel = clCreateKernel(prog.second.program, kernel_name.c_str(),
+																 &kernel_err), kernel_err,
+								   "failed to create kernel \"" + kernel_name + "\" for device \"" + prog.first.get().name + "\"")
+			
+			// retrieve max possible work-group size for this device for this kernel
+			entry.max_total_local_size = (uint32_t)cl_get_info<CL_KERNEL_WORK_GROUP_SIZE>(entry.kernel, prog.first.get().device_id);
+			
+			// sanity check/override if reported local size > actual supported one (especially on Intel CPUs ...)
+			entry.max_total_local_size = min(entry.max_total_local_size, prog.first.get().max_total_local_size);
+			
+			// the original kernel object is the first one in the pool, more are created on demand
+			entry.pool = make_shared<opencl_kernel::kernel_pool>();
+			entry.pool->kernel = entry.kernel;
+			entry.pool->program = prog.second.program;
+			{
+				GUARD(entry.pool->pool_lock);
+				entry.pool->free_kernels.emplace_back(entry.kernel);
+			}
 			
-			for(const auto& info : prog.second.functions) {
-				if(info.name == kernel_name) {
-					opencl_kernel::opencl_kernel_entry entry;
-					entry.info = &info;
-					entry.max_local_size = prog.first.get().max_local_size;
-					
-					CL_CALL_ERR_PARAM_CONT(entry.kernel = clCreateKernel(prog.second.program, kernel_name.c_str(),
-																		 &kernel_err), kernel_err,
-										   "failed to create kernel \"" + kernel_name + "\" for device \"" + prog.first.get().name + "\"")
-					
-					// retrieve max possible work-group size for this device for this kernel
-					entry.max_total_local_size = (uint32_t)cl_get_info<CL_KERNEL_WORK_GROUP_SIZE>(entry.kernel, prog.first.get().device_id);
-					
-					// sanity check/override if reported local size > actual supported one (especially on Intel CPUs ...)
-					entry.max_total_local_size = min(entry.max_total_local_size, prog.first.get().max_total_local_size);
-					
 #if 0 // dump kernel + kernel args info
-					const auto arg_count = cl_get_info<CL_KERNEL_NUM_ARGS>(entry.kernel);
-					log_debug("kernel %s: arg count: %u", kernel_name, arg_count);
-					for(uint32_t i = 0; i < arg_count; ++i) {
-						log_debug("\targ #%u: %s: %u %u %s %u", i,
-								  cl_get_info<CL_KERNEL_ARG_NAME>(entry.kernel, i),
-								  cl_get_info<CL_KERNEL_ARG_ADDRESS_QUALIFIER>(entry.kernel, i),
-								  cl_get_info<CL_KERNEL_ARG_ACCESS_QUALIFIER>(entry.kernel, i),
-								  cl_get_info<CL_KERNEL_ARG_TYPE_NAME>(entry.kernel, i),
-								  cl_get_info<CL_KERNEL_ARG_TYPE_QUALIFIER>(entry.kernel, i));
-					}
-#endif
-					
-					// success, insert into map
-					kernel_map.insert_or_assign(prog.first, entry);
-					break;
-				}
+			const auto arg_count = cl_get_info<CL_KERNEL_NUM_ARGS>(entry.kernel);
+			log_debug("kernel %s: arg count: %u", kernel_name, arg_count);
+			for(uint32_t i = 0; i < arg_count; ++i) {
+				log_debug("\targ #%u: %s: %u %u %s %u", i,
+						  cl_get_info<CL_KERNEL_ARG_NAME>(entry.kernel, i),
+						  cl_get_info<CL_KERNEL_ARG_ADDRESS_QUALIFIER>(entry.kernel, i),
+						  cl_get_info<CL_KERNEL_ARG_ACCESS_QUALIFIER>(entry.kernel, i),
+						  cl_get_info<CL_KERNEL_ARG_TYPE_NAME>(entry.kernel, i),
+						  cl_get_info<CL_KERNEL_ARG_TYPE_QUALIFIER>(entry.kernel, i));
 			}
+#endif
+			
+			// success, insert into map
+			kernel_map.insert_or_assign(prog.first, entry);
 		}
-		
+	}
+	
+	kernels.reserve(kernel_names.size());
+	for(auto& kernel_map : kernel_maps) {
 		kernels.emplace_back(make_shared<opencl_kernel>(move(kernel_map)));
 	}
 }
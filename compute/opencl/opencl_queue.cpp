@@ -20,6 +20,27 @@
 
 #if !defined(FLOOR_NO_OPENCL)
 
+opencl_event::opencl_event(cl_event evt_) : evt(evt_) {
+}
+
+opencl_event::~opencl_event() {
+	if(evt != nullptr) {
+		CL_CALL_IGNORE(clReleaseEvent(evt), "failed to release event")
+	}
+}
+
+void opencl_event::wait() const {
+	CL_CALL_RET(clWaitForEvents(1, &evt), "failed to wait for event")
+}
+
+bool opencl_event::is_complete() const {
+	cl_int status = CL_QUEUED;
+	CL_CALL_RET(clGetEventInfo(evt, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status, nullptr),
+				"failed to query event status", true)
+	// NOTE: negative values signal an error, in which case the event is complete as well
+	return (status <= CL_COMPLETE);
+}
+
 opencl_queue::opencl_queue(const compute_device& device_, const cl_command_queue queue_) : compute_queue(device_), queue(queue_) {
 }
 
@@ -33,6 +54,18 @@ void opencl_queue::flush() const {
 	clFlush(queue);
 }
 
+shared_ptr<compute_event> opencl_queue::record_event() const {
+	cl_event evt { nullptr };
+	CL_CALL_RET(clEnqueueMarkerWithWaitList(queue, 0, nullptr, &evt), "failed to record event", {})
+	return make_shared<opencl_event>(evt);
+}
+
+void opencl_queue::wait_for_event(const compute_event& evt) const {
+	// NOTE: events are always recorded in a queue of the same device/context -> this is always an opencl_event
+	CL_CALL_RET(clEnqueueBarrierWithWaitList(queue, 1, &((const opencl_event&)evt).get_cl_event(), nullptr),
+				"failed to wait for event")
+}
+
 const void* opencl_queue::get_queue_ptr() const {
 	return queue;
 }
@@ -24,6 +24,25 @@
 #if !defined(FLOOR_NO_OPENCL)
 
 #include <floor/compute/compute_queue.hpp>
+#include <floor/compute/compute_event.hpp>
+
+//! wraps an OpenCL marker event
+class opencl_event final : public compute_event {
+public:
+	explicit opencl_event(cl_event evt);
+	~opencl_event() override;
+	
+	void wait() const override;
+	bool is_complete() const override;
+	
+	const cl_event& get_cl_event() const {
+		return evt;
+	}
+	
+protected:
+	cl_event evt { nullptr };
+	
+};
 
 class opencl_queue final : public compute_queue {
 public:
@@ -32,6 +51,9 @@ public:
 	void finish() const override;
 	void flush() const override;
 	
+	shared_ptr<compute_event> record_event() const override;
+	void wait_for_event(const compute_event& evt) const override;
+	
 	const void* get_queue_ptr() const override;
 	void* get_queue_ptr() override;
 	
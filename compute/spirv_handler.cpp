@@ -18,43 +18,37 @@
 
 #include <floor/compute/spirv_handler.hpp>
 #include <floor/core/logger.hpp>
-#include <floor/core/file_io.hpp>
 
 namespace spirv_handler {
 
-unique_ptr<uint32_t[]> load_binary(const string& file_name, size_t& code_size) {
-	unique_ptr<uint32_t[]> code;
-	
-	file_io binary(file_name, file_io::OPEN_TYPE::READ_BINARY);
-	if(!binary.is_open()) {
+binary load_binary(const string& file_name) {
+	binary ret;
+	ret.mapping = file_io::map_file(file_name);
+	if(!ret.mapping) {
 		log_error("failed to load spir-v binary (\"%s\")", file_name);
 		return {};
 	}
 	
-	code_size = (size_t)binary.get_filesize();
-	if(code_size % 4u != 0u) {
-		log_error("invalid spir-v binary size %u (\"%s\"): must be a multiple of 4!", code_size, file_name);
-		return {};
-	}
-	
-	code = make_unique<uint32_t[]>(code_size / 4u);
-	binary.get_block((char*)code.get(), (streamsize)code_size);
-	const auto read_size = binary.get_filestream()->gcount();
-	if(read_size != (decltype(read_size))code_size) {
-		log_error("failed to read spir-v binary (\"%s\"): expected %u bytes, but only read %u bytes", file_name, code_size, read_size);
+	ret.code_size = ret.mapping->size();
+	if(ret.code_size == 0u || ret.code_size % 4u != 0u) {
+		log_error("invalid spir-v binary size %u (\"%s\"): must be a non-zero multiple of 4!", ret.code_size, file_name);
 		return {};
 	}
 	
-	return code;
+	// mappings are always page-aligned
+	ret.code = (const uint32_t*)ret.mapping->data();
+	return ret;
 }
 
 spirv_handler::container load_container(const string& file_name) {
-	string data { "" };
-	if(!file_io::file_to_string(file_name, data)) {
+	auto mapping = file_io::map_file(file_name);
+	if(!mapping) {
 		log_error("failed to load spir-v container (\"%s\")", file_name);
 		return {};
 	}
-	return load_container_from_memory((const uint8_t*)data.data(), data.size(), file_name);
+	auto ret = load_container_from_memory(mapping->data(), mapping->size(), file_name);
+	ret.mapping = move(mapping);
+	return ret;
 }
 
 spirv_handler::container load_container_from_memory(const uint8_t* data_ptr_,
@@ -65,7 +59,7 @@ spirv_handler::container load_container_from_memory(const uint8_t* data_ptr_,
 		log_error("container too large");
 		return {};
 	}
-	if(data_size_ < 8) {
+	if(data_size_ < 12) {
 		log_error("container too small");
 		return {};
 	}
@@ -91,7 +85,7 @@ spirv_handler::container load_container_from_memory(const uint8_t* data_ptr_,
 	data_ptr += sizeof(entry_count);
 	
 	const auto expected_header_entries_size = entry_count * sizeof(uint32_t) * 2;
-	uint32_t cur_size = 8; // header
+	uint32_t cur_size = 12; // header
 	if(cur_size + expected_header_entries_size > data_size) {
 		log_error("invalid header entries size");
 		return {};
@@ -128,8 +122,16 @@ spirv_handler::container load_container_from_memory(const uint8_t* data_ptr_,
 		log_error("invalid spir-v data size");
 		return {};
 	}
-	ret.spirv_data = make_unique<uint32_t[]>(running_offset);
-	memcpy(ret.spirv_data.get(), data_ptr, spirv_data_size);
+	if(size_t(data_ptr) % sizeof(uint32_t) == 0u) {
+		// directly reference the container memory
+		ret.spirv_data = (const uint32_t*)data_ptr;
+	}
+	else {
+		// spir-v data must be 4-byte aligned -> need to copy
+		ret.aligned_spirv_data = make_unique<uint32_t[]>(running_offset);
+		memcpy(ret.aligned_spirv_data.get(), data_ptr, spirv_data_size);
+		ret.spirv_data = ret.aligned_spirv_data.get();
+	}
 	data_ptr += spirv_data_size;
 	cur_size += spirv_data_size;
 	
@@ -149,11 +151,12 @@ spirv_handler::container load_container_from_memory(const uint8_t* data_ptr_,
 		
 		//
 		for(uint32_t i = 0; i < function_entry_count; ++i) {
-			if(find(data_ptr, data_end_ptr, '\0') == data_end_ptr) {
+			const auto name_end_ptr = find(data_ptr, data_end_ptr, '\0');
+			if(name_end_ptr == data_end_ptr) {
 				log_error("function name has no terminator");
 				return {};
 			}
-			entry.function_names[i] = (const char*)data_ptr; // string is \0 terminated
+			entry.function_names[i] = string_view((const char*)data_ptr, size_t(name_end_ptr - data_ptr));
 			
 			auto padded_len = (uint32_t)entry.function_names[i].size();
 			padded_len += 4u - (padded_len % 4u);
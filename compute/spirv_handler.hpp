@@ -21,11 +21,23 @@
 
 #include <floor/core/essentials.hpp>
 #include <floor/compute/llvm_toolchain.hpp>
+#include <floor/core/file_io.hpp>
+#include <string_view>
 
 namespace spirv_handler {
-	//! loads a spir-v binary from the file specified by file_name,
-	//! returning the read code + setting code_size to the amount of bytes
-	unique_ptr<uint32_t[]> load_binary(const string& file_name, size_t& code_size);
+	//! memory-mapped spir-v binary
+	struct binary {
+		//! spir-v code (points into the mapping)
+		const uint32_t* code { nullptr };
+		//! size of the spir-v code in bytes
+		size_t code_size { 0u };
+		//! backing file mapping, the code is only valid as long as this exists
+		unique_ptr<file_io::mapped_file> mapping;
+	};
+	
+	//! loads (memory-maps) a spir-v binary from the file specified by file_name,
+	//! returns an empty binary (code == nullptr) on failure
+	binary load_binary(const string& file_name);
 	
 	// #### SPIR-V container file format ####
 	// ## header
@@ -45,21 +57,30 @@ namespace spirv_handler {
 	// char[function_entry_count][]: function names (always \0 terminated, with \0 padding to achieve
 	//                                               4-byte/uint32_t alignment)
 	
+	//! NOTE: function names and spir-v data directly reference the container memory (file mapping or user memory),
+	//!       which must therefore outlive the container object
 	struct container {
 		struct entry {
 			vector<llvm_toolchain::function_info::FUNCTION_TYPE> function_types;
-			vector<string> function_names;
+			vector<string_view> function_names;
 			uint32_t data_offset;
 			uint32_t data_word_count;
 		};
 		vector<entry> entries;
-		unique_ptr<uint32_t[]> spirv_data;
+		//! spir-v data of all modules (entry data_offset is a word offset into this)
+		const uint32_t* spirv_data { nullptr };
+		//! backing file mapping when loaded via load_container
+		unique_ptr<file_io::mapped_file> mapping;
+		//! only used when the spir-v data in the container memory is not 4-byte aligned and had to be copied
+		unique_ptr<uint32_t[]> aligned_spirv_data;
 		bool valid { false };
 	};
 	static constexpr const uint32_t container_version { 2u };
 	
-	//! loads a SPIR-V container file and processes it into a usable 'container' object
+	//! loads (memory-maps) a SPIR-V container file and processes it into a usable 'container' object
 	container load_container(const string& file_name);
+	//! processes the SPIR-V container in the specified memory into a usable 'container' object,
+	//! NOTE: the memory must stay valid for the lifetime of the returned container
 	container load_container_from_memory(const uint8_t* data_ptr,
 										 const size_t& data_size,
 										 const string identifier = "");
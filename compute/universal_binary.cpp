@@ -26,22 +26,86 @@
 #include <floor/compute/vulkan/vulkan_device.hpp>
 #include <floor/core/file_io.hpp>
 #include <floor/core/core.hpp>
-#include <floor/threading/task.hpp>
+#include <floor/core/lz_codec.hpp>
 #include <floor/floor/floor.hpp>
+#include <condition_variable>
+#include <thread>
 
 namespace universal_binary {
 	static constexpr const uint32_t min_required_toolchain_version_v2 { 80000u };
 	
+	//! returns the size of the static per-binary header (incl. compression info) for the specified binary format version
+	static constexpr size_t binary_header_size(const uint32_t version) {
+		return sizeof(binary_v2) + (version >= 3u ? sizeof(binary_compression_v3) : 0u);
+	}
+	
+	//! reads the static binary header and compression info of the binary at "bin_idx" (must already be bounds checked)
+	static void read_binary_header(const archive& ar, const size_t bin_idx,
+								   binary_v2& bin_header, binary_compression_v3& compression) {
+		const uint8_t* data_ptr = ar.file->data() + ar.header.offsets[bin_idx];
+		memcpy(&bin_header, data_ptr, sizeof(binary_v2));
+		if (ar.header.static_header.binary_format_version >= 3u) {
+			memcpy(&compression, data_ptr + sizeof(binary_v2), sizeof(binary_compression_v3));
+		} else {
+			compression = {};
+			compression.stored_size = bin_header.binary_size;
+		}
+	}
+	
+	//! parses the extension section at "offset" (build inputs of all binaries), returns false if it is invalid
+	static bool parse_extension(archive& ar, size_t offset) {
+		const auto data_size = ar.file->size();
+		const uint8_t* data_ptr = ar.file->data();
+		const auto bin_count = ar.header.static_header.binary_count;
+		
+		if (offset + 8u > data_size ||
+			memcmp(data_ptr + offset, "FUBE", 4) != 0) {
+			return false;
+		}
+		uint32_t version = 0;
+		memcpy(&version, data_ptr + offset + 4u, sizeof(version));
+		if (version != extension_version) {
+			return false;
+		}
+		offset += 8u;
+		
+		ar.build_inputs.resize(bin_count);
+		for (auto& build_input : ar.build_inputs) {
+			uint32_t dep_count = 0;
+			if (offset + sizeof(sha_256::hash_t) + sizeof(build_input.compile_time_us) + sizeof(dep_count) > data_size) {
+				return false;
+			}
+			memcpy(&build_input.hash, data_ptr + offset, sizeof(sha_256::hash_t));
+			offset += sizeof(sha_256::hash_t);
+			memcpy(&build_input.compile_time_us, data_ptr + offset, sizeof(build_input.compile_time_us));
+			offset += sizeof(build_input.compile_time_us);
+			memcpy(&dep_count, data_ptr + offset, sizeof(dep_count));
+			offset += sizeof(dep_count);
+			
+			build_input.dependencies.reserve(dep_count);
+			for (uint32_t dep_idx = 0; dep_idx < dep_count; ++dep_idx) {
+				const auto dep_max_len = data_size - offset;
+				const auto dep_len = strnlen((const char*)data_ptr + offset, dep_max_len);
+				if (dep_len == dep_max_len) {
+					return false;
+				}
+				build_input.dependencies.emplace_back((const char*)data_ptr + offset, dep_len);
+				offset += dep_len + 1;
+			}
+		}
+		return true;
+	}
+	
 	unique_ptr<archive> load_archive(const string& file_name) {
-		string data;
-		if (!file_io::file_to_string(file_name, data)) {
+		auto ar = make_unique<archive>();
+		ar->file_name = file_name;
+		ar->file = file_io::map_file(file_name);
+		if (!ar->file) {
 			return {};
 		}
-		const auto data_size = data.size();
+		const auto data_size = ar->file->size();
 		auto cur_size = (decltype(data_size))0;
-		const uint8_t* data_ptr = (const uint8_t*)data.data();
-		
-		auto ar = make_unique<archive>();
+		const uint8_t* data_ptr = ar->file->data();
 		
 		// parse header
 		cur_size += sizeof(header_v2);
@@ -57,7 +121,8 @@ namespace universal_binary {
 			log_error("universal binary %s: invalid header magic", file_name);
 			return {};
 		}
-		if (header.binary_format_version != binary_format_version) {
+		if (header.binary_format_version < min_binary_format_version ||
+			header.binary_format_version > binary_format_version) {
 			log_error("universal binary %s: unsupported binary version %u", file_name, header.binary_format_version);
 			return {};
 		}
@@ -117,129 +182,296 @@ namespace universal_binary {
 			}
 		}
 		
-		// parse binaries
+		// verify binary offsets: binaries are stored consecutively, directly after the header
+		// NOTE: binary contents are only parsed and verified on demand (see load_binary)
+		// NOTE: identical binaries are only stored once -> multiple binaries may point to the same offset
+		const auto bin_header_size = binary_header_size(header.binary_format_version);
+		auto prev_offset = uint64_t(cur_size);
+		uint32_t last_bin_idx = 0;
 		for (uint32_t bin_idx = 0; bin_idx < bin_count; ++bin_idx) {
-			binary_dynamic_v2 bin;
-			
-			// verify binary offset
-			if (cur_size != ar->header.offsets[bin_idx]) {
-				log_error("universal binary %s: invalid binary offset, expected %u, got %u",
-						  file_name, ar->header.offsets[bin_idx], cur_size);
+			const auto& offset = ar->header.offsets[bin_idx];
+			if (bin_idx > 0 && offset < prev_offset) {
+				// must be the same as the offset of a previous binary (with the same hash)
+				const auto offsets_begin = ar->header.offsets.cbegin();
+				const auto shared_iter = find(offsets_begin, offsets_begin + bin_idx, offset);
+				if (shared_iter == offsets_begin + bin_idx ||
+					ar->header.hashes[bin_idx] != ar->header.hashes[size_t(shared_iter - offsets_begin)]) {
+					log_error("universal binary %s: invalid shared binary offset %u for binary #%u",
+							  file_name, offset, bin_idx);
+					return {};
+				}
+				continue;
+			}
+			if ((bin_idx == 0 && offset != prev_offset) ||
+				offset < prev_offset ||
+				offset + bin_header_size > data_size) {
+				log_error("universal binary %s: invalid binary offset %u for binary #%u",
+						  file_name, offset, bin_idx);
 				return {};
 			}
+			prev_offset = offset + bin_header_size;
+			last_bin_idx = bin_idx;
+		}
+		
+		ar->binaries.resize(bin_count);
+		ar->loaded.resize(bin_count, false);
+		
+		// optional extension section after the last (stored) binary
+		binary_v2 last_bin_header;
+		binary_compression_v3 last_bin_compression;
+		read_binary_header(*ar, last_bin_idx, last_bin_header, last_bin_compression);
+		const auto ext_offset = (ar->header.offsets[last_bin_idx] + bin_header_size +
+								 uint64_t(last_bin_header.function_info_size) + uint64_t(last_bin_compression.stored_size));
+		if (ext_offset < data_size && !parse_extension(*ar, size_t(ext_offset))) {
+			// not fatal, the extension section is only needed for incremental builds
+			log_warn("universal binary %s: invalid extension section", file_name);
+			ar->build_inputs.clear();
+		}
+		
+		return ar;
+	}
+	
+	//! parses the binary header and function info of the binary at "bin_idx" into "bin" (hash is not verified here)
+	static bool parse_binary(const archive& ar, const size_t bin_idx, binary_dynamic_v2& bin) {
+		const auto& file_name = ar.file_name;
+		const auto data_size = ar.file->size();
+		auto cur_size = size_t(ar.header.offsets[bin_idx]);
+		const uint8_t* data_ptr = ar.file->data() + cur_size;
+		
+		// static binary header + compression info (already bounds checked in load_archive)
+		read_binary_header(ar, bin_idx, bin.static_binary_header, bin.compression);
+		const auto bin_header_size = binary_header_size(ar.header.static_header.binary_format_version);
+		cur_size += bin_header_size;
+		data_ptr += bin_header_size;
+		
+		// verify compression info
+		switch (bin.compression.type) {
+			case BINARY_COMPRESSION::NONE:
+				if (bin.compression.stored_size != bin.static_binary_header.binary_size ||
+					bin.compression.dictionary_index != ~0u) {
+					log_error("universal binary %s: invalid compression info for binary #%u", file_name, bin_idx);
+					return false;
+				}
+				break;
+			case BINARY_COMPRESSION::LZ:
+				if (bin.compression.dictionary_index != ~0u &&
+					(bin.compression.dictionary_index >= ar.binaries.size() || bin.compression.dictionary_index == bin_idx)) {
+					log_error("universal binary %s: invalid compression dictionary for binary #%u", file_name, bin_idx);
+					return false;
+				}
+				break;
+			default:
+				log_error("universal binary %s: unknown compression type %u for binary #%u",
+						  file_name, uint32_t(bin.compression.type), bin_idx);
+				return false;
+		}
+		
+		// pre-check sizes (we're still going to do on-the-fly checks while parsing the actual data)
+		if (cur_size + bin.static_binary_header.function_info_size > data_size) {
+			log_error("universal binary %s: invalid binary function info size (pre-check), expected %u, got %u",
+					  file_name, cur_size + bin.static_binary_header.function_info_size, data_size);
+			return false;
+		}
+		if (cur_size + bin.static_binary_header.function_info_size + bin.compression.stored_size > data_size) {
+			log_error("universal binary %s: invalid binary size (pre-check), expected %u, got %u",
+					  file_name,
+					  cur_size + bin.static_binary_header.function_info_size + bin.compression.stored_size,
+					  data_size);
+			return false;
+		}
+		
+		// dynamic binary header
+		
+		// function info
+		const auto func_info_start_size = cur_size;
+		bin.functions.reserve(bin.static_binary_header.function_count);
+		for (uint32_t func_idx = 0; func_idx < bin.static_binary_header.function_count; ++func_idx) {
+			function_info_dynamic_v2 func_info;
 			
-			// static binary header
-			cur_size += sizeof(binary_v2);
+			// static function info
+			cur_size += sizeof(function_info_v2);
 			if (cur_size > data_size) {
-				log_error("universal binary %s: invalid static binary header size, expected %u, got %u",
+				log_error("universal binary %s: invalid static function info size, expected %u, got %u",
 						  file_name, cur_size, data_size);
-				return {};
+				return false;
 			}
-			memcpy(&bin.static_binary_header, data_ptr, sizeof(binary_v2));
-			data_ptr += sizeof(binary_v2);
+			memcpy(&func_info.static_function_info, data_ptr, sizeof(function_info_v2));
+			data_ptr += sizeof(function_info_v2);
 			
-			// pre-check sizes (we're still going to do on-the-fly checks while parsing the actual data)
-			if (cur_size + bin.static_binary_header.function_info_size > data_size) {
-				log_error("universal binary %s: invalid binary function info size (pre-check), expected %u, got %u",
-						  file_name, cur_size + bin.static_binary_header.function_info_size, data_size);
-				return {};
-			}
-			if (cur_size + bin.static_binary_header.function_info_size + bin.static_binary_header.binary_size > data_size) {
-				log_error("universal binary %s: invalid binary size (pre-check), expected %u, got %u",
-						  file_name,
-						  cur_size + bin.static_binary_header.function_info_size + bin.static_binary_header.binary_size,
-						  data_size);
-				return {};
+			if (func_info.static_function_info.function_info_version != function_info_version) {
+				log_error("universal binary %s: unsupported function info version %u",
+						  file_name, func_info.static_function_info.function_info_version);
+				return false;
 			}
 			
-			// dynamic binary header
-			
-			// function info
-			const auto func_info_start_size = cur_size;
-			for (uint32_t func_idx = 0; func_idx < bin.static_binary_header.function_count; ++func_idx) {
-				function_info_dynamic_v2 func_info;
-				
-				// static function info
-				cur_size += sizeof(function_info_v2);
-				if (cur_size > data_size) {
-					log_error("universal binary %s: invalid static function info size, expected %u, got %u",
-							  file_name, cur_size, data_size);
-					return {};
-				}
-				memcpy(&func_info.static_function_info, data_ptr, sizeof(function_info_v2));
-				data_ptr += sizeof(function_info_v2);
-				
-				if (func_info.static_function_info.function_info_version != function_info_version) {
-					log_error("universal binary %s: unsupported function info version %u",
-							  file_name, func_info.static_function_info.function_info_version);
-					return {};
-				}
-				
-				// dynamic function info
-				for (;;) {
-					// name (\0 terminated)
-					++cur_size;
-					if (cur_size > data_size) {
-						log_error("universal binary %s: invalid function info name size, expected %u, got %u",
-								  file_name, cur_size, data_size);
-						return {};
-					}
-					
-					const auto ch = *data_ptr++;
-					if (ch == 0) {
-						break;
-					}
-					func_info.name += *(const char*)&ch;
-				}
-				
-				for (uint32_t arg_idx = 0; arg_idx < func_info.static_function_info.arg_count; ++arg_idx) {
-					function_info_dynamic_v2::arg_info arg;
-					
-					cur_size += sizeof(function_info_dynamic_v2::arg_info);
-					if (cur_size > data_size) {
-						log_error("universal binary %s: invalid function info arg size, expected %u, got %u",
-								  file_name, cur_size, data_size);
-						return {};
-					}
-					memcpy(&arg, data_ptr, sizeof(function_info_dynamic_v2::arg_info));
-					data_ptr += sizeof(function_info_dynamic_v2::arg_info);
-					
-					func_info.args.emplace_back(arg);
-				}
-				
-				bin.functions.emplace_back(func_info);
-			}
-			const auto func_info_end_size = cur_size;
-			const auto func_info_size = func_info_end_size - func_info_start_size;
-			if (func_info_size != size_t(bin.static_binary_header.function_info_size)) {
-				log_error("universal binary %s: invalid binary function info size, expected %u, got %u",
-						  file_name, bin.static_binary_header.function_info_size, func_info_size);
-				return {};
+			// dynamic function info
+			// name (\0 terminated)
+			const auto name_max_len = data_size - cur_size;
+			const auto name_len = strnlen((const char*)data_ptr, name_max_len);
+			if (name_len == name_max_len) {
+				log_error("universal binary %s: invalid function info name size, expected %u, got %u",
+						  file_name, cur_size + name_len + 1, data_size);
+				return false;
 			}
+			func_info.name.assign((const char*)data_ptr, name_len);
+			cur_size += name_len + 1;
+			data_ptr += name_len + 1;
 			
-			// binary data
-			cur_size += bin.static_binary_header.binary_size;
+			const auto args_size = sizeof(function_info_dynamic_v2::arg_info) * func_info.static_function_info.arg_count;
+			cur_size += args_size;
 			if (cur_size > data_size) {
-				log_error("universal binary %s: invalid binary size, expected %u, got %u",
+				log_error("universal binary %s: invalid function info arg size, expected %u, got %u",
 						  file_name, cur_size, data_size);
-				return {};
+				return false;
 			}
-			bin.data.resize(bin.static_binary_header.binary_size);
-			memcpy(bin.data.data(), data_ptr, bin.static_binary_header.binary_size);
-			data_ptr += bin.static_binary_header.binary_size;
+			func_info.args.resize(func_info.static_function_info.arg_count);
+			memcpy(func_info.args.data(), data_ptr, args_size);
+			data_ptr += args_size;
 			
-			// verify binary
-			const auto hash = sha_256::compute_hash(bin.data.data(), bin.data.size());
-			if (hash != ar->header.hashes[bin_idx]) {
-				log_error("universal binary %s: invalid binary (hash mismatch)", file_name);
-				return {};
+			bin.functions.emplace_back(move(func_info));
+		}
+		const auto func_info_end_size = cur_size;
+		const auto func_info_size = func_info_end_size - func_info_start_size;
+		if (func_info_size != size_t(bin.static_binary_header.function_info_size)) {
+			log_error("universal binary %s: invalid binary function info size, expected %u, got %u",
+					  file_name, bin.static_binary_header.function_info_size, func_info_size);
+			return false;
+		}
+		
+		// binary data (directly referenced inside the mapped file)
+		// NOTE: for compressed binaries, this initially points to the compressed data (see load_binaries)
+		cur_size += bin.compression.stored_size;
+		if (cur_size > data_size) {
+			log_error("universal binary %s: invalid binary size, expected %u, got %u",
+					  file_name, cur_size, data_size);
+			return false;
+		}
+		bin.data = { data_ptr, bin.compression.stored_size };
+		return true;
+	}
+	
+	bool load_binaries(archive& ar, const vector<size_t>& bin_indices) {
+		// parse all binaries that haven't been loaded yet
+		// NOTE: binaries that are shared with another binary (same offset) are only parsed/loaded once
+		vector<pair<size_t, binary_dynamic_v2>> parsed_binaries;
+		vector<pair<size_t, size_t>> shared_binaries; // <binary index, index of the binary with the same data>
+		parsed_binaries.reserve(bin_indices.size());
+		for (const auto& bin_idx : bin_indices) {
+			if (bin_idx >= ar.binaries.size() || !ar.file) {
+				log_error("universal binary %s: invalid binary index %u", ar.file_name, bin_idx);
+				return false;
+			}
+			if (ar.loaded[bin_idx] ||
+				find_if(parsed_binaries.begin(), parsed_binaries.end(), [&bin_idx](const auto& parsed_bin) {
+					return (parsed_bin.first == bin_idx);
+				}) != parsed_binaries.end()) {
+				continue;
 			}
 			
-			// binary done
-			ar->binaries.emplace_back(bin);
+			const auto& offset = ar.header.offsets[bin_idx];
+			const auto shared_parsed_bin = find_if(parsed_binaries.begin(), parsed_binaries.end(), [&ar, &offset](const auto& parsed_bin) {
+				return (ar.header.offsets[parsed_bin.first] == offset);
+			});
+			if (shared_parsed_bin != parsed_binaries.end()) {
+				shared_binaries.emplace_back(bin_idx, shared_parsed_bin->first);
+				continue;
+			}
+			bool is_shared_with_loaded_bin = false;
+			for (size_t other_idx = 0, count = ar.binaries.size(); other_idx < count; ++other_idx) {
+				if (ar.loaded[other_idx] && ar.header.offsets[other_idx] == offset) {
+					ar.binaries[bin_idx] = ar.binaries[other_idx];
+					ar.loaded[bin_idx] = true;
+					is_shared_with_loaded_bin = true;
+					break;
+				}
+			}
+			if (is_shared_with_loaded_bin) {
+				continue;
+			}
+			
+			binary_dynamic_v2 bin;
+			if (!parse_binary(ar, bin_idx, bin)) {
+				return false;
+			}
+			parsed_binaries.emplace_back(bin_idx, move(bin));
+		}
+		if (parsed_binaries.empty()) {
+			return true;
 		}
 		
-		return ar;
+		// load all compression dictionaries first
+		vector<size_t> dict_indices;
+		for (const auto& parsed_bin : parsed_binaries) {
+			const auto& compression = parsed_bin.second.compression;
+			if (compression.type != BINARY_COMPRESSION::LZ || compression.dictionary_index == ~0u) {
+				continue;
+			}
+			binary_v2 dict_header;
+			binary_compression_v3 dict_compression;
+			read_binary_header(ar, compression.dictionary_index, dict_header, dict_compression);
+			if (dict_compression.dictionary_index != ~0u) {
+				log_error("universal binary %s: invalid chained compression dictionary for binary #%u",
+						  ar.file_name, parsed_bin.first);
+				return false;
+			}
+			dict_indices.emplace_back(compression.dictionary_index);
+		}
+		if (!dict_indices.empty()) {
+			if (!load_binaries(ar, dict_indices)) {
+				return false;
+			}
+			// dictionaries that were also requested here have been fully loaded already
+			parsed_binaries.erase(remove_if(parsed_binaries.begin(), parsed_binaries.end(), [&ar](const auto& parsed_bin) {
+				return ar.loaded[parsed_bin.first];
+			}), parsed_binaries.end());
+		}
+		
+		// decompress
+		for (auto& parsed_bin : parsed_binaries) {
+			auto& bin = parsed_bin.second;
+			if (bin.compression.type != BINARY_COMPRESSION::LZ) {
+				continue;
+			}
+			const binary_data_view dict_data = (bin.compression.dictionary_index != ~0u ?
+												ar.binaries[bin.compression.dictionary_index].data : binary_data_view {});
+			bin.decompressed_data = make_shared<vector<uint8_t>>(size_t(bin.static_binary_header.binary_size));
+			if (!lz_codec::decompress(bin.data.data(), bin.data.size(),
+									  bin.decompressed_data->data(), bin.decompressed_data->size(),
+									  dict_data.data(), dict_data.size())) {
+				log_error("universal binary %s: failed to decompress binary #%u", ar.file_name, parsed_bin.first);
+				return false;
+			}
+			bin.data = { bin.decompressed_data->data(), bin.decompressed_data->size() };
+		}
+		
+		// verify all binaries (hashed in parallel)
+		vector<pair<const uint8_t*, size_t>> hash_inputs;
+		hash_inputs.reserve(parsed_binaries.size());
+		for (const auto& parsed_bin : parsed_binaries) {
+			hash_inputs.emplace_back(parsed_bin.second.data.data(), parsed_bin.second.data.size());
+		}
+		const auto hashes = sha_256::compute_hashes_parallel(hash_inputs);
+		for (size_t i = 0, count = parsed_binaries.size(); i < count; ++i) {
+			if (hashes[i] != ar.header.hashes[parsed_binaries[i].first]) {
+				log_error("universal binary %s: invalid binary #%u (hash mismatch)", ar.file_name, parsed_binaries[i].first);
+				return false;
+			}
+		}
+		
+		// binaries done
+		for (auto& parsed_bin : parsed_binaries) {
+			ar.binaries[parsed_bin.first] = move(parsed_bin.second);
+			ar.loaded[parsed_bin.first] = true;
+		}
+		for (const auto& shared_bin : shared_binaries) {
+			ar.binaries[shared_bin.first] = ar.binaries[shared_bin.second];
+			ar.loaded[shared_bin.first] = true;
+		}
+		return true;
+	}
+	
+	bool load_binary(archive& ar, const size_t bin_idx) {
+		return load_binaries(ar, { bin_idx });
 	}
 	
 	struct compile_return_t {
@@ -498,26 +730,165 @@ namespace universal_binary {
 		return { true, toolchain_version, program };
 	}
 	
-	static bool build_archive(const string& src_input,
-							  const bool is_file_input,
-							  const string& dst_archive_file_name,
-							  const llvm_toolchain::compile_options& options,
-							  const vector<target>& targets_in) {
-		// make sure we can open the output file before we start doing anything else
-		file_io archive(dst_archive_file_name, file_io::OPEN_TYPE::WRITE_BINARY);
-		if (!archive.is_open()) {
-			log_error("can't write archive to %s", dst_archive_file_name);
+	//! returns the toolchain version that is used to build binaries for the specified target
+	static uint32_t target_toolchain_version(const target& build_target) {
+		switch (build_target.type) {
+			case COMPUTE_TYPE::OPENCL: return floor::get_opencl_toolchain_version();
+			case COMPUTE_TYPE::CUDA: return floor::get_cuda_toolchain_version();
+			case COMPUTE_TYPE::METAL: return floor::get_metal_toolchain_version();
+			case COMPUTE_TYPE::VULKAN: return floor::get_vulkan_toolchain_version();
+			case COMPUTE_TYPE::HOST:
+			case COMPUTE_TYPE::NONE:
+				break;
+		}
+		return 0;
+	}
+	
+	//! computes the hash of all build inputs of a target: source code, compile options, target, toolchain version
+	//! and the contents of all dependencies (as reported by the compiler)
+	//! NOTE: returns an empty optional if any dependency can not be read (-> must rebuild)
+	static optional<sha_256::hash_t> compute_input_hash(const string& src_input,
+														const bool is_file_input,
+														const llvm_toolchain::compile_options& options,
+														const target& build_target,
+														const vector<string>& dependencies) {
+		string input_data = "fuba-build-input-v1\n";
+		input_data += (is_file_input ? "file:" : "code:") + src_input + '\n';
+		input_data += options.cli + '\n';
+		input_data += to_string(options.enable_warnings) + to_string(options.emit_debug_line_info) + '\n';
+		input_data += to_string(options.cuda.ptx_version) + ',' + to_string(options.cuda.max_registers) + ',' +
+					  to_string(options.cuda.short_ptr) + '\n';
+		input_data += to_string(options.metal.soft_printf ? *options.metal.soft_printf : floor::get_metal_soft_printf()) + '\n';
+		input_data += to_string(build_target.value) + ',' + to_string(target_toolchain_version(build_target)) + '\n';
+		
+		for (const auto& dep : dependencies) {
+			if (!file_io::is_file(dep)) {
+				return {};
+			}
+			auto dep_file = file_io::map_file(dep);
+			if (!dep_file) {
+				return {};
+			}
+			const auto dep_hash = sha_256::compute_hash_fast(dep_file->data(), dep_file->size());
+			input_data += dep + '\n';
+			input_data.append((const char*)&dep_hash, sizeof(dep_hash));
+		}
+		return sha_256::compute_hash_fast((const uint8_t*)input_data.data(), input_data.size());
+	}
+	
+	//! returns true if both function infos are identical
+	static bool is_same_function_info(const vector<llvm_toolchain::function_info>& lhs,
+									  const vector<llvm_toolchain::function_info>& rhs) {
+		if (lhs.size() != rhs.size()) {
 			return false;
 		}
+		for (size_t i = 0, count = lhs.size(); i < count; ++i) {
+			const auto& lfunc = lhs[i];
+			const auto& rfunc = rhs[i];
+			if (lfunc.name != rfunc.name ||
+				lfunc.type != rfunc.type ||
+				lfunc.flags != rfunc.flags ||
+				(lfunc.local_size != rfunc.local_size).any() ||
+				lfunc.args.size() != rfunc.args.size()) {
+				return false;
+			}
+			for (size_t arg_idx = 0, arg_count = lfunc.args.size(); arg_idx < arg_count; ++arg_idx) {
+				const auto& larg = lfunc.args[arg_idx];
+				const auto& rarg = rfunc.args[arg_idx];
+				if (larg.size != rarg.size ||
+					larg.address_space != rarg.address_space ||
+					larg.image_type != rarg.image_type ||
+					larg.image_access != rarg.image_access ||
+					larg.special_type != rarg.special_type) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+	
+	//! writes the binary header, compression info, function info and binary data of the specified program to the archive
+	//! NOTE: if compressed, "compressed_data" is written instead of the program binary data
+	static void write_binary(file_io& archive, const llvm_toolchain::program_data& bin,
+							 const binary_compression_v3& compression, const vector<uint8_t>& compressed_data) {
+		// static header
+		binary_dynamic_v2 bin_data {
+			.static_binary_header = {
+				.function_count = uint32_t(bin.functions.size()),
+				.function_info_size = 0, // N/A yet
+				.binary_size = uint32_t(bin.data_or_filename.size()),
+			},
+		};
+		// NOTE: bin_data.data must not even be written/copied here
 		
-		// create a thread pool of #logical-cpus threads that build all targets
+		// convert function info
+		bin_data.functions.reserve(bin.functions.size());
+		for (const auto& func : bin.functions) {
+			function_info_dynamic_v2 finfo {
+				.static_function_info = {
+					.function_info_version = function_info_version,
+					.type = func.type,
+					.flags = func.flags,
+					.arg_count = uint32_t(func.args.size()),
+					.local_size = func.local_size,
+				},
+				.name = func.name,
+				.args = {}, // need proper conversion
+			};
+			bin_data.static_binary_header.function_info_size += sizeof(finfo.static_function_info);
+			bin_data.static_binary_header.function_info_size += finfo.name.size() + 1 /* \0 */;
+			
+			// convert/create args
+			finfo.args.reserve(func.args.size());
+			for (const auto& arg : func.args) {
+				finfo.args.emplace_back(function_info_dynamic_v2::arg_info {
+					.argument_size = arg.size,
+					.address_space = arg.address_space,
+					._unused_0 = 0,
+					.image_type = arg.image_type,
+					.image_access = arg.image_access,
+					._unused_1 = 0,
+					.special_type = arg.special_type,
+				});
+			}
+			bin_data.static_binary_header.function_info_size += sizeof(function_info_dynamic_v2::arg_info) * finfo.args.size();
+			
+			bin_data.functions.emplace_back(move(finfo));
+		}
+		
+		// write static header + compression info
+		archive.write_block(&bin_data.static_binary_header, sizeof(bin_data.static_binary_header));
+		archive.write_block(&compression, sizeof(compression));
+		
+		// write dynamic binary part
+		for (const auto& finfo : bin_data.functions) {
+			archive.write_block(&finfo.static_function_info, sizeof(finfo.static_function_info));
+			archive.write_terminated_block(finfo.name, 0);
+			archive.write_block(finfo.args.data(), finfo.args.size() * sizeof(typename decltype(finfo.args)::value_type));
+		}
+		if (compression.type == BINARY_COMPRESSION::LZ) {
+			archive.write_block(compressed_data.data(), compressed_data.size());
+		} else {
+			archive.write_block(bin.data_or_filename.data(), bin.data_or_filename.size());
+		}
+	}
+	
+	static bool build_archive(const string& src_input,
+							  const bool is_file_input,
+							  const string& dst_archive_file_name,
+							  const llvm_toolchain::compile_options& options_in,
+							  const vector<target>& targets_in,
+							  const bool incremental,
+							  build_report* report) {
+		const auto build_start = core::unix_timestamp_us();
 		const auto target_count = targets_in.size();
-		const auto compile_job_count = uint32_t(min(size_t(core::get_hw_thread_count()), target_count));
 		
-		// enqueue + sanitize targets
-		safe_mutex targets_lock;
+		// dependencies are always needed, so that the build inputs can be stored
+		auto options = options_in;
+		options.collect_dependencies = true;
+		
+		// sanitize targets
 		vector<target_v2> targets;
-		deque<pair<size_t, target>> remaining_targets;
 		for (size_t i = 0; i < target_count; ++i) {
 			auto target = targets_in[i];
 			switch (target.type) {
@@ -542,36 +913,129 @@ namespace universal_binary {
 			}
 			
 			targets.emplace_back(target);
-			remaining_targets.emplace_back(i, target);
 		}
 		
-		safe_mutex prog_data_lock;
 		vector<unique_ptr<llvm_toolchain::program_data>> targets_prog_data(target_count);
 		vector<uint32_t> targets_toolchain_version(target_count);
 		vector<sha_256::hash_t> targets_hashes(target_count);
+		vector<build_input_v2> targets_build_inputs(target_count);
+		vector<target_build_report> targets_report(target_count);
+		for (size_t i = 0; i < target_count; ++i) {
+			targets_report[i].target = targets[i];
+		}
 		
-		atomic<uint32_t> remaining_compile_jobs { compile_job_count };
+		// the previous archive (if any) is used to schedule the longest builds first (based on their previous compile time),
+		// and for incremental builds: reuse all binaries whose build inputs haven't changed
+		// NOTE: targets without a previous compile time are assumed to take the longest
+		vector<uint64_t> expected_compile_times(target_count, ~uint64_t(0));
+		if (file_io::is_file(dst_archive_file_name)) {
+			// NOTE: the archive is memory-mapped -> must be closed again before the output file is written
+			auto prev_ar = load_archive(dst_archive_file_name);
+			if (prev_ar && prev_ar->build_inputs.size() == prev_ar->binaries.size()) {
+				vector<size_t> prev_indices(target_count, ~size_t(0));
+				vector<bool> prev_bin_used(prev_ar->binaries.size(), false);
+				for (size_t i = 0; i < target_count; ++i) {
+					for (size_t prev_idx = 0, prev_count = prev_ar->header.targets.size(); prev_idx < prev_count; ++prev_idx) {
+						if (!prev_bin_used[prev_idx] && prev_ar->header.targets[prev_idx].value == targets[i].value) {
+							prev_indices[i] = prev_idx;
+							prev_bin_used[prev_idx] = true;
+							expected_compile_times[i] = prev_ar->build_inputs[prev_idx].compile_time_us;
+							break;
+						}
+					}
+				}
+				
+				if (incremental) {
+					vector<pair<size_t, size_t>> reused_binaries; // <target index, previous binary index>
+					vector<size_t> prev_bin_indices;
+					for (size_t i = 0; i < target_count; ++i) {
+						if (prev_indices[i] == ~size_t(0)) {
+							continue;
+						}
+						const auto& prev_input = prev_ar->build_inputs[prev_indices[i]];
+						const auto input_hash = compute_input_hash(src_input, is_file_input, options, targets[i],
+																   prev_input.dependencies);
+						if (input_hash && *input_hash == prev_input.hash) {
+							reused_binaries.emplace_back(i, prev_indices[i]);
+							prev_bin_indices.emplace_back(prev_indices[i]);
+						}
+					}
+					
+					if (!load_binaries(*prev_ar, prev_bin_indices)) {
+						log_warn("failed to load binaries from %s, rebuilding all targets", dst_archive_file_name);
+					} else {
+						for (const auto& reused_bin : reused_binaries) {
+							const auto& prev_bin = prev_ar->binaries[reused_bin.second];
+							auto prog_data = make_unique<llvm_toolchain::program_data>();
+							prog_data->valid = true;
+							prog_data->data_or_filename.assign((const char*)prev_bin.data.data(), prev_bin.data.size());
+							prog_data->functions = translate_function_info(prev_bin.functions);
+							targets_prog_data[reused_bin.first] = move(prog_data);
+							targets_toolchain_version[reused_bin.first] = prev_ar->header.toolchain_versions[reused_bin.second];
+							targets_hashes[reused_bin.first] = prev_ar->header.hashes[reused_bin.second];
+							targets_build_inputs[reused_bin.first] = prev_ar->build_inputs[reused_bin.second];
+							targets_report[reused_bin.first].reused = true;
+						}
+						log_msg("reusing %u of %u binaries from %s", reused_binaries.size(), target_count, dst_archive_file_name);
+					}
+				}
+			}
+		}
+		
+		// make sure we can open the output file before we start compiling
+		file_io archive(dst_archive_file_name, file_io::OPEN_TYPE::WRITE_BINARY);
+		if (!archive.is_open()) {
+			log_error("can't write archive to %s", dst_archive_file_name);
+			return false;
+		}
+		
+		// schedule all targets that need to be built, longest (expected) builds first
+		vector<size_t> build_queue;
+		for (size_t i = 0; i < target_count; ++i) {
+			if (!targets_prog_data[i]) {
+				build_queue.emplace_back(i);
+			}
+		}
+		stable_sort(build_queue.begin(), build_queue.end(), [&expected_compile_times](const size_t& lhs, const size_t& rhs) {
+			return (expected_compile_times[lhs] > expected_compile_times[rhs]);
+		});
+		atomic<size_t> build_queue_pos { 0u };
+		
+		// build state that is shared between the build jobs and the archive writer (this thread)
+		safe_mutex build_state_lock;
+		condition_variable_any build_state_cv;
+		vector<bool> targets_done(target_count, false);
+		for (size_t i = 0; i < target_count; ++i) {
+			targets_done[i] = (targets_prog_data[i] != nullptr);
+		}
 		atomic<bool> compilation_successful { true };
+		
+		// create a thread pool of #logical-cpus threads that build all targets
+		// NOTE: all build state lives on this stack -> the build jobs are joined before it goes out of scope
+		const auto compile_job_count = uint32_t(min(size_t(core::get_hw_thread_count()), build_queue.size()));
+		uint32_t remaining_compile_jobs = compile_job_count;
+		vector<thread> compile_jobs;
+		compile_jobs.reserve(compile_job_count);
 		for (uint32_t i = 0; i < compile_job_count; ++i) {
-			task::spawn([&src_input, &is_file_input, &options,
-						 &targets_lock, &remaining_targets,
-						 &prog_data_lock, &targets_prog_data, &targets_toolchain_version, &targets_hashes,
-						 &remaining_compile_jobs,
-						 &compilation_successful]() {
+			compile_jobs.emplace_back([i, &src_input, &is_file_input, &options, &targets,
+									   &build_queue, &build_queue_pos,
+									   &build_state_lock, &build_state_cv, &targets_done, &remaining_compile_jobs,
+									   &targets_prog_data, &targets_toolchain_version, &targets_hashes,
+									   &targets_build_inputs, &targets_report,
+									   &compilation_successful]() {
+				core::set_current_thread_name("build_job_" + to_string(i));
 				while (compilation_successful) {
-					// get a target
-					pair<size_t, target> build_target;
-					{
-						GUARD(targets_lock);
-						if (remaining_targets.empty()) {
-							break;
-						}
-						build_target = remaining_targets[0];
-						remaining_targets.pop_front();
+					// get the next target
+					const auto queue_idx = build_queue_pos++;
+					if (queue_idx >= build_queue.size()) {
+						break;
 					}
+					const auto target_idx = build_queue[queue_idx];
+					const auto& build_target = targets[target_idx];
 					
 					// compile the target
-					auto compile_ret = compile_target(src_input, is_file_input, options, build_target.second);
+					const auto compile_start = core::unix_timestamp_us();
+					auto compile_ret = compile_target(src_input, is_file_input, options, build_target);
 					if (!compile_ret.success || !compile_ret.prog_data.valid) {
 						compilation_successful = false;
 						break;
@@ -590,55 +1054,60 @@ namespace universal_binary {
 						}
 						compile_ret.prog_data.data_or_filename = move(bin_data);
 					}
+					const auto hash_start = core::unix_timestamp_us();
 					
 					// compute binary hash
-					const auto binary_hash = sha_256::compute_hash((const uint8_t*)compile_ret.prog_data.data_or_filename.c_str(),
-																   compile_ret.prog_data.data_or_filename.size());
+					const auto binary_hash = sha_256::compute_hash_fast((const uint8_t*)compile_ret.prog_data.data_or_filename.c_str(),
+																		compile_ret.prog_data.data_or_filename.size());
 					
-					// add to program data array
+					// compute build input hash (if any dependency can't be hashed, this will always be rebuilt)
+					build_input_v2 build_input;
+					build_input.dependencies = move(compile_ret.prog_data.dependencies);
+					build_input.compile_time_us = hash_start - compile_start;
+					const auto input_hash = compute_input_hash(src_input, is_file_input, options, build_target,
+															   build_input.dependencies);
+					if (input_hash) {
+						build_input.hash = *input_hash;
+					}
+					const auto hash_end = core::unix_timestamp_us();
+					
+					// add to program data array and signal the archive writer
 					{
 						auto prog_data = make_unique<llvm_toolchain::program_data>();
 						*prog_data = move(compile_ret.prog_data);
 						
-						GUARD(prog_data_lock);
-						targets_prog_data[build_target.first] = move(prog_data);
-						targets_toolchain_version[build_target.first] = compile_ret.toolchain_version;
-						targets_hashes[build_target.first] = binary_hash;
+						GUARD(build_state_lock);
+						targets_prog_data[target_idx] = move(prog_data);
+						targets_toolchain_version[target_idx] = compile_ret.toolchain_version;
+						targets_hashes[target_idx] = binary_hash;
+						targets_build_inputs[target_idx] = move(build_input);
+						targets_report[target_idx].compile_time_us = hash_start - compile_start;
+						targets_report[target_idx].hash_time_us = hash_end - hash_start;
+						targets_done[target_idx] = true;
+						build_state_cv.notify_all();
 					}
 				}
+				
+				GUARD(build_state_lock);
 				--remaining_compile_jobs;
-			}, "build_job_" + to_string(i));
-		}
-		
-		while (remaining_compile_jobs > 0) {
-			this_thread::sleep_for(250ms);
-			this_thread::yield();
-		}
-		
-		// check success and output validity
-		if (!compilation_successful) {
-			return false;
-		}
-		for (const auto& prog_data : targets_prog_data) {
-			if (prog_data == nullptr) {
-				return false;
-			}
+				build_state_cv.notify_all();
+			});
 		}
 		
-		// write binary
+		// write the header
+		// NOTE: binary offsets, toolchain versions and hashes are only known once all binaries have been built/written,
+		//       -> these are updated at the end
 		header_dynamic_v2 header {
 			.static_header = {
 				.binary_format_version = binary_format_version,
-				.binary_count = uint32_t(targets_prog_data.size()),
+				.binary_count = uint32_t(target_count),
 			},
 			.targets = targets,
-			.toolchain_versions = move(targets_toolchain_version),
-			.hashes = move(targets_hashes),
 		};
-		// NOTE: proper offsets are written later on
-		header.offsets.resize(header.static_header.binary_count);
+		header.offsets.resize(target_count);
+		header.toolchain_versions.resize(target_count);
+		header.hashes.resize(target_count);
 		
-		// header
 		auto& ar_stream = *archive.get_filestream();
 		archive.write_block(&header.static_header, sizeof(header_v2));
 		archive.write_block(header.targets.data(), target_count * sizeof(typename decltype(header.targets)::value_type));
@@ -648,89 +1117,132 @@ namespace universal_binary {
 							header.toolchain_versions.size() * sizeof(typename decltype(header.toolchain_versions)::value_type));
 		archive.write_block(header.hashes.data(), header.hashes.size() * sizeof(typename decltype(header.hashes)::value_type));
 		
-		// binaries
+		// binaries are compressed when written, with the first binary of each compute type being used as the dictionary
+		// for all following binaries of the same type (these tend to share most of their code)
+		// NOTE: the uncompressed data of these must be kept until all binaries have been written
+		struct compression_dictionary {
+			COMPUTE_TYPE type;
+			uint32_t index;
+			unique_ptr<llvm_toolchain::program_data> bin;
+		};
+		vector<compression_dictionary> dictionaries;
+		
+		// identical binaries (same data hash + function info) are only stored once, sharing the same offset
+		struct stored_binary {
+			sha_256::hash_t hash;
+			uint64_t offset;
+			vector<llvm_toolchain::function_info> functions;
+		};
+		vector<stored_binary> stored_binaries;
+		
+		// write all binaries in order, as soon as they are available (while the remaining ones are still being built)
 		for (size_t i = 0; i < target_count; ++i) {
-			const auto& bin = *targets_prog_data[i];
-			
-			// remember offset
-			header.offsets[i] = uint64_t(ar_stream.tellp());
+			unique_ptr<llvm_toolchain::program_data> bin;
+			{
+				GUARD(build_state_lock);
+				build_state_cv.wait(build_state_lock, [&i, &targets_done, &compilation_successful, &remaining_compile_jobs] {
+					return (targets_done[i] || !compilation_successful || remaining_compile_jobs == 0);
+				});
+				if (!targets_done[i]) {
+					compilation_successful = false;
+					break;
+				}
+				// binary data is no longer needed after it has been written
+				bin = move(targets_prog_data[i]);
+				header.toolchain_versions[i] = targets_toolchain_version[i];
+				header.hashes[i] = targets_hashes[i];
+			}
 			
-			// static header
-			binary_dynamic_v2 bin_data {
-				.static_binary_header = {
-					.function_count = uint32_t(bin.functions.size()),
-					.function_info_size = 0, // N/A yet
-					.binary_size = uint32_t(bin.data_or_filename.size()),
-				},
-			};
-			// NOTE: bin_data.data must not even be written/copied here
+			const auto stored_bin = find_if(stored_binaries.begin(), stored_binaries.end(), [&header, &i, &bin](const stored_binary& entry) {
+				return (entry.hash == header.hashes[i] && is_same_function_info(entry.functions, bin->functions));
+			});
+			if (stored_bin != stored_binaries.end()) {
+				header.offsets[i] = stored_bin->offset;
+				continue;
+			}
 			
-			// convert function info
-			bin_data.functions.reserve(bin.functions.size());
-			for (const auto& func : bin.functions) {
-				function_info_dynamic_v2 finfo {
-					.static_function_info = {
-						.function_info_version = function_info_version,
-						.type = func.type,
-						.flags = func.flags,
-						.arg_count = uint32_t(func.args.size()),
-						.local_size = func.local_size,
-					},
-					.name = func.name,
-					.args = {}, // need proper conversion
-				};
-				bin_data.static_binary_header.function_info_size += sizeof(finfo.static_function_info);
-				bin_data.static_binary_header.function_info_size += finfo.name.size() + 1 /* \0 */;
-				
-				// convert/create args
-				finfo.args.reserve(func.args.size());
-				for (const auto& arg : func.args) {
-					finfo.args.emplace_back(function_info_dynamic_v2::arg_info {
-						.argument_size = arg.size,
-						.address_space = arg.address_space,
-						._unused_0 = 0,
-						.image_type = arg.image_type,
-						.image_access = arg.image_access,
-						._unused_1 = 0,
-						.special_type = arg.special_type,
-					});
-				}
-				bin_data.static_binary_header.function_info_size += sizeof(function_info_dynamic_v2::arg_info) * finfo.args.size();
-				
-				bin_data.functions.emplace_back(move(finfo));
+			// only store the compressed data if it is actually smaller
+			const auto dict = find_if(dictionaries.begin(), dictionaries.end(), [&targets, &i](const compression_dictionary& entry) {
+				return (entry.type == targets[i].type);
+			});
+			const auto& bin_data = bin->data_or_filename;
+			binary_compression_v3 compression;
+			auto compressed_data = lz_codec::compress((const uint8_t*)bin_data.data(), bin_data.size(),
+													  dict != dictionaries.end() ? (const uint8_t*)dict->bin->data_or_filename.data() : nullptr,
+													  dict != dictionaries.end() ? dict->bin->data_or_filename.size() : 0u);
+			if (compressed_data.size() < bin_data.size()) {
+				compression.type = BINARY_COMPRESSION::LZ;
+				compression.stored_size = uint32_t(compressed_data.size());
+				compression.dictionary_index = (dict != dictionaries.end() ? dict->index : ~0u);
+			} else {
+				compression.stored_size = uint32_t(bin_data.size());
+				compressed_data.clear();
 			}
 			
-			// write static header
-			archive.write_block(&bin_data.static_binary_header, sizeof(bin_data.static_binary_header));
+			header.offsets[i] = uint64_t(ar_stream.tellp());
+			write_binary(archive, *bin, compression, compressed_data);
+			stored_binaries.emplace_back(stored_binary { header.hashes[i], header.offsets[i], bin->functions });
 			
-			// write dynamic binary part
-			for (const auto& finfo : bin_data.functions) {
-				archive.write_block(&finfo.static_function_info, sizeof(finfo.static_function_info));
-				archive.write_terminated_block(finfo.name, 0);
-				archive.write_block(finfo.args.data(), finfo.args.size() * sizeof(typename decltype(finfo.args)::value_type));
+			if (dict == dictionaries.end()) {
+				dictionaries.emplace_back(compression_dictionary { targets[i].type, uint32_t(i), move(bin) });
 			}
-			archive.write_block(bin.data_or_filename.data(), bin.data_or_filename.size());
 		}
 		
-		// update binary offsets now that we know them all
+		// wait until all build jobs have finished
+		for (auto& compile_job : compile_jobs) {
+			compile_job.join();
+		}
+		
+		// check success
+		if (!compilation_successful) {
+			archive.close();
+			remove(dst_archive_file_name.c_str());
+			return false;
+		}
+		
+		// extension section
+		archive.write_block("FUBE", 4);
+		archive.write_block(&extension_version, sizeof(extension_version));
+		for (const auto& build_input : targets_build_inputs) {
+			archive.write_block(&build_input.hash, sizeof(build_input.hash));
+			archive.write_block(&build_input.compile_time_us, sizeof(build_input.compile_time_us));
+			const auto dep_count = uint32_t(build_input.dependencies.size());
+			archive.write_block(&dep_count, sizeof(dep_count));
+			for (const auto& dep : build_input.dependencies) {
+				archive.write_terminated_block(dep, 0);
+			}
+		}
+		
+		// update binary offsets, toolchain versions and hashes now that we know them all
 		ar_stream.seekp(header_offsets_pos);
 		archive.write_block(header.offsets.data(), header.offsets.size() * sizeof(typename decltype(header.offsets)::value_type));
+		archive.write_block(header.toolchain_versions.data(),
+							header.toolchain_versions.size() * sizeof(typename decltype(header.toolchain_versions)::value_type));
+		archive.write_block(header.hashes.data(), header.hashes.size() * sizeof(typename decltype(header.hashes)::value_type));
 		
+		if (report != nullptr) {
+			report->targets = move(targets_report);
+			report->total_time_us = core::unix_timestamp_us() - build_start;
+		}
 		return true;
 	}
 	
 	bool build_archive_from_file(const string& src_file_name,
 								 const string& dst_archive_file_name,
 								 const llvm_toolchain::compile_options& options,
-								 const vector<target>& targets) {
-		return build_archive(src_file_name, true, dst_archive_file_name, options, targets);
+								 const vector<target>& targets,
+								 const bool incremental,
+								 build_report* report) {
+		return build_archive(src_file_name, true, dst_archive_file_name, options, targets, incremental, report);
 	}
 	
 	bool build_archive_from_memory(const string& src_code,
 								   const string& dst_archive_file_name,
 								   const llvm_toolchain::compile_options& options,
-								   const vector<target>& targets) {
-		return build_archive(src_code, false, dst_archive_file_name, options, targets);
+								   const vector<target>& targets,
+								   const bool incremental,
+								   build_report* report) {
+		return build_archive(src_code, false, dst_archive_file_name, options, targets, incremental, report);
 	}
 	
 	pair<const binary_dynamic_v2*, const target_v2>
@@ -1249,7 +1761,9 @@ namespace universal_binary {
 		
 		// find the best matching binary for each device
 		vector<pair<const universal_binary::binary_dynamic_v2*, const universal_binary::target_v2>> dev_binaries;
+		vector<size_t> bin_indices;
 		dev_binaries.reserve(devices.size());
+		bin_indices.reserve(devices.size());
 		for (const auto& dev : devices) {
 			const auto best_bin = universal_binary::find_best_match_for_device(*dev, *ar);
 			if (best_bin.first == nullptr) {
@@ -1257,6 +1771,12 @@ namespace universal_binary {
 				return {};
 			}
 			dev_binaries.emplace_back(best_bin);
+			bin_indices.emplace_back(size_t(best_bin.first - ar->binaries.data()));
+		}
+		
+		// only load/verify the binaries we actually need
+		if (!load_binaries(*ar, bin_indices)) {
+			return {};
 		}
 		
 		return { move(ar), dev_binaries };
@@ -22,21 +22,26 @@
 #include <floor/compute/compute_common.hpp>
 #include <floor/compute/llvm_toolchain.hpp>
 #include <floor/constexpr/sha_256.hpp>
+#include <floor/core/file_io.hpp>
 
 //! Floor Universal Binary ARchive
 //!
 //! binary format:
 //! [magic: char[4] = "FUBA"]
-//! [binary format version: uint32_t = 2]
+//! [binary format version: uint32_t = 3]
 //! [binary count: uint32_t]
 //! [binary targets: target_v2[binary count]]
-//! [binary offsets: uint64_t[binary count]]
+//! [binary offsets: uint64_t[binary count]] (identical binaries are only stored once and share the same offset)
 //! [binary toolchain versions: uint32_t[binary count]]
-//! [binary SHA-256 hashes: sha_256::hash_t[binary count]]
+//! [binary SHA-256 hashes: sha_256::hash_t[binary count]] (of the uncompressed binary data)
 //! binaries[binary count]... (binary offset #0 points here):
 //!     [function count: uint32_t]
 //!     [function info size: uint32_t]
-//!     [binary size: uint32_t]
+//!     [binary size: uint32_t] (uncompressed)
+//!     --- v3+ only ---
+//!     [compression: BINARY_COMPRESSION (uint32_t)]
+//!     [stored size: uint32_t] (== binary size if uncompressed)
+//!     [dictionary binary index: uint32_t] (~0u if none)
 //!     functions[function count]...:
 //!         [function info version: uint32_t = 2]
 //!         [type: FUNCTION_TYPE (uint32_t)]
@@ -44,15 +49,27 @@
 //!         [local size: uint3]
 //!         [name: string (0-terminated)]
 //!         [args: arg_info[argument count]/uint64_t[argument count]]
-//!     [binary data: uint8_t[binary size]]
+//!     [binary data: uint8_t[stored size]]
+//! optional extension section (directly after the last binary, not present in older archives):
+//!     [magic: char[4] = "FUBE"]
+//!     [extension version: uint32_t = 2]
+//!     build inputs[binary count]...:
+//!         [input hash: sha_256::hash_t]
+//!         [compile time in µs: uint64_t]
+//!         [dependency count: uint32_t]
+//!         [dependencies: string (0-terminated)[dependency count]]
 
 namespace universal_binary {
 	//! current version of the binary format
-	static constexpr const uint32_t binary_format_version { 2u };
+	static constexpr const uint32_t binary_format_version { 3u };
+	//! oldest binary format version that can still be loaded
+	static constexpr const uint32_t min_binary_format_version { 2u };
 	//! current version of the target format
 	static constexpr const uint32_t target_format_version { 2u };
 	//! current version of the function info
 	static constexpr const uint32_t function_info_version { 2u };
+	//! current version of the extension section
+	static constexpr const uint32_t extension_version { 2u };
 	
 	//! target information (64-bit)
 	//! NOTE: right now this is still subject to change until said otherwise!
@@ -325,20 +342,80 @@ namespace universal_binary {
 	};
 	static_assert(sizeof(binary_v2) == sizeof(uint32_t) * 3);
 	
+	//! compression of the binary data
+	enum class BINARY_COMPRESSION : uint32_t {
+		//! stored as-is
+		NONE = 0u,
+		//! compressed with lz_codec, optionally using the uncompressed data of another binary as dictionary
+		LZ = 1u,
+	};
+	
+	//! per-binary compression information (v3+, directly follows the static binary header)
+	//! NOTE: a binary that is used as a dictionary can not use a dictionary itself
+	struct __attribute__((packed)) binary_compression_v3 {
+		//! compression type
+		BINARY_COMPRESSION type { BINARY_COMPRESSION::NONE };
+		//! size of the stored (compressed) binary data
+		uint32_t stored_size { 0u };
+		//! index of the binary whose uncompressed data is used as dictionary (~0u if none)
+		uint32_t dictionary_index { ~0u };
+	};
+	static_assert(sizeof(binary_compression_v3) == sizeof(uint32_t) * 3);
+	
+	//! non-owning view of binary data inside a memory-mapped archive
+	struct binary_data_view {
+		const uint8_t* ptr { nullptr };
+		size_t count { 0u };
+		
+		const uint8_t* data() const {
+			return ptr;
+		}
+		size_t size() const {
+			return count;
+		}
+	};
+	
 	//! per-binary header (dynamic part)
 	struct binary_dynamic_v2 {
 		//! static part of the binary header
 		binary_v2 static_binary_header;
+		//! compression information (always uncompressed for v2 archives)
+		binary_compression_v3 compression;
 		//! function info for all contained functions
 		vector<function_info_dynamic_v2> functions;
-		//! binary data
-		vector<uint8_t> data;
+		//! binary data (uncompressed)
+		//! NOTE: this points into the mapped archive file or into decompressed_data,
+		//!       and is only valid as long as the archive is alive
+		binary_data_view data;
+		//! decompressed binary data (only used for compressed binaries, shared by all binaries with the same data)
+		shared_ptr<vector<uint8_t>> decompressed_data;
+	};
+	
+	//! per-binary build input information (stored in the extension section),
+	//! used to determine if a binary must be rebuilt when incrementally building an archive
+	struct build_input_v2 {
+		//! hash of all build inputs (source code, dependencies, compile options, target, toolchain version)
+		sha_256::hash_t hash;
+		//! time it took to compile the binary in µs (used to schedule the longest builds first)
+		uint64_t compile_time_us { 0u };
+		//! all files the binary depends on (source + headers)
+		vector<string> dependencies;
 	};
 	
 	//! in-memory floor universal binary archive
+	//! NOTE: only the header is parsed when loading an archive, binaries are loaded on demand via load_binary()
 	struct archive {
 		header_dynamic_v2 header;
+		//! all binaries (loaded or not), in the same order as the targets in the header
 		vector<binary_dynamic_v2> binaries;
+		//! flags if the binary at the same index has already been loaded and verified
+		vector<bool> loaded;
+		//! build inputs of all binaries (empty if the archive has no extension section)
+		vector<build_input_v2> build_inputs;
+		//! memory-mapped archive file that backs all binary data
+		unique_ptr<file_io::mapped_file> file;
+		//! file name of the archive (for error reporting)
+		string file_name;
 	};
 	
 	//! aliases for current formats
@@ -349,12 +426,24 @@ namespace universal_binary {
 	using function_info_dynamic = function_info_dynamic_v2;
 	using binary = binary_v2;
 	using binary_dynamic = binary_dynamic_v2;
+	using binary_compression = binary_compression_v3;
+	using build_input = build_input_v2;
 	
-	//! loads a binary archive into memory and returns it if successful (nullptr if not)
+	//! memory-maps a binary archive, parses and verifies its header and returns it if successful (nullptr if not)
+	//! NOTE: contained binaries are not parsed or verified yet, use load_binary() for this
 	unique_ptr<archive> load_archive(const string& file_name);
 	
-	//! loads a binary archive into memory, finds the best matching binaries for the specified
-	//! devices and returns them
+	//! parses the function info of the binary at index "bin_idx", decompresses its data if necessary, verifies its hash
+	//! and makes its data available, returns true if successful or if the binary has already been loaded
+	//! NOTE: if the binary uses another binary as a compression dictionary, that binary is loaded as well
+	bool load_binary(archive& ar, const size_t bin_idx);
+	
+	//! loads all binaries at the specified indices (see load_binary()), verifying their hashes in parallel,
+	//! returns true if all binaries have been loaded successfully
+	bool load_binaries(archive& ar, const vector<size_t>& bin_indices);
+	
+	//! loads a binary archive, finds the best matching binaries for the specified devices, loads them and returns them
+	//! NOTE: only the matching binaries are loaded/verified
 	//! if an error occurred, ar will be nullptr and dev_binaries will be empty
 	struct archive_binaries {
 		//! loaded archive
@@ -365,20 +454,49 @@ namespace universal_binary {
 	archive_binaries load_dev_binaries_from_archive(const string& file_name, const vector<const compute_device*>& devices);
 	archive_binaries load_dev_binaries_from_archive(const string& file_name, const compute_context& ctx);
 	
+	//! per-target build timing information
+	struct target_build_report {
+		//! the built target
+		target_v2 target;
+		//! true if the binary has been reused from the previous archive (incremental build)
+		bool reused { false };
+		//! time it took to compile the binary in µs
+		uint64_t compile_time_us { 0u };
+		//! time it took to hash the binary and its build inputs in µs
+		uint64_t hash_time_us { 0u };
+	};
+	//! archive build timing information
+	struct build_report {
+		//! per-target information, in the same order as the specified targets
+		vector<target_build_report> targets;
+		//! total time it took to build and write the archive in µs
+		uint64_t total_time_us { 0u };
+	};
+	
 	//! builds an archive from the given source file/code, with the specified options, for the specified targets,
 	//! writing the binary output to the specified destination if successful (returns false if not)
 	//! NOTE: compile_options::target is ignored for this
+	//! if "incremental" is true and the destination archive already exists, binaries of targets whose build inputs
+	//! (source code, dependencies, compile options, target, toolchain version) haven't changed are reused instead of
+	//! being recompiled
+	//! targets are built in parallel, longest (previous) compile times first, binaries are written as soon as possible
+	//! if "report" is not nullptr, it is filled with per-target timing information on success
 	bool build_archive_from_file(const string& src_file_name,
 								 const string& dst_archive_file_name,
 								 const llvm_toolchain::compile_options& options,
-								 const vector<target>& targets);
+								 const vector<target>& targets,
+								 const bool incremental = false,
+								 build_report* report = nullptr);
 	bool build_archive_from_memory(const string& src_code,
 								   const string& dst_archive_file_name,
 								   const llvm_toolchain::compile_options& options,
-								   const vector<target>& targets);
+								   const vector<target>& targets,
+								   const bool incremental = false,
+								   build_report* report = nullptr);
 	
 	//! finds the best matching binary for the specified device inside the specified archive,
 	//! returns nullptr if no compatible binary has been found at all
+	//! NOTE: the returned binary is not necessarily loaded yet (see load_binary())
 	pair<const binary_dynamic_v2*, const target_v2>
 	find_best_match_for_device(const compute_device& dev,
 							   const archive& ar);
@@ -0,0 +1,492 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/compute/vulkan/vulkan_allocator.hpp>
+
+#if !defined(FLOOR_NO_VULKAN)
+
+#include <floor/compute/vulkan/vulkan_device.hpp>
+#include <floor/core/logger.hpp>
+#include <unordered_set>
+#include <map>
+
+struct vulkan_allocator::block {
+	VkDeviceMemory memory { nullptr };
+	uint8_t* mapped_ptr { nullptr };
+	uint64_t size { 0u };
+	uint32_t memory_type_index { ~0u };
+	RESOURCE resource { RESOURCE::BUFFER };
+	LIFETIME lifetime { LIFETIME::LONG };
+	
+	//! amount of live allocations and their total size
+	uint32_t allocation_count { 0u };
+	uint64_t used_bytes { 0u };
+	
+	//! free-list: free ranges (offset -> size), adjacent free ranges are always merged
+	map<uint64_t, uint64_t> free_ranges;
+	
+	//! linear: next allocation offset
+	uint64_t linear_offset { 0u };
+	
+	//! buddy: free offsets per order (size of order #i == min_buddy_size << i)
+	vector<unordered_set<uint64_t>> free_lists;
+	uint32_t max_order { 0u };
+};
+
+//! rounds "value" up to a multiple of "alignment"
+static uint64_t align_up(const uint64_t value, const uint64_t alignment) {
+	return ((value + alignment - 1u) / alignment) * alignment;
+}
+
+vulkan_allocator::vulkan_allocator(const vulkan_device& device_) : device(device_) {
+	VkPhysicalDeviceProperties props;
+	vkGetPhysicalDeviceProperties(device.physical_device, &props);
+	non_coherent_atom_size = max(uint64_t(props.limits.nonCoherentAtomSize), uint64_t(1u));
+	
+	// 64 MiB blocks by default, smaller ones for small heaps (at least 8 blocks should fit into the heap)
+	static constexpr const uint64_t default_block_size { 64ull * 1024ull * 1024ull };
+	static constexpr const uint64_t min_block_size { 1024ull * 1024ull };
+	const auto& mem_props = *device.mem_props;
+	for(uint32_t i = 0; i < mem_props.memoryTypeCount; ++i) {
+		const auto heap_size = uint64_t(mem_props.memoryHeaps[mem_props.memoryTypes[i].heapIndex].size);
+		uint64_t block_size = default_block_size;
+		while(block_size > min_block_size && block_size * 8u > heap_size) {
+			block_size >>= 1u;
+		}
+		block_sizes[i] = block_size;
+	}
+}
+
+vulkan_allocator::~vulkan_allocator() {
+	GUARD(allocator_lock);
+	for(auto& heaps_per_resource : heaps) {
+		for(auto& heaps_per_lifetime : heaps_per_resource) {
+			for(auto& h : heaps_per_lifetime) {
+				for(auto& blk : h.blocks) {
+					if(blk->allocation_count > 0) {
+						log_warn("destroying vulkan memory block with %u live allocations", blk->allocation_count);
+					}
+					destroy_block(*blk);
+				}
+				h.blocks.clear();
+			}
+		}
+	}
+}
+
+bool vulkan_allocator::is_host_visible(const uint32_t memory_type_index) const {
+	return ((device.mem_props->memoryTypes[memory_type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0);
+}
+
+bool vulkan_allocator::is_non_coherent(const uint32_t memory_type_index) const {
+	return (is_host_visible(memory_type_index) &&
+			(device.mem_props->memoryTypes[memory_type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0);
+}
+
+unique_ptr<vulkan_allocator::block> vulkan_allocator::create_block(const uint32_t memory_type_index,
+																   const RESOURCE resource,
+																   const LIFETIME lifetime) {
+	auto blk = make_unique<block>();
+	blk->size = block_sizes[memory_type_index];
+	blk->memory_type_index = memory_type_index;
+	blk->resource = resource;
+	blk->lifetime = lifetime;
+	
+	const VkMemoryAllocateInfo alloc_info {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+		.pNext = nullptr,
+		.allocationSize = blk->size,
+		.memoryTypeIndex = memory_type_index,
+	};
+	VK_CALL_RET(vkAllocateMemory(device.device, &alloc_info, nullptr, &blk->memory),
+				"failed to allocate device memory block", {})
+	
+	if(is_host_visible(memory_type_index)) {
+		void* mapped_ptr = nullptr;
+		if(vkMapMemory(device.device, blk->memory, 0, VK_WHOLE_SIZE, 0, &mapped_ptr) != VK_SUCCESS) {
+			log_error("failed to map device memory block");
+			vkFreeMemory(device.device, blk->memory, nullptr);
+			return {};
+		}
+		blk->mapped_ptr = (uint8_t*)mapped_ptr;
+	}
+	
+	// the whole block is initially free
+	if(lifetime == LIFETIME::LONG) {
+		blk->free_ranges.emplace(0u, blk->size);
+	}
+	else if(lifetime == LIFETIME::SHORT) {
+		while((min_buddy_size << blk->max_order) < blk->size) {
+			++blk->max_order;
+		}
+		blk->free_lists.resize(blk->max_order + 1u);
+		blk->free_lists[blk->max_order].emplace(0u);
+	}
+	return blk;
+}
+
+void vulkan_allocator::destroy_block(block& blk) {
+	if(blk.memory != nullptr) {
+		// NOTE: this implicitly unmaps the memory
+		vkFreeMemory(device.device, blk.memory, nullptr);
+		blk.memory = nullptr;
+		blk.mapped_ptr = nullptr;
+	}
+}
+
+vulkan_allocator::allocation vulkan_allocator::allocate_dedicated(const VkDeviceSize size, const uint32_t memory_type_index) {
+	allocation alloc;
+	const VkMemoryAllocateInfo alloc_info {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+		.pNext = nullptr,
+		.allocationSize = size,
+		.memoryTypeIndex = memory_type_index,
+	};
+	VK_CALL_RET(vkAllocateMemory(device.device, &alloc_info, nullptr, &alloc.memory),
+				"failed to allocate dedicated device memory", {})
+	
+	if(is_host_visible(memory_type_index)) {
+		void* mapped_ptr = nullptr;
+		if(vkMapMemory(device.device, alloc.memory, 0, VK_WHOLE_SIZE, 0, &mapped_ptr) != VK_SUCCESS) {
+			log_error("failed to map dedicated device memory");
+			vkFreeMemory(device.device, alloc.memory, nullptr);
+			return {};
+		}
+		alloc.mapped_ptr = (uint8_t*)mapped_ptr;
+	}
+	alloc.offset = 0;
+	alloc.size = size;
+	alloc.memory_type_index = memory_type_index;
+	alloc.is_non_coherent = is_non_coherent(memory_type_index);
+	
+	++dedicated_allocation_count;
+	dedicated_allocation_size += size;
+	return alloc;
+}
+
+bool vulkan_allocator::allocate_block(block& blk, const VkDeviceSize size, const VkDeviceSize alignment,
+									  allocation& alloc) {
+	switch(blk.lifetime) {
+		case LIFETIME::LONG: return allocate_free_list(blk, size, alignment, alloc);
+		case LIFETIME::SHORT: return allocate_buddy(blk, size, alignment, alloc);
+		case LIFETIME::TRANSIENT: return allocate_linear(blk, size, alignment, alloc);
+	}
+	floor_unreachable();
+}
+
+bool vulkan_allocator::allocate_free_list(block& blk, const VkDeviceSize size, const VkDeviceSize alignment,
+										  allocation& alloc) {
+	// first fit
+	for(auto iter = blk.free_ranges.begin(); iter != blk.free_ranges.end(); ++iter) {
+		const auto range_offset = iter->first;
+		const auto range_end = range_offset + iter->second;
+		const auto offset = align_up(range_offset, alignment);
+		if(offset + size > range_end) {
+			continue;
+		}
+		
+		// the alignment padding in front and the remainder behind the allocation stay free
+		blk.free_ranges.erase(iter);
+		if(offset > range_offset) {
+			blk.free_ranges.emplace(range_offset, offset - range_offset);
+		}
+		if(offset + size < range_end) {
+			blk.free_ranges.emplace(offset + size, range_end - (offset + size));
+		}
+		alloc.offset = offset;
+		alloc.size = size;
+		return true;
+	}
+	return false;
+}
+
+void vulkan_allocator::free_free_list(block& blk, const uint64_t offset_, const uint64_t size_) {
+	auto offset = offset_;
+	auto size = size_;
+	
+	// merge with the following free range
+	auto next = blk.free_ranges.lower_bound(offset);
+	if(next != blk.free_ranges.end() && next->first == offset + size) {
+		size += next->second;
+		next = blk.free_ranges.erase(next);
+	}
+	// merge with the preceding free range
+	if(next != blk.free_ranges.begin()) {
+		auto prev = std::prev(next);
+		if(prev->first + prev->second == offset) {
+			prev->second += size;
+			return;
+		}
+	}
+	blk.free_ranges.emplace_hint(next, offset, size);
+}
+
+bool vulkan_allocator::allocate_linear(block& blk, const VkDeviceSize size, const VkDeviceSize alignment,
+									   allocation& alloc) {
+	const auto offset = align_up(blk.linear_offset, alignment);
+	if(offset + size > blk.size) {
+		return false;
+	}
+	blk.linear_offset = offset + size;
+	alloc.offset = offset;
+	alloc.size = size;
+	return true;
+}
+
+bool vulkan_allocator::allocate_buddy(block& blk, const VkDeviceSize size, const VkDeviceSize alignment,
+									  allocation& alloc) {
+	// buddy allocations are naturally aligned to their (power-of-two) size
+	const auto req_size = max(max(size, alignment), min_buddy_size);
+	uint32_t order = 0;
+	while((min_buddy_size << order) < req_size) {
+		if(++order > blk.max_order) {
+			return false;
+		}
+	}
+	
+	// find the smallest free range that fits
+	uint32_t free_order = order;
+	while(free_order <= blk.max_order && blk.free_lists[free_order].empty()) {
+		++free_order;
+	}
+	if(free_order > blk.max_order) {
+		return false;
+	}
+	auto free_iter = blk.free_lists[free_order].begin();
+	const auto offset = *free_iter;
+	blk.free_lists[free_order].erase(free_iter);
+	
+	// split until we have the requested size, the upper halves become free
+	while(free_order > order) {
+		--free_order;
+		blk.free_lists[free_order].emplace(offset + (min_buddy_size << free_order));
+	}
+	
+	alloc.offset = offset;
+	alloc.size = (min_buddy_size << order);
+	alloc.buddy_order = order;
+	return true;
+}
+
+void vulkan_allocator::free_buddy(block& blk, const uint64_t offset_, const uint32_t order_) {
+	// merge with the buddy for as long as it is free
+	auto offset = offset_;
+	auto order = order_;
+	while(order < blk.max_order) {
+		const auto buddy_offset = offset ^ (min_buddy_size << order);
+		if(blk.free_lists[order].erase(buddy_offset) == 0) {
+			break;
+		}
+		offset = min(offset, buddy_offset);
+		++order;
+	}
+	blk.free_lists[order].emplace(offset);
+}
+
+vulkan_allocator::allocation vulkan_allocator::allocate(const VkMemoryRequirements& mem_req,
+														const uint32_t memory_type_index,
+														const RESOURCE resource,
+														const LIFETIME lifetime) {
+	if(memory_type_index >= device.mem_props->memoryTypeCount) {
+		log_error("invalid memory type index: %u", memory_type_index);
+		return {};
+	}
+	if(mem_req.size == 0) {
+		log_error("can't allocate 0 bytes");
+		return {};
+	}
+	
+	auto size = uint64_t(mem_req.size);
+	auto alignment = max(uint64_t(mem_req.alignment), uint64_t(1u));
+	const bool non_coherent = is_non_coherent(memory_type_index);
+	if(non_coherent) {
+		// flush/invalidate ranges must be aligned to the non-coherent atom size
+		size = align_up(size, non_coherent_atom_size);
+		alignment = align_up(alignment, non_coherent_atom_size);
+	}
+	
+	GUARD(allocator_lock);
+	if(size >= block_sizes[memory_type_index] / 2u) {
+		return allocate_dedicated(size, memory_type_index);
+	}
+	
+	auto& h = heaps[memory_type_index][uint32_t(resource)][uint32_t(lifetime)];
+	allocation alloc;
+	block* alloc_block = nullptr;
+	for(auto& blk : h.blocks) {
+		if(allocate_block(*blk, size, alignment, alloc)) {
+			alloc_block = blk.get();
+			break;
+		}
+	}
+	if(alloc_block == nullptr) {
+		auto new_block = create_block(memory_type_index, resource, lifetime);
+		if(!new_block) {
+			return {};
+		}
+		if(!allocate_block(*new_block, size, alignment, alloc)) {
+			// should not happen, since size < block size / 2
+			log_error("failed to sub-allocate %u bytes from a new memory block", size);
+			destroy_block(*new_block);
+			return {};
+		}
+		alloc_block = new_block.get();
+		h.blocks.emplace_back(move(new_block));
+	}
+	
+	++alloc_block->allocation_count;
+	alloc_block->used_bytes += alloc.size;
+	
+	alloc.memory = alloc_block->memory;
+	alloc.mapped_ptr = (alloc_block->mapped_ptr != nullptr ? alloc_block->mapped_ptr + alloc.offset : nullptr);
+	alloc.memory_type_index = memory_type_index;
+	alloc.is_non_coherent = non_coherent;
+	alloc.parent_block = alloc_block;
+	return alloc;
+}
+
+void vulkan_allocator::free(allocation& alloc) {
+	if(!alloc.is_valid()) return;
+	
+	GUARD(allocator_lock);
+	if(alloc.parent_block == nullptr) {
+		// dedicated
+		vkFreeMemory(device.device, alloc.memory, nullptr);
+		--dedicated_allocation_count;
+		dedicated_allocation_size -= alloc.size;
+		alloc = {};
+		return;
+	}
+	
+	auto& blk = *alloc.parent_block;
+	--blk.allocation_count;
+	blk.used_bytes -= alloc.size;
+	switch(blk.lifetime) {
+		case LIFETIME::LONG:
+			free_free_list(blk, alloc.offset, alloc.size);
+			break;
+		case LIFETIME::SHORT:
+			free_buddy(blk, alloc.offset, alloc.buddy_order);
+			break;
+		case LIFETIME::TRANSIENT:
+			// linear blocks can only be reused once all allocations have been freed
+			if(blk.allocation_count == 0) {
+				blk.linear_offset = 0;
+			}
+			break;
+	}
+	alloc = {};
+	
+	// release the block if it is empty and there is another empty block in this heap
+	if(blk.allocation_count == 0) {
+		auto& h = heaps[blk.memory_type_index][uint32_t(blk.resource)][uint32_t(blk.lifetime)];
+		const auto other_empty_block = find_if(h.blocks.begin(), h.blocks.end(), [&blk](const unique_ptr<block>& other) {
+			return (other.get() != &blk && other->allocation_count == 0);
+		});
+		if(other_empty_block != h.blocks.end()) {
+			const auto blk_iter = find_if(h.blocks.begin(), h.blocks.end(), [&blk](const unique_ptr<block>& other) {
+				return (other.get() == &blk);
+			});
+			destroy_block(blk);
+			h.blocks.erase(blk_iter);
+		}
+	}
+}
+
+void vulkan_allocator::flush(const allocation& alloc) const {
+	if(!alloc.is_non_coherent || alloc.mapped_ptr == nullptr) return;
+	const VkMappedMemoryRange range {
+		.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+		.pNext = nullptr,
+		.memory = alloc.memory,
+		.offset = alloc.offset,
+		.size = alloc.size,
+	};
+	VK_CALL_RET(vkFlushMappedMemoryRanges(device.device, 1, &range), "failed to flush mapped memory")
+}
+
+void vulkan_allocator::invalidate(const allocation& alloc) const {
+	if(!alloc.is_non_coherent || alloc.mapped_ptr == nullptr) return;
+	const VkMappedMemoryRange range {
+		.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+		.pNext = nullptr,
+		.memory = alloc.memory,
+		.offset = alloc.offset,
+		.size = alloc.size,
+	};
+	VK_CALL_RET(vkInvalidateMappedMemoryRanges(device.device, 1, &range), "failed to invalidate mapped memory")
+}
+
+vulkan_allocator::statistics vulkan_allocator::get_statistics() const {
+	statistics stats;
+	GUARD(allocator_lock);
+	for(const auto& heaps_per_resource : heaps) {
+		for(const auto& heaps_per_lifetime : heaps_per_resource) {
+			for(const auto& h : heaps_per_lifetime) {
+				for(const auto& blk : h.blocks) {
+					++stats.device_allocation_count;
+					stats.allocation_count += blk->allocation_count;
+					stats.allocated_bytes += blk->size;
+					stats.used_bytes += blk->used_bytes;
+					
+					switch(blk->lifetime) {
+						case LIFETIME::LONG:
+							for(const auto& free_range : blk->free_ranges) {
+								stats.free_bytes += free_range.second;
+								stats.largest_free_range = max(stats.largest_free_range, free_range.second);
+							}
+							break;
+						case LIFETIME::SHORT:
+							for(uint32_t order = 0; order <= blk->max_order; ++order) {
+								const auto order_size = (min_buddy_size << order);
+								stats.free_bytes += order_size * blk->free_lists[order].size();
+								if(!blk->free_lists[order].empty()) {
+									stats.largest_free_range = max(stats.largest_free_range, order_size);
+								}
+							}
+							break;
+						case LIFETIME::TRANSIENT: {
+							const auto free_range = blk->size - blk->linear_offset;
+							stats.free_bytes += free_range;
+							stats.largest_free_range = max(stats.largest_free_range, free_range);
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+	stats.device_allocation_count += dedicated_allocation_count;
+	stats.dedicated_allocation_count = dedicated_allocation_count;
+	stats.allocation_count += dedicated_allocation_count;
+	stats.allocated_bytes += dedicated_allocation_size;
+	stats.used_bytes += dedicated_allocation_size;
+	stats.fragmentation = (stats.free_bytes > 0 ?
+						   1.0f - float(double(stats.largest_free_range) / double(stats.free_bytes)) : 0.0f);
+	return stats;
+}
+
+void vulkan_allocator::log_statistics() const {
+	const auto stats = get_statistics();
+	log_msg("vulkan memory (%s): %u allocations in %u device allocations (%u dedicated), "
+			"%u KB used / %u KB allocated, %u KB free, fragmentation: %f",
+			device.name, stats.allocation_count, stats.device_allocation_count, stats.dedicated_allocation_count,
+			stats.used_bytes / 1024u, stats.allocated_bytes / 1024u, stats.free_bytes / 1024u, stats.fragmentation);
+}
+
+#endif
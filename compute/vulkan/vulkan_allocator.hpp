@@ -0,0 +1,178 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_VULKAN_ALLOCATOR_HPP__
+#define __FLOOR_VULKAN_ALLOCATOR_HPP__
+
+#include <floor/compute/vulkan/vulkan_common.hpp>
+
+#if !defined(FLOOR_NO_VULKAN)
+
+#include <floor/threading/thread_safety.hpp>
+#include <array>
+#include <vector>
+#include <memory>
+
+class vulkan_device;
+
+//! device memory manager of a vulkan_device: sub-allocates buffers and images from large device memory blocks
+//! (one set of blocks per memory type and resource kind), so that we don't need a vkAllocateMemory call per object
+//! NOTE: * long-lived allocations (the default) use free-list blocks (first fit, freed ranges are merged and reused)
+//!       * short-lived allocations (e.g. staging buffers) use buddy-allocated blocks
+//!       * transient (e.g. per-frame) allocations use linear blocks (bump allocation, a block is only reset once all
+//!         of its allocations have been freed -> must not be used for anything that outlives its siblings)
+//!       * very large allocations always get a dedicated device memory allocation
+//!       * host-visible memory is persistently mapped
+class vulkan_allocator {
+public:
+	explicit vulkan_allocator(const vulkan_device& device);
+	~vulkan_allocator();
+	
+	vulkan_allocator(const vulkan_allocator&) = delete;
+	vulkan_allocator& operator=(const vulkan_allocator&) = delete;
+	
+	//! expected lifetime of an allocation, determines the allocation strategy
+	enum class LIFETIME : uint32_t {
+		//! free-list sub-allocation
+		LONG,
+		//! buddy sub-allocation
+		SHORT,
+		//! linear sub-allocation
+		TRANSIENT,
+	};
+	static constexpr const uint32_t lifetime_count { 3u };
+	
+	//! kind of resource that is bound to an allocation
+	//! NOTE: buffers and (optimally tiled) images are never placed in the same block,
+	//!       so that we don't need to care about bufferImageGranularity
+	enum class RESOURCE : uint32_t {
+		BUFFER,
+		IMAGE,
+	};
+	
+	struct block;
+	struct allocation {
+		//! device memory that must be used for binding
+		VkDeviceMemory memory { nullptr };
+		//! offset of this allocation inside "memory"
+		VkDeviceSize offset { 0u };
+		//! size of this allocation (>= requested size)
+		VkDeviceSize size { 0u };
+		//! host pointer to the start of this allocation if the memory is host-visible, nullptr otherwise
+		uint8_t* mapped_ptr { nullptr };
+		//! memory type index of "memory"
+		uint32_t memory_type_index { ~0u };
+		//! if true, the host-visible memory is not coherent and requires flush()/invalidate() calls
+		bool is_non_coherent { false };
+		
+		// internal
+		block* parent_block { nullptr };
+		uint32_t buddy_order { 0u };
+		
+		bool is_valid() const {
+			return (memory != nullptr);
+		}
+	};
+	
+	//! allocates memory fulfilling the specified requirements in the specified memory type,
+	//! returns an invalid allocation on failure
+	allocation allocate(const VkMemoryRequirements& mem_req,
+						const uint32_t memory_type_index,
+						const RESOURCE resource,
+						const LIFETIME lifetime = LIFETIME::LONG) REQUIRES(!allocator_lock);
+	
+	//! frees the specified allocation (and resets it)
+	void free(allocation& alloc) REQUIRES(!allocator_lock);
+	
+	//! makes host writes to the mapped allocation memory visible to the device (no-op for coherent memory)
+	void flush(const allocation& alloc) const;
+	//! makes device writes to the allocation memory visible to the mapped host memory (no-op for coherent memory)
+	void invalidate(const allocation& alloc) const;
+	
+	//! memory usage and fragmentation statistics
+	struct statistics {
+		//! amount of device memory allocations (sub-allocated blocks + dedicated allocations)
+		uint64_t device_allocation_count { 0u };
+		//! amount of dedicated device memory allocations
+		uint64_t dedicated_allocation_count { 0u };
+		//! amount of live allocations (sub-allocations + dedicated allocations)
+		uint64_t allocation_count { 0u };
+		//! total size of all device memory allocations
+		uint64_t allocated_bytes { 0u };
+		//! total size of all live allocations
+		uint64_t used_bytes { 0u };
+		//! size of device memory that is currently usable for new sub-allocations
+		uint64_t free_bytes { 0u };
+		//! size of the largest contiguous free range inside any block
+		uint64_t largest_free_range { 0u };
+		//! 1 - (largest free range / free bytes) -> 0 == no fragmentation, 1 == fully fragmented
+		float fragmentation { 0.0f };
+	};
+	statistics get_statistics() const REQUIRES(!allocator_lock);
+	
+	//! logs the current statistics
+	void log_statistics() const REQUIRES(!allocator_lock);
+	
+protected:
+	const vulkan_device& device;
+	
+	//! size of sub-allocated blocks per memory type (power-of-two, for the buddy allocator)
+	//! NOTE: allocations >= half the block size always get a dedicated allocation
+	array<uint64_t, VK_MAX_MEMORY_TYPES> block_sizes {};
+	//! smallest buddy allocation size
+	static constexpr const uint64_t min_buddy_size { 256u };
+	//! alignment/granularity requirement for non-coherent host-visible memory
+	uint64_t non_coherent_atom_size { 1u };
+	
+	mutable safe_mutex allocator_lock;
+	
+	//! all blocks of one memory type + resource kind + lifetime
+	struct heap {
+		vector<unique_ptr<block>> blocks;
+	};
+	//! [memory type][resource][lifetime]
+	array<array<array<heap, lifetime_count>, 2>, VK_MAX_MEMORY_TYPES> heaps GUARDED_BY(allocator_lock);
+	
+	//! dedicated allocation count and size (for statistics)
+	uint64_t dedicated_allocation_count GUARDED_BY(allocator_lock) { 0u };
+	uint64_t dedicated_allocation_size GUARDED_BY(allocator_lock) { 0u };
+	
+	unique_ptr<block> create_block(const uint32_t memory_type_index, const RESOURCE resource,
+								   const LIFETIME lifetime) REQUIRES(allocator_lock);
+	void destroy_block(block& blk) REQUIRES(allocator_lock);
+	
+	allocation allocate_dedicated(const VkDeviceSize size, const uint32_t memory_type_index) REQUIRES(allocator_lock);
+	bool allocate_block(block& blk, const VkDeviceSize size, const VkDeviceSize alignment,
+						allocation& alloc) REQUIRES(allocator_lock);
+	bool allocate_free_list(block& blk, const VkDeviceSize size, const VkDeviceSize alignment,
+							allocation& alloc) REQUIRES(allocator_lock);
+	void free_free_list(block& blk, const uint64_t offset, const uint64_t size) REQUIRES(allocator_lock);
+	bool allocate_linear(block& blk, const VkDeviceSize size, const VkDeviceSize alignment,
+						 allocation& alloc) REQUIRES(allocator_lock);
+	bool allocate_buddy(block& blk, const VkDeviceSize size, const VkDeviceSize alignment,
+						allocation& alloc) REQUIRES(allocator_lock);
+	void free_buddy(block& blk, const uint64_t offset, const uint32_t order) REQUIRES(allocator_lock);
+	
+	bool is_host_visible(const uint32_t memory_type_index) const;
+	bool is_non_coherent(const uint32_t memory_type_index) const;
+	
+};
+
+#endif
+
+#endif
@@ -57,13 +57,7 @@ bool vulkan_buffer::create_internal(const bool copy_host_data, const compute_que
 		.pNext = nullptr,
 		.flags = 0, // no sparse backing
 		.size = size,
-		// set all the bits here, might need some better restrictions later on
-		// NOTE: not setting vertex bit here, b/c we're always using SSBOs
-		.usage = (VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
-				  VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-				  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-				  VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
-				  VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT),
+		.usage = buffer_usage,
 		// TODO: probably want a concurrent option later on
 		.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
 		.queueFamilyIndexCount = 0,
@@ -75,15 +69,15 @@ bool vulkan_buffer::create_internal(const bool copy_host_data, const compute_que
 	// allocate / back it up
 	VkMemoryRequirements mem_req;
 	vkGetBufferMemoryRequirements(vulkan_dev, buffer, &mem_req);
+	mem_alignment = mem_req.alignment;
 	
-	const VkMemoryAllocateInfo alloc_info {
-		.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-		.pNext = nullptr,
-		.allocationSize = mem_req.size,
-		.memoryTypeIndex = find_memory_type_index(mem_req.memoryTypeBits, true /* prefer device memory */),
-	};
-	VK_CALL_RET(vkAllocateMemory(vulkan_dev, &alloc_info, nullptr, &mem), "buffer allocation failed", false)
-	VK_CALL_RET(vkBindBufferMemory(vulkan_dev, buffer, mem, 0), "buffer allocation binding failed", false)
+	alloc = device.allocator->allocate(mem_req, find_memory_type_index(mem_req.memoryTypeBits, true /* prefer device memory */),
+									   vulkan_allocator::RESOURCE::BUFFER);
+	if(!alloc.is_valid()) {
+		log_error("buffer allocation failed");
+		return false;
+	}
+	VK_CALL_RET(vkBindBufferMemory(vulkan_dev, buffer, alloc.memory, alloc.offset), "buffer allocation binding failed", false)
 	
 	// update buffer desc info
 	buffer_info.buffer = buffer;
@@ -103,11 +97,80 @@ bool vulkan_buffer::create_internal(const bool copy_host_data, const compute_que
 	return true;
 }
 
-vulkan_buffer::~vulkan_buffer() {
-	if(buffer != nullptr) {
-		vkDestroyBuffer(((const vulkan_device&)dev).device, buffer, nullptr);
-		buffer = nullptr;
+vulkan_buffer::vulkan_buffer(const compute_queue& cqueue,
+							 shared_ptr<const vulkan_buffer> parent,
+							 const size_t& offset,
+							 const size_t& size_) :
+compute_buffer(cqueue, size_, (parent->host_ptr != nullptr ? (uint8_t*)parent->host_ptr + offset : nullptr),
+			   parent->flags | COMPUTE_MEMORY_FLAG::NO_INITIAL_COPY),
+vulkan_memory((const vulkan_device&)cqueue.get_device(), &buffer) {
+	// the memory is owned by the parent buffer
+	owns_alloc = false;
+	if(!create_sub_buffer_internal(*parent, offset)) {
+		if(buffer != nullptr) {
+			vkDestroyBuffer(((const vulkan_device&)cqueue.get_device()).device, buffer, nullptr);
+			buffer = nullptr;
+		}
+		alloc = {};
+		return;
 	}
+	parent_buffer = move(parent);
+}
+
+bool vulkan_buffer::create_sub_buffer_internal(const vulkan_buffer& parent, const size_t& offset) {
+	const auto& vulkan_dev = device.device;
+	
+	const VkBufferCreateInfo buffer_create_info {
+		.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+		.pNext = nullptr,
+		.flags = 0,
+		.size = size,
+		.usage = buffer_usage,
+		.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+		.queueFamilyIndexCount = 0,
+		.pQueueFamilyIndices = nullptr,
+	};
+	VK_CALL_RET(vkCreateBuffer(vulkan_dev, &buffer_create_info, nullptr, &buffer),
+				"sub-buffer creation failed", false)
+	
+	// the sub-buffer must fit into the memory range of the parent at the (aligned) offset
+	VkMemoryRequirements mem_req;
+	vkGetBufferMemoryRequirements(vulkan_dev, buffer, &mem_req);
+	mem_alignment = mem_req.alignment;
+	const auto& parent_alloc = parent.alloc;
+	if((mem_req.memoryTypeBits & (1u << parent_alloc.memory_type_index)) == 0u ||
+	   ((parent_alloc.offset + offset) % mem_req.alignment) != 0u ||
+	   offset + mem_req.size > parent_alloc.size) {
+		log_error("sub-buffer (offset: %u, size: %u) is incompatible with the memory of its parent buffer", offset, size);
+		return false;
+	}
+	
+	// this is a range inside the allocation of the parent
+	// NOTE: the offset is a multiple of 256 (>= nonCoherentAtomSize), so flush/invalidate of the range is valid
+	alloc = parent_alloc;
+	alloc.offset += offset;
+	alloc.size = std::min(VkDeviceSize(((size + 255u) / 256u) * 256u), parent_alloc.size - offset);
+	if(alloc.mapped_ptr != nullptr) {
+		alloc.mapped_ptr += offset;
+	}
+	VK_CALL_RET(vkBindBufferMemory(vulkan_dev, buffer, alloc.memory, alloc.offset), "sub-buffer binding failed", false)
+	
+	buffer_info.buffer = buffer;
+	buffer_info.offset = 0;
+	buffer_info.range = size;
+	return true;
+}
+
+vulkan_buffer::~vulkan_buffer() {
+	// batched transfers may still reference the buffer -> destroy it once they have completed
+	// NOTE: sub-buffers must also keep their parent (memory) alive until then
+	release_after_transfers([vulkan_dev = ((const vulkan_device&)dev).device, buffer_ = buffer, parent = parent_buffer]() mutable {
+		if(buffer_ != nullptr) {
+			vkDestroyBuffer(vulkan_dev, buffer_, nullptr);
+		}
+		parent = nullptr;
+	});
+	buffer = nullptr;
 	buffer_info = { nullptr, 0, 0 };
 }
 
@@ -158,6 +221,54 @@ void vulkan_buffer::fill(const compute_queue& cqueue floor_unused,
 	log_error("vulkan_buffer::fill not implemented yet");
 }
 
+bool vulkan_buffer::record_copy(VkCommandBuffer cmd_buffer, const compute_buffer& src,
+								const size_t size_, const size_t src_offset, const size_t dst_offset) const {
+	if(buffer == nullptr) return false;
+	
+	const size_t src_size = src.get_size();
+	const size_t copy_size = (size_ == 0 ? std::min(src_size, size) : size_);
+	if(!copy_check(size, src_size, copy_size, dst_offset, src_offset)) return false;
+	
+	const VkBufferCopy region {
+		.srcOffset = src_offset,
+		.dstOffset = dst_offset,
+		.size = copy_size,
+	};
+	vkCmdCopyBuffer(cmd_buffer, ((const vulkan_buffer&)src).get_vulkan_buffer(), buffer, 1, &region);
+	return true;
+}
+
+bool vulkan_buffer::record_fill(VkCommandBuffer cmd_buffer, const void* pattern, const size_t& pattern_size,
+								const size_t size_, const size_t offset) const {
+	if(buffer == nullptr) return false;
+	
+	const size_t fill_size = (size_ == 0 ? size : size_);
+	if(!fill_check(size, fill_size, pattern_size, offset)) return false;
+	if(offset % 4u != 0u || fill_size % 4u != 0u) return false;
+	
+	// replicate 1 and 2 byte patterns to the 4 byte data word of vkCmdFillBuffer
+	uint32_t data = 0u;
+	switch(pattern_size) {
+		case 1: {
+			const auto byte = uint32_t(*(const uint8_t*)pattern);
+			data = byte | (byte << 8u) | (byte << 16u) | (byte << 24u);
+			break;
+		}
+		case 2: {
+			const auto half = uint32_t(*(const uint16_t*)pattern);
+			data = half | (half << 16u);
+			break;
+		}
+		case 4:
+			data = *(const uint32_t*)pattern;
+			break;
+		default:
+			return false;
+	}
+	vkCmdFillBuffer(cmd_buffer, buffer, offset, fill_size, data);
+	return true;
+}
+
 void vulkan_buffer::zero(const compute_queue& cqueue) {
 	if(buffer == nullptr) return;
 	
@@ -180,6 +291,10 @@ void vulkan_buffer::zero(const compute_queue& cqueue) {
 bool vulkan_buffer::resize(const compute_queue& cqueue floor_unused, const size_t& new_size_ floor_unused,
 						   const bool copy_old_data floor_unused, const bool copy_host_data floor_unused,
 						   void* new_host_ptr floor_unused) {
+	if(parent_buffer) {
+		log_error("can't resize a sub-buffer!");
+		return false;
+	}
 	// TODO: implement this
 	return false;
 }
@@ -206,4 +321,17 @@ bool vulkan_buffer::release_opengl_object(const compute_queue*) {
 	return false;
 }
 
+shared_ptr<compute_buffer> vulkan_buffer::create_sub_buffer(const compute_queue& cqueue, const size_t& offset, const size_t& sub_size) const {
+	if(buffer == nullptr || !alloc.is_valid()) return {};
+	auto parent = sub_buffer_check(offset, sub_size);
+	if(!parent) return {};
+	auto ret = make_shared<vulkan_buffer>(cqueue, static_pointer_cast<const vulkan_buffer>(move(parent)), offset, sub_size);
+	if(ret->get_vulkan_buffer() == nullptr) return {};
+	return ret;
+}
+
+size_t vulkan_buffer::get_sub_buffer_alignment() const {
+	return std::max(size_t(mem_alignment), size_t(256u));
+}
+
 #endif
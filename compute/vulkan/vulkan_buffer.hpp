@@ -72,6 +72,13 @@ FLOOR_POP_WARNINGS()
 				  const uint32_t opengl_type_ = 0) :
 	vulkan_buffer(cqueue, sizeof(data_type) * n, (const void*)&data[0], flags_, opengl_type_) {}
 	
+	//! constructs a sub-buffer of "parent" (see create_sub_buffer), which holds a reference to "parent"
+	//! NOTE: this creates a new VkBuffer that is bound to the memory range of "parent" at "offset"
+	vulkan_buffer(const compute_queue& cqueue,
+				  shared_ptr<const vulkan_buffer> parent,
+				  const size_t& offset,
+				  const size_t& size_);
+	
 	~vulkan_buffer() override;
 
 	void read(const compute_queue& cqueue, const size_t size = 0, const size_t offset = 0) override;
@@ -89,6 +96,15 @@ FLOOR_POP_WARNINGS()
 	
 	void zero(const compute_queue& cqueue) override;
 	
+	//! records a copy from "src" to this buffer into the specified command buffer (see copy()), returns false on failure
+	bool record_copy(VkCommandBuffer cmd_buffer, const compute_buffer& src,
+					 const size_t size = 0, const size_t src_offset = 0, const size_t dst_offset = 0) const;
+	
+	//! records a fill of this buffer into the specified command buffer (see fill()), returns false on failure
+	//! NOTE: vkCmdFillBuffer only supports 1, 2 or 4 byte patterns and requires 4 byte aligned offsets and sizes
+	bool record_fill(VkCommandBuffer cmd_buffer, const void* pattern, const size_t& pattern_size,
+					 const size_t size = 0, const size_t offset = 0) const;
+	
 	bool resize(const compute_queue& cqueue,
 				const size_t& size,
 				const bool copy_old_data = false,
@@ -104,17 +120,41 @@ FLOOR_POP_WARNINGS()
 	bool acquire_opengl_object(const compute_queue* cqueue) override;
 	bool release_opengl_object(const compute_queue* cqueue) override;
 	
+	shared_ptr<compute_buffer> create_sub_buffer(const compute_queue& cqueue, const size_t& offset, const size_t& size) const override;
+	
+	//! the memory alignment of this buffer, at least 256 (max nonCoherentAtomSize and min*BufferOffsetAlignment)
+	size_t get_sub_buffer_alignment() const override;
+	
 	//! returns the vulkan specific buffer object/pointer
 	const VkBuffer& get_vulkan_buffer() const { return buffer; }
 	const VkDescriptorBufferInfo* get_vulkan_buffer_info() const { return &buffer_info; }
 	
+	//! returns the unique resource id of this buffer
+	uint64_t get_vulkan_resource_id() const { return resource_id; }
+	
 protected:
 	VkBuffer buffer { nullptr };
 	VkDescriptorBufferInfo buffer_info { nullptr, 0, 0 };
+	//! required memory alignment of this buffer (VkMemoryRequirements::alignment)
+	VkDeviceSize mem_alignment { 1u };
+	
+	//! usage flags of all buffers
+	static constexpr const VkBufferUsageFlags buffer_usage {
+		// set all the bits here, might need some better restrictions later on
+		// NOTE: not setting vertex bit here, b/c we're always using SSBOs
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+		VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+		VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+		VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+	};
 	
 	//! separate create buffer function, b/c it's called by the constructor and resize
 	bool create_internal(const bool copy_host_data, const compute_queue& cqueue);
 	
+	//! creates the buffer of a sub-buffer and binds it to the memory of "parent" at "offset"
+	bool create_sub_buffer_internal(const vulkan_buffer& parent, const size_t& offset);
+	
 };
 
 #endif
@@ -0,0 +1,230 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/compute/vulkan/vulkan_command_graph.hpp>
+
+#if !defined(FLOOR_NO_VULKAN)
+
+#include <floor/compute/vulkan/vulkan_queue.hpp>
+#include <floor/compute/vulkan/vulkan_device.hpp>
+#include <floor/compute/vulkan/vulkan_buffer.hpp>
+#include <floor/core/logger.hpp>
+
+vulkan_command_graph::vulkan_command_graph(const compute_queue& cqueue_) :
+compute_command_graph(cqueue_), replays(make_shared<replay_tracker>()) {
+	const VkCommandPoolCreateInfo cmd_pool_info {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		.pNext = nullptr,
+		.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+		.queueFamilyIndex = ((const vulkan_queue&)cqueue).get_family_index(),
+	};
+	VK_CALL_RET(vkCreateCommandPool(((const vulkan_device&)cqueue.get_device()).device, &cmd_pool_info, nullptr, &cmd_pool),
+				"failed to create command graph command pool")
+}
+
+vulkan_command_graph::~vulkan_command_graph() {
+	wait_for_replays();
+	release_recorded();
+	if(cmd_pool != nullptr) {
+		// NOTE: this also frees the command buffer
+		vkDestroyCommandPool(((const vulkan_device&)cqueue.get_device()).device, cmd_pool, nullptr);
+	}
+}
+
+void vulkan_command_graph::wait_for_replays() const {
+	GUARD(replays->lock);
+	replays->cv.wait(replays->lock, [this]() NO_THREAD_SAFETY_ANALYSIS {
+		return (replays->in_flight == 0u);
+	});
+}
+
+void vulkan_command_graph::release_recorded() const {
+	for(const auto& encoder : recorded_dispatches) {
+		vulkan_kernel::release_recorded_dispatch(encoder);
+	}
+	recorded_dispatches.clear();
+}
+
+bool vulkan_command_graph::finalize() {
+	if(finalized) return true;
+	if(!compute_command_graph::finalize()) return false;
+	
+	if(has_operations()) {
+		// can't record arbitrary host code
+		no_native_graph = true;
+	}
+	else if(cmd_pool == nullptr) {
+		no_native_graph = true;
+	}
+	else {
+		record();
+	}
+	return true;
+}
+
+bool vulkan_command_graph::record() const {
+	// the command buffer and all resources of the previous recording must not be in use anymore
+	wait_for_replays();
+	release_recorded();
+	modified = false;
+	
+	const auto& vk_dev = (const vulkan_device&)cqueue.get_device();
+	if(cmd_buffer == nullptr) {
+		const VkCommandBufferAllocateInfo cmd_buffer_info {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+			.pNext = nullptr,
+			.commandPool = cmd_pool,
+			.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+			.commandBufferCount = 1,
+		};
+		if(const auto alloc_err = vkAllocateCommandBuffers(vk_dev.device, &cmd_buffer_info, &cmd_buffer);
+		   alloc_err != VK_SUCCESS) {
+			log_error("failed to allocate command graph command buffer - replaying commands one by one: %u: %s",
+					  alloc_err, vulkan_error_to_string(alloc_err));
+			cmd_buffer = nullptr;
+			no_native_graph = true;
+			return false;
+		}
+	}
+	
+	// NOTE: compute/transfer only -> no render pass to inherit
+	const VkCommandBufferInheritanceInfo inheritance_info {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+		.pNext = nullptr,
+		.renderPass = nullptr,
+		.subpass = 0,
+		.framebuffer = nullptr,
+		.occlusionQueryEnable = VK_FALSE,
+		.queryFlags = 0,
+		.pipelineStatistics = 0,
+	};
+	// NOTE: the graph may be replayed again before the previous replay has completed
+	const VkCommandBufferBeginInfo begin_info {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		.pNext = nullptr,
+		.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+		.pInheritanceInfo = &inheritance_info,
+	};
+	// NOTE: this implicitly resets the command buffer
+	if(const auto begin_err = vkBeginCommandBuffer(cmd_buffer, &begin_info); begin_err != VK_SUCCESS) {
+		log_error("failed to begin command graph command buffer - replaying commands one by one: %u: %s",
+				  begin_err, vulkan_error_to_string(begin_err));
+		no_native_graph = true;
+		return false;
+	}
+	
+	// commands must be executed in order (as if they were executed one by one on the queue)
+	// -> full compute/transfer barrier in front of each command and after the last one
+	const VkMemoryBarrier barrier {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		.pNext = nullptr,
+		.srcAccessMask = (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT),
+		.dstAccessMask = (VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+						  VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT),
+	};
+	const auto record_barrier = [this, &barrier]() {
+		vkCmdPipelineBarrier(cmd_buffer,
+							 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+							 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+							 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	};
+	
+	bool success = true;
+	for(const auto& command : commands) {
+		record_barrier();
+		if(auto cmd = get_if<kernel_command>(&command)) {
+			auto encoder = ((const vulkan_kernel*)cmd->kernel.get())->record_dispatch(cqueue, cmd_buffer,
+																					   cmd->global_work_size,
+																					   cmd->local_work_size,
+																					   cmd->bound_args->get_args());
+			if(!encoder) {
+				success = false;
+				break;
+			}
+			recorded_dispatches.emplace_back(move(encoder));
+		} else if(auto copy_cmd = get_if<copy_command>(&command)) {
+			success = ((const vulkan_buffer*)copy_cmd->dst)->record_copy(cmd_buffer, *copy_cmd->src, copy_cmd->size,
+																		 copy_cmd->src_offset, copy_cmd->dst_offset);
+		} else if(auto fill_cmd = get_if<fill_command>(&command)) {
+			success = ((const vulkan_buffer*)fill_cmd->buffer)->record_fill(cmd_buffer, fill_cmd->pattern.data(),
+																			fill_cmd->pattern.size(),
+																			fill_cmd->size, fill_cmd->offset);
+		} else {
+			success = false;
+		}
+		if(!success) break;
+	}
+	if(success) {
+		record_barrier();
+	}
+	
+	if(const auto end_err = vkEndCommandBuffer(cmd_buffer); end_err != VK_SUCCESS) {
+		log_error("failed to end command graph command buffer: %u: %s", end_err, vulkan_error_to_string(end_err));
+		success = false;
+	}
+	if(!success) {
+		log_warn("failed to record the command graph into a command buffer - replaying commands one by one");
+		release_recorded();
+		no_native_graph = true;
+		return false;
+	}
+	return true;
+}
+
+void vulkan_command_graph::replay(const compute_queue& exec_queue) const {
+	// NOTE: the command buffer and all of its resources belong to the graph queue
+	if(no_native_graph || &exec_queue != &cqueue) {
+		replay_commands(exec_queue);
+		return;
+	}
+	if(modified || cmd_buffer == nullptr) {
+		if(!record()) {
+			replay_commands(exec_queue);
+			return;
+		}
+	}
+	
+	const auto& vk_queue = (const vulkan_queue&)cqueue;
+	auto primary_cmd_buffer = vk_queue.make_command_buffer("command graph");
+	if(primary_cmd_buffer.cmd_buffer == nullptr) return;
+	
+	const VkCommandBufferBeginInfo begin_info {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		.pNext = nullptr,
+		.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		.pInheritanceInfo = nullptr,
+	};
+	VK_CALL_RET(vkBeginCommandBuffer(primary_cmd_buffer.cmd_buffer, &begin_info),
+				"failed to begin command buffer")
+	vkCmdExecuteCommands(primary_cmd_buffer.cmd_buffer, 1, &cmd_buffer);
+	VK_CALL_RET(vkEndCommandBuffer(primary_cmd_buffer.cmd_buffer), "failed to end command buffer")
+	
+	{
+		GUARD(replays->lock);
+		++replays->in_flight;
+	}
+	vk_queue.submit_command_buffer(primary_cmd_buffer, [replays = replays](const vulkan_queue::command_buffer&) {
+		{
+			GUARD(replays->lock);
+			--replays->in_flight;
+		}
+		replays->cv.notify_all();
+	}, false);
+}
+
+#endif
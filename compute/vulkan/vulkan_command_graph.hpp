@@ -0,0 +1,78 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_VULKAN_COMMAND_GRAPH_HPP__
+#define __FLOOR_VULKAN_COMMAND_GRAPH_HPP__
+
+#include <floor/compute/vulkan/vulkan_common.hpp>
+
+#if !defined(FLOOR_NO_VULKAN)
+
+#include <floor/compute/compute_command_graph.hpp>
+#include <floor/compute/vulkan/vulkan_kernel.hpp>
+#include <floor/threading/thread_safety.hpp>
+#include <condition_variable>
+
+//! compiles the recorded commands into a reusable secondary command buffer, which is then executed as a whole
+//! (one primary command buffer + submission per replay), the graph owns all descriptor sets and constant argument
+//! buffers that are used by the recorded commands
+//! NOTE: if the graph contains opaque operations or image arguments (image layout transitions depend on the state
+//!       at submission time), or is replayed on a different queue, commands are replayed one by one instead
+class vulkan_command_graph final : public compute_command_graph {
+public:
+	explicit vulkan_command_graph(const compute_queue& cqueue);
+	~vulkan_command_graph() override;
+	
+	bool finalize() override;
+	
+	//! NOTE: if arguments or buffers have been rebound, this waits for all previous replays of this graph to complete
+	//!       and then re-records the command buffer first
+	void replay(const compute_queue& exec_queue) const override;
+	
+protected:
+	//! command pool of the secondary command buffer (owned by this graph, b/c the command buffer is reused)
+	VkCommandPool cmd_pool { nullptr };
+	mutable VkCommandBuffer cmd_buffer { nullptr };
+	//! resources of all recorded kernel dispatches
+	mutable vector<shared_ptr<vulkan_kernel::vulkan_encoder>> recorded_dispatches;
+	//! set if this graph can't be turned into a native graph (-> always replay commands one by one)
+	mutable bool no_native_graph { false };
+	
+	//! replays that haven't completed yet (shared with their completion handlers)
+	struct replay_tracker {
+		safe_mutex lock;
+		condition_variable_any cv;
+		uint32_t in_flight GUARDED_BY(lock) { 0u };
+	};
+	shared_ptr<replay_tracker> replays;
+	
+	//! blocks until all replays of this graph have completed
+	void wait_for_replays() const;
+	
+	//! (re-)records the secondary command buffer
+	bool record() const;
+	
+	//! releases the resources of all recorded dispatches
+	//! NOTE: the command buffer must not be in use anymore
+	void release_recorded() const;
+	
+};
+
+#endif
+
+#endif
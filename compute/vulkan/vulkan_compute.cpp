@@ -21,6 +21,7 @@
 #if !defined(FLOOR_NO_VULKAN)
 #include <floor/core/platform.hpp>
 #include <floor/compute/vulkan/vulkan_compute.hpp>
+#include <floor/compute/vulkan/vulkan_allocator.hpp>
 #include <floor/compute/spirv_handler.hpp>
 #include <floor/core/gl_support.hpp>
 #include <floor/core/logger.hpp>
@@ -32,6 +33,11 @@
 #include <floor/floor/floor_version.hpp>
 #include <floor/compute/device/sampler.hpp>
 
+#if !defined(__WINDOWS__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #if defined(FLOOR_DEBUG)
 static VKAPI_ATTR VkBool32 VKAPI_CALL vulkan_debug_callback(VkDebugReportFlagsEXT flags floor_unused,
 															VkDebugReportObjectTypeEXT object_type floor_unused,
@@ -312,9 +318,29 @@ compute_context(), enable_renderer(enable_renderer_) {
 			device_extensions_ptrs.emplace_back(ext.c_str());
 		}
 		
+		// timeline semaphores are optional (used for events/cross-queue dependencies), check if they are actually usable
+		VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_sema_features {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+			.pNext = nullptr,
+			.timelineSemaphore = VK_FALSE,
+		};
+		if (device_extensions_set.count(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) > 0) {
+			auto get_phys_dev_features2 = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(ctx, "vkGetPhysicalDeviceFeatures2KHR");
+			if (get_phys_dev_features2 != nullptr) {
+				VkPhysicalDeviceFeatures2KHR features2 {
+					.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR,
+					.pNext = &timeline_sema_features,
+					.features = {},
+				};
+				get_phys_dev_features2(phys_dev, &features2);
+				timeline_sema_features.pNext = nullptr;
+			}
+		}
+		const bool has_timeline_semaphores = (timeline_sema_features.timelineSemaphore == VK_TRUE);
+		
 		const VkDeviceCreateInfo dev_info {
 			.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-			.pNext = nullptr,
+			.pNext = (has_timeline_semaphores ? &timeline_sema_features : nullptr),
 			.flags = 0,
 			.queueCreateInfoCount = queue_family_count,
 			.pQueueCreateInfos = queue_create_info.data(),
@@ -344,6 +370,12 @@ compute_context(), enable_renderer(enable_renderer_) {
 		device.driver_version_str = to_string(props.driverVersion);
 		device.extensions = device_extensions;
 		
+		if (has_timeline_semaphores) {
+			device.wait_semaphores = (PFN_vkWaitSemaphoresKHR)vkGetDeviceProcAddr(dev, "vkWaitSemaphoresKHR");
+			device.get_semaphore_counter_value = (PFN_vkGetSemaphoreCounterValueKHR)vkGetDeviceProcAddr(dev, "vkGetSemaphoreCounterValueKHR");
+			device.timeline_semaphore_support = (device.wait_semaphores != nullptr && device.get_semaphore_counter_value != nullptr);
+		}
+		
 		// TODO: determine context/platform vulkan version
 		device.vulkan_version = vulkan_version_from_uint(VK_VERSION_MAJOR(props.apiVersion), VK_VERSION_MINOR(props.apiVersion));
 		if (device.vulkan_version == VULKAN_VERSION::VULKAN_1_0) {
@@ -534,6 +566,11 @@ compute_context(), enable_renderer(enable_renderer_) {
 		log_msg("queue families: %u", queue_family_count);
 		log_msg("max queues (family #0): %u", device.queue_counts[0]);
 		
+		create_pipeline_cache(device, props);
+		
+		// all buffer/image memory is sub-allocated from larger device memory blocks
+		device.allocator = make_shared<vulkan_allocator>(device);
+		
 		// TODO: other device flags
 		// TODO: fastest device selection, tricky to do without a unit count
 		
@@ -580,6 +617,17 @@ compute_context(), enable_renderer(enable_renderer_) {
 }
 
 vulkan_compute::~vulkan_compute() {
+	save_pipeline_caches();
+	
+#if defined(FLOOR_DEBUG)
+	for(const auto& dev : devices) {
+		const auto& vk_dev = (const vulkan_device&)*dev;
+		if(vk_dev.allocator) {
+			vk_dev.allocator->log_statistics();
+		}
+	}
+#endif
+	
 #if defined(FLOOR_DEBUG)
 	if(destroy_debug_report_callback != nullptr &&
 	   debug_callback != nullptr) {
@@ -1157,15 +1205,22 @@ vulkan_program::vulkan_program_entry vulkan_compute::create_vulkan_program(const
 		return {};
 	}
 	
-	auto container = spirv_handler::load_container(program.data_or_filename);
+	// NOTE: the container is memory-mapped and shader modules are created directly from the mapping
+	vulkan_program::vulkan_program_entry ret;
+	{
+		auto container = spirv_handler::load_container(program.data_or_filename);
+		if(container.valid) {
+			ret = create_vulkan_program_internal((const vulkan_device&)device, container, program.functions,
+												 program.data_or_filename);
+		}
+		// else: already prints an error
+	}
+	// must unmap before removing the file (required on Windows)
 	if(!floor::get_toolchain_keep_temp() && file_io::is_file(program.data_or_filename)) {
 		// cleanup if file exists
-		core::system("rm " + program.data_or_filename);
+		remove(program.data_or_filename.c_str());
 	}
-	if(!container.valid) return {}; // already prints an error
-	
-	return create_vulkan_program_internal((const vulkan_device&)device, container, program.functions,
-										  program.data_or_filename);
+	return ret;
 }
 
 vulkan_program::vulkan_program_entry
@@ -1205,16 +1260,15 @@ vulkan_compute::create_vulkan_program_internal(const vulkan_device& device,
 shared_ptr<compute_program> vulkan_compute::add_precompiled_program_file(const string& file_name,
 																		 const vector<llvm_toolchain::function_info>& functions) {
 	// TODO: allow spir-v container?
-	size_t code_size = 0;
-	auto code = spirv_handler::load_binary(file_name, code_size);
-	if(code == nullptr) return {};
+	const auto spirv_binary = spirv_handler::load_binary(file_name);
+	if(spirv_binary.code == nullptr) return {};
 	
 	const VkShaderModuleCreateInfo module_info {
 		.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
 		.pNext = nullptr,
 		.flags = 0,
-		.codeSize = code_size,
-		.pCode = code.get(),
+		.codeSize = spirv_binary.code_size,
+		.pCode = spirv_binary.code,
 	};
 	
 	// assume pre-compiled program is the same for all devices
@@ -1241,6 +1295,137 @@ shared_ptr<compute_program::program_entry> vulkan_compute::create_program_entry(
 	return make_shared<vulkan_program::vulkan_program_entry>(create_vulkan_program((const vulkan_device&)device, program));
 }
 
+void vulkan_compute::create_pipeline_cache(vulkan_device& device, const VkPhysicalDeviceProperties& props) const {
+	// try to load the on-disk pipeline cache (only when the toolchain cache is enabled and its directory is safe to use)
+	string cache_data;
+	if(floor::get_toolchain_use_cache() && llvm_toolchain::prepare_cache_directory()) {
+		string uuid_str;
+		static constexpr const char hex_chars[] { "0123456789abcdef" };
+		for(const auto& byte : props.pipelineCacheUUID) {
+			uuid_str += hex_chars[(byte >> 4u) & 0xFu];
+			uuid_str += hex_chars[byte & 0xFu];
+		}
+		device.pipeline_cache_file_name = (floor::get_toolchain_cache_path() + "vk_pipeline_cache_" +
+										   to_string(props.vendorID) + "_" + to_string(props.deviceID) + "_" +
+										   uuid_str + "_" + to_string(props.driverVersion) + ".bin");
+		
+		if(file_io::is_file(device.pipeline_cache_file_name) &&
+		   file_io::file_to_string(device.pipeline_cache_file_name, cache_data)) {
+			// validate the header, so that we never hand incompatible data to the driver
+			// (this should also be done by the driver, but better be safe than sorry)
+			struct __attribute__((packed)) pipeline_cache_header {
+				uint32_t header_size;
+				uint32_t header_version;
+				uint32_t vendor_id;
+				uint32_t device_id;
+				uint8_t uuid[VK_UUID_SIZE];
+			} header;
+			static_assert(sizeof(pipeline_cache_header) == 16u + VK_UUID_SIZE);
+			bool valid = (cache_data.size() >= sizeof(header));
+			if(valid) {
+				memcpy(&header, cache_data.data(), sizeof(header));
+				valid = (header.header_size >= sizeof(header) &&
+						 header.header_size <= cache_data.size() &&
+						 header.header_version == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+						 header.vendor_id == props.vendorID &&
+						 header.device_id == props.deviceID &&
+						 memcmp(header.uuid, props.pipelineCacheUUID, VK_UUID_SIZE) == 0);
+			}
+			if(!valid) {
+				log_warn("ignoring invalid or incompatible pipeline cache: %s", device.pipeline_cache_file_name);
+				cache_data.clear();
+			}
+			else {
+				log_debug("loaded pipeline cache: %s (%u bytes)", device.pipeline_cache_file_name, cache_data.size());
+			}
+		}
+	}
+	
+	const VkPipelineCacheCreateInfo cache_info {
+		.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+		.pNext = nullptr,
+		.flags = 0,
+		.initialDataSize = cache_data.size(),
+		.pInitialData = (!cache_data.empty() ? cache_data.data() : nullptr),
+	};
+	if(vkCreatePipelineCache(device.device, &cache_info, nullptr, &device.pipeline_cache) != VK_SUCCESS) {
+		// retry without initial data, then continue without a pipeline cache if this fails as well
+		const VkPipelineCacheCreateInfo empty_cache_info {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.initialDataSize = 0,
+			.pInitialData = nullptr,
+		};
+		device.pipeline_cache = nullptr;
+		VK_CALL_RET(vkCreatePipelineCache(device.device, &empty_cache_info, nullptr, &device.pipeline_cache),
+					"failed to create pipeline cache for device \"" + device.name + "\"")
+	}
+}
+
+//! writes "data" to a new file that is only accessible by the current user (0600), fails if the file already exists
+static bool write_private_file(const string& file_name, const uint8_t* data, const size_t size) {
+#if !defined(__WINDOWS__)
+	const auto fd = open(file_name.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if(fd < 0) {
+		return false;
+	}
+	bool success = true;
+	for(size_t written = 0; written < size; ) {
+		const auto ret = write(fd, data + written, size - written);
+		if(ret < 0) {
+			if(errno == EINTR) continue;
+			success = false;
+			break;
+		}
+		written += size_t(ret);
+	}
+	if(close(fd) != 0) {
+		success = false;
+	}
+	return success;
+#else
+	return file_io::buffer_to_file(file_name, (const char*)data, size);
+#endif
+}
+
+//! writes the pipeline cache data of the specified device to its pipeline cache file
+static void write_pipeline_cache(const vulkan_device& dev) {
+	size_t cache_size = 0;
+	if(vkGetPipelineCacheData(dev.device, dev.pipeline_cache, &cache_size, nullptr) != VK_SUCCESS ||
+	   cache_size == 0) {
+		return;
+	}
+	vector<uint8_t> cache_data(cache_size);
+	VK_CALL_RET(vkGetPipelineCacheData(dev.device, dev.pipeline_cache, &cache_size, cache_data.data()),
+				"failed to retrieve pipeline cache data for device \"" + dev.name + "\"")
+	
+	if(!llvm_toolchain::prepare_cache_directory()) {
+		return;
+	}
+	
+	// write to a temporary file first and rename it, so that other processes never see an incomplete cache
+	const auto tmp_file_name = dev.pipeline_cache_file_name + "." + to_string(core::rand<uint32_t>());
+	if(!write_private_file(tmp_file_name, cache_data.data(), cache_size) ||
+	   rename(tmp_file_name.c_str(), dev.pipeline_cache_file_name.c_str()) != 0) {
+		log_error("failed to write pipeline cache: %s", dev.pipeline_cache_file_name);
+		remove(tmp_file_name.c_str());
+	}
+}
+
+void vulkan_compute::save_pipeline_caches() const {
+	for(const auto& dev : devices) {
+		auto& vk_dev = (vulkan_device&)*dev;
+		if(vk_dev.pipeline_cache == nullptr) continue;
+		
+		if(!vk_dev.pipeline_cache_file_name.empty()) {
+			write_pipeline_cache(vk_dev);
+		}
+		vkDestroyPipelineCache(vk_dev.device, vk_dev.pipeline_cache, nullptr);
+		vk_dev.pipeline_cache = nullptr;
+	}
+}
+
 void vulkan_compute::create_fixed_sampler_set() const {
 	union vulkan_fixed_sampler {
 		struct {
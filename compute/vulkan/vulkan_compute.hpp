@@ -80,6 +80,8 @@ public:
 										   const COMPUTE_MEMORY_FLAG flags = (COMPUTE_MEMORY_FLAG::READ_WRITE |
 																			  COMPUTE_MEMORY_FLAG::HOST_READ_WRITE)) const override;
 	
+	bool has_sub_buffer_support() const override { return true; }
+	
 	//////////////////////////////////////////
 	// image creation
 	
@@ -225,6 +227,12 @@ protected:
 	// creates the fixed sampler set for all devices
 	void create_fixed_sampler_set() const;
 	
+	// creates the pipeline cache for the specified device, loading the on-disk cache if possible
+	void create_pipeline_cache(vulkan_device& device, const VkPhysicalDeviceProperties& props) const;
+	
+	// writes the pipeline caches of all devices to disk
+	void save_pipeline_caches() const;
+	
 };
 
 #endif
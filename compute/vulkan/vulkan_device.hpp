@@ -25,6 +25,10 @@
 #include <memory>
 #include <unordered_set>
 
+#if !defined(FLOOR_NO_VULKAN)
+class vulkan_allocator;
+#endif
+
 FLOOR_PUSH_WARNINGS()
 FLOOR_IGNORE_WARNING(weak-vtables)
 
@@ -51,10 +55,20 @@ public:
 	
 	//! memory properties of the device/implementation/host
 	shared_ptr<VkPhysicalDeviceMemoryProperties> mem_props;
+	
+	//! device memory sub-allocator, used for all buffer and image memory of this device
+	shared_ptr<vulkan_allocator> allocator;
+	
+	//! VK_KHR_timeline_semaphore functions (only set if timeline_semaphore_support is true)
+	PFN_vkWaitSemaphoresKHR wait_semaphores { nullptr };
+	PFN_vkGetSemaphoreCounterValueKHR get_semaphore_counter_value { nullptr };
 #else
 	void* _physical_device { nullptr };
 	void* _device { nullptr };
 	shared_ptr<void*> _mem_props;
+	shared_ptr<void> _allocator;
+	void* _wait_semaphores { nullptr };
+	void* _get_semaphore_counter_value { nullptr };
 #endif
 	
 	//! queue count per queue family
@@ -91,6 +105,9 @@ public:
 	//! feature support: can use 16-bit float types in SPIR-V
 	bool float16_support { false };
 	
+	//! feature support: VK_KHR_timeline_semaphore is supported and enabled (used for compute_event)
+	bool timeline_semaphore_support { false };
+	
 	// put these at the end, b/c they are rather large
 #if !defined(FLOOR_NO_VULKAN)
 	//! fixed sampler descriptor set
@@ -107,6 +124,10 @@ public:
 	//! NOTE: this solely consists of { nullptr, nullptr, 0 } objects, but is sadly necessary when updating/setting
 	//!       the descriptor set (.sampler is ignored if immutable samplers are used, others are ignored anyways)
 	vector<VkDescriptorImageInfo> fixed_sampler_image_info;
+	
+	//! pipeline cache used for all pipelines created on this device
+	//! NOTE: this is created at context creation (loaded from disk if possible) and written to disk at destruction
+	VkPipelineCache pipeline_cache { nullptr };
 #else
 	uint64_t _fixed_sampler_desc_set_layout;
 	uint64_t _fixed_sampler_desc_pool;
@@ -114,8 +135,13 @@ public:
 	vector<uint64_t> _fixed_sampler_set;
 	struct _dummy_desc_img_info { void* _a; void* _b; uint32_t _c; };
 	vector<_dummy_desc_img_info> _fixed_sampler_image_info;
+	uint64_t _pipeline_cache;
 #endif
 	
+	//! file name of the on-disk pipeline cache of this device
+	//! (identifies the device via its vendor id, device id, pipeline cache UUID and driver version)
+	string pipeline_cache_file_name;
+	
 	//! returns true if the specified object is the same object as this
 	bool operator==(const vulkan_device& dev) const {
 		return (this == &dev);
@@ -220,6 +220,18 @@ bool vulkan_image::create_internal(const bool copy_host_data, const compute_queu
 		{ COMPUTE_IMAGE_TYPE::BPTC_RGBUHF, VK_FORMAT_BC6H_UFLOAT_BLOCK },
 		{ COMPUTE_IMAGE_TYPE::BPTC_RGBA, VK_FORMAT_BC7_UNORM_BLOCK },
 		{ COMPUTE_IMAGE_TYPE::BPTC_RGBA_SRGB, VK_FORMAT_BC7_SRGB_BLOCK },
+		// ETC1/ETC2/EAC
+		{ COMPUTE_IMAGE_TYPE::ETC1_RGB, VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::ETC2_RGB, VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::ETC2_RGB_SRGB, VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::ETC2_RGB_A1, VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::ETC2_RGB_A1_SRGB, VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::ETC2_RGBA, VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::ETC2_RGBA_SRGB, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::EAC_RUI, VK_FORMAT_EAC_R11_UNORM_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::EAC_RI, VK_FORMAT_EAC_R11_SNORM_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::EAC_RGUI, VK_FORMAT_EAC_R11G11_UNORM_BLOCK },
+		{ COMPUTE_IMAGE_TYPE::EAC_RGI, VK_FORMAT_EAC_R11G11_SNORM_BLOCK },
 		// PVRTC formats
 		// NOTE: not to be confused with PVRTC version 2, here: PVRTC1 == RGB, PVRTC2 == RGBA
 		{ COMPUTE_IMAGE_TYPE::PVRTC_RGB2, VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG },
@@ -308,14 +320,13 @@ bool vulkan_image::create_internal(const bool copy_host_data, const compute_queu
 	VkMemoryRequirements mem_req;
 	vkGetImageMemoryRequirements(vulkan_dev, image, &mem_req);
 	
-	const VkMemoryAllocateInfo alloc_info {
-		.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-		.pNext = nullptr,
-		.allocationSize = mem_req.size,
-		.memoryTypeIndex = find_memory_type_index(mem_req.memoryTypeBits, true /* prefer device memory */),
-	};
-	VK_CALL_RET(vkAllocateMemory(vulkan_dev, &alloc_info, nullptr, &mem), "image allocation failed", false)
-	VK_CALL_RET(vkBindImageMemory(vulkan_dev, image, mem, 0), "image allocation binding failed", false)
+	alloc = device.allocator->allocate(mem_req, find_memory_type_index(mem_req.memoryTypeBits, true /* prefer device memory */),
+									   vulkan_allocator::RESOURCE::IMAGE);
+	if(!alloc.is_valid()) {
+		log_error("image allocation failed");
+		return false;
+	}
+	VK_CALL_RET(vkBindImageMemory(vulkan_dev, image, alloc.memory, alloc.offset), "image allocation binding failed", false)
 	
 	// create the view
 	VkImageViewType view_type = VK_IMAGE_VIEW_TYPE_2D;
@@ -458,25 +469,26 @@ bool vulkan_image::create_internal(const bool copy_host_data, const compute_queu
 }
 
 vulkan_image::~vulkan_image() {
-	auto vulkan_dev = ((const vulkan_device&)dev).device;
-	
+	// mip-map image views (only need to destroy all created ones, not up to dev->max_mip_levels)
+	vector<VkImageView> views;
+	if(is_mip_mapped && (generate_mip_maps || has_flag<COMPUTE_IMAGE_TYPE::WRITE>(image_type))) {
+		views.assign(mip_map_image_view.begin(), mip_map_image_view.begin() + mip_level_count);
+	}
 	if(image_view != nullptr) {
-		vkDestroyImageView(vulkan_dev, image_view, nullptr);
-		image_view = nullptr;
+		views.emplace_back(image_view);
 	}
 	
-	// mip-map image views
-	if(is_mip_mapped && (generate_mip_maps || has_flag<COMPUTE_IMAGE_TYPE::WRITE>(image_type))) {
-		// only need to destroy all created ones (not up to dev->max_mip_levels)
-		for(uint32_t i = 0; i < mip_level_count; ++i) {
-			vkDestroyImageView(vulkan_dev, mip_map_image_view[i], nullptr);
+	// batched transfers may still reference the image -> destroy it once they have completed
+	release_after_transfers([vulkan_dev = ((const vulkan_device&)dev).device, image_ = image, views = move(views)]() {
+		for(const auto& view : views) {
+			vkDestroyImageView(vulkan_dev, view, nullptr);
 		}
-	}
-	
-	if(image != nullptr) {
-		vkDestroyImage(vulkan_dev, image, nullptr);
-		image = nullptr;
-	}
+		if(image_ != nullptr) {
+			vkDestroyImage(vulkan_dev, image_, nullptr);
+		}
+	});
+	image_view = nullptr;
+	image = nullptr;
 }
 
 void vulkan_image::zero(const compute_queue& cqueue floor_unused) {
@@ -498,17 +510,20 @@ void vulkan_image::unmap(const compute_queue& cqueue,
 		return;
 	}
 	
+	// NOTE: the mapping is removed by vulkan_memory::unmap
+	const auto flags = iter->second.flags;
 	vulkan_memory::unmap(cqueue, mapped_ptr);
 	
 	// manually create mip-map chain
 	if(generate_mip_maps &&
-	   (has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE>(iter->second.flags) ||
-		has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE_INVALIDATE>(iter->second.flags))) {
+	   (has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE>(flags) ||
+		has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE_INVALIDATE>(flags))) {
 		generate_mip_map_chain(cqueue);
 	}
 }
 
-void vulkan_image::image_copy_dev_to_host(const compute_queue& cqueue, VkCommandBuffer cmd_buffer, VkBuffer host_buffer) {
+void vulkan_image::image_copy_dev_to_host(const compute_queue& cqueue, VkCommandBuffer cmd_buffer, VkBuffer host_buffer,
+										  const VkDeviceSize host_buffer_offset) {
 	// TODO: mip-mapping, array/layer support, depth/stencil support
 	const auto dim_count = image_dim_count(image_type);
 	const VkImageSubresourceLayers img_sub_rsrc_layers {
@@ -518,7 +533,7 @@ void vulkan_image::image_copy_dev_to_host(const compute_queue& cqueue, VkCommand
 		.layerCount = 1,
 	};
 	const VkBufferImageCopy region {
-		.bufferOffset = 0,
+		.bufferOffset = host_buffer_offset,
 		.bufferRowLength = 0, // tightly packed
 		.bufferImageHeight = 0, // tightly packed
 		.imageSubresource = img_sub_rsrc_layers,
@@ -537,7 +552,12 @@ void vulkan_image::image_copy_dev_to_host(const compute_queue& cqueue, VkCommand
 	vkCmdCopyImageToBuffer(cmd_buffer, image, image_info.imageLayout, host_buffer, 1, &region);
 }
 
-void vulkan_image::image_copy_host_to_dev(const compute_queue& cqueue, VkCommandBuffer cmd_buffer, VkBuffer host_buffer, void* data) {
+void vulkan_image::image_shim_host_to_mapped(void* mapped_ptr, const void* data) {
+	rgb_to_rgba(image_type, shim_image_type, (const uint8_t*)data, (uint8_t*)mapped_ptr, generate_mip_maps);
+}
+
+void vulkan_image::image_copy_host_to_dev(const compute_queue& cqueue, VkCommandBuffer cmd_buffer, VkBuffer host_buffer,
+										  const VkDeviceSize host_buffer_offset, void* data) {
 	// TODO: depth/stencil support
 	const auto dim_count = image_dim_count(image_type);
 	
@@ -547,14 +567,14 @@ void vulkan_image::image_copy_host_to_dev(const compute_queue& cqueue, VkCommand
 			   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 			   VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
 	
-	// RGB -> RGBA data conversion if necessary
-	if(image_type != shim_image_type) {
+	// RGB -> RGBA data conversion if necessary (and not already done when writing the mapped memory)
+	if(image_type != shim_image_type && data != nullptr) {
 		rgb_to_rgba_inplace(image_type, shim_image_type, (uint8_t*)data, generate_mip_maps);
 	}
 	
 	vector<VkBufferImageCopy> regions;
 	regions.reserve(mip_level_count);
-	uint64_t buffer_offset = 0;
+	uint64_t buffer_offset = host_buffer_offset;
 	apply_on_levels([this, &regions, &buffer_offset, &dim_count](const uint32_t& level,
 																 const uint4& mip_image_dim,
 																 const uint32_t&,
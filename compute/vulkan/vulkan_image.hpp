@@ -86,6 +86,11 @@ public:
 		return mip_map_image_info;
 	}
 	
+	//! returns the unique resource id of this image
+	uint64_t get_vulkan_resource_id() const {
+		return resource_id;
+	}
+	
 	//! returns the vulkan image format that is used for this image
 	VkFormat get_vulkan_format() const {
 		return vk_format;
@@ -109,9 +114,12 @@ protected:
 	bool create_internal(const bool copy_host_data, const compute_queue& cqueue);
 	
 	void image_copy_dev_to_host(const compute_queue& cqueue,
-								VkCommandBuffer cmd_buffer, VkBuffer host_buffer) override;
+								VkCommandBuffer cmd_buffer, VkBuffer host_buffer,
+								const VkDeviceSize host_buffer_offset) override;
 	void image_copy_host_to_dev(const compute_queue& cqueue,
-								VkCommandBuffer cmd_buffer, VkBuffer host_buffer, void* data) override;
+								VkCommandBuffer cmd_buffer, VkBuffer host_buffer,
+								const VkDeviceSize host_buffer_offset, void* data) override;
+	void image_shim_host_to_mapped(void* mapped_ptr, const void* data) override;
 	
 };
 
@@ -23,17 +23,185 @@
 #include <floor/compute/vulkan/vulkan_queue.hpp>
 #include <floor/compute/vulkan/vulkan_device.hpp>
 
+//! NOTE: encoders are pooled per kernel (see encoder_pool) -> all containers keep their capacity between launches
 struct vulkan_kernel::vulkan_encoder {
 	vulkan_queue::command_buffer cmd_buffer;
-	const vulkan_queue& cqueue;
-	const vulkan_device& device;
+	const vulkan_queue* cqueue { nullptr };
 	vector<VkWriteDescriptorSet> write_descs;
 	vector<shared_ptr<compute_buffer>> constant_buffers;
 	vector<uint32_t> dyn_offsets;
 	vector<shared_ptr<vector<VkDescriptorImageInfo>>> image_array_info;
-	const VkPipeline pipeline { nullptr };
-	const VkPipelineLayout pipeline_layout { nullptr };
+	VkPipeline pipeline { nullptr };
+	VkPipelineLayout pipeline_layout { nullptr };
+	//! if set, constant args are sub-allocated from the constant ring buffer of the queue,
+	//! which requires that release_constants() is called once the submission has completed
+	bool use_constant_ring { false };
+	//! constant ring allocations of this encoder
+	vector<uint64_t> constant_allocation_ids;
+	//! buffer infos of constant ring allocations (deque, so that these stay valid while adding more)
+	deque<VkDescriptorBufferInfo> constant_buffer_info;
+	//! entry index of each write descriptor (~0u if unused)
+	vector<uint32_t> write_desc_entries;
+	//! bound resources per entry (-> descriptor set cache key)
+	vector<vector<uint64_t>> desc_keys;
+	//! acquired descriptor set per entry (nullptr if an entry doesn't have any descriptors)
+	vector<VkDescriptorSet> desc_sets;
+	//! all acquired descriptor sets and their cache, these must be released once the submission has completed
+	vector<pair<shared_ptr<vulkan_kernel::desc_set_cache>, VkDescriptorSet>> acquired_desc_sets;
+	//! pool this encoder is returned to once its submission has completed (doesn't keep the kernel pool alive)
+	weak_ptr<vulkan_kernel::encoder_pool> pool;
+	
+	//! clears all per-launch state, but keeps the allocated memory
+	void reset() {
+		cmd_buffer = {};
+		cqueue = nullptr;
+		write_descs.clear();
+		constant_buffers.clear();
+		dyn_offsets.clear();
+		image_array_info.clear();
+		pipeline = nullptr;
+		pipeline_layout = nullptr;
+		use_constant_ring = false;
+		constant_allocation_ids.clear();
+		constant_buffer_info.clear();
+		write_desc_entries.clear();
+		for(auto& desc_key : desc_keys) {
+			desc_key.clear();
+		}
+		desc_sets.clear();
+		acquired_desc_sets.clear();
+	}
+};
+
+//! resource kinds in descriptor set cache keys (so that different resource kinds never produce the same key)
+enum class DESC_KEY_TYPE : uint64_t {
+	BUFFER,
+	QUEUE_BUFFER,
+	READ_IMAGE,
+	WRITE_IMAGE,
+	IMAGE_ARRAY,
 };
+//! amount of descriptor set key words of a buffer argument (kind, resource, range)
+static constexpr const size_t buffer_desc_key_size { 3u };
+
+vulkan_kernel::desc_set_cache::desc_set_cache(const vulkan_device& device_,
+											  const VkDescriptorSetLayout desc_set_layout_,
+											  vector<VkDescriptorPoolSize>&& pool_sizes_) :
+device(device_), desc_set_layout(desc_set_layout_), pool_sizes(move(pool_sizes_)) {
+}
+
+vulkan_kernel::desc_set_cache::~desc_set_cache() {
+	GUARD(cache_lock);
+	// NOTE: this also frees all sets
+	for(auto& pool : pools) {
+		vkDestroyDescriptorPool(device.device, pool, nullptr);
+	}
+	pools.clear();
+	entries.clear();
+}
+
+VkDescriptorSet vulkan_kernel::desc_set_cache::allocate_set() {
+	if(pools.empty() || sets_in_last_pool >= sets_per_pool) {
+		vector<VkDescriptorPoolSize> sizes(pool_sizes);
+		for(auto& size : sizes) {
+			size.descriptorCount *= sets_per_pool;
+		}
+		const VkDescriptorPoolCreateInfo desc_pool_info {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.maxSets = sets_per_pool,
+			.poolSizeCount = uint32_t(sizes.size()),
+			.pPoolSizes = sizes.data(),
+		};
+		VkDescriptorPool pool { nullptr };
+		VK_CALL_RET(vkCreateDescriptorPool(device.device, &desc_pool_info, nullptr, &pool),
+					"failed to create descriptor pool", nullptr)
+		pools.emplace_back(pool);
+		sets_in_last_pool = 0;
+	}
+	
+	const VkDescriptorSetAllocateInfo desc_set_alloc_info {
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+		.pNext = nullptr,
+		.descriptorPool = pools.back(),
+		.descriptorSetCount = 1,
+		.pSetLayouts = &desc_set_layout,
+	};
+	VkDescriptorSet desc_set { nullptr };
+	VK_CALL_RET(vkAllocateDescriptorSets(device.device, &desc_set_alloc_info, &desc_set),
+				"failed to allocate descriptor set", nullptr)
+	++sets_in_last_pool;
+	return desc_set;
+}
+
+//! 64-bit FNV-1a hash of all key words
+static uint64_t hash_desc_key(const vector<uint64_t>& key) {
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for(const auto& word : key) {
+		hash ^= word;
+		hash *= 0x100000001B3ull;
+	}
+	return hash;
+}
+
+VkDescriptorSet vulkan_kernel::desc_set_cache::acquire(const vector<uint64_t>& key, vector<VkWriteDescriptorSet>& write_descs) {
+	const auto key_hash = hash_desc_key(key);
+	
+	GUARD(cache_lock);
+	++use_counter;
+	for(auto& entry : entries) {
+		if(entry.key_hash == key_hash && entry.key == key) {
+			// cached -> no need to write anything
+			++entry.use_count;
+			entry.last_use = use_counter;
+			return entry.desc_set;
+		}
+	}
+	
+	// not cached yet: evict the least recently used set that isn't in use, or allocate a new one
+	cache_entry* new_entry = nullptr;
+	if(entries.size() >= max_cached_sets) {
+		for(auto& entry : entries) {
+			if(entry.use_count == 0 && (new_entry == nullptr || entry.last_use < new_entry->last_use)) {
+				new_entry = &entry;
+			}
+		}
+	}
+	if(new_entry == nullptr) {
+		const auto desc_set = allocate_set();
+		if(desc_set == nullptr) {
+			return nullptr;
+		}
+		entries.emplace_back(cache_entry { .desc_set = desc_set });
+		new_entry = &entries.back();
+	}
+	
+	for(auto& write_desc : write_descs) {
+		write_desc.dstSet = new_entry->desc_set;
+	}
+	vkUpdateDescriptorSets(device.device, uint32_t(write_descs.size()), write_descs.data(),
+						   // never copy (bad for performance)
+						   0, nullptr);
+	
+	new_entry->key_hash = key_hash;
+	new_entry->key = key;
+	new_entry->use_count = 1;
+	new_entry->last_use = use_counter;
+	return new_entry->desc_set;
+}
+
+void vulkan_kernel::desc_set_cache::release(const VkDescriptorSet desc_set) {
+	GUARD(cache_lock);
+	for(auto& entry : entries) {
+		if(entry.desc_set == desc_set) {
+			if(entry.use_count > 0) {
+				--entry.use_count;
+			}
+			return;
+		}
+	}
+}
 
 uint64_t vulkan_kernel::vulkan_kernel_entry::make_spec_key(const uint3& work_group_size) {
 #if defined(FLOOR_DEBUG)
@@ -90,7 +258,7 @@ vulkan_kernel::vulkan_kernel_entry::spec_entry* vulkan_kernel::vulkan_kernel_ent
 		.basePipelineIndex = 0,
 	};
 	log_debug("specializing %s for %v ...", info->name, work_group_size); logger::flush();
-	VK_CALL_RET(vkCreateComputePipelines(device.device, nullptr, 1, &pipeline_info, nullptr,
+	VK_CALL_RET(vkCreateComputePipelines(device.device, device.pipeline_cache, 1, &pipeline_info, nullptr,
 										 &spec_entry.pipeline),
 				"failed to create compute pipeline (" + info->name + ", " + work_group_size.to_string() + ")",
 				nullptr)
@@ -100,7 +268,15 @@ vulkan_kernel::vulkan_kernel_entry::spec_entry* vulkan_kernel::vulkan_kernel_ent
 	return &spec_iter.second->second;
 }
 
-vulkan_kernel::vulkan_kernel(kernel_map_type&& kernels_) : kernels(move(kernels_)) {
+vulkan_kernel::vulkan_kernel(kernel_map_type&& kernels_) : kernels(move(kernels_)), encoders(make_shared<encoder_pool>()) {
+}
+
+void vulkan_kernel::recycle_encoder(const shared_ptr<vulkan_encoder>& encoder) {
+	auto pool = encoder->pool.lock();
+	if(!pool) return; // kernel is gone -> encoder is destroyed with its last reference
+	encoder->reset();
+	GUARD(pool->lock);
+	pool->encoders.emplace_back(encoder);
 }
 
 typename vulkan_kernel::kernel_map_type::iterator vulkan_kernel::get_kernel(const compute_queue& cqueue) const {
@@ -136,23 +312,42 @@ shared_ptr<vulkan_kernel::vulkan_encoder> vulkan_kernel::create_encoder(const co
 		cmd_buffer = *(vulkan_queue::command_buffer*)cmd_buffer_;
 	}
 	
-	vkCmdBindPipeline(cmd_buffer.cmd_buffer,
-					  entries[0]->stage_info.stage == VK_SHADER_STAGE_COMPUTE_BIT ?
-					  VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS,
-					  pipeline);
+	const auto& vk_queue = (const vulkan_queue&)cqueue;
+	const auto bind_point = (entries[0]->stage_info.stage == VK_SHADER_STAGE_COMPUTE_BIT ?
+							 VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS);
+	vkCmdBindPipeline(cmd_buffer.cmd_buffer, bind_point, pipeline);
 	
-	const auto& vk_dev = (const vulkan_device&)cqueue.get_device();
-	auto encoder = make_shared<vulkan_encoder>(vulkan_encoder {
-		.cmd_buffer = cmd_buffer,
-		.cqueue = (const vulkan_queue&)cqueue,
-		.device = vk_dev,
-		.pipeline = pipeline,
-		.pipeline_layout = pipeline_layout,
-	});
+	// the fixed sampler set never changes -> only bound once per command buffer and bind point
+	vk_queue.bind_fixed_sampler_set(cmd_buffer, bind_point, pipeline_layout);
 	
-	// allocate #args write descriptor sets + 1 for the fixed sampler set
+	// reuse a pooled encoder if possible
+	shared_ptr<vulkan_encoder> encoder;
+	{
+		GUARD(encoders->lock);
+		if(!encoders->encoders.empty()) {
+			encoder = move(encoders->encoders.back());
+			encoders->encoders.pop_back();
+		}
+	}
+	if(!encoder) {
+		encoder = make_shared<vulkan_encoder>();
+		encoder->pool = encoders;
+	}
+	encoder->cmd_buffer = cmd_buffer;
+	encoder->cqueue = &vk_queue;
+	encoder->pipeline = pipeline;
+	encoder->pipeline_layout = pipeline_layout;
+	
+	init_encoder_args(encoder.get(), entries);
+	
+	success = true;
+	return encoder;
+}
+
+void vulkan_kernel::init_encoder_args(vulkan_encoder* encoder, const vector<const vulkan_kernel_entry*>& entries) {
+	// allocate #args write descriptor sets
 	// NOTE: any stage_input arguments have to be ignored
-	size_t arg_count = 1;
+	size_t arg_count = 0;
 	for(const auto& entry : entries) {
 		if(entry == nullptr) continue;
 		for(const auto& arg : entry->info->args) {
@@ -168,29 +363,15 @@ shared_ptr<vulkan_kernel::vulkan_encoder> vulkan_kernel::create_encoder(const co
 		}
 	}
 	encoder->write_descs.resize(arg_count);
-	
-	// fixed sampler set
-	{
-		auto& write_desc = encoder->write_descs[0];
-		write_desc.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		write_desc.pNext = nullptr;
-		write_desc.dstSet = vk_dev.fixed_sampler_desc_set;
-		write_desc.dstBinding = 0;
-		write_desc.dstArrayElement = 0;
-		write_desc.descriptorCount = (uint32_t)vk_dev.fixed_sampler_set.size();
-		write_desc.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-		write_desc.pImageInfo = vk_dev.fixed_sampler_image_info.data();
-		write_desc.pBufferInfo = nullptr;
-		write_desc.pTexelBufferView = nullptr;
-	}
-	
-	success = true;
-	return encoder;
+	encoder->write_desc_entries.resize(arg_count, ~0u);
+	encoder->desc_keys.resize(entries.size());
 }
 
 VkPipeline vulkan_kernel::get_pipeline_spec(const vulkan_device& device,
 											vulkan_kernel_entry& entry,
 											const uint3& work_group_size) const {
+	GUARD(specialization_lock);
+	
 	// try to find a pipeline that has already been built/specialized for this work-group size
 	const auto spec_key = vulkan_kernel_entry::make_spec_key(work_group_size);
 	const auto iter = entry.specializations.find(spec_key);
@@ -208,6 +389,77 @@ VkPipeline vulkan_kernel::get_pipeline_spec(const vulkan_device& device,
 	return spec_entry->pipeline;
 }
 
+bool vulkan_kernel::acquire_desc_sets(vulkan_encoder* encoder,
+									  const vector<const vulkan_kernel_entry*>& entries) const {
+	encoder->desc_sets.resize(entries.size(), nullptr);
+	vector<VkWriteDescriptorSet> entry_write_descs;
+	for(uint32_t i = 0; i < uint32_t(entries.size()); ++i) {
+		const auto entry = entries[i];
+		if(entry == nullptr || !entry->desc_cache) continue;
+		
+		entry_write_descs.clear();
+		for(size_t write_idx = 0; write_idx < encoder->write_descs.size(); ++write_idx) {
+			if(encoder->write_desc_entries[write_idx] == i) {
+				entry_write_descs.emplace_back(encoder->write_descs[write_idx]);
+			}
+		}
+		
+		const auto desc_set = entry->desc_cache->acquire(encoder->desc_keys[i], entry_write_descs);
+		if(desc_set == nullptr) {
+			log_error("failed to acquire a descriptor set for \"%s\"", entry->info->name);
+			release_desc_sets(encoder);
+			return false;
+		}
+		encoder->desc_sets[i] = desc_set;
+		encoder->acquired_desc_sets.emplace_back(entry->desc_cache, desc_set);
+	}
+	return true;
+}
+
+void vulkan_kernel::release_desc_sets(vulkan_encoder* encoder) {
+	for(const auto& acquired_desc_set : encoder->acquired_desc_sets) {
+		acquired_desc_set.first->release(acquired_desc_set.second);
+	}
+	encoder->acquired_desc_sets.clear();
+}
+
+bool vulkan_kernel::prespecialize(const vector<uint3>& work_group_sizes) const {
+	GUARD(specialization_lock);
+	
+	bool success = true;
+	for(auto& kernel : kernels) {
+		auto& entry = kernel.second;
+		if(entry.stage_info.stage != VK_SHADER_STAGE_COMPUTE_BIT) continue;
+		
+		for(const auto& work_group_size : work_group_sizes) {
+			// kernels with a fixed work-group size can only be built for exactly that size
+			if(entry.info->has_valid_local_size() && (work_group_size != entry.info->local_size).any()) continue;
+			if((work_group_size == 0u).any() ||
+			   (work_group_size > entry.max_local_size).any() ||
+			   work_group_size.extent() > entry.max_total_local_size) {
+				continue;
+			}
+			if(entry.specialize(kernel.first.get(), work_group_size) == nullptr) {
+				// NOTE: already prints an error
+				success = false;
+			}
+		}
+	}
+	return success;
+}
+
+//! returns the amount of work-groups that are necessary to cover "global_work_size" (at least 1 in each dimension)
+static uint3 compute_grid_dim(const uint3& global_work_size, const uint3& block_dim) {
+	const uint3 grid_dim_overflow {
+		global_work_size.x > 0 ? std::min(uint32_t(global_work_size.x % block_dim.x), 1u) : 0u,
+		global_work_size.y > 0 ? std::min(uint32_t(global_work_size.y % block_dim.y), 1u) : 0u,
+		global_work_size.z > 0 ? std::min(uint32_t(global_work_size.z % block_dim.z), 1u) : 0u
+	};
+	uint3 grid_dim { (global_work_size / block_dim) + grid_dim_overflow };
+	grid_dim.max(1u);
+	return grid_dim;
+}
+
 void vulkan_kernel::execute(const compute_queue& cqueue,
 							const bool& is_cooperative,
 							const uint32_t& dim floor_unused,
@@ -229,15 +481,40 @@ void vulkan_kernel::execute(const compute_queue& cqueue,
 	
 	// check work size
 	const uint3 block_dim = check_local_work_size(kernel_iter->second, local_work_size_);
+	execute_internal(cqueue, kernel_iter, block_dim, compute_grid_dim(global_work_size, block_dim), nullptr, 0, args);
+}
+
+void vulkan_kernel::execute_indirect(const compute_queue& cqueue,
+									 const uint32_t& dim floor_unused,
+									 const compute_buffer& indirect_buffer,
+									 const size_t& indirect_offset,
+									 const uint3& local_work_size,
+									 const vector<compute_kernel_arg>& args) const {
+	// find entry for queue device
+	const auto kernel_iter = get_kernel(cqueue);
+	if(kernel_iter == kernels.cend()) {
+		log_error("no kernel for this compute queue/device exists!");
+		return;
+	}
 	
-	const uint3 grid_dim_overflow {
-		global_work_size.x > 0 ? std::min(uint32_t(global_work_size.x % block_dim.x), 1u) : 0u,
-		global_work_size.y > 0 ? std::min(uint32_t(global_work_size.y % block_dim.y), 1u) : 0u,
-		global_work_size.z > 0 ? std::min(uint32_t(global_work_size.z % block_dim.z), 1u) : 0u
-	};
-	uint3 grid_dim { (global_work_size / block_dim) + grid_dim_overflow };
-	grid_dim.max(1u);
+	// NOTE: vkCmdDispatchIndirect requires a 4-byte aligned offset
+	if(indirect_offset % 4u != 0u || indirect_offset + sizeof(VkDispatchIndirectCommand) > indirect_buffer.get_size()) {
+		log_error("invalid indirect work-group count offset: %u", indirect_offset);
+		return;
+	}
 	
+	// NOTE: all three work-group counts are always used here (-> unused dimensions must be 1)
+	execute_internal(cqueue, kernel_iter, check_local_work_size(kernel_iter->second, local_work_size), {},
+					 (const vulkan_buffer*)&indirect_buffer, indirect_offset, args);
+}
+
+void vulkan_kernel::execute_internal(const compute_queue& cqueue,
+									 typename kernel_map_type::iterator kernel_iter,
+									 const uint3& block_dim,
+									 const uint3& grid_dim,
+									 const vulkan_buffer* indirect_buffer,
+									 const size_t& indirect_offset,
+									 const vector<compute_kernel_arg>& args) const {
 	// create command buffer ("encoder") for this kernel execution
 	const vector<const vulkan_kernel_entry*> shader_entries {
 		&kernel_iter->second
@@ -252,63 +529,309 @@ void vulkan_kernel::execute(const compute_queue& cqueue,
 		return;
 	}
 	
-	// set and handle arguments
+	// completion is handled by submit_dispatch() -> can use the constant ring buffer
+	encoder->use_constant_ring = true;
+	
+	if(!set_kernel_args(encoder.get(), shader_entries, args) ||
+	   !encode_dispatch(encoder.get(), shader_entries, grid_dim, indirect_buffer, indirect_offset)) {
+		return;
+	}
+	submit_dispatch(encoder, cqueue);
+}
+
+void vulkan_kernel::submit_dispatch(const shared_ptr<vulkan_encoder>& encoder, const compute_queue& cqueue) const {
+	// all done here, end + submit
+	if(const auto end_err = vkEndCommandBuffer(encoder->cmd_buffer.cmd_buffer); end_err != VK_SUCCESS) {
+		log_error("failed to end command buffer: %u: %s", end_err, vulkan_error_to_string(end_err));
+		encoder->cqueue->release_constants(encoder->constant_allocation_ids);
+		release_desc_sets(encoder.get());
+		return;
+	}
+	((const vulkan_queue&)cqueue).submit_command_buffer(encoder->cmd_buffer,
+														[encoder](const vulkan_queue::command_buffer&) {
+															// -> completion handler
+															
+															// kill constant buffers after the kernel has finished execution
+															encoder->constant_buffers.clear();
+															encoder->cqueue->release_constants(encoder->constant_allocation_ids);
+															
+															// cached descriptor sets may be reused/rewritten now
+															release_desc_sets(encoder.get());
+															
+															recycle_encoder(encoder);
+														});
+}
+
+bool vulkan_kernel::set_kernel_arg(vulkan_encoder* encoder,
+								   const vulkan_kernel_entry& entry,
+								   idx_handler& idx,
+								   const compute_kernel_arg& arg) const {
+	if (auto buf_ptr = get_if<const compute_buffer*>(&arg.var)) {
+		set_argument(encoder, entry, idx, *buf_ptr);
+	} else if (auto img_ptr = get_if<const compute_image*>(&arg.var)) {
+		set_argument(encoder, entry, idx, *img_ptr);
+	} else if (auto vec_img_ptrs = get_if<const vector<compute_image*>*>(&arg.var)) {
+		set_argument(encoder, entry, idx, **vec_img_ptrs);
+	} else if (auto vec_img_sptrs = get_if<const vector<shared_ptr<compute_image>>*>(&arg.var)) {
+		set_argument(encoder, entry, idx, **vec_img_sptrs);
+	} else if (auto generic_arg_ptr = get_if<const void*>(&arg.var)) {
+		set_argument(encoder, entry, idx, *generic_arg_ptr, arg.size);
+	} else {
+		log_error("encountered invalid arg");
+		return false;
+	}
+	return true;
+}
+
+bool vulkan_kernel::set_kernel_args(vulkan_encoder* encoder,
+									const vector<const vulkan_kernel_entry*>& shader_entries,
+									const vector<compute_kernel_arg>& args) const {
 	idx_handler idx;
 	for (const auto& arg : args) {
 		auto entry = arg_pre_handler(shader_entries, idx);
-		if (auto buf_ptr = get_if<const compute_buffer*>(&arg.var)) {
-			set_argument(encoder.get(), *entry, idx, *buf_ptr);
-		} else if (auto img_ptr = get_if<const compute_image*>(&arg.var)) {
-			set_argument(encoder.get(), *entry, idx, *img_ptr);
-		} else if (auto vec_img_ptrs = get_if<const vector<compute_image*>*>(&arg.var)) {
-			set_argument(encoder.get(), *entry, idx, **vec_img_ptrs);
-		} else if (auto vec_img_sptrs = get_if<const vector<shared_ptr<compute_image>>*>(&arg.var)) {
-			set_argument(encoder.get(), *entry, idx, **vec_img_sptrs);
-		} else if (auto generic_arg_ptr = get_if<const void*>(&arg.var)) {
-			set_argument(encoder.get(), *entry, idx, *generic_arg_ptr, arg.size);
-		} else {
-			log_error("encountered invalid arg");
-			return;
+		if (!set_kernel_arg(encoder, *entry, idx, arg)) {
+			encoder->cqueue->release_constants(encoder->constant_allocation_ids);
+			return false;
 		}
 	}
+	return true;
+}
+
+bool vulkan_kernel::encode_dispatch(vulkan_encoder* encoder,
+									const vector<const vulkan_kernel_entry*>& shader_entries,
+									const uint3& grid_dim,
+									const vulkan_buffer* indirect_buffer,
+									const size_t& indirect_offset) const {
+	// get the (cached) descriptor set for these arguments, this only writes descriptors if it isn't cached yet
+	if(!acquire_desc_sets(encoder, shader_entries)) {
+		encoder->cqueue->release_constants(encoder->constant_allocation_ids);
+		return false;
+	}
 	
-	// run
-	const auto& entry = kernel_iter->second;
-	const auto& vk_dev = (const vulkan_device&)cqueue.get_device();
+	// final desc set binding after all parameters have been set (the fixed sampler set has already been bound)
+	if(encoder->desc_sets[0] != nullptr) {
+		vkCmdBindDescriptorSets(encoder->cmd_buffer.cmd_buffer,
+								VK_PIPELINE_BIND_POINT_COMPUTE,
+								encoder->pipeline_layout,
+								1,
+								1,
+								&encoder->desc_sets[0],
+								(uint32_t)encoder->dyn_offsets.size(),
+								encoder->dyn_offsets.data());
+	}
 	
-	// set/write/update descriptors
-	vkUpdateDescriptorSets(vk_dev.device,
-						   (uint32_t)encoder->write_descs.size(), encoder->write_descs.data(),
-						   // never copy (bad for performance)
-						   0, nullptr);
+	// set dims + pipeline
+	// TODO: check if grid_dim matches compute shader defintion
+	if(indirect_buffer == nullptr) {
+		vkCmdDispatch(encoder->cmd_buffer.cmd_buffer, grid_dim.x, grid_dim.y, grid_dim.z);
+	}
+	else {
+		// make prior shader/transfer writes to the indirect buffer (on this queue) visible to the indirect read
+		const VkMemoryBarrier indirect_barrier {
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT),
+			.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+		};
+		vkCmdPipelineBarrier(encoder->cmd_buffer.cmd_buffer,
+							 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+							 VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+							 0, 1, &indirect_barrier, 0, nullptr, 0, nullptr);
+		vkCmdDispatchIndirect(encoder->cmd_buffer.cmd_buffer, indirect_buffer->get_vulkan_buffer(), indirect_offset);
+	}
+	return true;
+}
+
+shared_ptr<vulkan_kernel::vulkan_encoder> vulkan_kernel::record_dispatch(const compute_queue& cqueue,
+																		 VkCommandBuffer cmd_buffer,
+																		 const uint3& global_work_size,
+																		 const uint3& local_work_size,
+																		 const vector<compute_kernel_arg>& args) const {
+	const auto kernel_iter = get_kernel(cqueue);
+	if(kernel_iter == kernels.cend()) {
+		log_error("no kernel for this compute queue/device exists!");
+		return {};
+	}
 	
-	// final desc set binding after all parameters have been updated/set
-	const VkDescriptorSet desc_sets[2] {
-		vk_dev.fixed_sampler_desc_set,
-		entry.desc_set,
+	// image layout transitions depend on the state of the image at submission time -> can't be recorded once
+	for(const auto& arg : args) {
+		if(holds_alternative<const compute_image*>(arg.var) ||
+		   holds_alternative<const vector<compute_image*>*>(arg.var) ||
+		   holds_alternative<const vector<shared_ptr<compute_image>>*>(arg.var)) {
+			return {};
+		}
+	}
+	
+	const uint3 block_dim = check_local_work_size(kernel_iter->second, local_work_size);
+	const vector<const vulkan_kernel_entry*> shader_entries {
+		&kernel_iter->second
 	};
-	vkCmdBindDescriptorSets(encoder->cmd_buffer.cmd_buffer,
-							VK_PIPELINE_BIND_POINT_COMPUTE,
-							entry.pipeline_layout,
-							0,
-							(entry.desc_set != nullptr ? 2 : 1),
-							desc_sets,
-							(uint32_t)encoder->dyn_offsets.size(),
-							encoder->dyn_offsets.data());
+	vulkan_queue::command_buffer recording_cmd_buffer { cmd_buffer, ~0u, "recorded dispatch" };
+	bool encoder_success = false;
+	auto encoder = create_encoder(cqueue, &recording_cmd_buffer,
+								  get_pipeline_spec(kernel_iter->first, kernel_iter->second, block_dim),
+								  kernel_iter->second.pipeline_layout,
+								  shader_entries, encoder_success);
+	if(!encoder_success) {
+		log_error("failed to create vulkan encoder for kernel \"%s\"", kernel_iter->second.info->name);
+		return {};
+	}
 	
-	// set dims + pipeline
-	// TODO: check if grid_dim matches compute shader defintion
-	vkCmdDispatch(encoder->cmd_buffer.cmd_buffer, grid_dim.x, grid_dim.y, grid_dim.z);
+	// NOTE: constant args are stored in separate buffers (not in the constant ring), since these must stay alive
+	//       for as long as the recorded command buffer is used
+	if(!set_kernel_args(encoder.get(), shader_entries, args) ||
+	   !encode_dispatch(encoder.get(), shader_entries, compute_grid_dim(global_work_size, block_dim), nullptr, 0)) {
+		return {};
+	}
+	return encoder;
+}
+
+void vulkan_kernel::release_recorded_dispatch(const shared_ptr<vulkan_encoder>& encoder) {
+	encoder->constant_buffers.clear();
+	release_desc_sets(encoder.get());
+	recycle_encoder(encoder);
+}
+
+unique_ptr<compute_kernel_bound_args> vulkan_kernel::bind_args(vector<compute_kernel_arg>&& args) const {
+	return make_unique<vulkan_bound_args>(*this, move(args));
+}
+
+bool vulkan_kernel::vulkan_bound_args::update(const vulkan_kernel_entry& kernel_entry, const compute_queue& cqueue) {
+	const auto& vk_kernel = (const vulkan_kernel&)kernel;
 	
-	// all done here, end + submit
-	VK_CALL_RET(vkEndCommandBuffer(encoder->cmd_buffer.cmd_buffer), "failed to end command buffer")
-	((const vulkan_queue&)cqueue).submit_command_buffer(encoder->cmd_buffer,
-														[encoder](const vulkan_queue::command_buffer&) {
-															// -> completion handler
-															
-															// kill constant buffers after the kernel has finished execution
-															encoder->constant_buffers.clear();
-														});
+	// only buffer args can be resolved up front: generic args are sub-allocated from the constant ring of the launch queue
+	// and images need layout transitions in the launch command buffer
+	const auto is_resolvable = [](const compute_kernel_arg& arg) {
+		return holds_alternative<const compute_buffer*>(arg.var);
+	};
+	
+	bool full_update = (prepared_device != &cqueue.get_device());
+	if(!full_update) {
+		for(const auto& idx : modified_args) {
+			if(is_resolvable(args[idx]) != arg_states[idx].is_resolved) {
+				full_update = true;
+				break;
+			}
+		}
+	}
+	
+	if(full_update) {
+		// new device (or first use): resolve all buffer args, only record the indices of all other args
+		entry = &kernel_entry;
+		shader_entries = { &kernel_entry };
+		if(!resolved) {
+			resolved = make_shared<vulkan_encoder>();
+		}
+		resolved->reset();
+		resolved->cqueue = &(const vulkan_queue&)cqueue;
+		init_encoder_args(resolved.get(), shader_entries);
+		
+		all_resolved = true;
+		arg_states.resize(args.size());
+		idx_handler idx;
+		for(size_t i = 0, count = args.size(); i < count; ++i) {
+			const auto arg_entry = vk_kernel.arg_pre_handler(shader_entries, idx);
+			auto& state = arg_states[i];
+			state.idx = idx;
+			state.is_resolved = is_resolvable(args[i]);
+			if(state.is_resolved) {
+				state.key_offset = uint32_t(resolved->desc_keys[0].size());
+				state.dyn_offset_idx = uint32_t(resolved->dyn_offsets.size());
+				vk_kernel.set_argument(resolved.get(), *arg_entry, idx, *get_if<const compute_buffer*>(&args[i].var));
+			} else {
+				all_resolved = false;
+				
+				// skip the indices of this arg (read/write images use two descriptors)
+				if(holds_alternative<const compute_image*>(args[i].var) &&
+				   arg_entry->info->args[idx.arg].image_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ_WRITE) {
+					++idx.write_desc;
+					++idx.binding;
+				}
+				idx.next();
+			}
+		}
+		prepared_device = &cqueue.get_device();
+	} else {
+		// only resolve modified buffer args again, in place (the key and dynamic offset size of a buffer arg are fixed)
+		auto& key = resolved->desc_keys[0];
+		for(const auto& arg_idx : modified_args) {
+			const auto& state = arg_states[arg_idx];
+			if(!state.is_resolved) continue;
+			
+			auto idx = state.idx;
+			vk_kernel.set_argument(resolved.get(), *entry, idx, *get_if<const compute_buffer*>(&args[arg_idx].var));
+			copy(key.end() - buffer_desc_key_size, key.end(), key.begin() + state.key_offset);
+			key.resize(key.size() - buffer_desc_key_size);
+			resolved->dyn_offsets[state.dyn_offset_idx] = resolved->dyn_offsets.back();
+			resolved->dyn_offsets.pop_back();
+		}
+	}
+	modified_args.clear();
+	return true;
+}
+
+void vulkan_kernel::execute_bound(const compute_queue& cqueue,
+								  compute_kernel_bound_args& bound_args,
+								  const uint32_t& dim floor_unused,
+								  const uint3& global_work_size,
+								  const uint3& local_work_size_) const {
+	// find entry for queue device
+	const auto kernel_iter = get_kernel(cqueue);
+	if(kernel_iter == kernels.cend()) {
+		log_error("no kernel for this compute queue/device exists!");
+		return;
+	}
+	
+	// NOTE: bound args are always created by bind_args() above
+	auto& vk_args = (vulkan_bound_args&)bound_args;
+	if(!vk_args.update(kernel_iter->second, cqueue)) {
+		return;
+	}
+	
+	const uint3 block_dim = check_local_work_size(kernel_iter->second, local_work_size_);
+	bool encoder_success = false;
+	auto encoder = create_encoder(cqueue, nullptr,
+								  get_pipeline_spec(kernel_iter->first, kernel_iter->second, block_dim),
+								  kernel_iter->second.pipeline_layout,
+								  vk_args.shader_entries, encoder_success);
+	if(!encoder_success) {
+		log_error("failed to create vulkan encoder / command buffer for kernel \"%s\"", kernel_iter->second.info->name);
+		return;
+	}
+	encoder->use_constant_ring = true;
+	
+	// start from the resolved state, then resolve all other args for this launch
+	// NOTE: the key and dynamic offsets must be in arg order (as if all args were set one by one)
+	encoder->write_descs = vk_args.resolved->write_descs;
+	encoder->write_desc_entries = vk_args.resolved->write_desc_entries;
+	if(vk_args.all_resolved) {
+		encoder->desc_keys[0] = vk_args.resolved->desc_keys[0];
+		encoder->dyn_offsets = vk_args.resolved->dyn_offsets;
+	} else {
+		const auto& resolved_key = vk_args.resolved->desc_keys[0];
+		auto& key = encoder->desc_keys[0];
+		const auto& args = vk_args.get_args();
+		for(size_t i = 0, count = args.size(); i < count; ++i) {
+			const auto& state = vk_args.arg_states[i];
+			if(state.is_resolved) {
+				key.insert(key.end(), resolved_key.begin() + state.key_offset,
+						   resolved_key.begin() + state.key_offset + buffer_desc_key_size);
+				encoder->dyn_offsets.emplace_back(vk_args.resolved->dyn_offsets[state.dyn_offset_idx]);
+				continue;
+			}
+			
+			auto idx = state.idx;
+			if(!set_kernel_arg(encoder.get(), kernel_iter->second, idx, args[i])) {
+				encoder->cqueue->release_constants(encoder->constant_allocation_ids);
+				return;
+			}
+		}
+	}
+	
+	if(!encode_dispatch(encoder.get(), vk_args.shader_entries, compute_grid_dim(global_work_size, block_dim), nullptr, 0)) {
+		return;
+	}
+	submit_dispatch(encoder, cqueue);
 }
 
 void vulkan_kernel::draw_internal(shared_ptr<vulkan_encoder> encoder,
@@ -318,45 +841,26 @@ void vulkan_kernel::draw_internal(shared_ptr<vulkan_encoder> encoder,
 								  vector<shared_ptr<compute_buffer>>& retained_buffers,
 								  const vector<multi_draw_entry>* draw_entries,
 								  const vector<multi_draw_indexed_entry>* draw_indexed_entries) const {
-	const auto& vk_dev = (const vulkan_device&)cqueue.get_device();
-	
-	// set/write/update descriptors
-	vkUpdateDescriptorSets(vk_dev.device,
-						   (uint32_t)encoder->write_descs.size(), encoder->write_descs.data(),
-						   // never copy (bad for performance)
-						   0, nullptr);
+	// get the (cached) descriptor sets for these arguments, this only writes descriptors if they aren't cached yet
+	if(!acquire_desc_sets(encoder.get(), { vs_entry, fs_entry })) {
+		return;
+	}
 	
-	// final desc set binding after all parameters have been updated/set
+	// final desc set binding after all parameters have been set (the fixed sampler set has already been bound)
 	// note that we need to take care of the situation where the vertex shader doesn't have a desc set,
 	// but the fragment shader does -> binding discontiguous sets is not directly possible
-	const bool has_vs_desc = (vs_entry->desc_set != nullptr);
-	const bool has_fs_desc = (fs_entry != nullptr && fs_entry->desc_set != nullptr);
-	const bool discontiguous = (!has_vs_desc && has_fs_desc);
-	
-	const array<VkDescriptorSet, 3> desc_sets {{
-		vk_dev.fixed_sampler_desc_set,
-		vs_entry->desc_set,
-		has_fs_desc ? fs_entry->desc_set : nullptr,
-	}};
-	// either binds everything or just the fixed sampler set
-	vkCmdBindDescriptorSets(encoder->cmd_buffer.cmd_buffer,
-							VK_PIPELINE_BIND_POINT_GRAPHICS,
-							encoder->pipeline_layout,
-							0,
-							(discontiguous || !has_vs_desc) ? 1 : (!has_fs_desc ? 2 : 3),
-							desc_sets.data(),
-							// don't want to set dyn offsets when only binding the fixed sampler set
-							discontiguous ? 0 : uint32_t(encoder->dyn_offsets.size()),
-							discontiguous ? nullptr : encoder->dyn_offsets.data());
-	
-	// bind fs set
-	if(discontiguous) {
+	const auto vs_desc_set = encoder->desc_sets[0];
+	const auto fs_desc_set = (encoder->desc_sets.size() > 1 ? encoder->desc_sets[1] : nullptr);
+	if(vs_desc_set != nullptr || fs_desc_set != nullptr) {
+		const array<VkDescriptorSet, 2> desc_sets {{ vs_desc_set, fs_desc_set }};
+		const bool has_vs_desc = (vs_desc_set != nullptr);
+		const bool has_fs_desc = (fs_desc_set != nullptr);
 		vkCmdBindDescriptorSets(encoder->cmd_buffer.cmd_buffer,
 								VK_PIPELINE_BIND_POINT_GRAPHICS,
 								encoder->pipeline_layout,
-								2,
-								1,
-								&fs_entry->desc_set,
+								has_vs_desc ? 1 : 2,
+								(has_vs_desc && has_fs_desc) ? 2 : 1,
+								has_vs_desc ? &desc_sets[0] : &desc_sets[1],
 								(uint32_t)encoder->dyn_offsets.size(),
 								encoder->dyn_offsets.data());
 	}
@@ -380,6 +884,12 @@ void vulkan_kernel::draw_internal(shared_ptr<vulkan_encoder> encoder,
 	
 	// TODO: properly kill constant_buffers !!!
 	retained_buffers.insert(retained_buffers.end(), encoder->constant_buffers.begin(), encoder->constant_buffers.end());
+	
+	// the caller submits the command buffer -> cached descriptor sets may only be reused/rewritten once it has completed
+	((const vulkan_queue&)cqueue).add_completion_func(encoder->cmd_buffer, [encoder]() {
+		release_desc_sets(encoder.get());
+		recycle_encoder(encoder);
+	});
 }
 
 const vulkan_kernel::vulkan_kernel_entry* vulkan_kernel::arg_pre_handler(const vector<const vulkan_kernel_entry*>& entries,
@@ -423,9 +933,20 @@ void vulkan_kernel::set_argument(vulkan_encoder* encoder,
 								 const vulkan_kernel_entry& entry,
 								 idx_handler& idx,
 								 const void* ptr, const size_t& size) const {
-	// TODO: it would probably be better to allocate just one buffer, then use an offset/range for each argument
+	if(encoder->use_constant_ring) {
+		// sub-allocate from the constant ring buffer of the queue and use the offset as the dynamic offset
+		vulkan_queue::constant_allocation alloc;
+		if(encoder->cqueue->allocate_constant(ptr, size, alloc)) {
+			encoder->constant_allocation_ids.emplace_back(alloc.id);
+			encoder->constant_buffer_info.emplace_back(alloc.buffer_info);
+			set_buffer_argument(encoder, entry, idx, &encoder->constant_buffer_info.back(), alloc.dyn_offset, 0);
+			return;
+		}
+		// else: ring buffer is full or can't be used -> fall back to a separate buffer
+	}
+	
 	// TODO: current limitation of this is that size must be a multiple of 4
-	shared_ptr<compute_buffer> constant_buffer = make_shared<vulkan_buffer>(encoder->cqueue, size, ptr,
+	shared_ptr<compute_buffer> constant_buffer = make_shared<vulkan_buffer>(*encoder->cqueue, size, ptr,
 																			COMPUTE_MEMORY_FLAG::READ |
 																			COMPUTE_MEMORY_FLAG::HOST_WRITE);
 	encoder->constant_buffers.emplace_back(constant_buffer);
@@ -436,20 +957,41 @@ void vulkan_kernel::set_argument(vulkan_encoder* encoder,
 								 const vulkan_kernel_entry& entry,
 								 idx_handler& idx,
 								 const compute_buffer* arg) const {
+	// always offset 0 for now
+	const auto vk_buffer = (const vulkan_buffer*)arg;
+	set_buffer_argument(encoder, entry, idx, vk_buffer->get_vulkan_buffer_info(), 0, vk_buffer->get_vulkan_resource_id());
+}
+
+void vulkan_kernel::set_buffer_argument(vulkan_encoder* encoder,
+										const vulkan_kernel_entry& entry,
+										idx_handler& idx,
+										const VkDescriptorBufferInfo* buffer_info,
+										const uint32_t dyn_offset,
+										const uint64_t resource_id) const {
 	auto& write_desc = encoder->write_descs[idx.write_desc];
 	write_desc.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 	write_desc.pNext = nullptr;
-	write_desc.dstSet = entry.desc_set;
+	write_desc.dstSet = nullptr; // set once the descriptor set has been acquired
 	write_desc.dstBinding = idx.binding;
 	write_desc.dstArrayElement = 0;
 	write_desc.descriptorCount = 1;
 	write_desc.descriptorType = entry.desc_types[idx.binding];
 	write_desc.pImageInfo = nullptr;
-	write_desc.pBufferInfo = ((const vulkan_buffer*)arg)->get_vulkan_buffer_info();
+	write_desc.pBufferInfo = buffer_info;
 	write_desc.pTexelBufferView = nullptr;
+	encoder->write_desc_entries[idx.write_desc] = idx.entry;
 	
-	// always offset 0 for now
-	encoder->dyn_offsets.emplace_back(0);
+	// the dynamic offset isn't part of the descriptor -> not part of the key either
+	auto& desc_key = encoder->desc_keys[idx.entry];
+	if(resource_id != 0) {
+		desc_key.insert(desc_key.end(), { uint64_t(DESC_KEY_TYPE::BUFFER), resource_id, uint64_t(buffer_info->range) });
+	}
+	else {
+		desc_key.insert(desc_key.end(), { uint64_t(DESC_KEY_TYPE::QUEUE_BUFFER), (uint64_t)buffer_info->buffer,
+			uint64_t(buffer_info->range) });
+	}
+	
+	encoder->dyn_offsets.emplace_back(dyn_offset);
 	
 	idx.next();
 }
@@ -464,12 +1006,12 @@ void vulkan_kernel::set_argument(vulkan_encoder* encoder,
 	const auto img_access = entry.info->args[idx.arg].image_access;
 	if(img_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::WRITE ||
 	   img_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ_WRITE) {
-		vk_img->transition_write(encoder->cqueue, encoder->cmd_buffer.cmd_buffer,
+		vk_img->transition_write(*encoder->cqueue, encoder->cmd_buffer.cmd_buffer,
 								 // also readable?
 								 img_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ_WRITE);
 	}
 	else { // READ
-		vk_img->transition_read(encoder->cqueue, encoder->cmd_buffer.cmd_buffer);
+		vk_img->transition_read(*encoder->cqueue, encoder->cmd_buffer.cmd_buffer);
 	}
 	
 	// read image desc/obj
@@ -478,7 +1020,7 @@ void vulkan_kernel::set_argument(vulkan_encoder* encoder,
 		auto& write_desc = encoder->write_descs[idx.write_desc];
 		write_desc.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 		write_desc.pNext = nullptr;
-		write_desc.dstSet = entry.desc_set;
+		write_desc.dstSet = nullptr; // set once the descriptor set has been acquired
 		write_desc.dstBinding = idx.binding;
 		write_desc.dstArrayElement = 0;
 		write_desc.descriptorCount = 1;
@@ -486,6 +1028,12 @@ void vulkan_kernel::set_argument(vulkan_encoder* encoder,
 		write_desc.pImageInfo = vk_img->get_vulkan_image_info();
 		write_desc.pBufferInfo = nullptr;
 		write_desc.pTexelBufferView = nullptr;
+		encoder->write_desc_entries[idx.write_desc] = idx.entry;
+		
+		encoder->desc_keys[idx.entry].insert(encoder->desc_keys[idx.entry].end(), {
+			uint64_t(DESC_KEY_TYPE::READ_IMAGE), vk_img->get_vulkan_resource_id(),
+			uint64_t(vk_img->get_vulkan_image_info()->imageLayout)
+		});
 	}
 	
 	// write image descs/objs
@@ -502,7 +1050,7 @@ void vulkan_kernel::set_argument(vulkan_encoder* encoder,
 		auto& write_desc = encoder->write_descs[idx.write_desc];
 		write_desc.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 		write_desc.pNext = nullptr;
-		write_desc.dstSet = entry.desc_set;
+		write_desc.dstSet = nullptr; // set once the descriptor set has been acquired
 		write_desc.dstBinding = idx.binding;
 		write_desc.dstArrayElement = 0;
 		write_desc.descriptorCount = uint32_t(mip_info.size());
@@ -510,6 +1058,12 @@ void vulkan_kernel::set_argument(vulkan_encoder* encoder,
 		write_desc.pImageInfo = mip_info.data();
 		write_desc.pBufferInfo = nullptr;
 		write_desc.pTexelBufferView = nullptr;
+		encoder->write_desc_entries[idx.write_desc] = idx.entry;
+		
+		encoder->desc_keys[idx.entry].insert(encoder->desc_keys[idx.entry].end(), {
+			uint64_t(DESC_KEY_TYPE::WRITE_IMAGE), vk_img->get_vulkan_resource_id(),
+			uint64_t(!mip_info.empty() ? mip_info[0].imageLayout : VK_IMAGE_LAYOUT_UNDEFINED)
+		});
 	}
 	
 	idx.next();
@@ -527,14 +1081,14 @@ floor_inline_always static void set_image_array_argument(vulkan_kernel::vulkan_e
 	if(img_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::WRITE ||
 	   img_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ_WRITE) {
 		for(auto& img : image_array) {
-			image_accessor(img)->transition_write(encoder->cqueue, encoder->cmd_buffer.cmd_buffer,
+			image_accessor(img)->transition_write(*encoder->cqueue, encoder->cmd_buffer.cmd_buffer,
 												  // also readable?
 												  img_access == llvm_toolchain::function_info::ARG_IMAGE_ACCESS::READ_WRITE);
 		}
 	}
 	else { // READ
 		for(auto& img : image_array) {
-			image_accessor(img)->transition_read(encoder->cqueue, encoder->cmd_buffer.cmd_buffer);
+			image_accessor(img)->transition_read(*encoder->cqueue, encoder->cmd_buffer.cmd_buffer);
 		}
 	}
 	
@@ -557,7 +1111,7 @@ floor_inline_always static void set_image_array_argument(vulkan_kernel::vulkan_e
 	auto& write_desc = encoder->write_descs[idx.write_desc];
 	write_desc.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 	write_desc.pNext = nullptr;
-	write_desc.dstSet = entry.desc_set;
+	write_desc.dstSet = nullptr; // set once the descriptor set has been acquired
 	write_desc.dstBinding = idx.binding;
 	write_desc.dstArrayElement = 0;
 	write_desc.descriptorCount = elem_count;
@@ -565,6 +1119,15 @@ floor_inline_always static void set_image_array_argument(vulkan_kernel::vulkan_e
 	write_desc.pImageInfo = image_info->data();
 	write_desc.pBufferInfo = nullptr;
 	write_desc.pTexelBufferView = nullptr;
+	encoder->write_desc_entries[idx.write_desc] = idx.entry;
+	
+	auto& desc_key = encoder->desc_keys[idx.entry];
+	desc_key.insert(desc_key.end(), { uint64_t(DESC_KEY_TYPE::IMAGE_ARRAY), uint64_t(elem_count) });
+	for(uint32_t i = 0; i < elem_count; ++i) {
+		desc_key.insert(desc_key.end(), {
+			image_accessor(image_array[i])->get_vulkan_resource_id(), uint64_t((*image_info)[i].imageLayout)
+		});
+	}
 	
 	idx.next();
 }
@@ -25,6 +25,7 @@
 
 #include <floor/core/logger.hpp>
 #include <floor/threading/atomic_spin_lock.hpp>
+#include <floor/threading/thread_safety.hpp>
 #include <floor/compute/vulkan/vulkan_buffer.hpp>
 #include <floor/compute/vulkan/vulkan_image.hpp>
 #include <floor/compute/compute_kernel.hpp>
@@ -36,12 +37,61 @@ public:
 	// don't want to include vulkan_queue here
 	struct vulkan_encoder;
 	
+	//! cache of the descriptor sets of a kernel/shader entry, keyed by the resources that are bound to them,
+	//! so that repeated launches with the same resources don't need to write any descriptors
+	//! NOTE: a cached set is only ever (re-)written when no pending submission is using it
+	class desc_set_cache {
+	public:
+		desc_set_cache(const vulkan_device& device,
+					   const VkDescriptorSetLayout desc_set_layout,
+					   vector<VkDescriptorPoolSize>&& pool_sizes);
+		~desc_set_cache();
+		
+		//! returns the descriptor set for the specified resource key, if no set with this key is cached yet,
+		//! "write_descs" are written to a new or evicted set (-> their dstSet will be set accordingly),
+		//! returns nullptr on failure
+		//! NOTE: every acquired set must be released once the submission that uses it has completed
+		VkDescriptorSet acquire(const vector<uint64_t>& key, vector<VkWriteDescriptorSet>& write_descs) REQUIRES(!cache_lock);
+		
+		//! releases a set that has previously been acquired
+		void release(const VkDescriptorSet desc_set) REQUIRES(!cache_lock);
+		
+	protected:
+		const vulkan_device& device;
+		const VkDescriptorSetLayout desc_set_layout;
+		//! descriptor counts of a single set
+		const vector<VkDescriptorPoolSize> pool_sizes;
+		
+		static constexpr const uint32_t sets_per_pool { 16u };
+		//! soft limit: if all sets are in use, more sets will be allocated
+		static constexpr const uint32_t max_cached_sets { 64u };
+		
+		safe_mutex cache_lock;
+		vector<VkDescriptorPool> pools GUARDED_BY(cache_lock);
+		uint32_t sets_in_last_pool GUARDED_BY(cache_lock) { 0u };
+		
+		struct cache_entry {
+			VkDescriptorSet desc_set { nullptr };
+			uint64_t key_hash { 0u };
+			vector<uint64_t> key;
+			//! amount of acquisitions that haven't been released yet
+			uint32_t use_count { 0u };
+			//! for LRU eviction
+			uint64_t last_use { 0u };
+		};
+		vector<cache_entry> entries GUARDED_BY(cache_lock);
+		uint64_t use_counter GUARDED_BY(cache_lock) { 0u };
+		
+		//! allocates a new descriptor set, creating a new pool if necessary
+		VkDescriptorSet allocate_set() REQUIRES(cache_lock);
+	};
+	
 	struct vulkan_kernel_entry : kernel_entry {
 		VkPipelineLayout pipeline_layout { nullptr };
 		VkPipelineShaderStageCreateInfo stage_info;
 		VkDescriptorSetLayout desc_set_layout { nullptr };
-		VkDescriptorPool desc_pool { nullptr };
-		VkDescriptorSet desc_set { nullptr };
+		//! nullptr if this entry doesn't have any descriptors
+		shared_ptr<desc_set_cache> desc_cache;
 		vector<VkDescriptorType> desc_types;
 		
 		struct spec_entry {
@@ -67,8 +117,7 @@ public:
 		// actual argument index (directly corresponding to the c++ source code)
 		uint32_t arg { 0 };
 		// index into the descriptor set that will be updated/written
-		// NOTE: starts out at 1, because 0 is the fixed sampler set
-		uint32_t write_desc { 1 };
+		uint32_t write_desc { 0 };
 		// binding index in the resp. descriptor set
 		uint32_t binding { 0 };
 		// current kernel/shader entry
@@ -92,6 +141,39 @@ public:
 				 const uint3& local_work_size,
 				 const vector<compute_kernel_arg>& args) const override;
 	
+	//! natively supported via vkCmdDispatchIndirect
+	void execute_indirect(const compute_queue& cqueue,
+						  const uint32_t& dim,
+						  const compute_buffer& indirect_buffer,
+						  const size_t& indirect_offset,
+						  const uint3& local_work_size,
+						  const vector<compute_kernel_arg>& args) const override;
+	
+	//! only resolves modified and generic/image arguments per launch (see vulkan_bound_args)
+	void execute_bound(const compute_queue& cqueue,
+					   compute_kernel_bound_args& bound_args,
+					   const uint32_t& dim,
+					   const uint3& global_work_size,
+					   const uint3& local_work_size) const override;
+	
+	//! records the dispatch of this kernel with the specified arguments into "cmd_buffer", which must be a command buffer
+	//! that is currently recording (it is neither ended nor submitted here), returns the encoder that holds all resources
+	//! of the recorded dispatch, or nullptr on failure or if the dispatch can't be recorded (any image arguments)
+	//! NOTE: the returned encoder must be released via release_recorded_dispatch() once "cmd_buffer" won't be executed anymore
+	shared_ptr<vulkan_encoder> record_dispatch(const compute_queue& cqueue,
+											   VkCommandBuffer cmd_buffer,
+											   const uint3& global_work_size,
+											   const uint3& local_work_size,
+											   const vector<compute_kernel_arg>& args) const;
+	
+	//! releases all resources of a dispatch that has been recorded via record_dispatch()
+	static void release_recorded_dispatch(const shared_ptr<vulkan_encoder>& encoder);
+	
+	//! pre-specializes (builds the compute pipelines of) this kernel for all specified work-group sizes on all devices,
+	//! so that these don't have to be built on first use, returns false if any specialization failed
+	//! NOTE: work-group sizes that aren't supported by a device or kernel are ignored
+	bool prespecialize(const vector<uint3>& work_group_sizes) const;
+	
 	//! NOTE: very wip/temporary
 	struct multi_draw_entry {
 		uint32_t vertex_count;
@@ -195,10 +277,89 @@ public:
 protected:
 	mutable kernel_map_type kernels;
 	
+	//! protects the specializations of all kernel entries
+	mutable safe_mutex specialization_lock;
+	
+	//! encoders whose submission has completed and that can be reused for the next launch/draw
+	struct encoder_pool {
+		safe_mutex lock;
+		vector<shared_ptr<vulkan_encoder>> encoders GUARDED_BY(lock);
+	};
+	//! NOTE: encoders only hold a weak reference to this, so in-flight encoders don't keep it alive
+	shared_ptr<encoder_pool> encoders;
+	//! resets the encoder and returns it to the pool it was created by (if it still exists)
+	static void recycle_encoder(const shared_ptr<vulkan_encoder>& encoder);
+	
 	typename kernel_map_type::iterator get_kernel(const compute_queue& queue) const;
 	
 	COMPUTE_TYPE get_compute_type() const override { return COMPUTE_TYPE::VULKAN; }
 	
+	//! records and submits the dispatch of this kernel with the specified arguments, dispatching either "grid_dim" work-groups,
+	//! or the work-group count that is stored in "indirect_buffer" at "indirect_offset" if "indirect_buffer" is non-nullptr
+	void execute_internal(const compute_queue& cqueue,
+						  typename kernel_map_type::iterator kernel_iter,
+						  const uint3& block_dim,
+						  const uint3& grid_dim,
+						  const vulkan_buffer* indirect_buffer,
+						  const size_t& indirect_offset,
+						  const vector<compute_kernel_arg>& args) const;
+	
+	//! bound args that keep the resolved write descriptors, descriptor set key and dynamic offsets of all buffer args,
+	//! so that launches only need to resolve generic and image args (constant ring allocations and image layout
+	//! transitions are per launch), buffer args are only resolved again if they have been modified
+	struct vulkan_bound_args final : public compute_kernel_bound_args {
+		using compute_kernel_bound_args::compute_kernel_bound_args;
+		
+		//! entry of the prepared device
+		const vulkan_kernel_entry* entry { nullptr };
+		vector<const vulkan_kernel_entry*> shader_entries;
+		//! resolved state of all buffer args (not used for any submission)
+		shared_ptr<vulkan_encoder> resolved;
+		struct arg_state {
+			//! indices at the start of this arg
+			idx_handler idx;
+			//! set for buffer args
+			bool is_resolved { false };
+			//! offset of the key of this arg in the resolved key
+			uint32_t key_offset { 0u };
+			//! index of the dynamic offset of this arg in the resolved dynamic offsets
+			uint32_t dyn_offset_idx { 0u };
+		};
+		vector<arg_state> arg_states;
+		//! set if all args are buffer args (-> the resolved key and dynamic offsets can be used as-is)
+		bool all_resolved { false };
+		
+		//! resolves all buffer args if the device changed, or only the modified ones, returns false on failure
+		bool update(const vulkan_kernel_entry& kernel_entry, const compute_queue& cqueue);
+	};
+	unique_ptr<compute_kernel_bound_args> bind_args(vector<compute_kernel_arg>&& args) const override;
+	
+	//! sets the specified argument in the encoder, returns false if the argument is invalid
+	bool set_kernel_arg(vulkan_encoder* encoder,
+						const vulkan_kernel_entry& entry,
+						idx_handler& idx,
+						const compute_kernel_arg& arg) const;
+	
+	//! sets all arguments in the encoder, returns false on failure
+	//! (-> any constant ring allocations of the encoder have been released again)
+	bool set_kernel_args(vulkan_encoder* encoder,
+						 const vector<const vulkan_kernel_entry*>& shader_entries,
+						 const vector<compute_kernel_arg>& args) const;
+	
+	//! acquires the descriptor set and records its binding + the dispatch into the encoder (all args must have been set),
+	//! returns false on failure (-> any constant ring allocations of the encoder have been released again)
+	bool encode_dispatch(vulkan_encoder* encoder,
+						 const vector<const vulkan_kernel_entry*>& shader_entries,
+						 const uint3& grid_dim,
+						 const vulkan_buffer* indirect_buffer,
+						 const size_t& indirect_offset) const;
+	
+	//! ends and submits the command buffer of the encoder, releasing all of its resources once it has completed
+	void submit_dispatch(const shared_ptr<vulkan_encoder>& encoder, const compute_queue& cqueue) const;
+	
+	//! sizes the write descriptors and descriptor set keys of the encoder for all args of the specified entries
+	static void init_encoder_args(vulkan_encoder* encoder, const vector<const vulkan_kernel_entry*>& entries);
+	
 	shared_ptr<vulkan_encoder> create_encoder(const compute_queue& queue,
 											  void* cmd_buffer,
 											  const VkPipeline pipeline,
@@ -209,6 +370,13 @@ protected:
 								 vulkan_kernel_entry& entry,
 								 const uint3& work_group_size) const;
 	
+	//! acquires the (cached) descriptor sets of all entries for the arguments that have been set in the encoder,
+	//! writes descriptors only if a set isn't cached yet
+	bool acquire_desc_sets(vulkan_encoder* encoder,
+						   const vector<const vulkan_kernel_entry*>& entries) const;
+	//! releases all descriptor sets that have been acquired by the encoder
+	static void release_desc_sets(vulkan_encoder* encoder);
+	
 	void draw_internal(shared_ptr<vulkan_encoder> encoder,
 					   const compute_queue& cqueue,
 					   const vulkan_kernel_entry* vs_entry,
@@ -270,6 +438,15 @@ protected:
 					  idx_handler& idx,
 					  const compute_buffer* arg) const;
 	
+	//! writes the buffer descriptor for the current argument
+	//! NOTE: "resource_id" must be the unique resource id of the buffer, or 0 if the buffer lives as long as the queue
+	void set_buffer_argument(vulkan_encoder* encoder,
+							 const vulkan_kernel_entry& entry,
+							 idx_handler& idx,
+							 const VkDescriptorBufferInfo* buffer_info,
+							 const uint32_t dyn_offset,
+							 const uint64_t resource_id) const;
+	
 	void set_argument(vulkan_encoder* encoder,
 					  const vulkan_kernel_entry& entry,
 					  idx_handler& idx,
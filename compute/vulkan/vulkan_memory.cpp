@@ -24,24 +24,39 @@
 #include <floor/compute/vulkan/vulkan_device.hpp>
 #include <floor/compute/vulkan/vulkan_queue.hpp>
 #include <floor/compute/vulkan/vulkan_image.hpp>
+#include <atomic>
+
+//! returns a new unique resource id (never 0)
+static uint64_t make_resource_id() {
+	static atomic<uint64_t> next_resource_id { 1u };
+	return next_resource_id++;
+}
 
 vulkan_memory::vulkan_memory(const vulkan_device& device_, const uint64_t* object_, const bool is_image_) noexcept :
-device(device_), object(object_), is_image(is_image_) {
+device(device_), object(object_), resource_id(make_resource_id()), is_image(is_image_) {
 }
 
 vulkan_memory::~vulkan_memory() noexcept {
-	if(mem != nullptr) {
-		vkFreeMemory(device.device, mem, nullptr);
-		mem = nullptr;
+	if(alloc.is_valid() && owns_alloc) {
+		device.allocator->free(alloc);
 	}
 }
 
 bool vulkan_memory::write_memory_data(const compute_queue& cqueue, const void* data, const size_t& size, const size_t& offset,
 									  const size_t non_shim_input_size, const char* error_msg_on_failure) {
 	// we definitively need a queue for this (use specified one if possible, otherwise use the default queue)
-	auto mapped_ptr = map(cqueue, COMPUTE_MEMORY_MAP_FLAG::WRITE_INVALIDATE | COMPUTE_MEMORY_MAP_FLAG::BLOCK, size, offset);
+	// NOTE: this doesn't need to block, since the host data is copied into staging memory right away
+	//       and the staging -> device copy is executed in order with all later work on the queue
+	auto mapped_ptr = map(cqueue, COMPUTE_MEMORY_MAP_FLAG::WRITE_INVALIDATE, size, offset);
 	if(mapped_ptr != nullptr) {
-		memcpy(mapped_ptr, data, (non_shim_input_size == 0 ? size : non_shim_input_size));
+		if(is_image && non_shim_input_size != 0) {
+			// RGB -> RGBA conversion directly into the mapped memory (no need to copy first and convert in-place later)
+			image_shim_host_to_mapped(mapped_ptr, data);
+			mappings.at(mapped_ptr).shim_converted = true;
+		}
+		else {
+			memcpy(mapped_ptr, data, (non_shim_input_size == 0 ? size : non_shim_input_size));
+		}
 		unmap(cqueue, mapped_ptr);
 	}
 	else {
@@ -103,94 +118,113 @@ void* __attribute__((aligned(128))) vulkan_memory::map(const compute_queue& cque
 	
 	// here is the deal with vulkan device memory:
 	//  * we always allocate device local memory, regardless of any host-visibility
-	//  * if the device local memory is not host-visible, we need to allocate an appropriately sized
-	//    host-visible buffer, then: a) for read: create a device -> host memory copy (in here)
-	//                               b) for write: create a host buffer -> device memory copy (in unmap)
-	//  * if the device local memory is host-visible, we can just call vulkan map/unmap functions
+	//  * if the device local memory is not host-visible, we need host-visible staging memory, then:
+	//    a) for read: record a device -> staging memory copy (in here)
+	//    b) for write: record a staging memory -> device copy (in unmap)
+	//    staging memory is sub-allocated from the persistent staging ring buffer of the queue,
+	//    or a separate buffer is created if the ring is full or the mapping is too large
+	//    all copies are batched into the next submission on the queue (or submitted right away when blocking)
+	//  * if the device local memory is host-visible, we can directly use its mapped memory
 	
 	// create the host-visible buffer if necessary
 	vulkan_mapping mapping {
 		.buffer = nullptr,
-		.mem = nullptr,
+		.buffer_offset = 0,
+		.alloc = {},
+		.staging = {},
+		.staging_queue = nullptr,
 		.size = size,
 		.offset = offset,
 		.flags = flags,
+		.shim_converted = false,
 	};
-	size_t host_buffer_offset = offset;
+	const auto& vk_queue = (const vulkan_queue&)cqueue;
 	auto vulkan_dev = device.device;
-	// TODO: make sure this is cleaned up properly on failure
+	void* __attribute__((aligned(128))) host_ptr { nullptr };
 	if(!device.unified_memory || is_image) { // TODO: or already created host-visible (-> create_internal)
-		// we're only creating a buffer that is large enough + start from the offset
-		host_buffer_offset = 0;
-		
-		// create the host-visible buffer
-		const VkBufferCreateInfo buffer_create_info {
-			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-			.pNext = nullptr,
-			.flags = 0,
-			.size = size,
-			.usage = VkBufferUsageFlags((does_write ? VK_BUFFER_USAGE_TRANSFER_SRC_BIT : VkBufferUsageFlagBits(0u)) |
-										(does_read ? VK_BUFFER_USAGE_TRANSFER_DST_BIT : VkBufferUsageFlagBits(0u))),
-			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-			.queueFamilyIndexCount = 0,
-			.pQueueFamilyIndices = nullptr,
-		};
-		VK_CALL_RET(vkCreateBuffer(vulkan_dev, &buffer_create_info, nullptr, &mapping.buffer), "map buffer creation failed", nullptr)
-	
-		// allocate / back it up
-		VkMemoryRequirements mem_req;
-		vkGetBufferMemoryRequirements(vulkan_dev, mapping.buffer, &mem_req);
-	
-		const VkMemoryAllocateInfo alloc_info {
-			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-			.pNext = nullptr,
-			.allocationSize = mem_req.size,
-			.memoryTypeIndex = device.host_mem_cached_index,
-		};
-		VK_CALL_RET(vkAllocateMemory(vulkan_dev, &alloc_info, nullptr, &mapping.mem), "map buffer allocation failed", nullptr)
-		VK_CALL_RET(vkBindBufferMemory(vulkan_dev, mapping.buffer, mapping.mem, 0), "map buffer allocation binding failed", nullptr)
+		if(vk_queue.allocate_staging(size, mapping.staging)) {
+			mapping.staging_queue = &vk_queue;
+			mapping.buffer = mapping.staging.buffer;
+			mapping.buffer_offset = mapping.staging.offset;
+			host_ptr = mapping.staging.mapped_ptr;
+		}
+		else {
+			// create a separate host-visible buffer that is large enough
+			const VkBufferCreateInfo buffer_create_info {
+				.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.size = size,
+				.usage = VkBufferUsageFlags((does_write ? VK_BUFFER_USAGE_TRANSFER_SRC_BIT : VkBufferUsageFlagBits(0u)) |
+											(does_read ? VK_BUFFER_USAGE_TRANSFER_DST_BIT : VkBufferUsageFlagBits(0u))),
+				.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+				.queueFamilyIndexCount = 0,
+				.pQueueFamilyIndices = nullptr,
+			};
+			VK_CALL_RET(vkCreateBuffer(vulkan_dev, &buffer_create_info, nullptr, &mapping.buffer), "map buffer creation failed", nullptr)
+			
+			// allocate / back it up (short-lived -> sub-allocated from the device allocator)
+			VkMemoryRequirements mem_req;
+			vkGetBufferMemoryRequirements(vulkan_dev, mapping.buffer, &mem_req);
+			
+			mapping.alloc = device.allocator->allocate(mem_req, find_memory_type_index(mem_req.memoryTypeBits, false),
+													   vulkan_allocator::RESOURCE::BUFFER, vulkan_allocator::LIFETIME::SHORT);
+			if(!mapping.alloc.is_valid() || mapping.alloc.mapped_ptr == nullptr ||
+			   vkBindBufferMemory(vulkan_dev, mapping.buffer, mapping.alloc.memory, mapping.alloc.offset) != VK_SUCCESS) {
+				log_error("map buffer allocation failed");
+				release_staging_memory(vk_queue, mapping);
+				return nullptr;
+			}
+			host_ptr = mapping.alloc.mapped_ptr;
+		}
 	}
 	else {
+		// host-visible device memory is persistently mapped by the allocator
 		mapping.buffer = (VkBuffer)*object;
-		mapping.mem = mem;
+		mapping.buffer_offset = offset;
+		mapping.alloc = alloc;
+		if(alloc.mapped_ptr == nullptr) {
+			log_error("failed to map host buffer (memory is not host-visible)");
+			return nullptr;
+		}
+		host_ptr = alloc.mapped_ptr + offset;
 	}
 	
 	// check if we need to copy the buffer from the device (in case READ was specified)
-	const auto& vk_queue = (const vulkan_queue&)cqueue;
 	if(!write_only) {
-		if(blocking_map) {
-			// must finish up all current work before we can properly read from the current buffer
-			cqueue.finish();
-		}
-		
 		// device -> host buffer copy
 		if(!device.unified_memory || is_image) {
-			auto cmd_buffer = vk_queue.make_command_buffer("dev -> host memory copy"); // TODO: should probably abstract this a little
-			const VkCommandBufferBeginInfo begin_info {
-				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-				.pNext = nullptr,
-				.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-				.pInheritanceInfo = nullptr,
-			};
-			VK_CALL_RET(vkBeginCommandBuffer(cmd_buffer.cmd_buffer, &begin_info),
-						"failed to begin command buffer", nullptr)
-			
-			if(!is_image) {
-				const VkBufferCopy region {
-					.srcOffset = mapping.offset,
-					.dstOffset = 0,
-					.size = mapping.size,
-				};
-				vkCmdCopyBuffer(cmd_buffer.cmd_buffer, (VkBuffer)*object, mapping.buffer, 1, &region);
+			if(!vk_queue.record_transfer([this, &cqueue, &mapping](VkCommandBuffer cmd_buffer) {
+				if(!is_image) {
+					const VkBufferCopy region {
+						.srcOffset = mapping.offset,
+						.dstOffset = mapping.buffer_offset,
+						.size = mapping.size,
+					};
+					vkCmdCopyBuffer(cmd_buffer, (VkBuffer)*object, mapping.buffer, 1, &region);
+				}
+				else {
+					image_copy_dev_to_host(cqueue, cmd_buffer, mapping.buffer, mapping.buffer_offset);
+				}
+			})) {
+				log_error("failed to record dev -> host memory copy");
+				release_staging_memory(vk_queue, mapping);
+				return nullptr;
 			}
-			else {
-				image_copy_dev_to_host(cqueue, cmd_buffer.cmd_buffer, mapping.buffer);
+			transfer_queues.emplace(&vk_queue);
+			
+			if(blocking_map) {
+				vk_queue.submit_transfers(true);
+				// make the device writes visible to the host (only necessary for non-coherent memory)
+				device.allocator->invalidate(mapping.alloc);
 			}
-	
-			VK_CALL_RET(vkEndCommandBuffer(cmd_buffer.cmd_buffer), "failed to end command buffer", nullptr)
-			vk_queue.submit_command_buffer(cmd_buffer, blocking_map);
 		}
 		else {
+			if(blocking_map) {
+				// must finish up all current work before we can properly read from the current buffer
+				cqueue.finish();
+			}
+			
 			// TODO: make this actually work
 			auto cmd_buffer = vk_queue.make_command_buffer("dev -> host memory barrier");
 			const VkCommandBufferBeginInfo begin_info {
@@ -219,15 +253,14 @@ void* __attribute__((aligned(128))) vulkan_memory::map(const compute_queue& cque
 			
 			VK_CALL_RET(vkEndCommandBuffer(cmd_buffer.cmd_buffer), "failed to end command buffer", nullptr)
 			vk_queue.submit_command_buffer(cmd_buffer, blocking_map);
+			
+			if(blocking_map) {
+				// make the device writes visible to the host (only necessary for non-coherent memory)
+				device.allocator->invalidate(mapping.alloc);
+			}
 		}
 	}
 	
-	// TODO: use vkFlushMappedMemoryRanges/vkInvalidateMappedMemoryRanges if necessary (non-coherent)
-	
-	// map the host buffer
-	void* __attribute__((aligned(128))) host_ptr { nullptr };
-	VK_CALL_RET(vkMapMemory(vulkan_dev, mapping.mem, host_buffer_offset, size, 0, &host_ptr), "failed to map host buffer", nullptr)
-	
 	// need to remember how much we mapped and where (so the host -> device write-back copies the right amount of bytes)
 	mappings.emplace(host_ptr, mapping);
 	
@@ -239,7 +272,6 @@ void vulkan_memory::unmap(const compute_queue& cqueue, void* __attribute__((alig
 	if(mapped_ptr == nullptr) return;
 	
 	const auto& vk_queue = (const vulkan_queue&)cqueue;
-	auto vulkan_dev = device.device;
 	
 	// check if this is actually a mapped pointer (+get the mapped size)
 	const auto iter = mappings.find(mapped_ptr);
@@ -247,52 +279,42 @@ void vulkan_memory::unmap(const compute_queue& cqueue, void* __attribute__((alig
 		log_error("invalid mapped pointer: %X", mapped_ptr);
 		return;
 	}
+	const auto& mapping = iter->second;
 	
 	// check if we need to actually copy data back to the device (not the case if read-only mapping)
-	if(has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE>(iter->second.flags) ||
-	   has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE_INVALIDATE>(iter->second.flags)) {
+	if(has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE>(mapping.flags) ||
+	   has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE_INVALIDATE>(mapping.flags)) {
+		// make the host writes visible to the device (only necessary for non-coherent memory)
+		device.allocator->flush(mapping.alloc);
+		
 		if(!device.unified_memory || is_image) {
-			do {
-				// host -> device copy
-				// TODO: sync ...
-				auto cmd_buffer = vk_queue.make_command_buffer("host -> dev memory copy"); // TODO: should probably abstract this a little
-				const VkCommandBufferBeginInfo begin_info {
-					.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-					.pNext = nullptr,
-					.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-					.pInheritanceInfo = nullptr,
-				};
-				VK_CALL_BREAK(vkBeginCommandBuffer(cmd_buffer.cmd_buffer, &begin_info),
-							  "failed to begin command buffer")
-				
+			// host -> device copy (batched)
+			if(!vk_queue.record_transfer([this, &cqueue, &mapping, &mapped_ptr](VkCommandBuffer cmd_buffer) {
 				if(!is_image) {
 					const VkBufferCopy region {
-						.srcOffset = 0,
-						.dstOffset = iter->second.offset,
-						.size = iter->second.size,
+						.srcOffset = mapping.buffer_offset,
+						.dstOffset = mapping.offset,
+						.size = mapping.size,
 					};
-					vkCmdCopyBuffer(cmd_buffer.cmd_buffer, iter->second.buffer, (VkBuffer)*object, 1, &region);
+					vkCmdCopyBuffer(cmd_buffer, mapping.buffer, (VkBuffer)*object, 1, &region);
 				}
 				else {
-					image_copy_host_to_dev(cqueue, cmd_buffer.cmd_buffer, iter->second.buffer, mapped_ptr);
+					image_copy_host_to_dev(cqueue, cmd_buffer, mapping.buffer, mapping.buffer_offset,
+										   (mapping.shim_converted ? nullptr : mapped_ptr));
+				}
+			})) {
+				log_error("failed to record host -> dev memory copy");
+			}
+			else {
+				transfer_queues.emplace(&vk_queue);
+				if(has_flag<COMPUTE_MEMORY_MAP_FLAG::BLOCK>(mapping.flags)) {
+					vk_queue.submit_transfers(true);
 				}
-				
-				VK_CALL_BREAK(vkEndCommandBuffer(cmd_buffer.cmd_buffer), "failed to end command buffer")
-				vk_queue.submit_command_buffer(cmd_buffer, has_flag<COMPUTE_MEMORY_MAP_FLAG::BLOCK>(iter->second.flags));
-			} while(false);
+			}
 		}
-	}
-	
-	// unmap
-	// TODO/NOTE: we can only unmap the whole buffer with vulkan, not individual mappings ... -> can only unmap if this is the last mapping (if unified_memory, if the buffer was just created/allocated for this, then it doesn't matter)
-	// also: TODO: SYNC!
-	vkUnmapMemory(vulkan_dev, iter->second.mem);
-	
-	// barrier after unmap when using unified memory
-	// TODO: make this actually work
-	if(has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE>(iter->second.flags) ||
-	   has_flag<COMPUTE_MEMORY_MAP_FLAG::WRITE_INVALIDATE>(iter->second.flags)) {
-		if(device.unified_memory && !is_image) {
+		else {
+			// barrier after unmap when using unified memory
+			// TODO: make this actually work
 			auto cmd_buffer = vk_queue.make_command_buffer("host -> dev memory barrier");
 			const VkCommandBufferBeginInfo begin_info {
 				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
@@ -307,38 +329,81 @@ void vulkan_memory::unmap(const compute_queue& cqueue, void* __attribute__((alig
 				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
 				.pNext = nullptr,
 				.srcAccessMask = VkAccessFlags(VK_ACCESS_HOST_WRITE_BIT |
-											   (has_flag<COMPUTE_MEMORY_MAP_FLAG::READ>(iter->second.flags) ? VK_ACCESS_HOST_READ_BIT : VkAccessFlagBits(0u))),
+											   (has_flag<COMPUTE_MEMORY_MAP_FLAG::READ>(mapping.flags) ? VK_ACCESS_HOST_READ_BIT : VkAccessFlagBits(0u))),
 				.dstAccessMask = (VK_ACCESS_MEMORY_READ_BIT |
 								  VK_ACCESS_MEMORY_WRITE_BIT |
 								  VK_ACCESS_SHADER_READ_BIT |
 								  VK_ACCESS_SHADER_WRITE_BIT),
 				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
 				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-				.buffer = iter->second.buffer,
-				.offset = iter->second.offset,
-				.size = iter->second.size,
+				.buffer = mapping.buffer,
+				.offset = mapping.offset,
+				.size = mapping.size,
 			};
 			
 			vkCmdPipelineBarrier(cmd_buffer.cmd_buffer, VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
 								 0, 0, nullptr, 1, &buffer_barrier, 0, nullptr);
 			
 			VK_CALL_RET(vkEndCommandBuffer(cmd_buffer.cmd_buffer), "failed to end command buffer")
-			vk_queue.submit_command_buffer(cmd_buffer, has_flag<COMPUTE_MEMORY_MAP_FLAG::BLOCK>(iter->second.flags));
+			vk_queue.submit_command_buffer(cmd_buffer, has_flag<COMPUTE_MEMORY_MAP_FLAG::BLOCK>(mapping.flags));
 		}
 	}
 	
-	// delete host buffer
+	// release staging memory (once all transfers that use it have completed)
 	if(!device.unified_memory || is_image) {
-		if(iter->second.buffer != nullptr) {
-			vkDestroyBuffer(vulkan_dev, iter->second.buffer, nullptr);
-		}
-		if(iter->second.mem != nullptr) {
-			vkFreeMemory(vulkan_dev, iter->second.mem, nullptr);
-		}
+		release_staging_memory(vk_queue, mapping);
 	}
 	
 	// remove the mapping
-	mappings.erase(mapped_ptr);
+	mappings.erase(iter);
+}
+
+void vulkan_memory::release_after_transfers(function<void()> destroy_func) {
+	// holds the vulkan object and its memory until the last queue has completed its transfers
+	struct deferred_release {
+		function<void()> destroy_func;
+		shared_ptr<vulkan_allocator> allocator;
+		vulkan_allocator::allocation alloc;
+		
+		~deferred_release() {
+			destroy_func();
+			if(alloc.is_valid()) {
+				allocator->free(alloc);
+			}
+		}
+	};
+	auto release = make_shared<deferred_release>(deferred_release {
+		move(destroy_func), device.allocator, (owns_alloc ? alloc : vulkan_allocator::allocation {})
+	});
+	alloc = {};
+	
+	for(const auto& vk_queue : transfer_queues) {
+		// don't wait for the next user submission on this queue
+		vk_queue->flush();
+		vk_queue->after_transfers([release]() mutable {
+			release = nullptr;
+		});
+	}
+	transfer_queues.clear();
+	// if there are no pending transfers, this is the last reference and the object is destroyed right away
+}
+
+void vulkan_memory::release_staging_memory(const vulkan_queue& vk_queue, const vulkan_mapping& mapping) {
+	// NOTE: this may be executed after this object has been destroyed -> only capture what is necessary
+	vk_queue.after_transfers([vulkan_dev = device.device, allocator = device.allocator,
+							  staging_queue = mapping.staging_queue, staging = mapping.staging,
+							  buffer = mapping.buffer, alloc = mapping.alloc]() mutable {
+		if(staging_queue != nullptr) {
+			staging_queue->release_staging(staging);
+			return;
+		}
+		if(buffer != nullptr) {
+			vkDestroyBuffer(vulkan_dev, buffer, nullptr);
+		}
+		if(alloc.is_valid()) {
+			allocator->free(alloc);
+		}
+	});
 }
 
 uint32_t vulkan_memory::find_memory_type_index(const uint32_t memory_type_bits,
@@ -24,9 +24,11 @@
 #if !defined(FLOOR_NO_VULKAN)
 
 #include <floor/compute/compute_memory.hpp>
+#include <floor/compute/vulkan/vulkan_allocator.hpp>
+#include <floor/compute/vulkan/vulkan_queue.hpp>
+#include <unordered_set>
 
 class vulkan_device;
-class vulkan_queue;
 class compute_queue;
 
 //! helper class for common code between vulkan_buffer and vulkan_image
@@ -50,20 +52,43 @@ public:
 protected:
 	const vulkan_device& device;
 	const uint64_t* object { nullptr };
-	VkDeviceMemory mem { nullptr };
+	//! unique id of this memory object (vulkan handles may be reused once an object has been destroyed)
+	const uint64_t resource_id;
+	//! device memory sub-allocation of this object (from the device allocator)
+	vulkan_allocator::allocation alloc;
+	//! if false, "alloc" is a range inside the allocation of another object (sub-buffer) and must not be freed
+	bool owns_alloc { true };
 	const bool is_image { false };
 	
 	struct vulkan_mapping {
+		//! buffer that is used for device <-> host copies (staging ring buffer, separate staging buffer or the buffer itself)
 		VkBuffer buffer;
-		VkDeviceMemory mem;
+		//! offset of the mapped memory inside "buffer"
+		VkDeviceSize buffer_offset;
+		//! short-lived host-visible allocation (if a separate staging buffer is used)
+		vulkan_allocator::allocation alloc;
+		//! staging ring allocation (if the staging ring buffer of "staging_queue" is used)
+		vulkan_queue::staging_allocation staging;
+		const vulkan_queue* staging_queue;
 		const size_t size;
 		const size_t offset;
 		const COMPUTE_MEMORY_MAP_FLAG flags;
+		//! set if 3-channel image data has already been converted to 4-channel data when it was written to the mapped memory
+		bool shim_converted { false };
 	};
 	// stores all mapped pointers and the mapped buffer
 	unordered_map<void*, vulkan_mapping> mappings;
+	//! all queues that batched transfers referencing this object have been recorded on
+	unordered_set<const vulkan_queue*> transfer_queues;
+	
+	//! must be called by the destructor of the derived class: "destroy_func" (destroying the vulkan object) is called
+	//! and the memory of this object is freed once all batched transfers referencing this object have completed
+	//! NOTE: pending transfer batches are flushed, but this doesn't block
+	void release_after_transfers(function<void()> destroy_func);
 	
 	//! overwrites memory data with the host data pointed to by data, with the specified size/offset
+	//! NOTE: the device-side copy is batched on "cqueue", i.e. the written data only becomes visible to other queues
+	//!       after the next submission on "cqueue" or after "cqueue" has been flushed/finished
 	bool write_memory_data(const compute_queue& cqueue,
 						   const void* data, const size_t& size, const size_t& offset,
 						   const size_t non_shim_input_size = 0,
@@ -80,8 +105,14 @@ protected:
 	
 	void unmap(const compute_queue& cqueue, void* __attribute__((aligned(128))) mapped_ptr);
 	
-	virtual void image_copy_dev_to_host(const compute_queue&, VkCommandBuffer, VkBuffer) {}
-	virtual void image_copy_host_to_dev(const compute_queue&, VkCommandBuffer, VkBuffer, void*) {}
+	//! releases the staging memory of the specified mapping once all transfers on the specified queue have completed
+	void release_staging_memory(const vulkan_queue& vk_queue, const vulkan_mapping& mapping);
+	
+	virtual void image_copy_dev_to_host(const compute_queue&, VkCommandBuffer, VkBuffer, const VkDeviceSize) {}
+	//! NOTE: if the mapped data has already been converted to 4-channel data (or no conversion is necessary), data is nullptr
+	virtual void image_copy_host_to_dev(const compute_queue&, VkCommandBuffer, VkBuffer, const VkDeviceSize, void*) {}
+	//! for 3-channel images: converts the RGB host data to RGBA data, directly writing it to the mapped memory
+	virtual void image_shim_host_to_mapped(void*, const void*) {}
 	
 	//! based on the specified/supported memory type bits and "wants device memory" flag,
 	//! this tries to find the best matching memory type index (heap / location)
@@ -43,6 +43,10 @@ public:
 	
 	vulkan_program(program_map_type&& programs);
 	
+	//! pre-specializes all kernels in this program for the specified work-group sizes (see vulkan_kernel::prespecialize),
+	//! returns false if any specialization failed
+	bool prespecialize_kernels(const vector<uint3>& work_group_sizes) const;
+	
 protected:
 	const program_map_type programs;
 	
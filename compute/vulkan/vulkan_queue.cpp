@@ -20,8 +20,53 @@
 
 #if !defined(FLOOR_NO_VULKAN)
 #include <floor/compute/vulkan/vulkan_device.hpp>
+#include <floor/compute/vulkan/vulkan_command_graph.hpp>
 #include <floor/core/logger.hpp>
-#include <floor/threading/task.hpp>
+#include <floor/core/core.hpp>
+
+vulkan_timeline_semaphore::vulkan_timeline_semaphore(const vulkan_device& dev_) : dev(dev_) {
+	const VkSemaphoreTypeCreateInfoKHR sema_type_info {
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+		.pNext = nullptr,
+		.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+		.initialValue = 0u,
+	};
+	const VkSemaphoreCreateInfo sema_info {
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+		.pNext = &sema_type_info,
+		.flags = 0,
+	};
+	VK_CALL_RET(vkCreateSemaphore(dev.device, &sema_info, nullptr, &sema), "failed to create timeline semaphore")
+}
+
+vulkan_timeline_semaphore::~vulkan_timeline_semaphore() {
+	if(sema != nullptr) {
+		vkDestroySemaphore(dev.device, sema, nullptr);
+	}
+}
+
+vulkan_event::vulkan_event(shared_ptr<vulkan_timeline_semaphore> sema_, const uint64_t value_) :
+sema(sema_), value(value_) {
+}
+
+void vulkan_event::wait() const {
+	const VkSemaphoreWaitInfoKHR wait_info {
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
+		.pNext = nullptr,
+		.flags = 0,
+		.semaphoreCount = 1,
+		.pSemaphores = &sema->sema,
+		.pValues = &value,
+	};
+	VK_CALL_RET(sema->dev.wait_semaphores(sema->dev.device, &wait_info, ~0ull), "failed to wait for event")
+}
+
+bool vulkan_event::is_complete() const {
+	uint64_t counter_value = 0u;
+	VK_CALL_RET(sema->dev.get_semaphore_counter_value(sema->dev.device, sema->sema, &counter_value),
+				"failed to query event status", true)
+	return (counter_value >= value);
+}
 
 vulkan_queue::vulkan_queue(const compute_device& device_, const VkQueue queue_, const uint32_t family_index_) :
 compute_queue(device_), queue(queue_), family_index(family_index_) {
@@ -49,32 +94,173 @@ compute_queue(device_), queue(queue_), family_index(family_index_) {
 	VK_CALL_RET(vkAllocateCommandBuffers(((const vulkan_device&)device).device, &cmd_buffer_info, &cmd_buffers[0]), "failed to create command buffers")
 	cmd_buffers_in_use.reset();
 	
-	// create fences
+	// create one fence per command buffer
 	static constexpr const VkFenceCreateInfo fence_info {
 		.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
 		.pNext = nullptr,
 		.flags = 0,
 	};
-	for(uint32_t i = 0; i < fence_count; ++i) {
-		VK_CALL_RET(vkCreateFence(((const vulkan_device&)device).device, &fence_info, nullptr, &fences[i]),
+	for(uint32_t i = 0; i < cmd_buffer_count; ++i) {
+		VK_CALL_RET(vkCreateFence(((const vulkan_device&)device).device, &fence_info, nullptr, &cmd_buffer_fences[i]),
 					"failed to create fence #" + to_string(i))
 	}
-	fences_in_use.reset();
+	
+	// create the timeline semaphore that is used for events
+	if(((const vulkan_device&)device).timeline_semaphore_support) {
+		auto sema = make_shared<vulkan_timeline_semaphore>((const vulkan_device&)device);
+		if(sema->sema != nullptr) {
+			timeline_sema = move(sema);
+		}
+	}
+}
+
+vulkan_queue::~vulkan_queue() {
+	// submit and wait for all remaining transfers
+	submit_transfers(true);
+	
+	// signal the completion thread to exit and wait until it has handled all pending submissions
+	unique_ptr<thread> thread_to_join;
+	{
+		GUARD(completion_lock);
+		completion_thread_should_exit = true;
+		thread_to_join = move(completion_thread);
+	}
+	completion_cv.notify_all();
+	if(thread_to_join && thread_to_join->joinable()) {
+		thread_to_join->join();
+	}
+	
+	const auto dev = ((const vulkan_device&)device).device;
+	for(auto& fence : cmd_buffer_fences) {
+		if(fence != nullptr) {
+			vkDestroyFence(dev, fence, nullptr);
+		}
+	}
+	
+	{
+		GUARD(constant_ring_lock);
+		destroy_ring(constant_ring);
+	}
+	{
+		GUARD(staging_ring_lock);
+		destroy_ring(staging_ring);
+	}
 }
 
 void vulkan_queue::finish() const {
+	submit_transfers(true);
+	
 	GUARD(queue_lock);
 	VK_CALL_RET(vkQueueWaitIdle(queue), "queue finish failed")
 }
 
 void vulkan_queue::flush() const {
-	// nop
+	submit_transfers(false);
+}
+
+shared_ptr<compute_event> vulkan_queue::record_event() const {
+	if(!timeline_sema) {
+		return compute_queue::record_event();
+	}
+	
+	// the event must include all transfers that have been recorded so far
+	submit_transfers(false);
+	
+	// empty submission that only signals the next timeline value
+	// NOTE: the signal operation includes all commands that were submitted earlier on this queue
+	GUARD(queue_lock);
+	const VkSubmitInfo submit_info {
+		.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+		.pNext = nullptr,
+		.waitSemaphoreCount = 0,
+		.pWaitSemaphores = nullptr,
+		.pWaitDstStageMask = nullptr,
+		.commandBufferCount = 0,
+		.pCommandBuffers = nullptr,
+		.signalSemaphoreCount = 0,
+		.pSignalSemaphores = nullptr,
+	};
+	const auto signal_value = timeline_value + 1u;
+	VK_CALL_RET(queue_submit(submit_info, nullptr, signal_value), "failed to record event", {})
+	timeline_value = signal_value;
+	return make_shared<vulkan_event>(timeline_sema, signal_value);
+}
+
+void vulkan_queue::wait_for_event(const compute_event& evt) const {
+	if(!timeline_sema) {
+		compute_queue::wait_for_event(evt);
+		return;
+	}
+	
+	// NOTE: timeline semaphore support is per device, so all events recorded on this device are vulkan_events
+	// NOTE: an empty submission that waits on the semaphore would not block later submissions
+	//       -> attach the wait to the next actual submission instead
+	const auto& vk_evt = (const vulkan_event&)evt;
+	GUARD(queue_lock);
+	pending_event_waits.emplace_back(vk_evt.get_vulkan_semaphore(), vk_evt.get_value());
+}
+
+VkResult vulkan_queue::queue_submit(const VkSubmitInfo& submit_info, VkFence fence, const uint64_t signal_value) const {
+	if(pending_event_waits.empty() && signal_value == 0u) {
+		return vkQueueSubmit(queue, 1, &submit_info, fence);
+	}
+	
+	// add all pending event waits and the timeline signal to the submission
+	// NOTE: values of binary semaphores are ignored
+	vector<VkSemaphore> wait_semas;
+	vector<uint64_t> wait_values;
+	vector<VkPipelineStageFlags> wait_stages;
+	for(uint32_t i = 0; i < submit_info.waitSemaphoreCount; ++i) {
+		wait_semas.emplace_back(submit_info.pWaitSemaphores[i]);
+		wait_values.emplace_back(0u);
+		wait_stages.emplace_back(submit_info.pWaitDstStageMask != nullptr ?
+								 submit_info.pWaitDstStageMask[0] : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+	}
+	for(const auto& event_wait : pending_event_waits) {
+		wait_semas.emplace_back(event_wait.first);
+		wait_values.emplace_back(event_wait.second);
+		wait_stages.emplace_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+	}
+	
+	vector<VkSemaphore> signal_semas(submit_info.pSignalSemaphores,
+									 submit_info.pSignalSemaphores + submit_info.signalSemaphoreCount);
+	vector<uint64_t> signal_values(signal_semas.size(), 0u);
+	if(signal_value != 0u) {
+		signal_semas.emplace_back(timeline_sema->sema);
+		signal_values.emplace_back(signal_value);
+	}
+	
+	const VkTimelineSemaphoreSubmitInfoKHR timeline_info {
+		.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+		.pNext = submit_info.pNext,
+		.waitSemaphoreValueCount = (uint32_t)wait_values.size(),
+		.pWaitSemaphoreValues = wait_values.data(),
+		.signalSemaphoreValueCount = (uint32_t)signal_values.size(),
+		.pSignalSemaphoreValues = signal_values.data(),
+	};
+	auto timeline_submit_info = submit_info;
+	timeline_submit_info.pNext = &timeline_info;
+	timeline_submit_info.waitSemaphoreCount = (uint32_t)wait_semas.size();
+	timeline_submit_info.pWaitSemaphores = wait_semas.data();
+	timeline_submit_info.pWaitDstStageMask = wait_stages.data();
+	timeline_submit_info.signalSemaphoreCount = (uint32_t)signal_semas.size();
+	timeline_submit_info.pSignalSemaphores = signal_semas.data();
+	
+	const auto submit_err = vkQueueSubmit(queue, 1, &timeline_submit_info, fence);
+	if(submit_err == VK_SUCCESS) {
+		pending_event_waits.clear();
+	}
+	return submit_err;
 }
 
 static const char* cmd_buffer_name(const vulkan_queue::command_buffer& cmd_buffer) {
 	return (cmd_buffer.name != nullptr ? cmd_buffer.name : "unknown");
 }
 
+unique_ptr<compute_command_graph> vulkan_queue::create_command_graph() const {
+	return make_unique<vulkan_command_graph>(*this);
+}
+
 vulkan_queue::command_buffer vulkan_queue::make_command_buffer(const char* name) const {
 	GUARD(cmd_buffers_lock);
 	if(!cmd_buffers_in_use.all()) {
@@ -85,6 +271,7 @@ vulkan_queue::command_buffer vulkan_queue::make_command_buffer(const char* name)
 							"failed to reset command buffer ("s + (name != nullptr ? name : "unknown") + ")",
 							{ nullptr, ~0u, nullptr })
 				cmd_buffers_in_use.set(i);
+				cmd_buffer_fixed_sampler_binds[i] = 0u;
 				return { cmd_buffers[i], i, name };
 			}
 		}
@@ -95,32 +282,99 @@ vulkan_queue::command_buffer vulkan_queue::make_command_buffer(const char* name)
 	return {};
 }
 
-pair<VkFence, uint32_t> vulkan_queue::acquire_fence() const {
-	for(uint32_t trial = 0, limiter = 10; trial < limiter; ++trial) {
-		{
-			GUARD(fence_lock);
-			if(!fences_in_use.all()) {
-				for(uint32_t i = 0; i < fence_count; ++i) {
-					if(!fences_in_use[i]) {
-						fences_in_use.set(i);
-						return { fences[i], i };
-					}
-				}
-				floor_unreachable();
-			}
+void vulkan_queue::bind_fixed_sampler_set(const command_buffer& cmd_buffer,
+										  const VkPipelineBindPoint bind_point,
+										  const VkPipelineLayout pipeline_layout) const {
+	if(cmd_buffer.index < cmd_buffer_count) {
+		GUARD(cmd_buffers_lock);
+		const auto bind_point_bit = uint8_t(1u << uint32_t(bind_point));
+		if((cmd_buffer_fixed_sampler_binds[cmd_buffer.index] & bind_point_bit) != 0u) {
+			return;
 		}
-		this_thread::sleep_for(1ms);
+		cmd_buffer_fixed_sampler_binds[cmd_buffer.index] |= bind_point_bit;
+	}
+	// else: unknown command buffer -> always bind
+	
+	const auto& vk_dev = (const vulkan_device&)device;
+	vkCmdBindDescriptorSets(cmd_buffer.cmd_buffer, bind_point, pipeline_layout, 0, 1, &vk_dev.fixed_sampler_desc_set, 0, nullptr);
+}
+
+//! waits until the specified fence has been signaled, returns false on failure
+static bool wait_for_fence(VkDevice dev, VkFence fence, const vulkan_queue::command_buffer& cmd_buffer) {
+	const auto wait_err = vkWaitForFences(dev, 1, &fence, VK_TRUE, ~0ull);
+	if(wait_err != VK_SUCCESS) {
+		log_error("failed to wait for command buffer completion (%s): %u: %s",
+				  cmd_buffer_name(cmd_buffer), wait_err, vulkan_error_to_string(wait_err));
+		return false;
 	}
-	log_error("failed to acquire a fence");
-	return { nullptr, ~0u };
+	return true;
 }
 
-void vulkan_queue::release_fence(VkDevice dev, const pair<VkFence, uint32_t>& fence) const {
-	VK_CALL_RET(vkResetFences(dev, 1, &fence.first),
-				"failed to reset fence")
+void vulkan_queue::complete_command_buffer(const command_buffer& cmd_buffer,
+										   const function<void(const command_buffer&)>& completion_handler) const {
+	// reset fence for the next use of this command buffer
+	VK_CALL_IGNORE(vkResetFences(((const vulkan_device&)device).device, 1, &cmd_buffer_fences[cmd_buffer.index]),
+				   "failed to reset fence")
 	
-	GUARD(fence_lock);
-	fences_in_use.reset(fence.second);
+	// call user-specified handler
+	completion_handler(cmd_buffer);
+	
+	// call all functions that have been added while recording
+	vector<function<void()>> completion_funcs;
+	{
+		GUARD(cmd_buffers_lock);
+		completion_funcs.swap(cmd_buffer_completion_funcs[cmd_buffer.index]);
+	}
+	for(const auto& func : completion_funcs) {
+		func();
+	}
+	
+	// mark cmd buffer as free again
+	{
+		GUARD(cmd_buffers_lock);
+		cmd_buffers_in_use.reset(cmd_buffer.index);
+	}
+}
+
+void vulkan_queue::add_completion_func(const command_buffer& cmd_buffer, function<void()> func) const {
+	if(cmd_buffer.index >= cmd_buffer_count) {
+		log_error("invalid command buffer");
+		return;
+	}
+	GUARD(cmd_buffers_lock);
+	cmd_buffer_completion_funcs[cmd_buffer.index].emplace_back(move(func));
+}
+
+void vulkan_queue::run_completion_thread() const {
+	core::set_current_thread_name("vk_q_complete");
+	const auto dev = ((const vulkan_device&)device).device;
+	for(;;) {
+		// wait for the next submission, exit once all submissions have been handled and we should exit
+		command_buffer cmd_buffer;
+		{
+			GUARD(completion_lock);
+			completion_cv.wait(completion_lock, [this]() NO_THREAD_SAFETY_ANALYSIS {
+				return (!pending_submissions.empty() || completion_thread_should_exit);
+			});
+			if(pending_submissions.empty()) {
+				return;
+			}
+			cmd_buffer = pending_submissions.front().cmd_buffer;
+		}
+		
+		// completion handlers must be called in submission order -> only need to wait for the oldest submission,
+		// any later submissions that have already completed will then be handled right away
+		// NOTE: on failure, still complete the command buffer so that it can be reused
+		wait_for_fence(dev, cmd_buffer_fences[cmd_buffer.index], cmd_buffer);
+		
+		pending_submission submission;
+		{
+			GUARD(completion_lock);
+			submission = move(pending_submissions.front());
+			pending_submissions.pop_front();
+		}
+		complete_command_buffer(submission.cmd_buffer, submission.completion_handler);
+	}
 }
 
 void vulkan_queue::submit_command_buffer(command_buffer cmd_buffer,
@@ -138,65 +392,415 @@ void vulkan_queue::submit_command_buffer(vulkan_queue::command_buffer cmd_buffer
 										 const VkSemaphore* wait_semas,
 										 const uint32_t wait_sema_count,
 										 const VkPipelineStageFlags wait_stage_flags) const {
-	const auto submit_func = [this, cmd_buffer, completion_handler,
-							  wait_semas, wait_sema_count, wait_stage_flags,
-							  dev = ((const vulkan_device&)device).device]() {
-		// must sync/lock queue
-		auto fence = acquire_fence();
-		if(fence.first == nullptr) return;
-		{
-			GUARD(queue_lock);
-			const VkSubmitInfo submit_info {
-				.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-				.pNext = nullptr,
-				.waitSemaphoreCount = wait_sema_count,
-				.pWaitSemaphores = wait_semas,
-				.pWaitDstStageMask = (wait_stage_flags != 0 ? &wait_stage_flags : nullptr),
-				.commandBufferCount = 1,
-				.pCommandBuffers = &cmd_buffer.cmd_buffer,
-				.signalSemaphoreCount = 0,
-				.pSignalSemaphores = nullptr,
-			};
-			const auto submit_err = vkQueueSubmit(queue, 1, &submit_info, fence.first);
-			if(submit_err != VK_SUCCESS) {
-				log_error("failed to submit queue (%s): %u: %s",
-						  cmd_buffer_name(cmd_buffer), submit_err, vulkan_error_to_string(submit_err));
-				// still continue here to free the cmd buffer
-			}
+	if(cmd_buffer.cmd_buffer == nullptr || cmd_buffer.index >= cmd_buffer_count) {
+		log_error("invalid command buffer (%s)", cmd_buffer_name(cmd_buffer));
+		return;
+	}
+	submit_internal(&cmd_buffer, move(completion_handler), blocking, wait_semas, wait_sema_count, wait_stage_flags);
+}
+
+void vulkan_queue::submit_transfers(const bool blocking) const {
+	submit_internal(nullptr, [](const command_buffer&){}, blocking, nullptr, 0, 0);
+}
+
+void vulkan_queue::submit_internal(const command_buffer* cmd_buffer,
+								   function<void(const command_buffer&)> completion_handler,
+								   const bool blocking,
+								   const VkSemaphore* wait_semas,
+								   const uint32_t wait_sema_count,
+								   const VkPipelineStageFlags wait_stage_flags) const {
+	// submit directly in this thread (also ensures that the specified wait semaphores are still valid)
+	// NOTE: the fence of the last command buffer in the submission signals the completion of the whole submission
+	shared_ptr<transfer_batch> batch;
+	command_buffer fence_cmd_buffer;
+	bool submitted = true;
+	{
+		// must hold the transfer lock until the submission is done, so that transfers are executed in recording order
+		GUARD(transfer_lock);
+		batch = take_transfer_batch();
+		if(cmd_buffer == nullptr && !batch) {
+			// nothing to submit
+			return;
 		}
 		
-		// TODO: it might make sense to sleep+wait+vkGetFenceStatus instead of vkWaitForFences
-		// TODO: connect a fence to a cmd buffer allocation, this way they don't need to be created + destroyed every time
-		// TODO: instead of creating a completion handler thread every time, it's probably better to have just one (or two) threads to handle this (+vkGetFenceStatus)
-		
-		for(;;) {
-			auto status = vkGetFenceStatus(dev, fence.first);
-			//log_debug(">> fence %X status: %X", fence.first, status);
-			if(status == VK_SUCCESS) break;
-			this_thread::sleep_for(1ms);
+		// the transfer batch completes together with the submitted command buffer
+		if(batch) {
+			if(cmd_buffer != nullptr) {
+				completion_handler = [this, batch, handler = move(completion_handler)](const command_buffer& completed_cmd_buffer) {
+					handler(completed_cmd_buffer);
+					complete_command_buffer(batch->cmd_buffer, [](const command_buffer&){});
+					complete_transfer_batch(batch);
+				};
+			}
+			else {
+				completion_handler = [this, batch](const command_buffer&) {
+					complete_transfer_batch(batch);
+				};
+			}
 		}
 		
-		// reset + release fence
-		release_fence(dev, fence);
-		
-		// call user-specified handler
-		completion_handler(cmd_buffer);
+		array<VkCommandBuffer, 2> submit_cmd_buffers;
+		uint32_t submit_cmd_buffer_count = 0;
+		if(batch) {
+			submit_cmd_buffers[submit_cmd_buffer_count++] = batch->cmd_buffer.cmd_buffer;
+			fence_cmd_buffer = batch->cmd_buffer;
+		}
+		if(cmd_buffer != nullptr) {
+			submit_cmd_buffers[submit_cmd_buffer_count++] = cmd_buffer->cmd_buffer;
+			fence_cmd_buffer = *cmd_buffer;
+		}
 		
-		// mark cmd buffer as free again
-		{
-			GUARD(cmd_buffers_lock);
-			cmd_buffers_in_use.reset(cmd_buffer.index);
+		// must sync/lock queue
+		GUARD(queue_lock);
+		const VkSubmitInfo submit_info {
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+			.pNext = nullptr,
+			.waitSemaphoreCount = wait_sema_count,
+			.pWaitSemaphores = wait_semas,
+			.pWaitDstStageMask = (wait_stage_flags != 0 ? &wait_stage_flags : nullptr),
+			.commandBufferCount = submit_cmd_buffer_count,
+			.pCommandBuffers = submit_cmd_buffers.data(),
+			.signalSemaphoreCount = 0,
+			.pSignalSemaphores = nullptr,
+		};
+		const auto submit_err = queue_submit(submit_info, cmd_buffer_fences[fence_cmd_buffer.index]);
+		if(submit_err != VK_SUCCESS) {
+			log_error("failed to submit queue (%s): %u: %s",
+					  cmd_buffer_name(fence_cmd_buffer), submit_err, vulkan_error_to_string(submit_err));
+			// still continue here to free the cmd buffer
+			submitted = false;
+		}
+		else if(!blocking) {
+			// hand off to the completion thread
+			// NOTE: this must happen while still holding the queue lock, so that pending submissions are always
+			//       ordered like the actual queue submissions (the completion thread handles them in this order)
+			GUARD(completion_lock);
+			if(!completion_thread) {
+				completion_thread = make_unique<thread>([this]() {
+					run_completion_thread();
+				});
+			}
+			pending_submissions.emplace_back(pending_submission { fence_cmd_buffer, move(completion_handler) });
+		}
+	}
+	
+	if(blocking || !submitted) {
+		// wait until done (fence will never be signaled if submission failed)
+		if(submitted) {
+			wait_for_fence(((const vulkan_device&)device).device, cmd_buffer_fences[fence_cmd_buffer.index], fence_cmd_buffer);
+		}
+		complete_command_buffer(fence_cmd_buffer, completion_handler);
+		return;
+	}
+	completion_cv.notify_one();
+}
+
+shared_ptr<vulkan_queue::transfer_batch> vulkan_queue::take_transfer_batch() const {
+	if(!open_transfer_batch) {
+		return {};
+	}
+	auto batch = move(open_transfer_batch);
+	open_transfer_batch = nullptr;
+	VK_CALL_IGNORE(vkEndCommandBuffer(batch->cmd_buffer.cmd_buffer), "failed to end transfer command buffer")
+	in_flight_transfer_batches.emplace_back(batch);
+	return batch;
+}
+
+void vulkan_queue::complete_transfer_batch(const shared_ptr<transfer_batch>& batch) const {
+	vector<function<void()>> completion_funcs;
+	{
+		GUARD(transfer_lock);
+		const auto iter = find(in_flight_transfer_batches.begin(), in_flight_transfer_batches.end(), batch);
+		if(iter != in_flight_transfer_batches.end()) {
+			in_flight_transfer_batches.erase(iter);
+		}
+		completion_funcs.swap(batch->completion_funcs);
+	}
+	for(const auto& func : completion_funcs) {
+		func();
+	}
+}
+
+bool vulkan_queue::record_transfer(const function<void(VkCommandBuffer)>& record_func) const {
+	GUARD(transfer_lock);
+	if(!open_transfer_batch) {
+		auto cmd_buffer = make_command_buffer("transfer batch");
+		if(cmd_buffer.cmd_buffer == nullptr) {
+			return false;
+		}
+		const VkCommandBufferBeginInfo begin_info {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.pNext = nullptr,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+			.pInheritanceInfo = nullptr,
+		};
+		const auto begin_err = vkBeginCommandBuffer(cmd_buffer.cmd_buffer, &begin_info);
+		if(begin_err != VK_SUCCESS) {
+			log_error("failed to begin transfer command buffer: %u: %s", begin_err, vulkan_error_to_string(begin_err));
+			complete_command_buffer(cmd_buffer, [](const command_buffer&){});
+			return false;
+		}
+		open_transfer_batch = make_shared<transfer_batch>();
+		open_transfer_batch->cmd_buffer = cmd_buffer;
+	}
+	auto cmd_buffer = open_transfer_batch->cmd_buffer.cmd_buffer;
+	
+	// all prior device and host writes must be visible to the transfer
+	static constexpr const VkMemoryBarrier pre_barrier {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		.pNext = nullptr,
+		.srcAccessMask = (VK_ACCESS_MEMORY_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT),
+		.dstAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT),
+	};
+	vkCmdPipelineBarrier(cmd_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+						 VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &pre_barrier, 0, nullptr, 0, nullptr);
+	
+	record_func(cmd_buffer);
+	
+	// transfer results must be visible to all later commands and the host
+	static constexpr const VkMemoryBarrier post_barrier {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		.pNext = nullptr,
+		.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+		.dstAccessMask = (VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT | VK_ACCESS_HOST_READ_BIT),
+	};
+	vkCmdPipelineBarrier(cmd_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+						 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+						 0, 1, &post_barrier, 0, nullptr, 0, nullptr);
+	return true;
+}
+
+void vulkan_queue::after_transfers(function<void()> func) const {
+	{
+		GUARD(transfer_lock);
+		if(open_transfer_batch) {
+			open_transfer_batch->completion_funcs.emplace_back(move(func));
+			return;
+		}
+		if(!in_flight_transfer_batches.empty()) {
+			in_flight_transfer_batches.back()->completion_funcs.emplace_back(move(func));
+			return;
 		}
+	}
+	// no pending transfers
+	func();
+}
+
+bool vulkan_queue::create_ring(ring_buffer& ring,
+							   const VkBufferUsageFlags usage,
+							   const VkMemoryPropertyFlags preferred_flags,
+							   const char* name) const {
+	const auto& vk_dev = (const vulkan_device&)device;
+	
+	const VkBufferCreateInfo buffer_create_info {
+		.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+		.pNext = nullptr,
+		.flags = 0,
+		.size = ring.size,
+		.usage = usage,
+		.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+		.queueFamilyIndexCount = 0,
+		.pQueueFamilyIndices = nullptr,
 	};
+	VK_CALL_RET(vkCreateBuffer(vk_dev.device, &buffer_create_info, nullptr, &ring.buffer),
+				name + " buffer creation failed"s, false)
 	
-	if(!blocking) {
-		// spawn handler thread
-		task::spawn(submit_func, "q_submit_hndlr");
+	// need host-visible + coherent memory (so that we never need to flush)
+	VkMemoryRequirements mem_req;
+	vkGetBufferMemoryRequirements(vk_dev.device, ring.buffer, &mem_req);
+	static constexpr const VkMemoryPropertyFlags required_flags {
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+	};
+	uint32_t mem_type_index = ~0u;
+	for(uint32_t i = 0; i < vk_dev.mem_props->memoryTypeCount; ++i) {
+		const auto flags = vk_dev.mem_props->memoryTypes[i].propertyFlags;
+		if((mem_req.memoryTypeBits & (1u << i)) == 0 || (flags & required_flags) != required_flags) continue;
+		if(mem_type_index == ~0u || (flags & preferred_flags) == preferred_flags) {
+			mem_type_index = i;
+			if((flags & preferred_flags) == preferred_flags) break;
+		}
+	}
+	if(mem_type_index == ~0u) {
+		log_error("no host-coherent memory type found for the %s buffer", name);
+		return false;
+	}
+	
+	const VkMemoryAllocateInfo alloc_info {
+		.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+		.pNext = nullptr,
+		.allocationSize = mem_req.size,
+		.memoryTypeIndex = mem_type_index,
+	};
+	VK_CALL_RET(vkAllocateMemory(vk_dev.device, &alloc_info, nullptr, &ring.memory),
+				name + " buffer allocation failed"s, false)
+	VK_CALL_RET(vkBindBufferMemory(vk_dev.device, ring.buffer, ring.memory, 0),
+				name + " buffer bind failed"s, false)
+	
+	void* mapped_ptr = nullptr;
+	VK_CALL_RET(vkMapMemory(vk_dev.device, ring.memory, 0, VK_WHOLE_SIZE, 0, &mapped_ptr),
+				"failed to map "s + name + " buffer", false)
+	ring.mapped_ptr = (uint8_t*)mapped_ptr;
+	return true;
+}
+
+void vulkan_queue::destroy_ring(ring_buffer& ring) const {
+	const auto dev = ((const vulkan_device&)device).device;
+	if(ring.memory != nullptr) {
+		if(ring.mapped_ptr != nullptr) {
+			vkUnmapMemory(dev, ring.memory);
+			ring.mapped_ptr = nullptr;
+		}
+		vkFreeMemory(dev, ring.memory, nullptr);
+		ring.memory = nullptr;
+	}
+	if(ring.buffer != nullptr) {
+		vkDestroyBuffer(dev, ring.buffer, nullptr);
+		ring.buffer = nullptr;
+	}
+}
+
+bool vulkan_queue::allocate_ring(ring_buffer& ring, const uint32_t alloc_size, uint32_t& offset, uint64_t& id) {
+	if(alloc_size == 0 || alloc_size > ring.size / 4u) {
+		return false;
+	}
+	const auto align_offset = [&ring](const uint32_t unaligned_offset) {
+		return ((unaligned_offset + ring.alignment - 1u) / ring.alignment) * ring.alignment;
+	};
+	
+	// find free space: everything is free if there are no allocations, otherwise free space is [head, tail),
+	// which may wrap around the end of the buffer
+	uint32_t begin = ~0u;
+	if(ring.allocations.empty()) {
+		begin = 0;
+	}
+	else if(ring.head > ring.tail) {
+		// free: [head, size) and [0, tail)
+		const auto aligned_head = align_offset(ring.head);
+		if(uint64_t(aligned_head) + alloc_size <= ring.size) {
+			begin = aligned_head;
+		}
+		else if(alloc_size < ring.tail) {
+			begin = 0;
+		}
+	}
+	else if(ring.head < ring.tail) {
+		// free: [head, tail)
+		const auto aligned_head = align_offset(ring.head);
+		if(uint64_t(aligned_head) + alloc_size < ring.tail) {
+			begin = aligned_head;
+		}
+	}
+	// else: head == tail with existing allocations -> full
+	if(begin == ~0u) {
+		return false;
+	}
+	
+	const auto end = begin + alloc_size;
+	if(ring.allocations.empty()) {
+		ring.tail = begin;
+	}
+	ring.head = end;
+	ring.allocations.emplace_back(ring_buffer::allocation { ring.next_id, begin, end, false });
+	
+	offset = begin;
+	id = ring.next_id++;
+	return true;
+}
+
+void vulkan_queue::release_ring(ring_buffer& ring, const vector<uint64_t>& allocation_ids) {
+	for(const auto& id : allocation_ids) {
+		// ids are monotonically increasing -> can compute the position relative to the oldest allocation
+		if(ring.allocations.empty() || id < ring.allocations.front().id) continue;
+		const auto pos = size_t(id - ring.allocations.front().id);
+		if(pos < ring.allocations.size()) {
+			ring.allocations[pos].released = true;
+		}
+	}
+	
+	// reclaim all released allocations at the front
+	while(!ring.allocations.empty() && ring.allocations.front().released) {
+		ring.allocations.pop_front();
+	}
+	if(ring.allocations.empty()) {
+		ring.head = 0;
+		ring.tail = 0;
 	}
 	else {
-		// block until done or timeout
-		submit_func();
+		ring.tail = ring.allocations.front().begin;
+	}
+}
+
+bool vulkan_queue::allocate_constant(const void* data, const size_t& size, constant_allocation& alloc) const {
+	GUARD(constant_ring_lock);
+	auto& ring = constant_ring;
+	if(ring.mapped_ptr == nullptr) {
+		if(ring.creation_failed) return false;
+		VkPhysicalDeviceProperties props;
+		vkGetPhysicalDeviceProperties(((const vulkan_device&)device).physical_device, &props);
+		ring.alignment = max(uint32_t(props.limits.minStorageBufferOffsetAlignment), 4u);
+		if(!create_ring(ring, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "constant ring")) {
+			destroy_ring(ring);
+			ring.creation_failed = true;
+			return false;
+		}
+	}
+	
+	// all allocations are a multiple of 4 bytes (minimum SSBO granularity)
+	const auto alloc_size = uint32_t((size + 3u) & ~size_t(3u));
+	uint32_t offset = 0;
+	uint64_t id = 0;
+	if(size == 0 || !allocate_ring(ring, alloc_size, offset, id)) {
+		return false;
 	}
+	memcpy(ring.mapped_ptr + offset, data, size);
+	
+	alloc.buffer_info = VkDescriptorBufferInfo { ring.buffer, 0, alloc_size };
+	alloc.dyn_offset = offset;
+	alloc.id = id;
+	return true;
+}
+
+void vulkan_queue::release_constants(const vector<uint64_t>& allocation_ids) const {
+	if(allocation_ids.empty()) return;
+	
+	GUARD(constant_ring_lock);
+	release_ring(constant_ring, allocation_ids);
+}
+
+bool vulkan_queue::allocate_staging(const size_t& size, staging_allocation& alloc) const {
+	GUARD(staging_ring_lock);
+	auto& ring = staging_ring;
+	if(ring.mapped_ptr == nullptr) {
+		if(ring.creation_failed) return false;
+		// image copies require offsets that are a multiple of the texel block size (1, 2, 3, 4, 6, 8, 12 or 16 bytes)
+		ring.alignment = 48u;
+		if(!create_ring(ring, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+						VK_MEMORY_PROPERTY_HOST_CACHED_BIT, "staging ring")) {
+			destroy_ring(ring);
+			ring.creation_failed = true;
+			return false;
+		}
+	}
+	
+	if(size > ring.size) {
+		return false;
+	}
+	uint32_t offset = 0;
+	uint64_t id = 0;
+	if(!allocate_ring(ring, uint32_t(size), offset, id)) {
+		return false;
+	}
+	
+	alloc.buffer = ring.buffer;
+	alloc.offset = offset;
+	alloc.mapped_ptr = ring.mapped_ptr + offset;
+	alloc.id = id;
+	return true;
+}
+
+void vulkan_queue::release_staging(const staging_allocation& alloc) const {
+	GUARD(staging_ring_lock);
+	release_ring(staging_ring, { alloc.id });
 }
 
 #endif
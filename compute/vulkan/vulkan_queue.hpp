@@ -24,15 +24,62 @@
 #if !defined(FLOOR_NO_VULKAN)
 
 #include <floor/compute/compute_queue.hpp>
+#include <floor/compute/compute_event.hpp>
 #include <floor/threading/thread_safety.hpp>
 #include <bitset>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+
+class vulkan_device;
+
+//! timeline semaphore of a queue, shared with all events recorded on that queue
+struct vulkan_timeline_semaphore {
+	const vulkan_device& dev;
+	VkSemaphore sema { nullptr };
+	
+	explicit vulkan_timeline_semaphore(const vulkan_device& dev);
+	~vulkan_timeline_semaphore();
+};
+
+//! event that is signaled once the timeline semaphore of the recording queue has reached "value"
+class vulkan_event final : public compute_event {
+public:
+	vulkan_event(shared_ptr<vulkan_timeline_semaphore> sema, const uint64_t value);
+	
+	void wait() const override;
+	bool is_complete() const override;
+	
+	VkSemaphore get_vulkan_semaphore() const {
+		return sema->sema;
+	}
+	uint64_t get_value() const {
+		return value;
+	}
+	
+protected:
+	shared_ptr<vulkan_timeline_semaphore> sema;
+	const uint64_t value;
+	
+};
 
 class vulkan_queue final : public compute_queue {
 public:
 	explicit vulkan_queue(const compute_device& device, VkQueue queue, const uint32_t family_index);
+	~vulkan_queue() override REQUIRES(!completion_lock, !constant_ring_lock, !staging_ring_lock,
+									  !transfer_lock, !cmd_buffers_lock, !queue_lock);
+	
+	void finish() const override REQUIRES(!queue_lock, !transfer_lock, !cmd_buffers_lock, !completion_lock);
+	//! submits all pending transfers
+	void flush() const override REQUIRES(!queue_lock, !transfer_lock, !cmd_buffers_lock, !completion_lock);
 	
-	void finish() const override REQUIRES(!queue_lock);
-	void flush() const override;
+	//! NOTE: requires VK_KHR_timeline_semaphore, falls back to the compute_queue implementation otherwise
+	shared_ptr<compute_event> record_event() const override REQUIRES(!queue_lock, !transfer_lock, !cmd_buffers_lock, !completion_lock);
+	//! NOTE: the wait is attached to the next submission on this queue
+	void wait_for_event(const compute_event& evt) const override REQUIRES(!queue_lock);
+	
+	//! records into a reusable secondary command buffer (see vulkan_command_graph)
+	unique_ptr<compute_command_graph> create_command_graph() const override;
 	
 	// this is synchronized elsewhere
 	const void* get_queue_ptr() const override NO_THREAD_SAFETY_ANALYSIS {
@@ -53,19 +100,95 @@ public:
 	};
 	command_buffer make_command_buffer(const char* name = nullptr) const REQUIRES(!cmd_buffers_lock);
 	
+	//! binds the fixed sampler descriptor set (set #0) at "bind_point" of the specified command buffer,
+	//! unless it has already been bound there since the command buffer has been made
+	//! NOTE: all pipeline layouts use the fixed sampler set layout as set #0 and no push constants, i.e. they are
+	//!       compatible for set #0 and the binding stays valid when switching pipelines inside the command buffer
+	void bind_fixed_sampler_set(const command_buffer& cmd_buffer,
+								const VkPipelineBindPoint bind_point,
+								const VkPipelineLayout pipeline_layout) const REQUIRES(!cmd_buffers_lock);
+	
+	//! adds a function that is called once the specified command buffer has completed (after its completion handler),
+	//! regardless of who submits the command buffer
+	void add_completion_func(const command_buffer& cmd_buffer, function<void()> func) const REQUIRES(!cmd_buffers_lock);
+	
+	//! submits the specified command buffer to this queue
+	//! NOTE: if "blocking" is false, completion is handled by the completion thread of this queue,
+	//!       which calls all completion handlers in submission order
+	//! NOTE: the current transfer batch (if any) is submitted in front of the command buffer
 	void submit_command_buffer(command_buffer cmd_buffer,
 							   const bool blocking = true,
 							   const VkSemaphore* wait_semas = nullptr,
 							   const uint32_t wait_sema_count = 0,
-							   const VkPipelineStageFlags wait_stage_flags = 0) const REQUIRES(!cmd_buffers_lock, !queue_lock);
+							   const VkPipelineStageFlags wait_stage_flags = 0) const REQUIRES(!cmd_buffers_lock, !queue_lock, !completion_lock, !transfer_lock);
 	void submit_command_buffer(command_buffer cmd_buffer,
 							   function<void(const command_buffer&)> completion_handler,
 							   const bool blocking = true,
 							   const VkSemaphore* wait_semas = nullptr,
 							   const uint32_t wait_sema_count = 0,
-							   const VkPipelineStageFlags wait_stage_flags = 0) const REQUIRES(!cmd_buffers_lock, !queue_lock);
+							   const VkPipelineStageFlags wait_stage_flags = 0) const REQUIRES(!cmd_buffers_lock, !queue_lock, !completion_lock, !transfer_lock);
+	
+	//! records transfer commands (buffer/image <-> staging memory copies) into the current transfer batch of this queue,
+	//! a memory barrier is recorded in front of and after the transfer commands
+	//! NOTE: the batch is submitted together with the next command buffer submission on this queue,
+	//!       or when calling submit_transfers(), flush() or finish(), i.e. other queues can't observe the transfer results
+	//!       before that has happened
+	bool record_transfer(const function<void(VkCommandBuffer)>& record_func) const REQUIRES(!transfer_lock, !cmd_buffers_lock);
+	
+	//! submits the current transfer batch (if there is one)
+	void submit_transfers(const bool blocking) const REQUIRES(!cmd_buffers_lock, !queue_lock, !completion_lock, !transfer_lock);
+	
+	//! calls "func" once all transfers that have been recorded so far have completed,
+	//! or right away if there are no pending transfers
+	void after_transfers(function<void()> func) const REQUIRES(!transfer_lock);
+	
+	//! sub-allocation inside the constant argument ring buffer of this queue
+	struct constant_allocation {
+		//! buffer info that must be used for the descriptor (offset is always 0)
+		VkDescriptorBufferInfo buffer_info;
+		//! dynamic offset of this allocation
+		uint32_t dyn_offset { 0u };
+		//! allocation id that must be specified when releasing this allocation
+		uint64_t id { 0u };
+	};
+	
+	//! allocates "size" bytes in the persistently mapped constant argument ring buffer of this queue
+	//! and copies "data" into it, returns false if there is currently no space left
+	//! (-> caller must fall back to a separate buffer)
+	bool allocate_constant(const void* data, const size_t& size, constant_allocation& alloc) const REQUIRES(!constant_ring_lock);
+	
+	//! releases the specified constant allocations, this must be called once the submission that uses them has completed
+	void release_constants(const vector<uint64_t>& allocation_ids) const REQUIRES(!constant_ring_lock);
+	
+	//! sub-allocation inside the staging ring buffer of this queue
+	struct staging_allocation {
+		//! staging buffer that must be used for copies
+		VkBuffer buffer { nullptr };
+		//! offset of this allocation inside "buffer"
+		VkDeviceSize offset { 0u };
+		//! host pointer to the start of this allocation (host-coherent memory)
+		uint8_t* mapped_ptr { nullptr };
+		//! allocation id that must be specified when releasing this allocation
+		uint64_t id { 0u };
+	};
+	
+	//! allocates "size" bytes in the persistently mapped, host-coherent staging ring buffer of this queue,
+	//! returns false if there is currently no space left (-> caller must fall back to a separate staging buffer)
+	bool allocate_staging(const size_t& size, staging_allocation& alloc) const REQUIRES(!staging_ring_lock);
+	
+	//! releases the specified staging allocation, this must be called once all transfers that use it have completed
+	void release_staging(const staging_allocation& alloc) const REQUIRES(!staging_ring_lock);
 	
 protected:
+	//! timeline semaphore that is signaled by record_event() (nullptr if timeline semaphores are not supported)
+	shared_ptr<vulkan_timeline_semaphore> timeline_sema;
+	//! last value that has been signaled on "timeline_sema"
+	mutable uint64_t timeline_value GUARDED_BY(queue_lock) { 0u };
+	//! timeline semaphore waits (from wait_for_event()) that must be attached to the next submission on this queue
+	mutable vector<pair<VkSemaphore, uint64_t>> pending_event_waits GUARDED_BY(queue_lock);
+	//! submits "submit_info" with all pending event waits + the specified timeline semaphore signal (if "signal_value" != 0)
+	VkResult queue_submit(const VkSubmitInfo& submit_info, VkFence fence, const uint64_t signal_value = 0u) const REQUIRES(queue_lock);
+	
 	VkQueue queue GUARDED_BY(queue_lock);
 	mutable safe_mutex queue_lock;
 	const uint32_t family_index;
@@ -78,13 +201,99 @@ protected:
 	};
 	mutable array<VkCommandBuffer, cmd_buffer_count> cmd_buffers GUARDED_BY(cmd_buffers_lock);
 	mutable bitset<cmd_buffer_count> cmd_buffers_in_use GUARDED_BY(cmd_buffers_lock);
+	//! one fence per command buffer (same index), signaled when the command buffer has completed
+	//! NOTE: fences are reset when the command buffer is marked as free again
+	array<VkFence, cmd_buffer_count> cmd_buffer_fences {};
+	//! per command buffer functions that are called on completion (see add_completion_func())
+	mutable array<vector<function<void()>>, cmd_buffer_count> cmd_buffer_completion_funcs GUARDED_BY(cmd_buffers_lock);
+	//! per command buffer bit mask of the bind points the fixed sampler set has been bound at (reset in make_command_buffer())
+	mutable array<uint8_t, cmd_buffer_count> cmd_buffer_fixed_sampler_binds GUARDED_BY(cmd_buffers_lock) {};
+	
+	//! resets the fence, calls the completion handler + completion functions and marks the command buffer as free again
+	void complete_command_buffer(const command_buffer& cmd_buffer,
+								 const function<void(const command_buffer&)>& completion_handler) const REQUIRES(!cmd_buffers_lock);
+	
+	//! non-blocking submissions that are waiting for completion (in submission order)
+	struct pending_submission {
+		command_buffer cmd_buffer;
+		function<void(const command_buffer&)> completion_handler;
+	};
+	mutable safe_mutex completion_lock;
+	mutable condition_variable_any completion_cv;
+	mutable deque<pending_submission> pending_submissions GUARDED_BY(completion_lock);
+	mutable bool completion_thread_should_exit GUARDED_BY(completion_lock) { false };
+	//! completion thread of this queue (started on the first non-blocking submission)
+	mutable unique_ptr<thread> completion_thread GUARDED_BY(completion_lock);
+	void run_completion_thread() const REQUIRES(!completion_lock, !cmd_buffers_lock);
+	
+	//! persistently mapped, host-coherent ring buffer (lazily created on first use)
+	struct ring_buffer {
+		const uint32_t size;
+		VkBuffer buffer { nullptr };
+		VkDeviceMemory memory { nullptr };
+		uint8_t* mapped_ptr { nullptr };
+		//! alignment of all allocations
+		uint32_t alignment { 4u };
+		//! next allocation offset
+		uint32_t head { 0u };
+		//! offset of the oldest allocation that is still in use
+		uint32_t tail { 0u };
+		//! all allocations that are still in use or haven't been reclaimed yet (in allocation order)
+		struct allocation {
+			uint64_t id;
+			uint32_t begin;
+			uint32_t end;
+			bool released;
+		};
+		deque<allocation> allocations;
+		uint64_t next_id { 0u };
+		//! set if creation failed, in which case we won't try again
+		bool creation_failed { false };
+	};
+	
+	//! creates the buffer and memory of the specified ring, the memory type must be host-visible and coherent,
+	//! memory types with all "preferred_flags" are preferred
+	bool create_ring(ring_buffer& ring,
+					 const VkBufferUsageFlags usage,
+					 const VkMemoryPropertyFlags preferred_flags,
+					 const char* name) const;
+	void destroy_ring(ring_buffer& ring) const;
+	//! allocates "size" bytes in the specified ring, returns false if there is no space left
+	static bool allocate_ring(ring_buffer& ring, const uint32_t size, uint32_t& offset, uint64_t& id);
+	//! releases the specified allocations in the specified ring and reclaims space
+	static void release_ring(ring_buffer& ring, const vector<uint64_t>& allocation_ids);
+	
+	//! constant argument ring buffer (1 MiB, storage buffer, preferably device-local)
+	mutable safe_mutex constant_ring_lock;
+	mutable ring_buffer constant_ring GUARDED_BY(constant_ring_lock) { 1024u * 1024u };
+	
+	//! staging ring buffer for uploads/readbacks (16 MiB, transfer src/dst, preferably host-cached)
+	mutable safe_mutex staging_ring_lock;
+	mutable ring_buffer staging_ring GUARDED_BY(staging_ring_lock) { 16u * 1024u * 1024u };
+	
+	//! a command buffer containing batched transfers
+	struct transfer_batch {
+		command_buffer cmd_buffer;
+		//! called once this batch has completed (see after_transfers())
+		vector<function<void()>> completion_funcs;
+	};
+	mutable safe_mutex transfer_lock;
+	//! batch that transfers are currently recorded into (nullptr if there is none)
+	mutable shared_ptr<transfer_batch> open_transfer_batch GUARDED_BY(transfer_lock);
+	//! submitted batches that haven't completed yet (in submission order)
+	mutable deque<shared_ptr<transfer_batch>> in_flight_transfer_batches GUARDED_BY(transfer_lock);
+	//! ends the open transfer batch and moves it to the in-flight batches, returns nullptr if there is no open batch
+	shared_ptr<transfer_batch> take_transfer_batch() const REQUIRES(transfer_lock);
+	//! removes the batch from the in-flight batches and calls all of its completion functions
+	void complete_transfer_batch(const shared_ptr<transfer_batch>& batch) const REQUIRES(!transfer_lock);
 	
-	static constexpr const uint32_t fence_count { 32 };
-	mutable safe_mutex fence_lock;
-	mutable array<VkFence, fence_count> fences GUARDED_BY(fence_lock);
-	mutable bitset<fence_count> fences_in_use GUARDED_BY(fence_lock);
-	pair<VkFence, uint32_t> acquire_fence() const REQUIRES(!fence_lock);
-	void release_fence(VkDevice dev, const pair<VkFence, uint32_t>& fence) const REQUIRES(!fence_lock);
+	//! submits the current transfer batch (if any) + the specified command buffer (if non-nullptr)
+	void submit_internal(const command_buffer* cmd_buffer,
+						 function<void(const command_buffer&)> completion_handler,
+						 const bool blocking,
+						 const VkSemaphore* wait_semas,
+						 const uint32_t wait_sema_count,
+						 const VkPipelineStageFlags wait_stage_flags) const REQUIRES(!cmd_buffers_lock, !queue_lock, !completion_lock, !transfer_lock);
 	
 };
 
@@ -0,0 +1,218 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/core/core.hpp>
+#include <floor/constexpr/sha_256.hpp>
+#include <thread>
+#include <atomic>
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define FLOOR_SHA_256_HAS_SHA_NI 1
+#endif
+
+namespace sha_256 {
+	//! block-wise transform of "block_count" consecutive 64-byte blocks, updating "state"
+	using transform_func_type = void (*)(uint32_t* state, const uint8_t* data, size_t block_count);
+	
+	static inline uint32_t rotr(const uint32_t x, const uint32_t n) {
+		return (x >> n) | (x << (32u - n));
+	}
+	
+	//! portable scalar transform (same algorithm as compute_hash, but operating on whole blocks)
+	static void transform_scalar(uint32_t* state, const uint8_t* data, size_t block_count) {
+		for (; block_count > 0; --block_count, data += 64) {
+			uint32_t m[64];
+			for (uint32_t i = 0, j = 0; i < 16; ++i, j += 4) {
+				m[i] = ((uint32_t(data[j]) << 24u) |
+						(uint32_t(data[j + 1]) << 16u) |
+						(uint32_t(data[j + 2]) << 8u) |
+						uint32_t(data[j + 3]));
+			}
+			for (uint32_t i = 16; i < 64; ++i) {
+				const auto sig0 = rotr(m[i - 15], 7) ^ rotr(m[i - 15], 18) ^ (m[i - 15] >> 3u);
+				const auto sig1 = rotr(m[i - 2], 17) ^ rotr(m[i - 2], 19) ^ (m[i - 2] >> 10u);
+				m[i] = sig1 + m[i - 7] + sig0 + m[i - 16];
+			}
+			
+			auto a = state[0], b = state[1], c = state[2], d = state[3];
+			auto e = state[4], f = state[5], g = state[6], h = state[7];
+			for (uint32_t i = 0; i < 64; ++i) {
+				const auto ep1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+				const auto ch = (e & f) ^ (~e & g);
+				const auto t1 = h + ep1 + ch + k[i] + m[i];
+				const auto ep0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+				const auto maj = (a & b) ^ (a & c) ^ (b & c);
+				const auto t2 = ep0 + maj;
+				h = g;
+				g = f;
+				f = e;
+				e = d + t1;
+				d = c;
+				c = b;
+				b = a;
+				a = t1 + t2;
+			}
+			
+			state[0] += a;
+			state[1] += b;
+			state[2] += c;
+			state[3] += d;
+			state[4] += e;
+			state[5] += f;
+			state[6] += g;
+			state[7] += h;
+		}
+	}
+	
+#if defined(FLOOR_SHA_256_HAS_SHA_NI)
+	//! SHA-NI transform (x86 SHA extensions), processing 4 rounds per message vector
+	__attribute__((target("sha,sse4.1")))
+	static void transform_sha_ni(uint32_t* state, const uint8_t* data, size_t block_count) {
+		// converts the big endian message words to little endian
+		const __m128i byte_swap_mask = _mm_set_epi64x(0x0C0D0E0F08090A0Bll, 0x0405060700010203ll);
+		
+		// state is expected as ABEF/CDGH by the sha256rnds2 instruction
+		__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1); // CDAB
+		__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B); // EFGH
+		__m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+		state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+		
+		for (; block_count > 0; --block_count, data += 64) {
+			const auto state0_save = state0;
+			const auto state1_save = state1;
+			
+			__m128i msgs[4];
+#pragma unroll
+			for (uint32_t i = 0; i < 4; ++i) {
+				msgs[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 16u)), byte_swap_mask);
+			}
+			
+			// 16 groups of 4 rounds each, message schedule is computed on-the-fly in a 4 vector ring
+#pragma unroll
+			for (uint32_t group = 0; group < 16; ++group) {
+				auto& cur_msg = msgs[group & 3u];
+				if (group >= 4) {
+					// W[g] = msg2(msg1(W[g - 4], W[g - 3]) + alignr(W[g - 1], W[g - 2]), W[g - 1])
+					cur_msg = _mm_sha256msg1_epu32(cur_msg, msgs[(group + 1u) & 3u]);
+					cur_msg = _mm_add_epi32(cur_msg, _mm_alignr_epi8(msgs[(group + 3u) & 3u], msgs[(group + 2u) & 3u], 4));
+					cur_msg = _mm_sha256msg2_epu32(cur_msg, msgs[(group + 3u) & 3u]);
+				}
+				
+				auto msg = _mm_add_epi32(cur_msg, _mm_loadu_si128((const __m128i*)&k[group * 4u]));
+				state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+				msg = _mm_shuffle_epi32(msg, 0x0E);
+				state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+			}
+			
+			state0 = _mm_add_epi32(state0, state0_save);
+			state1 = _mm_add_epi32(state1, state1_save);
+		}
+		
+		// ABEF/CDGH -> ABCD/EFGH
+		tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+		state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+		state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+		state1 = _mm_alignr_epi8(state1, tmp, 8); // HGFE
+		_mm_storeu_si128((__m128i*)&state[0], state0);
+		_mm_storeu_si128((__m128i*)&state[4], state1);
+	}
+#endif
+	
+	//! returns the best transform function for the current cpu (determined once)
+	static transform_func_type get_transform_func() {
+#if defined(FLOOR_SHA_256_HAS_SHA_NI)
+		static const transform_func_type transform_func = (core::cpu_has_sha() ? &transform_sha_ni : &transform_scalar);
+		return transform_func;
+#else
+		return &transform_scalar;
+#endif
+	}
+	
+	hash_t compute_hash_fast(const uint8_t* data, const size_t size) {
+		const auto transform = get_transform_func();
+		uint32_t state[8] {
+			0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+			0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+		};
+		
+		// all full blocks can directly be transformed from the input data
+		const auto full_block_count = size / 64u;
+		if (full_block_count > 0) {
+			transform(state, data, full_block_count);
+		}
+		
+		// pad the remaining data (0 - 63 bytes): 0x80, zeros, 64-bit big endian bit length -> 1 or 2 blocks
+		uint8_t tail[128];
+		memset(tail, 0, sizeof(tail));
+		const auto remaining_size = size - full_block_count * 64u;
+		if (remaining_size > 0) {
+			memcpy(tail, data + full_block_count * 64u, remaining_size);
+		}
+		tail[remaining_size] = 0x80;
+		const size_t tail_size = (remaining_size < 56u ? 64u : 128u);
+		const uint64_t bit_len = uint64_t(size) * 8ull;
+		for (uint32_t i = 0; i < 8; ++i) {
+			tail[tail_size - 1u - i] = uint8_t((bit_len >> (uint64_t(i) * 8ull)) & 0xFFull);
+		}
+		transform(state, tail, tail_size / 64u);
+		
+		// output is big endian
+		hash_t ret;
+		for (uint32_t i = 0; i < 8; ++i) {
+			ret.hash[i * 4u] = uint8_t((state[i] >> 24u) & 0xFFu);
+			ret.hash[i * 4u + 1u] = uint8_t((state[i] >> 16u) & 0xFFu);
+			ret.hash[i * 4u + 2u] = uint8_t((state[i] >> 8u) & 0xFFu);
+			ret.hash[i * 4u + 3u] = uint8_t(state[i] & 0xFFu);
+		}
+		return ret;
+	}
+	
+	vector<hash_t> compute_hashes_parallel(const vector<pair<const uint8_t*, size_t>>& inputs) {
+		vector<hash_t> ret(inputs.size());
+		const auto thread_count = (uint32_t)std::min(size_t(core::get_hw_thread_count()), inputs.size());
+		if (thread_count <= 1) {
+			for (size_t i = 0, count = inputs.size(); i < count; ++i) {
+				ret[i] = compute_hash_fast(inputs[i].first, inputs[i].second);
+			}
+			return ret;
+		}
+		
+		// inputs usually differ a lot in size -> dynamically fetch the next input instead of splitting up front
+		atomic<size_t> next_input { 0u };
+		const auto hash_inputs = [&inputs, &ret, &next_input]() {
+			for (;;) {
+				const auto idx = next_input++;
+				if (idx >= inputs.size()) {
+					break;
+				}
+				ret[idx] = compute_hash_fast(inputs[idx].first, inputs[idx].second);
+			}
+		};
+		vector<thread> worker_threads;
+		worker_threads.reserve(thread_count - 1u);
+		for (uint32_t i = 1; i < thread_count; ++i) {
+			worker_threads.emplace_back(hash_inputs);
+		}
+		hash_inputs();
+		for (auto& worker : worker_threads) {
+			worker.join();
+		}
+		return ret;
+	}
+	
+} // sha_256
@@ -22,6 +22,10 @@
 #if !defined(FLOOR_NO_MATH_STR)
 #include <iostream>
 #endif
+#if !defined(FLOOR_COMPUTE) || defined(FLOOR_COMPUTE_HOST)
+#include <vector>
+#include <utility>
+#endif
 
 #define SHA_256_ROTLEFT(a, b) (((a) << (b)) | ((a) >> (32 - (b))))
 #define SHA_256_ROTRIGHT(a, b) (((a) >> (b)) | ((a) << (32 - (b))))
@@ -231,6 +235,17 @@ namespace sha_256 {
 		
 		return ret;
 	}
+	
+#if !defined(FLOOR_COMPUTE) || defined(FLOOR_COMPUTE_HOST)
+	//! computes the SHA-256 hash of the specified "data" of the specified "size" at run-time,
+	//! using SHA-NI instructions if supported by the cpu (falls back to a block-wise scalar implementation otherwise)
+	//! NOTE: produces the same result as compute_hash, but is considerably faster for large inputs
+	hash_t compute_hash_fast(const uint8_t* data, const size_t size);
+	
+	//! computes the SHA-256 hashes of all specified { data, size } inputs at run-time,
+	//! distributing the inputs onto multiple threads if there is more than one
+	vector<hash_t> compute_hashes_parallel(const vector<pair<const uint8_t*, size_t>>& inputs);
+#endif
 
 } // sha_ 256
 
@@ -29,6 +29,19 @@
 #include <cpuid.h>
 #endif
 
+#if !defined(__WINDOWS__) && !defined(FLOOR_IOS)
+#include <spawn.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#if defined(__APPLE__)
+#include <crt_externs.h>
+#else
+extern char** environ;
+#endif
+#endif
+
 namespace core {
 static random_device rd {};
 static mt19937 gen { rd() };
@@ -364,9 +377,7 @@ void system(const string& cmd) {
 }
 
 void system(const string& cmd, string& output) {
-	static constexpr size_t buffer_size = 8192;
-	char buffer[buffer_size+1];
-	memset(&buffer, 0, buffer_size+1);
+	static constexpr size_t buffer_size = 65536;
 	
 #if defined(_MSC_VER)
 #define popen _popen
@@ -379,13 +390,178 @@ void system(const string& cmd, string& output) {
 						   ("\"" + cmd + "\"").c_str()
 #endif
 						   , "r");
-	while(fgets(buffer, buffer_size, sys_pipe) != nullptr) {
-		output += buffer;
-		memset(buffer, 0, buffer_size); // size+1 is always 0
+	if(sys_pipe == nullptr) {
+		return;
+	}
+	// NOTE: read binary-safe in large blocks (output may contain \0 chars)
+	auto buffer = make_unique<char[]>(buffer_size);
+	for(;;) {
+		const auto read_size = fread(buffer.get(), 1, buffer_size, sys_pipe);
+		if(read_size == 0) break;
+		output.append(buffer.get(), read_size);
 	}
 	pclose(sys_pipe);
 }
 
+#if !defined(__WINDOWS__) && !defined(FLOOR_IOS)
+//! creates a pipe with FD_CLOEXEC set on both ends (so that concurrently spawned processes won't inherit them)
+static bool create_cloexec_pipe(int (&fds)[2]) {
+#if defined(__linux__)
+	return (pipe2(fds, O_CLOEXEC) == 0);
+#else
+	if(pipe(fds) != 0) return false;
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+	return true;
+#endif
+}
+#endif
+
+int spawn_process(const vector<string>& args, string& output, string& error_output, const string& input,
+				  const vector<pair<int, int>>& fd_mappings) {
+#if !defined(__WINDOWS__) && !defined(FLOOR_IOS)
+	if(args.empty()) return -1;
+	
+	int in_pipe[2] { -1, -1 }, out_pipe[2] { -1, -1 }, err_pipe[2] { -1, -1 };
+	const auto close_fd = [](int& fd) {
+		if(fd >= 0) {
+			close(fd);
+			fd = -1;
+		}
+	};
+	const auto close_all = [&close_fd, &in_pipe, &out_pipe, &err_pipe]() {
+		for(auto fds : { &in_pipe, &out_pipe, &err_pipe }) {
+			close_fd((*fds)[0]);
+			close_fd((*fds)[1]);
+		}
+	};
+	if(!create_cloexec_pipe(in_pipe) || !create_cloexec_pipe(out_pipe) || !create_cloexec_pipe(err_pipe)) {
+		log_error("failed to create pipes for process %s", args[0]);
+		close_all();
+		return -1;
+	}
+	
+	// child: stdin/stdout/stderr -> pipes (dup2 clears FD_CLOEXEC on the new fds)
+	posix_spawn_file_actions_t file_actions;
+	posix_spawn_file_actions_init(&file_actions);
+	posix_spawn_file_actions_adddup2(&file_actions, in_pipe[0], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, out_pipe[1], STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, err_pipe[1], STDERR_FILENO);
+	// additional fds that are explicitly passed on to the child
+	for(const auto& mapping : fd_mappings) {
+		posix_spawn_file_actions_adddup2(&file_actions, mapping.first, mapping.second);
+	}
+	
+	vector<char*> argv;
+	argv.reserve(args.size() + 1);
+	for(const auto& arg : args) {
+		argv.emplace_back(const_cast<char*>(arg.c_str()));
+	}
+	argv.emplace_back(nullptr);
+	
+#if defined(__APPLE__)
+	char** env = *_NSGetEnviron();
+#else
+	char** env = environ;
+#endif
+	pid_t pid = 0;
+	const auto spawn_err = posix_spawnp(&pid, argv[0], &file_actions, nullptr, argv.data(), env);
+	posix_spawn_file_actions_destroy(&file_actions);
+	
+	// close child ends in the parent
+	close_fd(in_pipe[0]);
+	close_fd(out_pipe[1]);
+	close_fd(err_pipe[1]);
+	if(spawn_err != 0) {
+		log_error("failed to spawn process %s: %s", args[0], strerror(spawn_err));
+		close_all();
+		return -1;
+	}
+	
+	// block SIGPIPE while writing to stdin of the process (it might exit before consuming all input)
+	sigset_t sigpipe_set, prev_sig_set;
+	sigemptyset(&sigpipe_set);
+	sigaddset(&sigpipe_set, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &sigpipe_set, &prev_sig_set);
+	bool sigpipe_raised = false;
+	
+	// write stdin and read stdout/stderr at the same time, so that neither side can block on a full pipe
+	size_t input_offset = 0;
+	if(input.empty()) {
+		close_fd(in_pipe[1]);
+	}
+	else {
+		fcntl(in_pipe[1], F_SETFL, fcntl(in_pipe[1], F_GETFL) | O_NONBLOCK);
+	}
+	static constexpr size_t buffer_size = 65536;
+	auto buffer = make_unique<char[]>(buffer_size);
+	while(out_pipe[0] >= 0 || err_pipe[0] >= 0 || in_pipe[1] >= 0) {
+		pollfd poll_fds[3];
+		nfds_t poll_fd_count = 0;
+		for(const auto& fd_and_events : {
+			pair<int, short> { in_pipe[1], POLLOUT },
+			pair<int, short> { out_pipe[0], POLLIN },
+			pair<int, short> { err_pipe[0], POLLIN },
+		}) {
+			if(fd_and_events.first >= 0) {
+				poll_fds[poll_fd_count++] = { fd_and_events.first, fd_and_events.second, 0 };
+			}
+		}
+		if(poll(poll_fds, poll_fd_count, -1) < 0) {
+			if(errno == EINTR) continue;
+			break;
+		}
+		
+		for(nfds_t i = 0; i < poll_fd_count; ++i) {
+			const auto& pfd = poll_fds[i];
+			if(pfd.revents == 0) continue;
+			if(pfd.fd == in_pipe[1]) {
+				const auto written = write(in_pipe[1], input.data() + input_offset, input.size() - input_offset);
+				if(written > 0) {
+					input_offset += size_t(written);
+				}
+				if((written < 0 && errno != EAGAIN && errno != EINTR) || input_offset == input.size()) {
+					sigpipe_raised |= (written < 0 && errno == EPIPE);
+					close_fd(in_pipe[1]);
+				}
+			}
+			else {
+				auto& fd = (pfd.fd == out_pipe[0] ? out_pipe[0] : err_pipe[0]);
+				auto& dst = (pfd.fd == out_pipe[0] ? output : error_output);
+				const auto read_size = read(fd, buffer.get(), buffer_size);
+				if(read_size > 0) {
+					dst.append(buffer.get(), size_t(read_size));
+				}
+				else if(read_size == 0 || (errno != EAGAIN && errno != EINTR)) {
+					close_fd(fd);
+				}
+			}
+		}
+	}
+	close_all();
+	
+	// consume a pending SIGPIPE (if any) before restoring the signal mask
+	if(sigpipe_raised) {
+		sigset_t pending_set;
+		sigemptyset(&pending_set);
+		if(sigpending(&pending_set) == 0 && sigismember(&pending_set, SIGPIPE)) {
+			int sig = 0;
+			sigwait(&sigpipe_set, &sig);
+		}
+	}
+	pthread_sigmask(SIG_SETMASK, &prev_sig_set, nullptr);
+	
+	int status = 0;
+	while(waitpid(pid, &status, 0) < 0) {
+		if(errno != EINTR) return -1;
+	}
+	return (WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+#else
+	log_error("spawn_process is not supported on this platform (process: %s)", !args.empty() ? args[0] : "");
+	return -1;
+#endif
+}
+
 void set_random_seed(const unsigned int& seed) {
 	gen.seed(seed);
 }
@@ -589,6 +765,21 @@ bool cpu_has_avx512() {
 #endif
 }
 
+bool cpu_has_sha() {
+#if !defined(FLOOR_IOS)
+	int eax, ebx, ecx, edx;
+	__cpuid(0, eax, ebx, ecx, edx);
+	if(eax < 7) return false;
+	// SHA-NI code paths also require SSE4.1
+	__cpuid(1, eax, ebx, ecx, edx);
+	if((ecx & bit_SSE4_1) == 0) return false;
+	__cpuid(7, eax, ebx, ecx, edx);
+	return (ebx & 0x20000000) > 0;
+#else
+	return false;
+#endif
+}
+
 string create_tmp_file_name(const string prefix, const string suffix) {
 	seed_seq seed {
 		rd(),
@@ -137,6 +137,15 @@ namespace core {
 	void system(const string& cmd);
 	void system(const string& cmd, string& output);
 	
+	//! spawns the process "args[0]" (looked up in PATH if necessary) with the specified arguments, without going through
+	//! a shell, writes "input" to its stdin and captures its stdout in "output" and its stderr in "error_output",
+	//! returns the exit code of the process or -1 if it couldn't be spawned or didn't exit normally
+	//! "fd_mappings" optionally passes additional fds on to the process: each <fd in this process, fd in the process>
+	//! pair is dup2'ed in the process, all other fds should be FD_CLOEXEC so that they are never inherited
+	//! NOTE: not supported on Windows and iOS (always returns -1)
+	int spawn_process(const vector<string>& args, string& output, string& error_output, const string& input = "",
+					  const vector<pair<int, int>>& fd_mappings = {});
+	
 	// container functions
 	template <class container_type>
 	static inline void erase_if(container_type& container,
@@ -208,6 +217,8 @@ namespace core {
 	bool cpu_has_avx2();
 	//! returns true if the cpu has avx-512 instruction support
 	bool cpu_has_avx512();
+	//! returns true if the cpu has sha (SHA-NI) instruction support
+	bool cpu_has_sha();
 
 }
 
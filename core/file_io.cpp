@@ -23,6 +23,12 @@
 #include <errno.h>
 #endif
 
+#if !defined(__WINDOWS__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
 /*! there is no function currently
  */
 file_io::file_io() {
@@ -425,6 +431,17 @@ bool file_io::is_directory(const string& dirname) {
 #endif
 }
 
+bool file_io::create_directory(const string& dirname) {
+	if(dirname.empty()) return false;
+	if(is_directory(dirname)) return true;
+	
+#if !defined(__WINDOWS__)
+	return (mkdir(dirname.c_str(), 0755) == 0 || errno == EEXIST);
+#else
+	return (CreateDirectoryA(dirname.c_str(), nullptr) != 0 || GetLastError() == ERROR_ALREADY_EXISTS);
+#endif
+}
+
 /*! checks if a file is already opened - if so, return true, otherwise false
  */
 bool file_io::check_open() {
@@ -537,3 +554,83 @@ bool file_io::buffer_to_file(const string& filename, const char* buffer, const s
 	file.close();
 	return true;
 }
+
+unique_ptr<file_io::mapped_file> file_io::map_file(const string& filename) {
+	unique_ptr<mapped_file> ret { new mapped_file() };
+#if !defined(__WINDOWS__)
+	const auto fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0) {
+		log_error("failed to open file for mapping: %s", filename);
+		return {};
+	}
+	
+	struct stat file_stat;
+	if(fstat(fd, &file_stat) != 0) {
+		log_error("failed to retrieve file size: %s", filename);
+		::close(fd);
+		return {};
+	}
+	ret->data_size = size_t(file_stat.st_size);
+	
+	// NOTE: mmap of size 0 is invalid -> return a valid, but empty mapping
+	if(ret->data_size > 0) {
+		auto mapped_ptr = mmap(nullptr, ret->data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mapped_ptr == MAP_FAILED) {
+			log_error("failed to map file: %s", filename);
+			::close(fd);
+			return {};
+		}
+		ret->data_ptr = (const uint8_t*)mapped_ptr;
+	}
+	// the mapping keeps its own reference to the file
+	::close(fd);
+#else
+	auto file_handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file_handle == INVALID_HANDLE_VALUE) {
+		log_error("failed to open file for mapping: %s", filename);
+		return {};
+	}
+	ret->file_handle = file_handle;
+	
+	LARGE_INTEGER file_size;
+	if(!GetFileSizeEx(file_handle, &file_size)) {
+		log_error("failed to retrieve file size: %s", filename);
+		return {};
+	}
+	ret->data_size = size_t(file_size.QuadPart);
+	
+	// NOTE: mapping an empty file is invalid -> return a valid, but empty mapping
+	if(ret->data_size > 0) {
+		ret->mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(ret->mapping_handle == nullptr) {
+			log_error("failed to create file mapping: %s", filename);
+			return {};
+		}
+		ret->data_ptr = (const uint8_t*)MapViewOfFile(ret->mapping_handle, FILE_MAP_READ, 0, 0, 0);
+		if(ret->data_ptr == nullptr) {
+			log_error("failed to map file: %s", filename);
+			return {};
+		}
+	}
+#endif
+	return ret;
+}
+
+file_io::mapped_file::~mapped_file() {
+#if !defined(__WINDOWS__)
+	if(data_ptr != nullptr) {
+		munmap((void*)data_ptr, data_size);
+	}
+#else
+	if(data_ptr != nullptr) {
+		UnmapViewOfFile(data_ptr);
+	}
+	if(mapping_handle != nullptr) {
+		CloseHandle(mapping_handle);
+	}
+	if(file_handle != nullptr) {
+		CloseHandle(file_handle);
+	}
+#endif
+}
@@ -111,6 +111,9 @@ public:
 	//
 	static bool is_file(const string& filename);
 	static bool is_directory(const string& dirname);
+	//! creates the directory "dirname" (parent directories must already exist),
+	//! returns true if it has been created or already exists
+	static bool create_directory(const string& dirname);
 	bool eof() const;
 	bool good() const;
 	bool fail() const;
@@ -143,6 +146,40 @@ public:
 		
 		return ret;
 	}
+	
+	//! read-only memory mapping of an entire file
+	//! NOTE: the mapped data stays valid for the lifetime of this object
+	class mapped_file {
+	public:
+		~mapped_file();
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+		
+		//! returns a pointer to the mapped file data
+		const uint8_t* data() const {
+			return data_ptr;
+		}
+		
+		//! returns the size of the mapped file in bytes
+		size_t size() const {
+			return data_size;
+		}
+		
+	protected:
+		friend class file_io;
+		mapped_file() = default;
+		
+		const uint8_t* data_ptr { nullptr };
+		size_t data_size { 0u };
+#if defined(__WINDOWS__)
+		void* file_handle { nullptr };
+		void* mapping_handle { nullptr };
+#endif
+	};
+	
+	//! memory-maps the file "filename" read-only and returns the mapping (nullptr on failure)
+	//! NOTE: an empty file results in a valid mapping with a size of 0 and no data
+	static unique_ptr<mapped_file> map_file(const string& filename);
 
 protected:
 	OPEN_TYPE open_type { OPEN_TYPE::READ_BINARY };
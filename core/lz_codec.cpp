@@ -0,0 +1,234 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/core/lz_codec.hpp>
+#include <cstring>
+#include <algorithm>
+
+namespace lz_codec {
+	static constexpr const size_t min_match_length { 4u };
+	static constexpr const size_t max_offset { (1u << 24u) - 1u };
+	static constexpr const uint32_t hash_bits { 16u };
+	//! after this many consecutive misses, the search step is increased (skips incompressible data faster)
+	static constexpr const uint32_t skip_trigger { 6u };
+	
+	static inline uint32_t read_u32(const uint8_t* ptr) {
+		uint32_t ret;
+		memcpy(&ret, ptr, sizeof(uint32_t));
+		return ret;
+	}
+	
+	static inline uint32_t hash_u32(const uint32_t val) {
+		return (val * 2654435761u) >> (32u - hash_bits);
+	}
+	
+	//! writes a length extension (255 continuation bytes + remainder)
+	static inline void write_length(vector<uint8_t>& out, size_t len) {
+		for(; len >= 255u; len -= 255u) {
+			out.emplace_back(uint8_t(255u));
+		}
+		out.emplace_back(uint8_t(len));
+	}
+	
+	//! reads a length extension, returns false if the input ends prematurely
+	static inline bool read_length(const uint8_t*& src, const uint8_t* src_end, size_t& len) {
+		for(;;) {
+			if(src >= src_end) {
+				return false;
+			}
+			const auto byte = *src++;
+			len += byte;
+			if(byte != 255u) {
+				return true;
+			}
+		}
+	}
+	
+	//! writes a full sequence, if "match_length" is 0, this is the last sequence (literals only)
+	static void write_sequence(vector<uint8_t>& out,
+							   const uint8_t* literals, const size_t literal_length,
+							   const size_t offset, const size_t match_length) {
+		const auto match_token_length = (match_length > 0 ? match_length - min_match_length : 0u);
+		out.emplace_back(uint8_t((min(literal_length, size_t(15u)) << 4u) | min(match_token_length, size_t(15u))));
+		if(literal_length >= 15u) {
+			write_length(out, literal_length - 15u);
+		}
+		if(literal_length > 0) {
+			out.insert(out.end(), literals, literals + literal_length);
+		}
+		if(match_length == 0) {
+			return;
+		}
+		out.emplace_back(uint8_t(offset & 0xFFu));
+		out.emplace_back(uint8_t((offset >> 8u) & 0xFFu));
+		out.emplace_back(uint8_t((offset >> 16u) & 0xFFu));
+		if(match_token_length >= 15u) {
+			write_length(out, match_token_length - 15u);
+		}
+	}
+	
+	vector<uint8_t> compress(const uint8_t* data, const size_t size, const uint8_t* dict, size_t dict_size) {
+		// only the last part of the dictionary that can actually be referenced is used
+		if(dict == nullptr) {
+			dict_size = 0;
+		}
+		else if(dict_size > max_offset) {
+			dict += dict_size - max_offset;
+			dict_size = max_offset;
+		}
+		
+		// matching is done inside a single buffer: [dictionary][data]
+		vector<uint8_t> combined;
+		const uint8_t* buffer = data;
+		if(dict_size > 0) {
+			combined.resize(dict_size + size);
+			memcpy(combined.data(), dict, dict_size);
+			if(size > 0) {
+				memcpy(combined.data() + dict_size, data, size);
+			}
+			buffer = combined.data();
+		}
+		const size_t start = dict_size;
+		const size_t end = dict_size + size;
+		
+		vector<uint8_t> out;
+		out.reserve(size / 2u + 16u);
+		
+		// hash table of the last position of each hashed 4-byte sequence (+1, 0 == empty)
+		vector<uint32_t> table(1u << hash_bits, 0u);
+		for(size_t pos = 0; pos + min_match_length <= dict_size; ++pos) {
+			table[hash_u32(read_u32(buffer + pos))] = uint32_t(pos + 1u);
+		}
+		
+		size_t pos = start, anchor = start;
+		uint32_t miss_count = 0;
+		while(pos + min_match_length <= end) {
+			const auto seq = read_u32(buffer + pos);
+			auto& entry = table[hash_u32(seq)];
+			const auto candidate = size_t(entry) - 1u;
+			entry = uint32_t(pos + 1u);
+			if(candidate == ~size_t(0) || pos - candidate > max_offset || read_u32(buffer + candidate) != seq) {
+				pos += 1u + (miss_count++ >> skip_trigger);
+				continue;
+			}
+			miss_count = 0;
+			
+			// extend the match forward and backward
+			auto match_pos = pos, match_src = candidate;
+			size_t match_length = min_match_length;
+			while(match_pos + match_length < end && buffer[match_src + match_length] == buffer[match_pos + match_length]) {
+				++match_length;
+			}
+			while(match_pos > anchor && match_src > 0 && buffer[match_pos - 1u] == buffer[match_src - 1u]) {
+				--match_pos;
+				--match_src;
+				++match_length;
+			}
+			
+			write_sequence(out, buffer + anchor, match_pos - anchor, match_pos - match_src, match_length);
+			pos = match_pos + match_length;
+			anchor = pos;
+			
+			// also insert the position right before the end of the match (helps with consecutive matches)
+			if(pos - 2u >= start && pos - 2u + min_match_length <= end) {
+				table[hash_u32(read_u32(buffer + pos - 2u))] = uint32_t(pos - 2u + 1u);
+			}
+		}
+		
+		// last sequence: all remaining literals
+		write_sequence(out, buffer + anchor, end - anchor, 0, 0);
+		return out;
+	}
+	
+	bool decompress(const uint8_t* src, const size_t src_size,
+					uint8_t* dst, const size_t dst_size,
+					const uint8_t* dict, size_t dict_size) {
+		if(dict == nullptr) {
+			dict_size = 0;
+		}
+		const uint8_t* src_end = src + src_size;
+		size_t dst_pos = 0;
+		for(;;) {
+			if(src >= src_end) {
+				return false;
+			}
+			const auto token = *src++;
+			
+			// literals
+			size_t literal_length = (token >> 4u);
+			if(literal_length == 15u && !read_length(src, src_end, literal_length)) {
+				return false;
+			}
+			if(literal_length > size_t(src_end - src) || literal_length > dst_size - dst_pos) {
+				return false;
+			}
+			if(literal_length > 0) {
+				memcpy(dst + dst_pos, src, literal_length);
+				src += literal_length;
+				dst_pos += literal_length;
+			}
+			
+			// last sequence?
+			if(src == src_end) {
+				return (dst_pos == dst_size);
+			}
+			
+			// match
+			if(src_end - src < 3) {
+				return false;
+			}
+			const size_t offset = size_t(src[0]) | (size_t(src[1]) << 8u) | (size_t(src[2]) << 16u);
+			src += 3;
+			size_t match_length = (token & 0xFu);
+			if(match_length == 15u && !read_length(src, src_end, match_length)) {
+				return false;
+			}
+			match_length += min_match_length;
+			if(offset == 0 || offset > dst_pos + dict_size || match_length > dst_size - dst_pos) {
+				return false;
+			}
+			
+			// part of the match that lies inside the dictionary
+			if(offset > dst_pos) {
+				const auto dict_offset = offset - dst_pos;
+				const auto dict_length = min(match_length, dict_offset);
+				memcpy(dst + dst_pos, dict + (dict_size - dict_offset), dict_length);
+				dst_pos += dict_length;
+				match_length -= dict_length;
+			}
+			
+			if(match_length == 0) {
+				continue;
+			}
+			
+			// part of the match that lies inside the already decompressed data (may overlap)
+			// NOTE: offset <= dst_pos is guaranteed here, since any part before dst was taken from the dictionary
+			const uint8_t* match_src = dst + dst_pos - offset;
+			if(offset >= match_length) {
+				memcpy(dst + dst_pos, match_src, match_length);
+			}
+			else {
+				for(size_t i = 0; i < match_length; ++i) {
+					dst[dst_pos + i] = match_src[i];
+				}
+			}
+			dst_pos += match_length;
+		}
+	}
+	
+} // lz_codec
@@ -0,0 +1,54 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2019 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_LZ_CODEC_HPP__
+#define __FLOOR_LZ_CODEC_HPP__
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+//! fast LZ77 block codec (LZ4-class)
+//!
+//! block format (a sequence of sequences):
+//! [token: uint8_t = (literal length: 4 bits) << 4 | (match length - 4: 4 bits)]
+//! [literal length extension: uint8_t[], only if literal length == 15, each 255 byte continues]
+//! [literals: uint8_t[literal length]]
+//! --- not present in the last sequence (which only consists of literals) ---
+//! [match offset: 24-bit little endian, 1 - 16 MiB]
+//! [match length extension: uint8_t[], only if match length - 4 == 15, each 255 byte continues]
+//!
+//! NOTE: in contrast to LZ4, match offsets are 24-bit, so that a large dictionary (e.g. the binary of a related target)
+//!       can be fully referenced, the dictionary is treated as if it directly preceded the data
+namespace lz_codec {
+	//! compresses "size" bytes of "data", optionally using the specified dictionary
+	//! NOTE: the result may be larger than the input for incompressible data
+	vector<uint8_t> compress(const uint8_t* data, const size_t size,
+							 const uint8_t* dict = nullptr, const size_t dict_size = 0);
+	
+	//! decompresses "src_size" bytes of compressed data from "src" into "dst", which must be exactly "dst_size" bytes large,
+	//! with the same dictionary that was used for compression,
+	//! returns false if the compressed data is invalid or doesn't decompress to exactly "dst_size" bytes
+	bool decompress(const uint8_t* src, const size_t src_size,
+					uint8_t* dst, const size_t dst_size,
+					const uint8_t* dict = nullptr, const size_t dict_size = 0);
+	
+} // lz_codec
+
+#endif
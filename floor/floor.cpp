@@ -299,6 +299,38 @@ bool floor::init(const init_state& state) {
 		config.keep_temp = config_doc.get<bool>("toolchain.keep_temp", false);
 		config.keep_binaries = config_doc.get<bool>("toolchain.keep_binaries", true);
 		config.use_cache = config_doc.get<bool>("toolchain.use_cache", true);
+		config.cache_path = config_doc.get<string>("toolchain.cache_path", "");
+		if(config.cache_path.empty()) {
+			// default to a per-user cache directory (never a shared one, other users must not be able to inject binaries)
+			const auto get_env_path = [](const char* name) -> string {
+				const char* value = getenv(name);
+				return (value != nullptr ? value : "");
+			};
+#if defined(__APPLE__)
+			if(const auto home = get_env_path("HOME"); !home.empty()) {
+				config.cache_path = home + "/Library/Caches/floor/";
+			}
+#elif !defined(__WINDOWS__)
+			// XDG cache dir (must be absolute), or the default ~/.cache
+			if(const auto xdg_cache = get_env_path("XDG_CACHE_HOME"); !xdg_cache.empty() && xdg_cache[0] == '/') {
+				config.cache_path = xdg_cache + "/floor/";
+			}
+			else if(const auto home = get_env_path("HOME"); !home.empty()) {
+				config.cache_path = home + "/.cache/floor/";
+			}
+#else
+			if(const auto local_app_data = get_env_path("LOCALAPPDATA"); !local_app_data.empty()) {
+				config.cache_path = local_app_data + "\\floor\\cache\\";
+			}
+#endif
+			if(config.cache_path.empty() && config.use_cache) {
+				log_warn("no per-user cache directory found - disabling the compile cache");
+				config.use_cache = false;
+			}
+		}
+		else if(config.cache_path.back() != '/' && config.cache_path.back() != '\\') {
+			config.cache_path += '/';
+		}
 		config.log_commands = config_doc.get<bool>("toolchain.log_commands", false);
 		
 		//
@@ -1599,6 +1631,9 @@ bool floor::get_toolchain_keep_binaries() {
 bool floor::get_toolchain_use_cache() {
 	return config.use_cache;
 }
+const string& floor::get_toolchain_cache_path() {
+	return config.cache_path;
+}
 bool floor::get_toolchain_log_commands() {
 	return config.log_commands;
 }
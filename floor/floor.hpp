@@ -227,6 +227,7 @@ public:
 	static bool get_toolchain_keep_temp();
 	static bool get_toolchain_keep_binaries();
 	static bool get_toolchain_use_cache();
+	static const string& get_toolchain_cache_path();
 	static bool get_toolchain_log_commands();
 	
 	// generic toolchain
@@ -350,6 +351,7 @@ protected:
 		bool keep_temp = false;
 		bool keep_binaries = true;
 		bool use_cache = true;
+		string cache_path = "";
 		bool log_commands = false;
 		
 		// compute toolchain